@@ -0,0 +1,619 @@
+/**
+ * @file aluverify.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks every ALU instruction of each copy of the arithmetic against
+   a vectorized reference model, over every combination of accumulator,
+   operand and flags.
+   Usage: aluverify [--exhaustive]
+   ADD, ADC, SUB, SBB, ANA, XRA, ORA and CMP (register and immediate forms) are
+   checked for all 256 operands and 32 flag combinations, with the
+   accumulators on either side of each carry, sign and decimal boundary and
+   a fixed random sample of others, or all 256 with `--exhaustive`; INR,
+   DCR, DAA, the rotates, CMA, STC and CMC for all 256 x 32; DAD for a
+   fixed random sample. Each is run by
+   `cpu::step` and by `blockEngine`, alone in its block and followed by
+   `aci 0` or `ora a` so that the handlers computing only the carry or no
+   flags are used. The helpers of `recompiled::` are checked with every
+   flag and with each flag alone. The reference is evaluated 8 inputs at a
+   time with GCC vector extensions. The exit status is 1 if any result
+   differs.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./intel8080.hpp"
+#include "./blocks.hpp"
+#include "./opcodes.hpp"
+#include "./recompiled.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief 8 lanes of 16 bits, the width of an SSE2 or NEON register.
+	   Results are packed into a lane as A << 8 | F.
+	 */
+	using lanes = std::uint16_t __attribute__((vector_size(16)));
+
+	constexpr int laneCount = sizeof(lanes) / sizeof(std::uint16_t);
+
+	// Bits of the flags register
+	constexpr std::uint16_t S = 0x80;
+	constexpr std::uint16_t Z = 0x40;
+	constexpr std::uint16_t AC = 0x10;
+	constexpr std::uint16_t CY = 0x01;
+	constexpr std::uint16_t notCY = 0xfffe;
+
+	/**
+	 * @brief The number of mismatches printed for each opcode before the
+	   rest are only counted.
+	 */
+	constexpr int maxReported = 8;
+
+	/**
+	 * @return `std::vector<int>` The accumulators the two-operand
+	   instructions are checked with: all of them if `exhaustive`, otherwise
+	   those next to a boundary and a fixed random sample.
+	 */
+	std::vector<int> accumulators(const bool exhaustive)
+	{
+		std::vector<int> values;
+
+		if(exhaustive)
+		{
+			for(int a = 0; a < 0x100; ++a) values.push_back(a);
+			return values;
+		}
+
+		values = {0x00, 0x01, 0x09, 0x0a, 0x0f, 0x10, 0x7f, 0x80, 0x81, 0x99, 0x9a, 0xf0, 0xfe, 0xff};
+
+		std::mt19937 rng(8080);
+		for(int i = 0; i < 10; ++i) values.push_back(rng() & 0xff);
+
+		return values;
+	}
+
+	/**
+	 * @return `lanes` 1 in each lane where `mask` is set, 0 elsewhere.
+	 */
+	template<typename mask>
+	lanes bit(const mask m) noexcept
+	{
+		return (lanes)m & 1;
+	}
+
+	/**
+	 * @return `lanes` `value` in every lane.
+	 */
+	lanes splat(const std::uint16_t value) noexcept
+	{
+		return lanes{} + value;
+	}
+
+	/**
+	 * @return `lanes` The sign, zero and parity flags, and the always-set
+	   bit 1, of the low 8 bits of `result`.
+	 */
+	lanes szp(lanes result) noexcept
+	{
+		result &= 0xff;
+
+		lanes p = result ^ result >> 4;
+		p ^= p >> 2;
+		p ^= p >> 1;
+
+		return (result & S) | bit(result == 0) << 6 | (~p & 1) << 2 | 0x02;
+	}
+
+	/**
+	 * @brief The reference model for the 8 accumulator operations, in the
+	   order in which they are encoded: ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP.
+	 */
+	lanes alu(const int op, const lanes a, const lanes b, const lanes f) noexcept
+	{
+		lanes result, aux = {}, carry = {};
+
+		switch(op)
+		{
+			case 0:
+			case 1:
+			{
+				const lanes c = op == 1 ? f & CY : lanes{};
+				result = a + b + c;
+				carry = result >> 8 & 1;
+				aux = ((a & 0xf) + (b & 0xf) + c) & AC;
+				break;
+			}
+
+			case 2:
+			case 3:
+			case 7:
+			{
+				const lanes notBorrow = op == 3 ? ~f & CY : splat(1);
+				const lanes complement = ~b & 0xff;
+				result = a + complement + notBorrow;
+				carry = ~result >> 8 & 1;
+				aux = ((a & 0xf) + (complement & 0xf) + notBorrow) & AC;
+				break;
+			}
+
+			case 4:
+				result = a & b;
+				aux = ((a | b) & 0x08) << 1;
+				break;
+
+			case 5:
+				result = a ^ b;
+				break;
+
+			default:
+				result = a | b;
+				break;
+		}
+
+		const lanes newA = op == 7 ? a : result & 0xff;
+		return newA << 8 | szp(result) | aux | carry;
+	}
+
+	/**
+	 * @brief The reference model for the instructions that take only the
+	   accumulator: INR A, DCR A, RLC, RRC, RAL, RAR, DAA, CMA, STC and CMC.
+	 */
+	lanes unary(const byte opcode, const lanes a, const lanes f) noexcept
+	{
+		const lanes carry = f & CY;
+		lanes result;
+
+		switch(opcode)
+		{
+			case 0x3c:
+				result = (a + 1) & 0xff;
+				return result << 8 | szp(result) | bit((result & 0xf) == 0) << 4 | carry;
+
+			case 0x3d:
+				result = (a - 1) & 0xff;
+				return result << 8 | szp(result) | bit((result & 0xf) != 0xf) << 4 | carry;
+
+			case 0x07:
+				return ((a << 1 | a >> 7) & 0xff) << 8 | (f & notCY) | a >> 7;
+
+			case 0x0f:
+				return ((a >> 1 | a << 7) & 0xff) << 8 | (f & notCY) | (a & 1);
+
+			case 0x17:
+				return ((a << 1 | carry) & 0xff) << 8 | (f & notCY) | a >> 7;
+
+			case 0x1f:
+				return (a >> 1 | carry << 7) << 8 | (f & notCY) | (a & 1);
+
+			case 0x27:
+			{
+				const lanes low = a & 0xf, high = a >> 4;
+				const lanes correctLow = bit((f & AC) != 0 or low > 9);
+				const lanes carryOut = bit(carry != 0 or high > 9 or (high >= 9 and low > 9));
+				const lanes added = alu(0, a, correctLow * 0x06 + carryOut * 0x60, f);
+				return (added & notCY) | carryOut;
+			}
+
+			case 0x2f:
+				return (~a & 0xff) << 8 | f;
+
+			case 0x37:
+				return a << 8 | f | CY;
+
+			default:
+				return a << 8 | (f ^ CY);
+		}
+	}
+
+	/**
+	 * @return `byte` The flags register for one of the 32 combinations of
+	   the sign, zero, auxiliary carry, parity and carry flags.
+	 */
+	byte flagsFor(const int i) noexcept
+	{
+		return 0x02 | (i & 1) | (i >> 1 & 1) << 2 | (i >> 2 & 1) << 4 | (i >> 3 & 1) << 6 | (i >> 4 & 1) << 7;
+	}
+
+	/**
+	 * @brief What follows each instruction in its block, for `blockEngine`.
+	 */
+	enum class followUp
+	{
+		none,		// Nothing: every flag is computed.
+		carryIn,	// `aci 0`, which only reads the carry.
+		overwrite	// `ora a`, which reads no flag.
+	};
+
+	/**
+	 * @return `lanes` The results after `follow` ran with `results`.
+	 */
+	lanes followed(const lanes results, const followUp follow) noexcept
+	{
+		const lanes a = results >> 8, f = results & 0xff;
+
+		switch(follow)
+		{
+			case followUp::carryIn: return alu(1, a, lanes{}, f);
+			case followUp::overwrite: return alu(6, a, a, f);
+			default: return results;
+		}
+	}
+
+	/**
+	 * @brief Runs single instructions with `cpu::step`, or in blocks of
+	   their own with `blockEngine`.
+	 */
+	class harness
+	{
+	public:
+		std::uint64_t checked = 0;
+		std::uint64_t failed = 0;
+
+		/**
+		 * @brief What is being checked, printed with each mismatch.
+		 */
+		const char* name = "cpu";
+
+		harness()
+		:
+			ram(0x10000),
+			machine(nullptr, nullptr, ram.data()),
+			engine(machine)
+		{}
+
+		/**
+		 * @brief Runs instructions with `blockEngine` from now on, each
+		   followed by `follow`, or with `cpu::step` if `blocks` is false.
+		 */
+		void use(const bool blocks, const followUp follow = followUp::none) noexcept
+		{
+			useBlocks = blocks;
+			this->follow = follow;
+			loaded = -1;
+		}
+
+		/**
+		 * @return `std::uint16_t` A << 8 | F after running `opcode` (with
+		   `operand` in B and as the immediate byte).
+		 */
+		std::uint16_t run(const byte opcode, const byte a, const byte operand, const byte f)
+		{
+			machine.B() = operand;
+			machine.A() = a;
+			machine.flags() = f;
+
+			if(useBlocks)
+			{
+				if(loaded != opcode) load(opcode);
+
+				machine.PC = slot(operand);
+				engine.run(1);
+			}
+			else
+			{
+				ram[0] = opcode;
+				ram[1] = operand;
+				machine.PC = 0;
+				machine.step();
+			}
+
+			return machine.A() << 8 | machine.flags();
+		}
+
+		/**
+		 * @brief Compares the expected results, one for each of `count`
+		   consecutive operands starting at `firstOperand`.
+		 */
+		void compare(const byte opcode, const byte a, const int firstOperand, const byte f,
+			const std::uint16_t* expected, const std::uint16_t* actual, const int count) noexcept
+		{
+			for(int i = 0; i < count; ++i)
+			{
+				++checked;
+				if(expected[i] == actual[i]) continue;
+
+				if(++failed <= maxReported)
+				{
+					std::printf("%s: opcode %02x A=%02x operand=%02x F=%02x: expected A=%02x F=%02x, got A=%02x F=%02x\n",
+						name, opcode, a, firstOperand + i, f, expected[i] >> 8, expected[i] & 0xff, actual[i] >> 8, actual[i] & 0xff);
+				}
+			}
+		}
+
+	private:
+		std::vector<byte> ram;
+
+	public:
+		cpu machine;
+
+	private:
+		blockEngine engine;
+		bool useBlocks = false;
+		followUp follow = followUp::none;
+		int loaded = -1;
+
+		/**
+		 * @brief Where the block for `operand` is, so that every immediate
+		   operand has a block translated once.
+		 */
+		static bytePair slot(const byte operand) noexcept
+		{
+			return operand * 8;
+		}
+
+		/**
+		 * @brief Places `opcode` with each operand (if it takes one), then
+		   `follow` and a jump back, which ends the block.
+		 */
+		void load(const byte opcode)
+		{
+			for(int operand = 0; operand < 0x100; ++operand)
+			{
+				byte* p = ram.data() + slot(operand);
+
+				*p++ = opcode;
+				if(opcodes[opcode].length == 2) *p++ = operand;
+
+				if(follow == followUp::carryIn) { *p++ = 0xce; *p++ = 0x00; }
+				else if(follow == followUp::overwrite) *p++ = 0xb7;
+
+				*p++ = 0xc3;
+				*p++ = slot(operand) & 0xff;
+				*p++ = slot(operand) >> 8;
+			}
+
+			engine.flush();
+			loaded = opcode;
+		}
+	};
+
+	/**
+	 * @brief Checks the ALU instructions as run by `h`, followed by `follow`.
+	 */
+	void checkInstructions(harness& h, const followUp follow, const std::vector<int>& accumulators)
+	{
+		lanes index;
+		for(int i = 0; i < laneCount; ++i) index[i] = i;
+
+		// The accumulator operations, in their register (B) and immediate forms
+		for(int op = 0; op < 8; ++op)
+		{
+			for(const byte opcode : {byte(0x80 | op << 3), byte(0xc6 | op << 3)})
+			{
+				for(int fi = 0; fi < 32; ++fi)
+				{
+					const byte f = flagsFor(fi);
+
+					for(const int a : accumulators)
+					{
+						for(int b = 0; b < 0x100; b += laneCount)
+						{
+							const lanes expected = followed(alu(op, splat(a), index + splat(b), splat(f)), follow);
+
+							std::uint16_t actual[laneCount];
+							for(int i = 0; i < laneCount; ++i) actual[i] = h.run(opcode, a, b + i, f);
+
+							h.compare(opcode, a, b, f, (const std::uint16_t*)&expected, actual, laneCount);
+						}
+					}
+				}
+			}
+		}
+
+		// The instructions on the accumulator alone
+		for(const byte opcode : {0x3c, 0x3d, 0x07, 0x0f, 0x17, 0x1f, 0x27, 0x2f, 0x37, 0x3f})
+		{
+			for(int fi = 0; fi < 32; ++fi)
+			{
+				const byte f = flagsFor(fi);
+
+				for(int a = 0; a < 0x100; a += laneCount)
+				{
+					const lanes expected = followed(unary(opcode, index + splat(a), splat(f)), follow);
+
+					for(int i = 0; i < laneCount; ++i)
+					{
+						const std::uint16_t actual = h.run(opcode, a + i, 0, f);
+						h.compare(opcode, a + i, 0, f, (const std::uint16_t*)&expected + i, &actual, 1);
+					}
+				}
+			}
+		}
+
+		if(follow != followUp::none)
+			return;
+
+		// DAD B, sampled: HL and BC are too many combinations to check exhaustively
+		std::mt19937 rng(8080);
+
+		for(int sample = 0; sample < 0x10000; sample += laneCount)
+		{
+			lanes hl, bc, f;
+			for(int i = 0; i < laneCount; ++i)
+			{
+				const std::uint32_t r = rng();
+				hl[i] = r;
+				bc[i] = r >> 16;
+				f[i] = flagsFor(rng() % 32);
+			}
+
+			const lanes sum = hl + bc;
+			const lanes expectedF = (f & notCY) | bit(sum < hl);
+
+			for(int i = 0; i < laneCount; ++i)
+			{
+				h.machine.HL() = hl[i];
+				h.machine.BC() = bc[i];
+				h.run(0x09, 0, bc[i] >> 8, f[i]);
+
+				++h.checked;
+				if(h.machine.HL() != sum[i] or h.machine.flags() != expectedF[i])
+				{
+					if(++h.failed <= maxReported)
+					{
+						std::printf("%s: dad b HL=%04x BC=%04x F=%02x: expected HL=%04x F=%02x, got HL=%04x F=%02x\n",
+							h.name, hl[i], bc[i], f[i], sum[i], expectedF[i], h.machine.HL(), h.machine.flags());
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * @return `std::uint16_t` A << 8 | F after the `recompiled::` helper for
+	   accumulator operation `op` (as in `alu`), computing the flags in `used`.
+	 */
+	template<byte used>
+	std::uint16_t runHelper(const int op, byte a, const byte b, byte f) noexcept
+	{
+		const unsigned carry = f & CY;
+
+		switch(op)
+		{
+			case 0: recompiled::add<used>(a, f, b, 0); break;
+			case 1: recompiled::add<used>(a, f, b, carry); break;
+			case 2: a = recompiled::sub<used>(a, f, b, 0); break;
+			case 3: a = recompiled::sub<used>(a, f, b, carry); break;
+			case 4: recompiled::ana<used>(a, f, b); break;
+			case 5: recompiled::xra<used>(a, f, b); break;
+			case 6: recompiled::ora<used>(a, f, b); break;
+			default: recompiled::sub<used>(a, f, b, 0); break;
+		}
+
+		return a << 8 | f;
+	}
+
+	/**
+	 * @brief Checks the helpers of `recompiled::` that compute only the
+	   flags in `used`: the flags in it must be right, and the others must
+	   be as they were.
+	 */
+	template<byte used>
+	void checkHelpers(harness& h, const std::vector<int>& accumulators)
+	{
+		// The flags not in `used`, as they were
+		const auto masked = [](const lanes expected, const lanes f) -> lanes
+		{
+			constexpr std::uint16_t computed = 0xff00 | used, kept = 0xff & ~used;
+			return (expected & computed) | (f & kept);
+		};
+
+		lanes index;
+		for(int i = 0; i < laneCount; ++i) index[i] = i;
+
+		for(int op = 0; op < 8; ++op)
+		{
+			for(int fi = 0; fi < 32; ++fi)
+			{
+				const byte f = flagsFor(fi);
+
+				for(const int a : accumulators)
+				{
+					for(int b = 0; b < 0x100; b += laneCount)
+					{
+						const lanes expected = masked(alu(op, splat(a), index + splat(b), splat(f)), splat(f));
+
+						std::uint16_t actual[laneCount];
+						for(int i = 0; i < laneCount; ++i) actual[i] = runHelper<used>(op, a, b + i, f);
+
+						h.compare(0x80 | op << 3, a, b, f, (const std::uint16_t*)&expected, actual, laneCount);
+					}
+				}
+			}
+		}
+
+		// INR, DCR and DAA on the accumulator
+		for(const byte opcode : {0x3c, 0x3d, 0x27})
+		{
+			for(int fi = 0; fi < 32; ++fi)
+			{
+				const byte f = flagsFor(fi);
+
+				for(int a = 0; a < 0x100; a += laneCount)
+				{
+					lanes expected = unary(opcode, index + splat(a), splat(f));
+
+					// DAA always computes every flag
+					if(opcode != 0x27) expected = masked(expected, splat(f));
+
+					for(int i = 0; i < laneCount; ++i)
+					{
+						byte A = a + i, F = f;
+
+						if(opcode == 0x3c) A = recompiled::inr<used>(F, A);
+						else if(opcode == 0x3d) A = recompiled::dcr<used>(F, A);
+						else recompiled::daa(A, F);
+
+						const std::uint16_t actual = A << 8 | F;
+						h.compare(opcode, a + i, 0, f, (const std::uint16_t*)&expected + i, &actual, 1);
+					}
+				}
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool exhaustive = false;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(std::string(argv[i]) == "--exhaustive")
+		{
+			exhaustive = true;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--exhaustive]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const std::vector<int> a = accumulators(exhaustive);
+	harness h;
+
+	checkInstructions(h, followUp::none, a);
+
+	h.use(true);
+	h.name = "blockEngine";
+	checkInstructions(h, followUp::none, a);
+
+	h.use(true, followUp::carryIn);
+	h.name = "blockEngine, then aci 0";
+	checkInstructions(h, followUp::carryIn, a);
+
+	h.use(true, followUp::overwrite);
+	h.name = "blockEngine, then ora a";
+	checkInstructions(h, followUp::overwrite, a);
+
+	h.name = "recompiled::";
+	checkHelpers<flagMask::all>(h, a);
+	checkHelpers<flagMask::sign>(h, a);
+	checkHelpers<flagMask::zero>(h, a);
+	checkHelpers<flagMask::auxCarry>(h, a);
+	checkHelpers<flagMask::parity>(h, a);
+	checkHelpers<flagMask::carry>(h, a);
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf("%llu results checked in %.3f s, %llu wrong\n",
+		(unsigned long long)h.checked, seconds, (unsigned long long)h.failed);
+
+	return h.failed ? 1 : 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file arcadeboard.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief The Midway 8080 arcade board that Space Invaders runs on, without
+   sound.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `arcadeboard.hpp`.
+
+#include "./arcadeboard.hpp"
+
+#include <cstdio>
+#include <algorithm>
+
+using namespace intel8080;
+
+namespace
+{
+	// `rst 1` and `rst 2`
+	constexpr byte midScreenVector = 0xcf;
+	constexpr byte verticalBlankVector = 0xd7;
+
+	/**
+	 * @brief The most cycles any instruction takes (`xthl`), so that running
+	   this many times fewer instructions than there are cycles left never
+	   overshoots by more than a block.
+	 */
+	constexpr std::uint64_t maxInstructionCycles = 18;
+}
+
+arcadeBoard::arcadeBoard(void)
+:
+	inputs{0x0e, 0x08, 0x00},
+	soundOutput([](const byte, const byte){}),
+	memory(0x10000),
+	machine(
+		[this](const byte port){ return in(port); },
+		[this](const byte port, const byte value){ out(port, value); },
+		memory.data()),
+	engine(machine),
+	screen(memory.data(), screenGeometry())
+{}
+
+bool arcadeBoard::load(const std::vector<std::string>& files)
+{
+	std::uint32_t size = 0;
+
+	for(const std::string& filename : files)
+	{
+		std::FILE *const f = std::fopen(filename.c_str(), "rb");
+
+		if(not f)
+			return false;
+
+		// One byte more than fits, to tell whether the file is too large
+		size += std::fread(memory.data() + size, 1, romSize - size + 1, f);
+		std::fclose(f);
+
+		if(size > romSize)
+			return false;
+	}
+
+	reset();
+	return true;
+}
+
+void arcadeBoard::reset(void)
+{
+	std::fill(memory.begin() + romSize, memory.end(), 0);
+
+	machine = cpu(machine.portInputHandler, machine.portOutputHandler, memory.data());
+	engine.flush();
+
+	shiftRegister = 0;
+	shiftAmount = 0;
+	frames = 0;
+	frameStart = 0;
+}
+
+std::size_t arcadeBoard::loadCache(const std::string& filename)
+{
+	return engine.loadCache(filename, hashBytes(memory.data(), romSize));
+}
+
+bool arcadeBoard::saveCache(const std::string& filename) const
+{
+	return engine.saveCache(filename, hashBytes(memory.data(), romSize));
+}
+
+void arcadeBoard::runFrame(void)
+{
+	runUntil(frameStart + cyclesToMidScreen);
+	machine.interrupt(midScreenVector);
+
+	runUntil(frameStart + cyclesPerFrame);
+	machine.interrupt(verticalBlankVector);
+
+	// From when the frame should have ended, so that overshooting it does
+	// not make the next one late
+	frameStart += cyclesPerFrame;
+	++frames;
+}
+
+std::uint64_t arcadeBoard::getFrames(void) const noexcept
+{
+	return frames;
+}
+
+frameGeometry arcadeBoard::screenGeometry(void) noexcept
+{
+	frameGeometry g;
+	g.base = videoBase;
+	g.width = height;
+	g.scanlines = width;
+	g.turn = frameGeometry::rotation::anticlockwise;
+	return g;
+}
+
+const framebuffer& arcadeBoard::getScreen(void) const noexcept
+{
+	return screen;
+}
+
+std::uint64_t arcadeBoard::frameHash(void) const noexcept
+{
+	return screen.digest();
+}
+
+void arcadeBoard::toGrayscale(byte *const out) const noexcept
+{
+	screen.toGrayscale(out);
+}
+
+void arcadeBoard::toRGBA(std::uint32_t *const out, const std::uint32_t lit /* = 0xffffffff */, const std::uint32_t unlit /* = 0xff000000 */) const noexcept
+{
+	screen.toRGBA(out, lit, unlit);
+}
+
+void arcadeBoard::runUntil(const std::uint64_t target)
+{
+	blockEngine::limits stop;
+	stop.accelerate = false;
+
+	while(machine.cycles < target)
+	{
+		// Waiting for the interrupt
+		if(engine.run((target - machine.cycles) / maxInstructionCycles + 1, stop) == 0)
+		{
+			machine.cycles = target;
+			break;
+		}
+	}
+}
+
+byte arcadeBoard::in(const byte port) noexcept
+{
+	switch(port)
+	{
+		case 0:
+		case 1:
+		case 2:
+			return inputs[port];
+
+		// The top 8 bits of the register, after shifting it left
+		case 3:
+			return (shiftRegister << shiftAmount) >> 8;
+
+		default:
+			return 0;
+	}
+}
+
+void arcadeBoard::out(const byte port, const byte value)
+{
+	switch(port)
+	{
+		case 2:
+			shiftAmount = value & 7;
+			break;
+
+		// New data enters at the top
+		case 4:
+			shiftRegister = value << 8 | shiftRegister >> 8;
+			break;
+
+		case 3:
+		case 5:
+		case 6:
+			soundOutput(port, value);
+			break;
+
+		default:
+			break;
+	}
+}
@@ -0,0 +1,202 @@
+/**
+ * @file arcadeboard.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief The Midway 8080 arcade board that Space Invaders runs on, without
+   sound.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+#include "./blocks.hpp"
+#include "./framebuffer.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace intel8080
+{
+	/**
+	 * @brief Runs Space Invaders and other games for the same board: 8 KiB
+	   of ROM at 0x0000, 1 KiB of work RAM at 0x2000 and a 1bpp framebuffer
+	   from 0x2400 to 0x3fff, a 2 MHz CPU, and a 16-bit shift register on
+	   ports 2 (shift amount, write), 3 (result, read) and 4 (data, write)
+	   that the games use to draw sprites at any pixel position.
+	 * The video hardware requests `rst 1` when the beam reaches the middle
+	   of the screen and `rst 2` at the start of vertical blank, 60 times a
+	   second; `runFrame` runs the CPU for the cycles between them and
+	   requests each in turn. The code runs in `blockEngine`, with copy and
+	   fill loops run normally so that none of them runs across an interrupt.
+	 * The framebuffer holds 224 scanlines of 256 pixels, least significant
+	   bit first, but the monitor is turned 90 degrees anticlockwise, so the
+	   picture is 224 pixels wide and 256 high. `getScreen` converts it to
+	   the picture as it is seen.
+	 * @note Memory is not mirrored above 0x4000, and the ROM is not
+	   write-protected.
+	 * @see https://www.computerarcheology.com/Arcade/SpaceInvaders/Hardware.html
+	 */
+	class arcadeBoard
+	{
+	public:
+		static constexpr bytePair romSize = 0x2000;
+		static constexpr bytePair videoBase = 0x2400;
+		static constexpr bytePair videoSize = 0x1c00;
+
+		/**
+		 * @brief The size of the picture, as seen on the monitor.
+		 */
+		static constexpr int width = 224;
+		static constexpr int height = 256;
+
+		/**
+		 * @brief The CPU clock, and the cycles before the mid-screen and
+		   vertical blank interrupts.
+		 */
+		static constexpr std::uint64_t clockRate = 2000000;
+		static constexpr std::uint64_t cyclesPerFrame = clockRate / 60;
+		static constexpr std::uint64_t cyclesToMidScreen = cyclesPerFrame / 2;
+
+		/**
+		 * @brief The values read from input ports 0, 1 and 2. Bits that are
+		   not wired to a button or DIP switch read as the hardware's
+		   defaults after construction.
+		 * On Space Invaders, port 1 has the coin (bit 0), the 2 and 1 player
+		   start buttons (bits 1 and 2) and player 1's fire, left and right
+		   (bits 4 to 6); port 2 has the DIP switches and player 2's controls.
+		 */
+		std::array<byte, 3> inputs;
+
+		/**
+		 * @brief Receives writes to the sound ports (3 and 5) and the
+		   watchdog (6). Does nothing by default.
+		 */
+		std::function<void(byte port, byte value)> soundOutput;
+
+		/**
+		 * @brief The RAM of `machine`, with the ROM at the bottom.
+		 */
+		std::vector<byte> memory;
+
+		/**
+		 * @brief The CPU. Its port handlers implement the board's ports and
+		   must not be replaced.
+		 */
+		cpu machine;
+
+		arcadeBoard(void);
+
+		/**
+		 * @brief Loads the ROM from `files` in turn, each after the last
+		   (e.g. invaders.h, .g, .f and .e), and resets the board.
+		 * @return `bool` Whether every file was read and they fit in `romSize`.
+		 */
+		bool load(const std::vector<std::string>& files);
+
+		/**
+		 * @brief Clears the RAM, the shift register and the frame count, and
+		   starts the CPU at 0x0000.
+		 */
+		void reset(void);
+
+		/**
+		 * @brief Translates the code in a cache file written by `saveCache`
+		   for the same ROM, so that the first frames run as fast as later
+		   ones. Call it after `load`, which discards translated code.
+		 * @return `std::size_t` The number of blocks translated, which is 0
+		   if the file is missing or was written for another ROM.
+		 */
+		std::size_t loadCache(const std::string& filename);
+
+		/**
+		 * @brief Writes the code translated so far to a cache file for
+		   `loadCache`, keyed by the ROM.
+		 * @return `bool` Whether the file was written.
+		 */
+		bool saveCache(const std::string& filename) const;
+
+		/**
+		 * @brief Runs the CPU for one frame, requesting the mid-screen and
+		   vertical blank interrupts.
+		 */
+		void runFrame(void);
+
+		/**
+		 * @return `std::uint64_t` The number of frames run since the reset.
+		 */
+		std::uint64_t getFrames(void) const noexcept;
+
+		/**
+		 * @return `frameGeometry` Where the framebuffer is, and how the
+		   monitor is turned.
+		 */
+		static frameGeometry screenGeometry(void) noexcept;
+
+		/**
+		 * @return `const framebuffer&` The framebuffer, for converting it
+		   to pictures.
+		 */
+		const framebuffer& getScreen(void) const noexcept;
+
+		/**
+		 * @return `std::uint64_t` The framebuffer's digest, for comparing
+		   frames with ones recorded earlier.
+		 */
+		std::uint64_t frameHash(void) const noexcept;
+
+		/**
+		 * @brief Converts the framebuffer to the picture seen on the
+		   monitor, one byte per pixel, 255 where a pixel is lit and 0
+		   elsewhere, as `framebuffer::toGrayscale`.
+		 * @param out `byte *const` `width * height` bytes, row by row from
+		   the top left.
+		 */
+		void toGrayscale(byte *const out) const noexcept;
+
+		/**
+		 * @brief Converts the framebuffer to the picture seen on the
+		   monitor, one 32-bit pixel at a time, as `framebuffer::toRGBA`.
+		 * @param out `std::uint32_t *const` `width * height` pixels, row by
+		   row from the top left.
+		 * @param lit `std::uint32_t` The value of lit pixels.
+		 * @param unlit `std::uint32_t` The value of the others.
+		 */
+		void toRGBA(std::uint32_t *const out, const std::uint32_t lit = 0xffffffff, const std::uint32_t unlit = 0xff000000) const noexcept;
+
+	private:
+		blockEngine engine;
+		framebuffer screen;
+
+		/**
+		 * @brief The shift register's contents, and the amount it is read
+		   shifted by (port 2).
+		 */
+		bytePair shiftRegister = 0;
+		byte shiftAmount = 0;
+
+		std::uint64_t frames = 0;
+
+		/**
+		 * @brief When the current frame began, in CPU cycles.
+		 */
+		std::uint64_t frameStart = 0;
+
+		/**
+		 * @brief Runs the CPU until `machine.cycles` reaches `target`, or
+		   skips to it if the CPU halts.
+		 */
+		void runUntil(const std::uint64_t target);
+
+		byte in(const byte port) noexcept;
+		void out(const byte port, const byte value);
+	};
+}
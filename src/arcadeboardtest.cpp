@@ -0,0 +1,162 @@
+/**
+ * @file arcadeboardtest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs small ROMs on `arcadeBoard` that drive its ports: the shift
+   register read at every shift amount, the input ports and the sound
+   ports. Then checks what they stored, that the translated code is cached
+   for the same ROM only, and that loading a ROM resets the shift register.
+   Usage: arcadeboardtest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./arcadeboard.hpp"
+#include "./check.hpp"
+
+#include <fstream>
+#include <utility>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	// Where the ROMs store what they read: the bottom of work RAM
+	constexpr bytePair results = 0x2000;
+
+	/**
+	 * @brief Assembles a ROM, which starts at 0x0000.
+	 */
+	class assembler
+	{
+	public:
+		std::vector<byte> code;
+
+		void emit(const std::initializer_list<int> bytes)
+		{
+			for(const int b : bytes) code.push_back(b);
+		}
+
+		/**
+		 * @brief `mvi a, value; out port`
+		 */
+		void out(const byte port, const byte value)
+		{
+			emit({0x3e, value, 0xd3, port});
+		}
+
+		/**
+		 * @brief `in port; sta adr`
+		 */
+		void in(const byte port, const bytePair adr)
+		{
+			emit({0xdb, port, 0x32, adr & 0xff, adr >> 8});
+		}
+
+		void write(const std::string& filename) const
+		{
+			std::ofstream(filename, std::ios::binary).write((const char*)code.data(), code.size());
+		}
+	};
+}
+
+int main(void)
+{
+	const scratchDirectory dir;
+
+	if(not CHECK(dir.ok()))
+		return checks::summary("arcadeboardtest");
+
+	assembler rom;
+	rom.emit({0xf3});				// di
+	rom.emit({0x31, 0x00, 0x24});	// lxi sp, 0x2400
+
+	// Data enters at the top: the register is 0xa35c, then read with each
+	// shift amount
+	rom.out(4, 0x5c);
+	rom.out(4, 0xa3);
+
+	for(byte amount = 0; amount < 8; ++amount)
+	{
+		rom.out(2, amount);
+		rom.in(3, results + amount);
+	}
+
+	// 0x0fa3, shifted by 3: only the low 3 bits of the amount count
+	rom.out(4, 0x0f);
+	rom.out(2, 0x0b);
+	rom.in(3, results + 8);
+
+	// Inputs, then the sound ports and the watchdog
+	rom.in(0, results + 9);
+	rom.in(1, results + 10);
+	rom.in(2, results + 11);
+	rom.out(3, 0x21);
+	rom.out(5, 0x12);
+	rom.out(6, 0x33);
+	rom.emit({0x76});				// hlt
+
+	rom.write(dir / "ports.rom");
+
+	arcadeBoard board;
+	std::vector<std::pair<byte, byte>> sounds;
+	board.soundOutput = [&](const byte port, const byte value){ sounds.emplace_back(port, value); };
+	board.inputs = {0x0e, 0x09, 0x83};
+
+	if(not CHECK(board.load({dir / "ports.rom"})))
+		return checks::summary("arcadeboardtest");
+
+	board.runFrame();
+
+	CHECK(board.machine.getHalted());
+
+	// The top 8 bits of `0xa35c << amount`
+	const byte shifted[] = {0xa3, 0x46, 0x8d, 0x1a, 0x35, 0x6b, 0xd7, 0xae};
+	const byte *const r = board.memory.data() + results;
+
+	for(int amount = 0; amount < 8; ++amount)
+		CHECK(r[amount] == shifted[amount]);
+
+	CHECK(r[8] == 0x7d);
+	CHECK(r[9] == 0x0e and r[10] == 0x09 and r[11] == 0x83);
+	CHECK((sounds == std::vector<std::pair<byte, byte>>{{3, 0x21}, {5, 0x12}, {6, 0x33}}));
+
+	// The code translated for the ROM, for another board with the same ROM
+	// but not for one with another
+	CHECK(board.saveCache(dir / "ports.blocks"));
+
+	{
+		arcadeBoard again;
+
+		if(CHECK(again.load({dir / "ports.rom"})))
+			CHECK(again.loadCache(dir / "ports.blocks") != 0);
+	}
+
+	// Loading a ROM resets the register and the amount
+	assembler after;
+	after.in(3, results);
+	after.emit({0x76});				// hlt
+	after.write(dir / "after.rom");
+
+	if(CHECK(board.load({dir / "after.rom"})))
+	{
+		CHECK(board.loadCache(dir / "ports.blocks") == 0);
+
+		board.runFrame();
+		CHECK(board.memory[results] == 0);
+		CHECK(board.getFrames() == 1);
+	}
+
+	// Too large for the ROM
+	std::ofstream(dir / "large.rom", std::ios::binary) << std::string(arcadeBoard::romSize + 1, '\0');
+	CHECK(not board.load({dir / "large.rom"}));
+	CHECK(not board.load({dir / "missing.rom"}));
+
+	return checks::summary("arcadeboardtest");
+}
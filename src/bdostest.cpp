@@ -0,0 +1,198 @@
+/**
+ * @file bdostest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs a small .COM program under `cpm` that prints with BDOS
+   functions 2 and 9 and reads a file in a scratch directory with 15, 20 and
+   16, then checks what it printed and the codes the calls returned. Also
+   checks that names which would lead out of the directory are refused.
+   Usage: bdostest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./cpm.hpp"
+#include "./check.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	// Where the program stores the code each call returned
+	constexpr bytePair results = 0x0300;
+
+	// FCBs with names CP/M does not allow, filled in once the program is
+	// loaded; the second name of a rename is 16 bytes in
+	constexpr bytePair badFcbs = 0x0400, fcbSize = 0x30;
+	constexpr int badNames = 6;
+
+	/**
+	 * @brief Fills in the drive, name and type of the FCB at `fcb`, padded
+	   with spaces.
+	 */
+	void setName(byte *const fcb, const std::string& name, const std::string& type)
+	{
+		fcb[0] = 0;
+		std::fill(fcb + 1, fcb + 12, ' ');
+		std::copy(name.begin(), name.end(), fcb + 1);
+		std::copy(type.begin(), type.end(), fcb + 9);
+	}
+
+	/**
+	 * @brief Assembles the test program, loaded at 0x0100.
+	 */
+	class assembler
+	{
+	public:
+		std::vector<byte> code;
+
+		bytePair here(void) const noexcept
+		{
+			return 0x0100 + code.size();
+		}
+
+		void emit(const std::initializer_list<int> bytes)
+		{
+			for(const int b : bytes) code.push_back(b);
+		}
+
+		/**
+		 * @brief `mvi c, function; lxi d, de; call 5`; returns the offset
+		   of DE's operand, to be patched later if need be.
+		 */
+		std::size_t bdos(const byte function, const bytePair de)
+		{
+			emit({0x0e, function, 0x11, de & 0xff, de >> 8});
+			const std::size_t operand = code.size() - 2;
+			emit({0xcd, 0x05, 0x00});
+			return operand;
+		}
+
+		/**
+		 * @brief `sta adr`
+		 */
+		void store(const bytePair adr)
+		{
+			emit({0x32, adr & 0xff, adr >> 8});
+		}
+
+		void patch(const std::size_t offset, const bytePair value)
+		{
+			code[offset] = value & 0xff;
+			code[offset + 1] = value >> 8;
+		}
+	};
+}
+
+int main(void)
+{
+	const scratchDirectory dir;
+
+	if(not CHECK(dir.ok()))
+		return checks::summary("bdostest");
+
+	assembler a;
+
+	// Console output, then print string
+	a.bdos(2, 'A');
+	const std::size_t message = a.bdos(9, 0);
+
+	// Open, read, print the record read, read past the end, close; then
+	// open a file that does not exist
+	a.bdos(15, 0x005c);
+	a.store(results + 0);
+	a.bdos(20, 0x005c);
+	a.store(results + 1);
+	a.bdos(9, 0x0080);
+	a.bdos(20, 0x005c);
+	a.store(results + 2);
+	a.bdos(16, 0x005c);
+	a.store(results + 3);
+	a.bdos(15, 0x006c);
+	a.store(results + 4);
+
+	// Open, make, delete, make, make and rename with names that are refused
+	const byte badFunctions[badNames] = {15, 22, 19, 22, 22, 23};
+
+	for(int i = 0; i < badNames; ++i)
+	{
+		a.bdos(badFunctions[i], badFcbs + i * fcbSize);
+		a.store(results + 6 + i);
+	}
+
+	// A call with SP at 0x0001 leaves its return address across the end of
+	// memory, at 0xffff and 0x0000
+	a.emit({0x31, 0x01, 0x00});	// lxi sp, 0x0001
+	a.bdos(2, '!');
+	a.emit({0x3e, 0x01});		// mvi a, 1: reached only if the return was right
+	a.store(results + 5);
+	a.emit({0xc3, 0x00, 0x00});	// jmp 0
+
+	a.patch(message, a.here());
+	for(const char c : std::string("BDOS $")) a.code.push_back(c);
+
+	// The directory the program sees is inside the scratch directory, so
+	// that files next to it can be checked
+	const std::string root = dir / "cpm";
+	std::filesystem::create_directory(root);
+
+	const std::string program = root + "/TEST.COM";
+	std::ofstream(program, std::ios::binary).write((const char*)a.code.data(), a.code.size());
+	std::ofstream(root + "/DATA.TXT", std::ios::binary) << "Hello from a file$";
+	std::ofstream(dir / "X", std::ios::binary) << "Outside";
+
+	cpm machine(root);
+	std::string output;
+	machine.consoleOutput = [&](const char* data, const std::size_t size){ output.append(data, size); };
+	machine.consoleInput = [](){ return EOF; };
+
+	if(not CHECK(machine.loadComFile(program, "data.txt missing.txt")))
+		return checks::summary("bdostest");
+
+	byte *const bad = machine.memory.data() + badFcbs;
+	setName(bad + 0 * fcbSize, "../X", "");
+	setName(bad + 1 * fcbSize, "../Y", "");
+	setName(bad + 2 * fcbSize, "../X", "");
+	setName(bad + 3 * fcbSize, "A\\B", "");
+	setName(bad + 4 * fcbSize, "A\tB", "TXT");
+	setName(bad + 5 * fcbSize, "DATA", "TXT");
+	setName(bad + 5 * fcbSize + 16, "../Z", "");
+
+	machine.run(100000);
+
+	CHECK(machine.getWarmBooted());
+	CHECK(output == "ABDOS Hello from a file!");
+
+	const byte *const r = machine.memory.data() + results;
+	CHECK(r[0] == 0x00);	// Opened
+	CHECK(r[1] == 0x00);	// Read a record
+	CHECK(r[2] == 0x01);	// End of file
+	CHECK(r[3] == 0x00);	// Closed
+	CHECK(r[4] == 0xff);	// No such file
+	CHECK(r[5] == 0x01);	// Returned across the end of memory
+
+	for(int i = 0; i < badNames; ++i)
+		CHECK(r[6 + i] == 0xff);
+
+	// Nothing outside was touched, and nothing was made in the directory
+	CHECK(std::filesystem::exists(dir / "X"));
+	CHECK(not std::filesystem::exists(dir / "Y") and not std::filesystem::exists(dir / "Z"));
+	CHECK(std::filesystem::exists(root + "/DATA.TXT"));
+	CHECK(std::distance(std::filesystem::directory_iterator(root), std::filesystem::directory_iterator()) == 2);
+
+	// The partial record was padded with Ctrl-Z
+	CHECK(machine.memory[0x0080 + 18] == 0x1a and machine.memory[0x00ff] == 0x1a);
+
+	return checks::summary("bdostest");
+}
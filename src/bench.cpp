@@ -0,0 +1,839 @@
+/**
+ * @file bench.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Measures the speed of the emulator on reproducible workloads and
+   on microbenchmarks of each family of instructions.
+   Usage: bench [--reps N] [--warmup N] [--budget N] [--filter TEXT] [--json FILE] [--tests DIR] [--list]
+                [--baseline FILE [--threshold PERCENT] [--alpha P]]
+   Each workload is run for --budget instructions per repetition (restarting
+   programs that finish early); the median and 10th/90th percentiles over the
+   repetitions are reported. --json writes the results, including every sample,
+   to FILE, or to stdout if FILE is -.
+   With --baseline, the results are compared against a file written by --json
+   and the exit status is 1 if any workload got more than --threshold percent
+   (default 10) slower and a one-sided Mann-Whitney U test says the slowdown
+   is significant at level --alpha (default 0.01). If FILE does not exist, the
+   results are saved to it as the new baseline.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./intel8080.hpp"
+#include "./cpm.hpp"
+#include "./blocks.hpp"
+#include "./tiered.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+#ifndef INTEL8080_TESTS_DIR
+	#define INTEL8080_TESTS_DIR "tests"
+#endif
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief What one repetition of a workload did, and how long it took.
+	 */
+	struct sample
+	{
+		std::uint64_t instructions = 0;
+		std::uint64_t cycles = 0;
+		double seconds = 0;
+	};
+
+	/**
+	 * @brief Something to measure.
+	 */
+	struct workload
+	{
+		/**
+		 * @brief The name the workload is reported and filtered by.
+		 */
+		std::string name;
+
+		/**
+		 * @brief Runs the workload for at least `budget` instructions, or
+		   fewer if it cannot run at all.
+		 */
+		std::function<sample(std::uint64_t budget)> run;
+	};
+
+	/**
+	 * @brief The results of all repetitions of a workload.
+	 */
+	struct result
+	{
+		std::string name;
+		std::vector<sample> samples;
+	};
+
+	using clock = std::chrono::steady_clock;
+
+	double secondsSince(const clock::time_point start) noexcept
+	{
+		return std::chrono::duration<double>(clock::now() - start).count();
+	}
+
+	/**
+	 * @brief Runs a CP/M program headless, restarting it until `budget`
+	   instructions have run. Loading is not timed.
+	 */
+	sample runComFile(const std::string& filename, const std::uint64_t budget)
+	{
+		cpm machine;
+		machine.consoleOutput = [](const char*, const std::size_t){};
+		machine.consoleInput = [](){ return EOF; };
+
+		sample s;
+
+		while(s.instructions < budget)
+		{
+			if(not machine.loadComFile(filename))
+				break;
+
+			machine.machine.cycles = 0;
+
+			const auto start = clock::now();
+			const std::uint64_t steps = machine.run(budget - s.instructions);
+			s.seconds += secondsSince(start);
+
+			s.instructions += steps;
+			s.cycles += machine.machine.cycles;
+
+			if(steps == 0)
+				break;
+		}
+
+		return s;
+	}
+
+	/**
+	 * @brief Runs a kernel that loops forever from 0x0100 for exactly
+	   `budget` instructions.
+	 */
+	sample runKernel(const std::vector<byte>& code, const std::uint64_t budget)
+	{
+		std::vector<byte> memory(0x10000);
+		cpu machine([](const byte port){ return port; }, [](const byte, const byte){}, memory.data());
+
+		machine.load(0x0100, code);
+		machine.PC = 0x0100;
+		machine.SP = 0xf000;
+
+		const auto start = clock::now();
+
+		for(std::uint64_t i = 0; i < budget; ++i)
+		{
+			machine.step();
+		}
+
+		sample s;
+		s.seconds = secondsSince(start);
+		s.instructions = budget;
+		s.cycles = machine.cycles;
+		return s;
+	}
+
+	/**
+	 * @brief Runs a kernel like `runKernel`, but with `blockEngine`, for at
+	   least `budget` instructions.
+	 */
+	sample runKernelBlocks(const std::vector<byte>& code, const std::uint64_t budget)
+	{
+		std::vector<byte> memory(0x10000);
+		cpu machine([](const byte port){ return port; }, [](const byte, const byte){}, memory.data());
+		blockEngine blocks(machine);
+
+		machine.load(0x0100, code);
+		machine.PC = 0x0100;
+		machine.SP = 0xf000;
+
+		const auto start = clock::now();
+
+		sample s;
+		s.instructions = blocks.run(budget);
+		s.seconds = secondsSince(start);
+		s.cycles = machine.cycles;
+		return s;
+	}
+
+	/**
+	 * @brief Runs a kernel like `runKernel`, but with `tieredEngine` and its
+	   default thresholds, for at least `budget` instructions.
+	 */
+	sample runKernelTiered(const std::vector<byte>& code, const std::uint64_t budget)
+	{
+		std::vector<byte> memory(0x10000);
+		cpu machine([](const byte port){ return port; }, [](const byte, const byte){}, memory.data());
+		tieredEngine tiered(machine, tieredEngine::thresholds());
+
+		machine.load(0x0100, code);
+		machine.PC = 0x0100;
+		machine.SP = 0xf000;
+
+		const auto start = clock::now();
+
+		sample s;
+		s.instructions = tiered.run(budget);
+		s.seconds = secondsSince(start);
+		s.cycles = machine.cycles;
+		return s;
+	}
+
+	/**
+	 * @brief Synthetic kernels, each an endless loop starting at 0x0100.
+	 */
+	const std::vector<std::pair<std::string, std::vector<byte>>> kernels =
+	{
+		// Accumulator arithmetic and logic on registers and immediates
+		{"kernel/alu", {
+			0x3e, 0x01,			// 0100 MVI A, 01
+			0x06, 0x03,			// 0102 MVI B, 03
+			0x0e, 0x05,			// 0104 MVI C, 05
+			0x80,				// 0106 ADD B
+			0x89,				//      ADC C
+			0x90,				//      SUB B
+			0x99,				//      SBB C
+			0xa8,				//      XRA B
+			0xb1,				//      ORA C
+			0xa0,				//      ANA B
+			0xb9,				//      CMP C
+			0x04,				//      INR B
+			0x0d,				//      DCR C
+			0x27,				//      DAA
+			0x07,				//      RLC
+			0xc6, 0x11,			//      ADI 11
+			0xee, 0x5a,			//      XRI 5a
+			0xc3, 0x06, 0x01,	//      JMP 0106
+		}},
+
+		// Loads and stores through HL, DE, BC and direct addresses, with the
+		// pointers kept within 0x8000-0xafff so the code is never overwritten
+		{"kernel/memory", {
+			0x21, 0x00, 0x80,	// 0100 LXI H, 8000
+			0x11, 0x00, 0x90,	// 0103 LXI D, 9000
+			0x01, 0x00, 0xa0,	// 0106 LXI B, a000
+			0x7e,				// 0109 MOV A, M
+			0x12,				//      STAX D
+			0x0a,				//      LDAX B
+			0x77,				//      MOV M, A
+			0x34,				//      INR M
+			0x1a,				//      LDAX D
+			0x02,				//      STAX B
+			0x3a, 0x00, 0x70,	//      LDA 7000
+			0x32, 0x01, 0x70,	//      STA 7001
+			0x23,				//      INX H
+			0x13,				//      INX D
+			0x03,				//      INX B
+			0x7c,				//      MOV A, H
+			0xe6, 0x0f,			//      ANI 0f
+			0xf6, 0x80,			//      ORI 80
+			0x67,				//      MOV H, A
+			0x7a,				//      MOV A, D
+			0xe6, 0x0f,			//      ANI 0f
+			0xf6, 0x90,			//      ORI 90
+			0x57,				//      MOV D, A
+			0x78,				//      MOV A, B
+			0xe6, 0x0f,			//      ANI 0f
+			0xf6, 0xa0,			//      ORI a0
+			0x47,				//      MOV B, A
+			0xc3, 0x09, 0x01,	//      JMP 0109
+		}},
+
+		// Conditional jumps, taken and not taken in a data-dependent pattern
+		{"kernel/branch", {
+			0x04,				// 0100 INR B
+			0x78,				// 0101 MOV A, B
+			0xe6, 0x01,			// 0102 ANI 01
+			0xc2, 0x0d, 0x01,	// 0104 JNZ 010d
+			0x78,				// 0107 MOV A, B
+			0xe6, 0x02,			// 0108 ANI 02
+			0xca, 0x00, 0x01,	// 010a JZ 0100
+			0x78,				// 010d MOV A, B
+			0xfe, 0x80,			// 010e CPI 80
+			0xda, 0x00, 0x01,	// 0110 JC 0100
+			0xf2, 0x00, 0x01,	// 0113 JP 0100
+			0xc3, 0x00, 0x01,	// 0116 JMP 0100
+		}},
+
+		// Nested calls, conditional calls and returns, and stack traffic
+		{"kernel/call", {
+			0x31, 0x00, 0xf0,	// 0100 LXI SP, f000
+			0xcd, 0x10, 0x01,	// 0103 CALL 0110
+			0xcd, 0x14, 0x01,	// 0106 CALL 0114
+			0xc4, 0x10, 0x01,	// 0109 CNZ 0110
+			0xc3, 0x03, 0x01,	// 010c JMP 0103
+			0x00,				// 010f NOP
+			0xc5,				// 0110 PUSH B
+			0xc1,				// 0111 POP B
+			0x04,				// 0112 INR B
+			0xc9,				// 0113 RET
+			0xe5,				// 0114 PUSH H
+			0xcd, 0x1a, 0x01,	// 0115 CALL 011a
+			0xe1,				// 0118 POP H
+			0xc9,				// 0119 RET
+			0xc8,				// 011a RZ
+			0xc9,				// 011b RET
+		}},
+
+		// A byte copy with a 16-bit count and a byte fill with an 8-bit one,
+		// which `blockEngine` runs with `memmove` and `memset`
+		{"kernel/copy", {
+			0x21, 0x00, 0x80,	// 0100 LXI H, 8000
+			0x11, 0x00, 0x90,	// 0103 LXI D, 9000
+			0x01, 0x00, 0x08,	// 0106 LXI B, 0800
+			0x1a,				// 0109 LDAX D
+			0x77,				//      MOV M, A
+			0x23,				//      INX H
+			0x13,				//      INX D
+			0x0b,				//      DCX B
+			0x78,				//      MOV A, B
+			0xb1,				//      ORA C
+			0xc2, 0x09, 0x01,	//      JNZ 0109
+			0x21, 0x00, 0xa0,	// 0113 LXI H, a000
+			0x0e, 0x00,			// 0116 MVI C, 00
+			0x72,				// 0118 MOV M, D
+			0x23,				//      INX H
+			0x0d,				//      DCR C
+			0xc2, 0x18, 0x01,	//      JNZ 0118
+			0xc3, 0x00, 0x01,	//      JMP 0100
+		}},
+	};
+
+	/**
+	 * @brief A microbenchmark that isolates one family of instructions.
+	 * Its instructions are repeated as straight-line code, so that nearly
+	   every instruction executed belongs to the family.
+	 */
+	struct microKernel
+	{
+		std::string name;
+
+		/**
+		 * @brief The instructions to repeat, in order, one per element.
+		 */
+		std::vector<std::vector<byte>> instructions;
+
+		/**
+		 * @brief If `true`, the operand of every 3-byte instruction is
+		   replaced with the address of the next instruction, so jumps go to
+		   the same place whether they are taken or not.
+		 */
+		bool targetNext = false;
+	};
+
+	const std::vector<microKernel> microKernels =
+	{
+		{"micro/mov_r_r", {{0x41}, {0x4a}, {0x53}, {0x5c}, {0x65}, {0x6c}, {0x78}, {0x47}}},
+		{"micro/mov_r_m", {{0x46}, {0x4e}, {0x56}, {0x5e}, {0x7e}}},
+		{"micro/mov_m_r", {{0x70}, {0x71}, {0x72}, {0x73}, {0x77}}},
+		{"micro/alu_reg", {{0x80}, {0x89}, {0x92}, {0x9b}, {0xa0}, {0xa9}, {0xb2}, {0xbb}}},
+		{"micro/alu_imm", {{0xc6, 0x35}, {0xce, 0x9a}, {0xd6, 0x17}, {0xde, 0x80}, {0xe6, 0xf7}, {0xee, 0x5a}, {0xf6, 0x01}, {0xfe, 0x42}}},
+		{"micro/inr_dcr", {{0x04}, {0x0c}, {0x15}, {0x1d}, {0x3c}, {0x3d}}},
+		{"micro/dad", {{0x09}, {0x19}, {0x29}, {0x39}}},
+		{"micro/push_pop", {{0xc5}, {0xd5}, {0xe5}, {0xf5}, {0xf1}, {0xe1}, {0xd1}, {0xc1}}},
+		{"micro/jcc", {{0xc2, 0, 0}, {0xca, 0, 0}, {0xd2, 0, 0}, {0xda, 0, 0}, {0xe2, 0, 0}, {0xea, 0, 0}, {0xf2, 0, 0}, {0xfa, 0, 0}}, true},
+		{"micro/call_ret", {{0xcd, 0x03, 0x01}, {0xc4, 0x03, 0x01}, {0xcc, 0x03, 0x01}, {0xd4, 0x03, 0x01}, {0xdc, 0x03, 0x01}, {0xcd, 0x04, 0x01}}},
+		{"micro/in_out", {{0xdb, 0x10}, {0xd3, 0x11}}},
+		{"micro/daa", {{0x27}}},
+		{"micro/rotate", {{0x07}, {0x0f}, {0x17}, {0x1f}}},
+	};
+
+	/**
+	 * @brief Generates the code for a microbenchmark: a prelude with two
+	   subroutines and register setup, then about 4K of the kernel's
+	   instructions repeated, then a jump back to the start of them.
+	 */
+	std::vector<byte> generateMicroKernel(const microKernel& kernel)
+	{
+		std::vector<byte> code =
+		{
+			0xc3, 0x10, 0x01,	// 0100 JMP 0110
+			0xc9,				// 0103 RET
+			0xc0,				// 0104 RNZ
+			0xc8,				// 0105 RZ
+			0xc9,				// 0106 RET
+			0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0x31, 0x00, 0xf0,	// 0110 LXI SP, f000
+			0x21, 0x00, 0x80,	// 0113 LXI H, 8000
+			0x01, 0x34, 0x12,	// 0116 LXI B, 1234
+			0x11, 0x78, 0x56,	// 0119 LXI D, 5678
+			0x3e, 0x42,			// 011c MVI A, 42
+		};
+
+		const bytePair loop = 0x0100 + code.size();
+
+		while(code.size() < 0x1000)
+		{
+			for(auto instruction : kernel.instructions)
+			{
+				if(kernel.targetNext and instruction.size() == 3)
+				{
+					const bytePair next = 0x0100 + code.size() + 3;
+					instruction[1] = next % 0x100;
+					instruction[2] = next / 0x100;
+				}
+
+				code.insert(code.end(), instruction.begin(), instruction.end());
+			}
+		}
+
+		code.insert(code.end(), {0xc3, (byte)(loop % 0x100), (byte)(loop / 0x100)});
+		return code;
+	}
+
+	std::vector<workload> makeWorkloads(const std::string& testsDirectory)
+	{
+		std::vector<workload> workloads;
+
+		for(const char *const program : {"TST8080.COM", "8080PRE.COM", "CPUTEST.COM", "8080EXM.COM"})
+		{
+			const std::string filename = testsDirectory + "/" + program;
+			workloads.push_back({std::string("program/") + program, [filename](const std::uint64_t budget){ return runComFile(filename, budget); }});
+		}
+
+		for(const auto& kernel : kernels)
+		{
+			const std::vector<byte> code = kernel.second;
+			workloads.push_back({kernel.first, [code](const std::uint64_t budget){ return runKernel(code, budget); }});
+		}
+
+		for(const auto& kernel : microKernels)
+		{
+			const std::vector<byte> code = generateMicroKernel(kernel);
+			workloads.push_back({kernel.name, [code](const std::uint64_t budget){ return runKernel(code, budget); }});
+		}
+
+		// The same kernels again, run a block at a time
+		for(const auto& kernel : kernels)
+		{
+			const std::vector<byte> code = kernel.second;
+			workloads.push_back({"blocks/" + kernel.first, [code](const std::uint64_t budget){ return runKernelBlocks(code, budget); }});
+		}
+
+		for(const auto& kernel : microKernels)
+		{
+			const std::vector<byte> code = generateMicroKernel(kernel);
+			workloads.push_back({"blocks/" + kernel.name, [code](const std::uint64_t budget){ return runKernelBlocks(code, budget); }});
+		}
+
+		// And starting in the interpreter
+		for(const auto& kernel : kernels)
+		{
+			const std::vector<byte> code = kernel.second;
+			workloads.push_back({"tiered/" + kernel.first, [code](const std::uint64_t budget){ return runKernelTiered(code, budget); }});
+		}
+
+		for(const auto& kernel : microKernels)
+		{
+			const std::vector<byte> code = generateMicroKernel(kernel);
+			workloads.push_back({"tiered/" + kernel.name, [code](const std::uint64_t budget){ return runKernelTiered(code, budget); }});
+		}
+
+		return workloads;
+	}
+
+	/**
+	 * @return The `p`th percentile (0 to 100) of `values`, interpolating
+	   between the nearest two.
+	 */
+	double percentile(std::vector<double> values, const double p)
+	{
+		if(values.empty())
+			return 0;
+
+		std::sort(values.begin(), values.end());
+
+		const double rank = p / 100 * (values.size() - 1);
+		const std::size_t below = rank;
+		const std::size_t above = std::min(below + 1, values.size() - 1);
+
+		return values[below] + (rank - below) * (values[above] - values[below]);
+	}
+
+	std::vector<double> instructionsPerSecond(const result& r)
+	{
+		std::vector<double> values;
+		for(const auto& s : r.samples) values.push_back(s.seconds > 0 ? s.instructions / s.seconds : 0);
+		return values;
+	}
+
+	std::vector<double> cyclesPerSecond(const result& r)
+	{
+		std::vector<double> values;
+		for(const auto& s : r.samples) values.push_back(s.seconds > 0 ? s.cycles / s.seconds : 0);
+		return values;
+	}
+
+	void printTable(const std::vector<result>& results)
+	{
+		std::printf("%-20s %10s %10s %10s %10s %12s\n", "workload", "MIPS p50", "MIPS p10", "MIPS p90", "ns/instr", "MHz p50");
+
+		for(const auto& r : results)
+		{
+			const auto ips = instructionsPerSecond(r);
+			const double median = percentile(ips, 50);
+
+			std::printf("%-20s %10.2f %10.2f %10.2f %10.3f %12.2f\n",
+				r.name.c_str(),
+				median / 1e6, percentile(ips, 10) / 1e6, percentile(ips, 90) / 1e6,
+				median > 0 ? 1e9 / median : 0,
+				percentile(cyclesPerSecond(r), 50) / 1e6);
+		}
+	}
+
+	bool writeJson(const std::string& filename, const std::vector<result>& results, const std::uint64_t budget)
+	{
+		std::FILE *const out = filename == "-" ? stdout : std::fopen(filename.c_str(), "w");
+		if(not out)
+			return false;
+
+		std::fprintf(out, "{\n  \"emulator_version\": %d,\n  \"budget\": %llu,\n  \"workloads\": [", INTEL8080_VERSION__, (unsigned long long)budget);
+
+		for(std::size_t i = 0; i < results.size(); ++i)
+		{
+			const result& r = results[i];
+			const auto ips = instructionsPerSecond(r);
+			const double median = percentile(ips, 50);
+
+			std::fprintf(out, "%s\n    {\n      \"name\": \"%s\",\n", i ? "," : "", r.name.c_str());
+			std::fprintf(out, "      \"median_ips\": %.1f,\n      \"p10_ips\": %.1f,\n      \"p90_ips\": %.1f,\n",
+				median, percentile(ips, 10), percentile(ips, 90));
+			std::fprintf(out, "      \"median_ns_per_instruction\": %.4f,\n      \"median_cycles_per_second\": %.1f,\n",
+				median > 0 ? 1e9 / median : 0, percentile(cyclesPerSecond(r), 50));
+
+			std::fprintf(out, "      \"samples_ips\": [");
+			for(std::size_t j = 0; j < ips.size(); ++j) std::fprintf(out, "%s%.1f", j ? ", " : "", ips[j]);
+			std::fprintf(out, "]\n    }");
+		}
+
+		std::fprintf(out, "\n  ]\n}\n");
+
+		return out == stdout ? std::fflush(out) == 0 : std::fclose(out) == 0;
+	}
+
+	/**
+	 * @brief Reads the samples of each workload from a file written by
+	   `writeJson`. Only that format is understood.
+	 * @return `bool` Whether the file was read and has at least one
+	   workload, each with at least one sample.
+	 */
+	bool readJson(const std::string& filename, std::vector<result>& results)
+	{
+		std::FILE *const in = std::fopen(filename.c_str(), "r");
+		if(not in)
+			return false;
+
+		std::string text;
+		char buffer[4096];
+		for(std::size_t n; (n = std::fread(buffer, 1, sizeof buffer, in)) > 0; ) text.append(buffer, n);
+		std::fclose(in);
+
+		for(std::size_t pos = 0; (pos = text.find("\"name\": \"", pos)) != std::string::npos; )
+		{
+			pos += 9;
+			const std::size_t nameEnd = text.find('"', pos);
+			const std::size_t samples = text.find("\"samples_ips\": [", nameEnd);
+			if(nameEnd == std::string::npos or samples == std::string::npos) return false;
+
+			result r{text.substr(pos, nameEnd - pos), {}};
+			const char* p = text.c_str() + samples + 16;
+
+			for(;;)
+			{
+				char* end;
+				const double ips = std::strtod(p, &end);
+				if(end == p) break;
+
+				// Only the rate matters for comparison, so store it as one
+				// second's worth of instructions
+				sample s;
+				s.instructions = ips;
+				s.seconds = 1;
+				r.samples.push_back(s);
+
+				p = end;
+				while(*p == ',' or *p == ' ') ++p;
+			}
+
+			if(r.samples.empty())
+				return false;
+
+			results.push_back(r);
+			pos = samples;
+		}
+
+		return not results.empty();
+	}
+
+	/**
+	 * @brief Computes the one-sided p-value of a Mann-Whitney U test for the
+	   hypothesis that values in `current` tend to be lower than those in
+	   `baseline`.
+	 * The exact distribution of U is used for small samples without ties;
+	   otherwise the normal approximation with tie and continuity corrections.
+	 */
+	double mannWhitneyLess(const std::vector<double>& current, const std::vector<double>& baseline)
+	{
+		const std::size_t n1 = current.size();
+		const std::size_t n2 = baseline.size();
+
+		if(n1 == 0 or n2 == 0)
+			return 1;
+
+		// U counts the pairs in which the current sample is the larger one,
+		// with ties counting half; small U means current is slower
+		double u = 0;
+		bool ties = false;
+
+		for(const double c : current)
+		{
+			for(const double b : baseline)
+			{
+				if(c > b) u += 1;
+				else if(c == b) { u += 0.5; ties = true; }
+			}
+		}
+
+		if(not ties and n1 + n2 <= 40)
+		{
+			// counts[i][j][k]: arrangements of i current and j baseline
+			// samples with U = k, built up one sample at a time
+			std::vector<std::vector<double>> previous(n2 + 1), next(n2 + 1);
+
+			for(std::size_t j = 0; j <= n2; ++j) previous[j].assign(1, 1);
+
+			for(std::size_t i = 1; i <= n1; ++i)
+			{
+				next[0].assign(1, 1);
+
+				for(std::size_t j = 1; j <= n2; ++j)
+				{
+					// The largest sample is either a current one, beating all
+					// j baseline samples, or a baseline one, beating none
+					next[j].assign(i * j + 1, 0);
+					for(std::size_t k = 0; k < previous[j].size(); ++k) next[j][k + j] += previous[j][k];
+					for(std::size_t k = 0; k < next[j - 1].size(); ++k) next[j][k] += next[j - 1][k];
+				}
+
+				std::swap(previous, next);
+			}
+
+			double total = 0, atMost = 0;
+
+			for(std::size_t k = 0; k < previous[n2].size(); ++k)
+			{
+				total += previous[n2][k];
+				if(k <= u) atMost += previous[n2][k];
+			}
+
+			return atMost / total;
+		}
+
+		// Normal approximation, with the variance corrected for ties
+		std::vector<double> all(current);
+		all.insert(all.end(), baseline.begin(), baseline.end());
+		std::sort(all.begin(), all.end());
+
+		double tieTerm = 0;
+		for(std::size_t i = 0; i < all.size(); )
+		{
+			std::size_t j = i;
+			while(j < all.size() and all[j] == all[i]) ++j;
+			const double t = j - i;
+			tieTerm += t * t * t - t;
+			i = j;
+		}
+
+		const double n = n1 + n2;
+		const double mean = n1 * n2 / 2.0;
+		const double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+
+		if(variance <= 0)
+			return 1;
+
+		const double z = (u + 0.5 - mean) / std::sqrt(variance);
+		return 0.5 * std::erfc(-z / std::sqrt(2.0));
+	}
+
+	/**
+	 * @brief Compares results against a baseline, printing a line per
+	   workload.
+	 * @return Whether at least one workload was compared and none regressed.
+	 */
+	bool compareWithBaseline(const std::vector<result>& results, const std::vector<result>& baseline, const double threshold, const double alpha)
+	{
+		bool passed = true;
+		std::size_t compared = 0;
+
+		std::printf("\n%-20s %12s %12s %9s %9s  %s\n", "workload", "base MIPS", "MIPS", "change", "p", "verdict");
+
+		for(const auto& r : results)
+		{
+			const auto found = std::find_if(baseline.begin(), baseline.end(), [&](const result& b){ return b.name == r.name; });
+
+			if(found == baseline.end())
+			{
+				std::printf("%-20s %12s %12.2f %9s %9s  %s\n", r.name.c_str(), "-", percentile(instructionsPerSecond(r), 50) / 1e6, "-", "-", "new");
+				continue;
+			}
+
+			++compared;
+
+			const auto current = instructionsPerSecond(r);
+			const auto base = instructionsPerSecond(*found);
+			const double currentMedian = percentile(current, 50);
+			const double baseMedian = percentile(base, 50);
+			const double change = baseMedian > 0 ? (currentMedian / baseMedian - 1) * 100 : 0;
+			const double p = mannWhitneyLess(current, base);
+
+			const bool regressed = -change > threshold and p < alpha;
+			passed = passed and not regressed;
+
+			std::printf("%-20s %12.2f %12.2f %+8.1f%% %9.4f  %s\n",
+				r.name.c_str(), baseMedian / 1e6, currentMedian / 1e6, change, p,
+				regressed ? "REGRESSED" : -change > threshold ? "noise" : "ok");
+		}
+
+		// Otherwise nothing was checked at all
+		if(compared == 0)
+		{
+			std::printf("\nNone of the workloads run are in the baseline\n");
+			return false;
+		}
+
+		if(not passed)
+			std::printf("\nThroughput dropped by more than %.1f%% (p < %g)\n", threshold, alpha);
+
+		return passed;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int repetitions = 5;
+	int warmup = 1;
+	std::uint64_t budget = 20000000;
+	std::string filter;
+	std::string jsonFile;
+	std::string testsDirectory = INTEL8080_TESTS_DIR;
+	bool list = false;
+	std::string baselineFile;
+	double threshold = 10;
+	double alpha = 0.01;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if(arg == "--reps" and hasValue) repetitions = std::max(1, std::atoi(argv[++i]));
+		else if(arg == "--warmup" and hasValue) warmup = std::max(0, std::atoi(argv[++i]));
+		else if(arg == "--budget" and hasValue) budget = std::max(1ULL, std::strtoull(argv[++i], nullptr, 10));
+		else if(arg == "--filter" and hasValue) filter = argv[++i];
+		else if(arg == "--json" and hasValue) jsonFile = argv[++i];
+		else if(arg == "--tests" and hasValue) testsDirectory = argv[++i];
+		else if(arg == "--baseline" and hasValue) baselineFile = argv[++i];
+		else if(arg == "--threshold" and hasValue) threshold = std::atof(argv[++i]);
+		else if(arg == "--alpha" and hasValue) alpha = std::atof(argv[++i]);
+		else if(arg == "--list") list = true;
+		else
+		{
+			std::fprintf(stderr,
+				"usage: %s [--reps N] [--warmup N] [--budget N] [--filter TEXT] [--json FILE] [--tests DIR] [--list]\n"
+				"       [--baseline FILE [--threshold PERCENT] [--alpha P]]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::vector<result> results;
+
+	for(const auto& w : makeWorkloads(testsDirectory))
+	{
+		if(w.name.find(filter) == std::string::npos)
+			continue;
+
+		if(list)
+		{
+			std::printf("%s\n", w.name.c_str());
+			continue;
+		}
+
+		for(int i = 0; i < warmup; ++i)
+		{
+			w.run(budget);
+		}
+
+		result r{w.name, {}};
+
+		for(int i = 0; i < repetitions; ++i)
+		{
+			r.samples.push_back(w.run(budget));
+
+			if(r.samples.back().instructions == 0)
+			{
+				std::fprintf(stderr, "bench: %s: could not be run\n", w.name.c_str());
+				return 1;
+			}
+		}
+
+		results.push_back(r);
+	}
+
+	if(list)
+		return 0;
+
+	if(jsonFile != "-")
+		printTable(results);
+
+	if(not jsonFile.empty() and not writeJson(jsonFile, results, budget))
+	{
+		std::fprintf(stderr, "bench: cannot write %s\n", jsonFile.c_str());
+		return 1;
+	}
+
+	if(not baselineFile.empty())
+	{
+		std::vector<result> baseline;
+
+		if(std::filesystem::exists(baselineFile) and not readJson(baselineFile, baseline))
+		{
+			std::fprintf(stderr, "bench: %s is not a baseline with at least one workload\n", baselineFile.c_str());
+			return 1;
+		}
+
+		if(baseline.empty())
+		{
+			if(not writeJson(baselineFile, results, budget))
+			{
+				std::fprintf(stderr, "bench: cannot write %s\n", baselineFile.c_str());
+				return 1;
+			}
+
+			std::printf("\nNo baseline found; saved these results to %s\n", baselineFile.c_str());
+			return 0;
+		}
+
+		if(not compareWithBaseline(results, baseline, threshold, alpha))
+			return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file blockcachetest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks `blockEngine`'s cache files: the blocks translated by one
+   engine are saved, loaded by another for the same program and run with
+   the same results without translating anything more; files for another
+   key or version, damaged or missing files load nothing; and a block
+   whose code has changed since is left to be translated when reached.
+   Usage: blockcachetest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./blocks.hpp"
+#include "./check.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief Adds B + 3 to A for B from 10 down to 1 in a subroutine, then
+	   stores A at 0x0300. Five blocks: the start, the call on its own once
+	   `jnz` leads back to it, the subroutine, the `jnz` and the end.
+	 */
+	const std::vector<byte> program = {
+		0x31, 0x00, 0x04,	// 0100 lxi sp, 0400h
+		0x06, 0x0a,			// 0103 mvi b, 10
+		0xaf,				// 0105 xra a
+		0xcd, 0x11, 0x01,	// 0106 call 0111h
+		0x05,				// 0109 dcr b
+		0xc2, 0x06, 0x01,	// 010a jnz 0106h
+		0x32, 0x00, 0x03,	// 010d sta 0300h
+		0x76,				// 0110 hlt
+		0x80,				// 0111 add b
+		0xc6, 0x03,			// 0112 adi 3
+		0xc9				// 0114 ret
+	};
+
+	constexpr std::size_t blockCount = 5;
+
+	/**
+	 * @brief The program on a `cpu`, run by `cpu::step` or a `blockEngine`.
+	 */
+	struct testSystem
+	{
+		std::vector<byte> memory;
+		cpu machine;
+		blockEngine engine;
+
+		explicit testSystem(const std::vector<byte>& code)
+		:
+			memory(0x10000),
+			machine(nullptr, nullptr, memory.data()),
+			engine(machine)
+		{
+			std::copy(code.begin(), code.end(), memory.begin() + 0x0100);
+			machine.PC = 0x0100;
+			machine.PSW() = 0x0002;
+			machine.BC() = machine.DE() = machine.HL() = 0;
+		}
+
+		std::uint64_t key(void) const noexcept
+		{
+			return hashBytes(memory.data() + 0x0100, program.size());
+		}
+
+		/**
+		 * @brief Whether it ran to the end as `cpu::step` does.
+		 */
+		bool matches(const std::vector<byte>& code)
+		{
+			testSystem reference(code);
+
+			while(not reference.machine.getHalted())
+				reference.machine.step();
+
+			while(engine.run(1000) != 0) {}
+
+			return machine.getHalted() and memory == reference.memory
+				and machine.PSW() == reference.machine.PSW() and machine.BC() == reference.machine.BC()
+				and machine.SP == reference.machine.SP and machine.PC == reference.machine.PC
+				and machine.cycles == reference.machine.cycles;
+		}
+	};
+
+	std::vector<byte> readFile(const std::string& filename)
+	{
+		std::ifstream in(filename, std::ios::binary);
+		return std::vector<byte>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(const std::string& filename, const std::vector<byte>& data)
+	{
+		std::ofstream(filename, std::ios::binary).write((const char*)data.data(), data.size());
+	}
+}
+
+int main(void)
+{
+	const scratchDirectory dir;
+
+	if(not CHECK(dir.ok()))
+		return checks::summary("blockcachetest");
+
+	const std::string file = dir / "program.blocks";
+
+	{
+		testSystem first(program);
+
+		CHECK(first.matches(program));
+		CHECK(first.memory[0x0300] == 0x55);
+		CHECK(first.engine.getStatistics().translated == blockCount);
+		CHECK(first.engine.getStatistics().cached == 0);
+		CHECK(first.engine.saveCache(file, first.key()));
+	}
+
+	// Every block is ready before the program runs, and nothing more is
+	// translated while it does
+	{
+		testSystem second(program);
+
+		CHECK(second.engine.loadCache(file, second.key()) == blockCount);
+		CHECK(second.engine.translated(0x0100) and second.engine.translated(0x0111));
+		CHECK(second.matches(program));
+
+		const blockEngine::statistics& s = second.engine.getStatistics();
+		CHECK(s.cached == blockCount and s.translated == blockCount);
+	}
+
+	// Another key, another version, a damaged file and no file
+	{
+		testSystem other(program);
+		CHECK(other.engine.loadCache(file, other.key() + 1) == 0);
+
+		const std::vector<byte> contents = readFile(file);
+
+		std::vector<byte> version = contents;
+		++version[12];
+		writeFile(dir / "version.blocks", version);
+		CHECK(other.engine.loadCache(dir / "version.blocks", other.key()) == 0);
+
+		std::vector<byte> truncated(contents.begin(), contents.end() - 1);
+		writeFile(dir / "truncated.blocks", truncated);
+		CHECK(other.engine.loadCache(dir / "truncated.blocks", other.key()) == 0);
+
+		CHECK(other.engine.loadCache(dir / "missing.blocks", other.key()) == 0);
+		CHECK(other.engine.getStatistics().translated == 0);
+
+		// Nothing was left behind that would change how it runs
+		CHECK(other.matches(program));
+	}
+
+	// `adi 3` is now `sui 3`: the subroutine is translated again when
+	// called, and the other blocks come from the file
+	{
+		std::vector<byte> changed = program;
+		changed[0x12] = 0xd6;
+
+		testSystem third(changed);
+
+		CHECK(third.engine.loadCache(file, testSystem(program).key()) == blockCount - 1);
+		CHECK(not third.engine.translated(0x0111));
+		CHECK(third.matches(changed));
+		CHECK(third.memory[0x0300] == 0x19);
+		CHECK(third.engine.getStatistics().translated == blockCount);
+	}
+
+	// A file that cannot be written
+	{
+		testSystem fourth(program);
+		CHECK(not fourth.engine.saveCache(dir / "missing/program.blocks", fourth.key()));
+	}
+
+	return checks::summary("blockcachetest");
+}
@@ -0,0 +1,1286 @@
+/**
+ * @file blocks.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs an `intel8080::cpu` a basic block at a time from predecoded
+   blocks that are linked directly to one another.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `blocks.hpp`.
+
+#include "./blocks.hpp"
+#include "./opcodes.hpp"
+#include "./disassembler.hpp"
+#include "./cfg.hpp"
+#include "./recompiled.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief Whether the block containing `adr` starts at `begin` and is
+	   `size` bytes long, allowing for blocks that wrap around to 0.
+	 */
+	bool contains(const bytePair begin, const std::uint32_t size, const bytePair adr) noexcept
+	{
+		return (bytePair)(adr - begin) < size;
+	}
+
+	/**
+	 * @brief The start of a cache file written by `blockEngine::saveCache`,
+	   followed by `blockCount` `cachedBlock`s and then `opCount`
+	   `cachedOp`s, the instructions of each block in turn.
+	 * @note This is stored in cache files as-is.
+	 */
+	struct cacheHeader
+	{
+		char magic[8];
+		std::uint32_t formatVersion;
+
+		/**
+		 * @brief `INTEL8080_VERSION__` of the emulator that wrote the file,
+		   whose handlers and blocks the file describes.
+		 */
+		std::uint32_t emulatorVersion;
+
+		std::uint64_t key;
+		std::uint32_t blockCount;
+		std::uint32_t opCount;
+	};
+
+	static_assert(sizeof(cacheHeader) == 32);
+
+	struct cachedBlock
+	{
+		bytePair begin;
+		byte count;
+		byte reserved;
+	};
+
+	/**
+	 * @brief An instruction of a cached block: its opcode, to check against
+	   memory, and the set of handlers it was given.
+	 */
+	struct cachedOp
+	{
+		byte opcode;
+		byte variant;
+	};
+
+	constexpr char cacheMagic[8] = {'I', '8', '0', '8', '0', 'B', 'L', 'K'};
+	constexpr std::uint32_t cacheFormatVersion = 1;
+
+	/**
+	 * @brief Whether the handlers of `opcode` differ by the flags they
+	   compute: those of the ALU instructions, `inr` and `dcr`.
+	 */
+	constexpr bool reducible(const byte opcode) noexcept
+	{
+		return opcode >> 6 == 2 or (opcode >> 6 == 3 and (opcode & 7) == 6)
+			or (opcode >> 6 == 0 and ((opcode & 7) == 4 or (opcode & 7) == 5));
+	}
+
+	/**
+	 * @brief Whether `opcode` can store to memory without ending its block,
+	   and so rewrite the instructions after it.
+	 */
+	bool storesWithinBlock(const byte opcode) noexcept
+	{
+		return (opcode >> 3 == 0x0e and opcode != 0x76)	// MOV M, r
+			or opcode == 0x34 or opcode == 0x35 or opcode == 0x36	// INR M, DCR M, MVI M
+			or opcode == 0x02 or opcode == 0x12 or opcode == 0x22 or opcode == 0x32	// STAX, SHLD, STA
+			or (opcode & 0xcf) == 0xc5 or opcode == 0xe3;	// PUSH, XTHL
+	}
+}
+
+// Each handler does what `cpu::exec` does for its opcode, except that the
+// operand has already been fetched and the program counter already points to
+// the next instruction; stores also check for translated code. ALU
+// instructions, `inr` and `dcr` only compute the flags in `used`, with the
+// helpers the recompiler's generated code uses.
+template<byte opcode, byte used>
+void blockEngine::execute(blockEngine& e, const microOp& op) noexcept
+{
+	cpu& m = e.machine;
+	byte& A = m.regs[7];
+	byte& F = m.regs[6];
+	bytePair& HL = m.pairs[2];
+
+	constexpr int ddd = opcode >> 3 & 7;
+	constexpr int sss = opcode & 7;
+	constexpr int rp = opcode >> 4 & 3;
+
+	if constexpr(opcode == 0x76)
+	{
+		m.halted = true;
+	}
+	// MOV
+	else if constexpr(opcode >> 6 == 1)
+	{
+		if constexpr(ddd == 6) e.store(HL, m.reg<sss>());
+		else m.reg<ddd>() = m.reg<sss>();
+	}
+	// ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP with a register or immediate
+	else if constexpr(opcode >> 6 == 2 or (opcode >> 6 == 3 and sss == 6))
+	{
+		byte value;
+		if constexpr(opcode >> 6 == 2) value = m.reg<sss>();
+		else value = op.operand;
+
+		if constexpr(ddd == 0) recompiled::add<used>(A, F, value, 0);
+		else if constexpr(ddd == 1) recompiled::add<used>(A, F, value, F & 1);
+		else if constexpr(ddd == 2) A = recompiled::sub<used>(A, F, value, 0);
+		else if constexpr(ddd == 3) A = recompiled::sub<used>(A, F, value, F & 1);
+		else if constexpr(ddd == 4) recompiled::ana<used>(A, F, value);
+		else if constexpr(ddd == 5) recompiled::xra<used>(A, F, value);
+		else if constexpr(ddd == 6) recompiled::ora<used>(A, F, value);
+		else recompiled::sub<used>(A, F, value, 0);
+	}
+	else if constexpr(opcode >> 6 == 0)
+	{
+		// NOP
+		if constexpr(sss == 0) {}
+		// DAD
+		else if constexpr(sss == 1 and (opcode & 0x08))
+		{
+			const unsigned sum = HL + m.pair<rp>();
+			F = (F & ~flagMask::carry) | sum >> 16;
+			HL = sum;
+		}
+		// LXI
+		else if constexpr(sss == 1) m.pair<rp>() = op.operand;
+		// STAX, LDAX, SHLD, LHLD, STA, LDA
+		else if constexpr(sss == 2)
+		{
+			if constexpr(ddd == 0) e.store(m.pair<0>(), A);
+			else if constexpr(ddd == 1) A = m.ram[m.pair<0>()];
+			else if constexpr(ddd == 2) e.store(m.pair<1>(), A);
+			else if constexpr(ddd == 3) A = m.ram[m.pair<1>()];
+			else if constexpr(ddd == 4) e.store16(op.operand, HL);
+			else if constexpr(ddd == 5) HL = e.load16(op.operand);
+			else if constexpr(ddd == 6) e.store(op.operand, A);
+			else A = m.ram[op.operand];
+		}
+		// INX, DCX
+		else if constexpr(sss == 3)
+		{
+			if constexpr(opcode & 0x08) --m.pair<rp>();
+			else ++m.pair<rp>();
+		}
+		// INR, DCR
+		else if constexpr(sss == 4 or sss == 5)
+		{
+			byte& r = m.reg<ddd>();
+
+			if constexpr(sss == 4) r = recompiled::inr<used>(F, r);
+			else r = recompiled::dcr<used>(F, r);
+
+			if constexpr(ddd == 6) e.wrote(HL);
+		}
+		// MVI
+		else if constexpr(sss == 6)
+		{
+			if constexpr(ddd == 6) e.store(HL, op.operand);
+			else m.reg<ddd>() = op.operand;
+		}
+		// RLC
+		else if constexpr(ddd == 0)
+		{
+			const byte out = A >> 7;
+			F = (F & ~1) | out;
+			A = A << 1 | out;
+		}
+		// RRC
+		else if constexpr(ddd == 1)
+		{
+			const byte out = A & 1;
+			F = (F & ~1) | out;
+			A = A >> 1 | out << 7;
+		}
+		// RAL
+		else if constexpr(ddd == 2)
+		{
+			const byte in = F & 1;
+			F = (F & ~1) | A >> 7;
+			A = A << 1 | in;
+		}
+		// RAR
+		else if constexpr(ddd == 3)
+		{
+			const byte in = F & 1;
+			F = (F & ~1) | (A & 1);
+			A = A >> 1 | in << 7;
+		}
+		// DAA
+		else if constexpr(ddd == 4) recompiled::daa(A, F);
+		// CMA
+		else if constexpr(ddd == 5) A = ~A;
+		// STC
+		else if constexpr(ddd == 6) F |= 1;
+		// CMC
+		else F ^= 1;
+	}
+	// Conditional returns
+	else if constexpr(sss == 0)
+	{
+		if(m.condition<ddd>())
+		{
+			m.cycles += 6;
+			e.pop(m.PC);
+		}
+	}
+	else if constexpr(sss == 1)
+	{
+		// RET, incl. undocumented
+		if constexpr(opcode == 0xc9 or opcode == 0xd9) e.pop(m.PC);
+		// PCHL
+		else if constexpr(opcode == 0xe9) m.PC = HL;
+		// SPHL
+		else if constexpr(opcode == 0xf9) m.SP = HL;
+		// POP
+		else if constexpr(rp == 3) e.pop(m.pairs[3]);
+		else e.pop(m.pair<rp>());
+	}
+	// Conditional jumps
+	else if constexpr(sss == 2)
+	{
+		if(m.condition<ddd>()) m.PC = op.operand;
+	}
+	else if constexpr(sss == 3)
+	{
+		// JMP, incl. undocumented
+		if constexpr(opcode == 0xc3 or opcode == 0xcb) m.PC = op.operand;
+		// OUT
+		else if constexpr(opcode == 0xd3) m.portOutputHandler(op.operand, A);
+		// IN
+		else if constexpr(opcode == 0xdb) A = m.portInputHandler(op.operand);
+		// XTHL
+		else if constexpr(opcode == 0xe3)
+		{
+			const bytePair top = e.load16(m.SP);
+			e.store16(m.SP, HL);
+			HL = top;
+		}
+		// XCHG
+		else if constexpr(opcode == 0xeb) std::swap(HL, m.pairs[1]);
+		// DI
+		else if constexpr(opcode == 0xf3) m.interruptsEnabled = false;
+		// EI
+		else m.interruptsEnabled = true;
+	}
+	// Conditional calls
+	else if constexpr(sss == 4)
+	{
+		if(m.condition<ddd>())
+		{
+			m.cycles += 6;
+			e.push(m.PC);
+			m.PC = op.operand;
+		}
+	}
+	else if constexpr(sss == 5)
+	{
+		// CALL, incl. undocumented
+		if constexpr(opcode & 0x08)
+		{
+			e.push(m.PC);
+			m.PC = op.operand;
+		}
+		// PUSH
+		else if constexpr(rp == 3) e.push(m.pairs[3]);
+		else e.push(m.pair<rp>());
+	}
+	// RST
+	else
+	{
+		e.push(m.PC);
+		m.PC = 8 * ddd;
+	}
+}
+
+// Opcodes whose handlers do not differ share the one computing every flag
+template<byte used, std::size_t... opcode>
+constexpr std::array<blockEngine::handler, 256> blockEngine::makeHandlers(std::index_sequence<opcode...>) noexcept
+{
+	return {{&execute<opcode, reducible(opcode) ? used : flagMask::all>...}};
+}
+
+const std::array<byte, blockEngine::flagVariants> blockEngine::variantFlags = {
+	flagMask::all,
+	flagMask::sign | flagMask::zero | flagMask::carry,
+	flagMask::none
+};
+
+const std::array<std::array<blockEngine::handler, 256>, blockEngine::flagVariants> blockEngine::handlers = {
+	makeHandlers<flagMask::all>(std::make_index_sequence<256>()),
+	makeHandlers<flagMask::sign | flagMask::zero | flagMask::carry>(std::make_index_sequence<256>()),
+	makeHandlers<flagMask::none>(std::make_index_sequence<256>())
+};
+
+blockEngine::blockEngine(cpu& m)
+:
+	machine(m),
+	entries(0x10000),
+	code(0x10000),
+	pages(0x100),
+	snapshot(0x10000),
+	exits(0x10000),
+	watched(0x100)
+{}
+
+std::uint64_t blockEngine::run(const std::uint64_t maxInstructions)
+{
+	return run(maxInstructions, limits());
+}
+
+std::uint64_t blockEngine::run(const std::uint64_t maxInstructions, const limits& stop)
+{
+	std::uint64_t executed = 0;
+	block* b = nullptr;
+
+	while(executed < maxInstructions)
+	{
+		if(machine.interruptsEnabled and machine.interruptPending)
+		{
+			machine.step();
+			++executed;
+
+			// The vector is almost always `rst`, which pushes the return address
+			wrote(machine.SP);
+			wrote(machine.SP + 1);
+
+			b = nullptr;
+			continue;
+		}
+
+		if(machine.halted)
+			break;
+
+		if(not b)
+		{
+			if(not stop.translate and not entries[machine.PC])
+				break;
+
+			b = &lookup(machine.PC);
+			++stats.lookups;
+		}
+
+		if((++b->runs == stop.hotRuns or b->exit) and executed != 0)
+			break;
+
+		// A loop starting at an exit must stop there every iteration
+		if(b->loop.type != loopInfo::kind::none and stop.accelerate and not b->exit)
+			executed += accelerate(*b);
+
+		executed += execute(*b);
+
+		// The usual case, inline: the taken target or the next instruction
+		// is already linked
+		if(not stale)
+		{
+			// A call or return that was taken leaves the program counter
+			// somewhere other than after it
+			if(b->calls and machine.PC != b->links[1].target)
+			{
+				returnTop = (returnTop + 1) % returnStackSize;
+				returnStack[returnTop] = {machine.SP, b};
+				returnDepth = std::min(returnDepth + 1, returnStackSize);
+			}
+			else if(b->returns and not (b->links[1].used and machine.PC == b->links[1].target))
+			{
+				if(block *const next = predictReturn(stop.translate))
+				{
+					b = next;
+					continue;
+				}
+			}
+
+			const link& taken = b->links[0];
+			const link& notTaken = b->links[1];
+
+			if(taken.target == machine.PC and taken.to and taken.to->valid)
+			{
+				++stats.chained;
+				b = taken.to;
+				continue;
+			}
+
+			if(notTaken.target == machine.PC and notTaken.to)
+			{
+				++stats.chained;
+				b = notTaken.to;
+				continue;
+			}
+		}
+
+		b = follow(*b, stop.translate);
+	}
+
+	return executed;
+}
+
+void blockEngine::invalidate(const bytePair begin, const std::uint32_t length /* = 1 */)
+{
+	for(std::uint32_t i = 0; i < length and i < 0x10000; ++i)
+	{
+		wrote(begin + i);
+	}
+}
+
+bool blockEngine::endsBlock(const byte opcode) noexcept
+{
+	// Besides control transfers, blocks end where an interrupt may have
+	// become serviceable: after `ei` and `di`, and after `in` and `out`,
+	// whose handlers may request one
+	return opcodes[opcode].flow != flowType::next
+		or opcode == 0xfb or opcode == 0xf3 or opcode == 0xdb or opcode == 0xd3;
+}
+
+bool blockEngine::translated(const bytePair adr) const noexcept
+{
+	return entries[adr];
+}
+
+std::uint64_t blockEngine::getRuns(const bytePair adr) const noexcept
+{
+	return entries[adr] ? entries[adr]->runs : 0;
+}
+
+void blockEngine::translateAt(const bytePair adr)
+{
+	lookup(adr);
+}
+
+void blockEngine::setExit(const bytePair adr, const bool exit /* = true */)
+{
+	exits[adr] = exit;
+
+	if(block *const b = entries[adr])
+		b->exit = exit;
+
+	// A block running through `adr` is translated again, ending before it
+	else if(exit and code[adr])
+		invalidateAt(adr);
+}
+
+void blockEngine::revalidate(void)
+{
+	for(std::uint32_t page = 0; page < 0x100; ++page)
+	{
+		revalidate(page);
+	}
+}
+
+void blockEngine::revalidate(const byte page)
+{
+	const std::uint32_t begin = page << 8;
+
+	if(pages[page].empty() or std::memcmp(machine.ram + begin, snapshot.data() + begin, 0x100) == 0)
+		return;
+
+	for(std::uint32_t adr = begin; adr < begin + 0x100; ++adr)
+	{
+		if(machine.ram[adr] != snapshot[adr])
+		{
+			snapshot[adr] = machine.ram[adr];
+			wrote(adr);
+		}
+	}
+}
+
+void blockEngine::watch(const bytePair begin, const std::uint32_t length, const bool w /* = true */)
+{
+	for(std::uint32_t i = 0; i < length and i < 0x10000; i += 0x100)
+	{
+		watched[(bytePair)(begin + i) >> 8] = w;
+	}
+
+	// The last page, if `length` ends partway into it
+	if(length)
+		watched[(bytePair)(begin + std::min<std::uint32_t>(length, 0x10000) - 1) >> 8] = w;
+}
+
+void blockEngine::flush(void)
+{
+	blocks.clear();
+	opChunks.clear();
+	opChunkUsed = opChunkSize;
+	std::fill(entries.begin(), entries.end(), nullptr);
+	std::fill(code.begin(), code.end(), 0);
+
+	for(auto& page : pages)
+	{
+		page.clear();
+	}
+
+	returnDepth = 0;
+	++generation;
+	++stats.flushes;
+}
+
+bool blockEngine::saveCache(const std::string& filename, const std::uint64_t key) const
+{
+	std::vector<cachedBlock> saved;
+	std::vector<cachedOp> ops;
+
+	for(const block& b : blocks)
+	{
+		if(not b.valid)
+			continue;
+
+		// The opcodes as they were when the block was translated
+		const std::size_t first = ops.size();
+		bytePair adr = b.begin;
+
+		for(std::uint32_t i = 0; i < b.count; ++i)
+		{
+			const byte opcode = snapshot[adr];
+			byte variant = 0;
+
+			while(variant < flagVariants and handlers[variant][opcode] != b.ops[i].run)
+				++variant;
+
+			ops.push_back({opcode, variant});
+			adr = b.ops[i].next;
+		}
+
+		saved.push_back({b.begin, (byte)b.count, 0});
+
+		// A block that does not decode as it was translated is left out
+		if(std::any_of(ops.begin() + first, ops.end(), [](const cachedOp& op){ return op.variant == flagVariants; }))
+		{
+			ops.resize(first);
+			saved.pop_back();
+		}
+	}
+
+	cacheHeader header = {};
+	std::memcpy(header.magic, cacheMagic, sizeof header.magic);
+	header.formatVersion = cacheFormatVersion;
+	header.emulatorVersion = INTEL8080_VERSION__;
+	header.key = key;
+	header.blockCount = saved.size();
+	header.opCount = ops.size();
+
+	const std::string temporary = filename + ".tmp" + std::to_string(getpid());
+	std::FILE *const file = std::fopen(temporary.c_str(), "wb");
+
+	if(not file)
+		return false;
+
+	const bool written
+		= std::fwrite(&header, sizeof header, 1, file) == 1
+		and std::fwrite(saved.data(), sizeof(cachedBlock), saved.size(), file) == saved.size()
+		and std::fwrite(ops.data(), sizeof(cachedOp), ops.size(), file) == ops.size();
+
+	if(std::fclose(file) != 0 or not written or std::rename(temporary.c_str(), filename.c_str()) != 0)
+	{
+		std::remove(temporary.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::size_t blockEngine::loadCache(const std::string& filename, const std::uint64_t key)
+{
+	const int fd = open(filename.c_str(), O_RDONLY);
+	if(fd < 0)
+		return 0;
+
+	struct stat st;
+	void* p = MAP_FAILED;
+
+	if(fstat(fd, &st) == 0 and (std::size_t)st.st_size >= sizeof(cacheHeader))
+		p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+
+	if(p == MAP_FAILED)
+		return 0;
+
+	const byte *const mapping = (const byte*)p;
+	const std::size_t mappingSize = st.st_size;
+	const cacheHeader& header = *(const cacheHeader*)mapping;
+
+	// The counts are 32 bits, so the size cannot wrap around
+	const std::uint64_t expectedSize = sizeof header
+		+ (std::uint64_t)header.blockCount * sizeof(cachedBlock) + (std::uint64_t)header.opCount * sizeof(cachedOp);
+
+	if(std::memcmp(header.magic, cacheMagic, sizeof header.magic) != 0
+		or header.formatVersion != cacheFormatVersion or header.emulatorVersion != INTEL8080_VERSION__
+		or header.key != key or expectedSize != mappingSize)
+	{
+		munmap(p, mappingSize);
+		return 0;
+	}
+
+	const cachedBlock *const saved = (const cachedBlock*)(mapping + sizeof header);
+	const cachedOp* ops = (const cachedOp*)(saved + header.blockCount);
+	const cachedOp *const opsEnd = ops + header.opCount;
+
+	// Whether the block would be translated from the same instructions,
+	// ending in the same place
+	const auto matches = [&](const cachedBlock& c)
+	{
+		bytePair adr = c.begin;
+
+		for(std::uint32_t i = 0; i < c.count; ++i)
+		{
+			if(machine.ram[adr] != ops[i].opcode or ops[i].variant >= flagVariants)
+				return false;
+
+			adr += intel8080::opcodes[ops[i].opcode].length;
+
+			const bool ends = endsBlock(ops[i].opcode) or i + 1 == maxBlockInstructions or exits[adr];
+			if(ends != (i + 1 == c.count))
+				return false;
+		}
+
+		return true;
+	};
+
+	std::size_t loaded = 0;
+
+	for(std::uint32_t i = 0; i < header.blockCount; ++i)
+	{
+		const cachedBlock& c = saved[i];
+
+		if(c.count == 0 or c.count > opsEnd - ops or blocks.size() >= maxBlocks)
+			break;
+
+		if(not entries[c.begin] and matches(c))
+		{
+			byte variants[maxBlockInstructions];
+
+			for(std::uint32_t j = 0; j < c.count; ++j)
+				variants[j] = ops[j].variant;
+
+			translate(c.begin, variants);
+			++loaded;
+		}
+
+		ops += c.count;
+	}
+
+	munmap(p, mappingSize);
+	stats.cached += loaded;
+	return loaded;
+}
+
+const blockEngine::statistics& blockEngine::getStatistics(void) const noexcept
+{
+	return stats;
+}
+
+blockEngine::block& blockEngine::lookup(const bytePair adr)
+{
+	if(block *const b = entries[adr])
+		return *b;
+
+	if(blocks.size() >= maxBlocks)
+		flush();
+
+	return translate(adr);
+}
+
+blockEngine::block& blockEngine::translate(const bytePair adr, const byte* variants /* = nullptr */)
+{
+	block& b = blocks.emplace_back();
+	b.begin = adr;
+	b.size = 0;
+	b.count = 0;
+
+	if(opChunkUsed + maxBlockInstructions > opChunkSize)
+	{
+		opChunks.push_back(std::make_unique<microOp[]>(opChunkSize));
+		opChunkUsed = 0;
+	}
+
+	microOp *const ops = opChunks.back().get() + opChunkUsed;
+	instruction instructions[maxBlockInstructions];
+	byte opcodes[maxBlockInstructions];
+	byte opcode;
+
+	do
+	{
+		const instruction& instr = instructions[b.count] = decodeInstruction(machine.ram, adr + b.size);
+		opcode = instr.opcode;
+		opcodes[b.count] = opcode;
+		b.size += instr.length;
+
+		ops[b.count++] = {nullptr, instr.operand, (bytePair)(adr + b.size), intel8080::opcodes[opcode].cycles};
+	}
+	while(not endsBlock(opcode) and b.count < maxBlockInstructions and not exits[(bytePair)(adr + b.size)]);
+
+	// Each instruction only computes the flags read before they are written
+	// again. Every flag may be read after the block, and after a store that
+	// may rewrite the rest of it, since the block is then left there.
+	byte chosen[maxBlockInstructions];
+
+	if(not variants)
+	{
+		byte used[maxBlockInstructions];
+
+		for(std::uint32_t first = 0, i = 0; i < b.count; ++i)
+		{
+			if(storesWithinBlock(opcodes[i]) or i == b.count - 1)
+			{
+				findUsedFlags(instructions + first, i + 1 - first, used + first);
+				first = i + 1;
+			}
+		}
+
+		for(std::uint32_t i = 0; i < b.count; ++i)
+		{
+			std::size_t variant = flagVariants - 1;
+
+			while(used[i] & ~variantFlags[variant])
+				--variant;
+
+			chosen[i] = variant;
+		}
+
+		variants = chosen;
+	}
+
+	for(std::uint32_t i = 0; i < b.count; ++i)
+	{
+		ops[i].run = handlers[variants[i]][opcodes[i]];
+	}
+
+	b.ops = ops;
+	opChunkUsed += b.count;
+
+	// Where the block can continue to
+	const microOp& last = ops[b.count - 1];
+	const opcodeInfo& info = intel8080::opcodes[opcode];
+
+	switch(info.flow)
+	{
+		case flowType::jump:
+			b.links[0].target = last.operand;
+			b.links[0].used = true;
+			break;
+
+		// The next instruction is where calls return to
+		case flowType::call:
+		case flowType::conditionalCall:
+			b.links[0].target = last.operand;
+			b.links[0].used = true;
+			b.links[1].target = last.next;
+			b.links[1].used = true;
+			b.calls = true;
+			break;
+
+		case flowType::restart:
+			b.links[0].target = opcode & 0x38;
+			b.links[0].used = true;
+			b.links[1].target = last.next;
+			b.links[1].used = true;
+			b.calls = true;
+			break;
+
+		case flowType::conditionalJump:
+			b.links[0].target = last.operand;
+			b.links[0].used = true;
+			b.links[1].target = last.next;
+			b.links[1].used = true;
+			break;
+
+		case flowType::conditionalReturn:
+			b.links[0].cache = true;
+			b.links[0].used = true;
+			b.links[1].target = last.next;
+			b.links[1].used = true;
+			b.returns = true;
+			break;
+
+		case flowType::ret:
+			b.links[0].cache = true;
+			b.links[0].used = true;
+			b.returns = true;
+			break;
+
+		case flowType::indirectJump:
+			b.links[0].cache = true;
+			b.links[0].used = true;
+			break;
+
+		case flowType::next:
+		case flowType::halt:
+			b.links[1].target = last.next;
+			b.links[1].used = true;
+			break;
+	}
+
+	// Only register the block once it is complete, since a block that
+	// overlaps itself by wrapping around must still be found by `wrote`
+	for(std::uint32_t i = 0; i < b.size; ++i)
+	{
+		const bytePair a = adr + i;
+		code[a] = 1;
+		snapshot[a] = machine.ram[a];
+
+		auto& page = pages[a >> 8];
+		if(page.empty() or page.back() != &b) page.push_back(&b);
+	}
+
+	recognizeLoop(b, opcodes);
+
+	b.exit = exits[adr];
+	entries[adr] = &b;
+	++stats.translated;
+	return b;
+}
+
+std::uint32_t blockEngine::execute(block& b) noexcept
+{
+	current = &b;
+	stale = false;
+	++stats.blocksRun;
+
+	const microOp* op = b.ops;
+	const microOp *const end = op + b.count;
+
+	do
+	{
+		machine.cycles += op->cycles;
+		machine.PC = op->next;
+		op->run(*this, *op);
+	}
+	while(++op != end and not stale);
+
+	current = nullptr;
+	return op - b.ops;
+}
+
+blockEngine::block* blockEngine::follow(block& b, const bool translate)
+{
+	// Its links may point to blocks that are no longer valid
+	if(stale)
+		return nullptr;
+
+	const bytePair pc = machine.PC;
+
+	for(link& l : b.links)
+	{
+		if(l.to and l.target == pc and l.to->valid)
+		{
+			++stats.chained;
+			return l.to;
+		}
+	}
+
+	// `run` stops there
+	if(not translate and not entries[pc])
+		return nullptr;
+
+	const std::uint64_t before = generation;
+	block& next = lookup(pc);
+	++stats.lookups;
+
+	// A flush frees `b`
+	if(generation != before)
+		return &next;
+
+	for(link& l : b.links)
+	{
+		if(l.used and not l.cache and l.target == pc)
+		{
+			attach(l, next);
+			return &next;
+		}
+	}
+
+	for(link& l : b.links)
+	{
+		if(l.cache)
+		{
+			// Not recorded in `incoming`, since it changes too often; `valid`
+			// is checked instead
+			++stats.inlineCacheMisses;
+			l.target = pc;
+			l.to = &next;
+			break;
+		}
+	}
+
+	return &next;
+}
+
+blockEngine::block* blockEngine::predictReturn(const bool translate)
+{
+	const bytePair pc = machine.PC;
+	const bytePair sp = machine.SP - 2;
+
+	// Calls whose frames are below the one returned from were left some
+	// other way, e.g. by resetting the stack pointer
+	while(returnDepth and returnStack[returnTop].sp < sp)
+	{
+		returnTop = (returnTop + returnStackSize - 1) % returnStackSize;
+		--returnDepth;
+	}
+
+	// Otherwise this returns from a frame that was not made by a call seen
+	// here, such as an interrupt's, and the calls above it are kept
+	if(not returnDepth or returnStack[returnTop].sp != sp)
+	{
+		++stats.returnsMispredicted;
+		return nullptr;
+	}
+
+	block& caller = *returnStack[returnTop].caller;
+	link& l = caller.links[1];
+
+	returnTop = (returnTop + returnStackSize - 1) % returnStackSize;
+	--returnDepth;
+
+	if(not caller.valid or l.target != pc)
+	{
+		++stats.returnsMispredicted;
+		return nullptr;
+	}
+
+	if(not l.to)
+	{
+		if(not translate and not entries[pc])
+			return nullptr;
+
+		// A flush frees `caller` and empties the stack
+		const std::uint64_t before = generation;
+		block& next = lookup(pc);
+		++stats.lookups;
+
+		if(generation != before)
+			return &next;
+
+		attach(l, next);
+	}
+
+	++stats.returnsPredicted;
+	return l.to;
+}
+
+void blockEngine::recognizeLoop(block& b, const byte* opcodes) noexcept
+{
+	// A loop jumps back to its own start with `jnz`
+	std::uint32_t body = b.count - 1;
+
+	if(b.count < 3 or opcodes[body] != 0xc2 or b.ops[body].operand != b.begin)
+		return;
+
+	loopInfo l;
+
+	// The count, tested just before the `jnz` by `dcr r` or by
+	// `mov a, r; ora r` on the two halves of a pair
+	const byte last = opcodes[body - 1];
+
+	if((last & 0xc7) == 0x05 and (last >> 3 & 7) != 6 and (last >> 3 & 7) != 7)
+	{
+		l.counter = last >> 3 & 7;
+		body -= 1;
+	}
+	else if(body >= 3 and (last & 0xf8) == 0xb0 and (opcodes[body - 2] & 0xf8) == 0x78
+		and (last & 7) < 6 and ((last ^ opcodes[body - 2]) & 7) == 1)
+	{
+		l.wide = true;
+		l.counter = (last & 7) >> 1;
+		body -= 2;
+	}
+	else
+	{
+		return;
+	}
+
+	int steps[3] = {};
+	bool loaded = false;
+	bool stored = false;
+
+	for(std::uint32_t i = 0; i < body; ++i)
+	{
+		const byte opcode = opcodes[i];
+		const int rp = opcode >> 4 & 3;
+
+		// LDAX B, LDAX D, MOV A, M
+		if(opcode == 0x0a or opcode == 0x1a or opcode == 0x7e)
+		{
+			if(loaded or stored) return;
+
+			loaded = true;
+			l.source = opcode == 0x7e ? 2 : rp;
+			l.sourceOffset = steps[l.source];
+		}
+		// STAX B, STAX D, MOV M, r, MVI M
+		else if(opcode == 0x02 or opcode == 0x12 or (opcode >= 0x70 and opcode < 0x78 and opcode != 0x76) or opcode == 0x36)
+		{
+			if(stored) return;
+
+			stored = true;
+			l.dest = opcode < 0x70 and opcode != 0x36 ? rp : 2;
+			l.destOffset = steps[l.dest];
+			l.constant = opcode == 0x36;
+			l.value = l.constant ? b.ops[i].operand : opcode < 0x70 ? 7 : opcode & 7;
+		}
+		// INX, DCX, other than on SP
+		else if((opcode & 0xc7) == 0x03 and rp != 3)
+		{
+			steps[rp] += opcode & 0x08 ? -1 : 1;
+		}
+		else
+		{
+			return;
+		}
+	}
+
+	if(not stored or (steps[l.dest] != 1 and steps[l.dest] != -1))
+		return;
+
+	l.destStep = steps[l.dest];
+
+	if(loaded)
+	{
+		// The byte loaded into A is the one stored
+		if(l.value != 7 or l.source == l.dest or (steps[l.source] != 1 and steps[l.source] != -1))
+			return;
+
+		l.type = loopInfo::kind::copy;
+		l.sourceStep = steps[l.source];
+	}
+	else
+	{
+		l.type = loopInfo::kind::fill;
+	}
+
+	// Every other pair is left alone, except a counter
+	for(int rp = 0; rp < 3; ++rp)
+	{
+		const bool pointer = rp == l.dest or (loaded and rp == l.source);
+
+		if(l.wide and rp == l.counter)
+		{
+			if(pointer or steps[rp] != -1) return;
+		}
+		else if(not pointer and steps[rp] != 0)
+		{
+			return;
+		}
+	}
+
+	// An 8-bit counter must be in a pair that is left alone, and the value
+	// filled with must not change between iterations
+	if(not l.wide and steps[l.counter >> 1] != 0)
+		return;
+
+	if(l.type == loopInfo::kind::fill and not l.constant)
+	{
+		if(l.value == 7 ? l.wide : (steps[l.value >> 1] != 0 or (l.wide and l.value >> 1 == l.counter) or (not l.wide and l.value == l.counter)))
+			return;
+	}
+
+	for(std::uint32_t i = 0; i < b.count; ++i)
+	{
+		l.cycles += b.ops[i].cycles;
+	}
+
+	b.loop = l;
+}
+
+bool blockEngine::canAccess(const std::int32_t first, const int step, const std::uint32_t count, const bool written) const noexcept
+{
+	const std::int32_t lowest = step > 0 ? first : first - (std::int32_t)count + 1;
+
+	if(lowest < 0 or lowest + count > 0x10000)
+		return false;
+
+	for(std::uint32_t page = lowest >> 8; page <= (lowest + count - 1) >> 8; ++page)
+	{
+		if(watched[page]) return false;
+	}
+
+	return not written or not std::memchr(code.data() + lowest, 1, count);
+}
+
+std::uint64_t blockEngine::accelerate(const block& b) noexcept
+{
+	const loopInfo& l = b.loop;
+	cpu& m = machine;
+
+	// The number of iterations left, counting this one
+	const std::uint32_t iterations = l.wide
+		? (m.pairs[l.counter] ? m.pairs[l.counter] : 0x10000)
+		: (m.regs[cpu::regSlot(l.counter)] ? m.regs[cpu::regSlot(l.counter)] : 0x100);
+
+	// Too few to be worth it
+	if(iterations < 4)
+		return 0;
+
+	const std::uint32_t count = iterations - 1;
+	const std::int32_t dest = m.pairs[l.dest] + l.destOffset;
+	const std::int32_t source = m.pairs[l.source] + l.sourceOffset;
+	const bool copy = l.type == loopInfo::kind::copy;
+
+	if(not canAccess(dest, l.destStep, count, true) or (copy and not canAccess(source, l.sourceStep, count, false)))
+	{
+		++stats.loopFallbacks;
+		return 0;
+	}
+
+	byte *const ram = m.ram;
+	const std::int32_t destLowest = l.destStep > 0 ? dest : dest - (std::int32_t)count + 1;
+
+	if(not copy)
+	{
+		std::memset(ram + destLowest, l.constant ? l.value : m.regs[cpu::regSlot(l.value)], count);
+	}
+	else
+	{
+		// Copying a byte at a time in the same direction as `memmove` gives
+		// the same result, unless the destination starts inside the source
+		// ahead of it, which repeats the bytes in between
+		const std::int32_t ahead = (dest - source) * l.destStep;
+
+		if(l.sourceStep == l.destStep and (ahead <= 0 or ahead >= (std::int32_t)count))
+		{
+			const std::int32_t sourceLowest = l.sourceStep > 0 ? source : source - (std::int32_t)count + 1;
+			std::memmove(ram + destLowest, ram + sourceLowest, count);
+		}
+		else
+		{
+			for(std::int32_t i = 0; i < (std::int32_t)count; ++i)
+			{
+				ram[dest + l.destStep * i] = ram[source + l.sourceStep * i];
+			}
+		}
+
+		m.pairs[l.source] += l.sourceStep * (std::int32_t)count;
+	}
+
+	m.pairs[l.dest] += l.destStep * (std::int32_t)count;
+
+	if(l.wide) m.pairs[l.counter] -= count;
+	else m.regs[cpu::regSlot(l.counter)] -= count;
+
+	m.cycles += (std::uint64_t)l.cycles * count;
+	++stats.loopsAccelerated;
+	return (std::uint64_t)b.count * count;
+}
+
+void blockEngine::attach(link& l, block& to)
+{
+	l.to = &to;
+	to.incoming.push_back(&l);
+}
+
+void blockEngine::detach(link& l) noexcept
+{
+	if(not l.to)
+		return;
+
+	auto& incoming = l.to->incoming;
+	const auto it = std::find(incoming.begin(), incoming.end(), &l);
+
+	if(it != incoming.end())
+	{
+		*it = incoming.back();
+		incoming.pop_back();
+	}
+
+	l.to = nullptr;
+}
+
+void blockEngine::invalidateAt(const bytePair adr)
+{
+	// Copied, since discarding a block removes it from the page
+	const std::vector<block*> candidates = pages[adr >> 8];
+
+	for(block *const b : candidates)
+	{
+		if(b->valid and contains(b->begin, b->size, adr))
+			discard(*b);
+	}
+}
+
+void blockEngine::discard(block& b)
+{
+	b.valid = false;
+	++stats.invalidated;
+
+	if(entries[b.begin] == &b) entries[b.begin] = nullptr;
+	if(current == &b) stale = true;
+
+	for(link *const l : b.incoming)
+	{
+		if(l->to == &b) l->to = nullptr;
+	}
+	b.incoming.clear();
+
+	for(link& l : b.links)
+	{
+		detach(l);
+	}
+
+	for(std::uint32_t i = 0; i < b.size; ++i)
+	{
+		auto& page = pages[(bytePair)(b.begin + i) >> 8];
+		page.erase(std::remove(page.begin(), page.end(), &b), page.end());
+	}
+
+	// Bytes that are still part of another block stay marked
+	for(std::uint32_t i = 0; i < b.size; ++i)
+	{
+		const bytePair a = b.begin + i;
+		code[a] = std::any_of(pages[a >> 8].begin(), pages[a >> 8].end(),
+			[a](const block* other){ return contains(other->begin, other->size, a); });
+	}
+}
+
+void blockEngine::store(const bytePair adr, const byte value) noexcept
+{
+	machine.ram[adr] = value;
+	wrote(adr);
+}
+
+void blockEngine::store16(const bytePair adr, const bytePair value) noexcept
+{
+	store(adr, value);
+	store(adr + 1, value >> 8);
+}
+
+bytePair blockEngine::load16(const bytePair adr) const noexcept
+{
+	return machine.ram[adr] | machine.ram[(bytePair)(adr + 1)] << 8;
+}
+
+void blockEngine::push(const bytePair value) noexcept
+{
+	machine.SP -= 2;
+	store16(machine.SP, value);
+}
+
+void blockEngine::pop(bytePair& r16) noexcept
+{
+	r16 = load16(machine.SP);
+	machine.SP += 2;
+
+	// As `cpu::pop`, which resets the unused flags whatever is popped
+	machine.regs[6] = (machine.regs[6] & 0xd7) | 0x02;
+}
@@ -0,0 +1,584 @@
+/**
+ * @file blocks.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs an `intel8080::cpu` a basic block at a time from predecoded
+   blocks that are linked directly to one another.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief Runs a `cpu` from blocks of predecoded instructions, with the
+	   same results as calling `cpu::step` repeatedly.
+	 * A block is translated the first time control reaches its address and
+	   ends at the first control transfer, `hlt`, `ei`, `di`, `in` or `out`
+	   (after which an interrupt may be pending). Each block remembers the
+	   blocks it was last seen to continue to: a fixed target for `jmp`,
+	   `call`, `rst` and conditional jumps and calls, plus the next
+	   instruction, and an inline cache of the last target for `ret` and
+	   `pchl`. Between linked blocks there is no lookup at all.
+	 * Calls are also remembered on a shadow stack with the stack pointer
+	   after them, so that a return to the same address from the same stack
+	   frame continues directly in the block after the call. Returns that
+	   do not match (from interrupts, or with a rewritten stack) fall back to
+	   the inline cache; frames below the stack pointer are forgotten.
+	 * Stores made by translated code to bytes of translated blocks discard
+	   those blocks and undo every link to them, so self-modifying code is
+	   retranslated. Memory written any other way (by port handlers, DMA or
+	   the host) must be reported with `invalidate`.
+	 * A block that is a whole copy or fill loop (a pointer or two stepped by
+	   `inx` or `dcx`, one byte stored per iteration, a count kept in a
+	   register with `dcr` or in a register pair with `dcx`, `mov a`, `ora`,
+	   and a `jnz` back to the start) runs all but its last iteration at
+	   once with `memmove` or `memset`; the last is run normally, so that
+	   registers, flags and cycles are exactly as if every iteration had
+	   run. Loops that would write translated code, read or write pages
+	   given to `watch`, or wrap around the end of memory are run normally.
+	 * The blocks can be saved to a cache file with `saveCache`, so that a
+	   later process running the same image starts with them translated.
+	 */
+	class blockEngine
+	{
+	public:
+		/**
+		 * @brief The maximum number of instructions in a block.
+		 */
+		static constexpr std::uint32_t maxBlockInstructions = 64;
+
+		/**
+		 * @brief The number of blocks at which all blocks are discarded, to
+		   bound memory use by code that keeps rewriting itself.
+		 */
+		static constexpr std::size_t maxBlocks = 1 << 14;
+
+		/**
+		 * @brief The number of calls remembered to predict returns; deeper
+		   calls forget the oldest.
+		 */
+		static constexpr std::uint32_t returnStackSize = 64;
+
+		/**
+		 * @brief Counts of what the engine has done, for tuning.
+		 */
+		struct statistics
+		{
+			std::uint64_t blocksRun = 0;		// Blocks entered.
+			std::uint64_t chained = 0;			// Blocks entered through a link.
+			std::uint64_t lookups = 0;			// Blocks found by address instead.
+			std::uint64_t inlineCacheMisses = 0;	// `ret` and `pchl` targets that were not the cached one.
+			std::uint64_t returnsPredicted = 0;	// Returns to the block after the matching call.
+			std::uint64_t returnsMispredicted = 0;	// Returns that did not match a remembered call.
+			std::uint64_t translated = 0;		// Blocks translated.
+			std::uint64_t cached = 0;			// Blocks translated from a cache file, also counted in `translated`.
+			std::uint64_t invalidated = 0;		// Blocks discarded because their code was written.
+			std::uint64_t flushes = 0;			// Times every block was discarded.
+			std::uint64_t loopsAccelerated = 0;	// Copy and fill loops run at once.
+			std::uint64_t loopFallbacks = 0;	// Copy and fill loops that had to be run normally.
+		};
+
+		/**
+		 * @brief When `run` stops early, for a caller that runs some code
+		   another way (see `tieredEngine`).
+		 */
+		struct limits
+		{
+			/**
+			 * @brief Whether blocks reached for the first time are
+			   translated; if not, `run` returns at them.
+			 */
+			bool translate = true;
+
+			/**
+			 * @brief If not 0, `run` returns before entering a block for the
+			   `hotRuns`th time.
+			 */
+			std::uint64_t hotRuns = 0;
+
+			/**
+			 * @brief Whether copy and fill loops are run at once. Such a loop
+			   can run far past `maxInstructions`, and no interrupt can be
+			   requested from the host until it is done.
+			 */
+			bool accelerate = true;
+		};
+
+		/**
+		 * @brief Construct an engine for `machine`, which must have RAM.
+		 * @param machine `cpu&` The CPU to run. Its registers can be changed
+		   freely between calls to `run`.
+		 */
+		explicit blockEngine(cpu& machine);
+
+		/**
+		 * @brief Runs whole blocks until at least `maxInstructions`
+		   instructions have run or the CPU halts. Pending interrupts are
+		   serviced between blocks, as `cpu::step` would.
+		 * @note An interrupt vector other than `rst`, `push` or `call` that
+		   writes to translated code is not noticed.
+		 *
+		 * @param maxInstructions `std::uint64_t` The number of instructions to run.
+		 * @return `std::uint64_t` The number of instructions run, which is 0
+		   if the CPU is halted with no interrupt to service.
+		 */
+		std::uint64_t run(const std::uint64_t maxInstructions);
+
+		/**
+		 * @brief Runs blocks as `run(maxInstructions)` does, but also returns
+		   with the program counter at the first block that `stop` or
+		   `setExit` rules out. The block at the program counter when `run`
+		   is called is always run.
+		 *
+		 * @param maxInstructions `std::uint64_t` The number of instructions to run.
+		 * @param stop `const limits&` Where else to stop.
+		 * @return `std::uint64_t` The number of instructions run.
+		 */
+		std::uint64_t run(const std::uint64_t maxInstructions, const limits& stop);
+
+		/**
+		 * @param opcode `const byte` An opcode.
+		 * @return `bool` Whether a block ends after the instruction `opcode`,
+		   unless it has already reached `maxBlockInstructions`.
+		 */
+		static bool endsBlock(const byte opcode) noexcept;
+
+		/**
+		 * @param adr `const bytePair` An address.
+		 * @return `bool` Whether a valid block starts at `adr`.
+		 */
+		bool translated(const bytePair adr) const noexcept;
+
+		/**
+		 * @param adr `const bytePair` An address.
+		 * @return `std::uint64_t` The number of times the block at `adr`
+		   has been entered since it was translated, or 0 if there is none.
+		 */
+		std::uint64_t getRuns(const bytePair adr) const noexcept;
+
+		/**
+		 * @brief Translates the block at `adr` if it has not been already.
+		 */
+		void translateAt(const bytePair adr);
+
+		/**
+		 * @brief Sets whether `run` returns instead of entering the block at
+		   `adr`, until it is changed again; this survives `flush`. Blocks
+		   end before an exit, so `run` stops there however control
+		   reaches it, e.g. at a breakpoint.
+		 */
+		void setExit(const bytePair adr, const bool exit = true);
+
+		/**
+		 * @brief Discards the blocks whose bytes have changed since they were
+		   translated, for when memory may have been written without
+		   `invalidate`. Only pages that hold blocks are compared.
+		 */
+		void revalidate(void);
+
+		/**
+		 * @brief Discards the blocks with bytes in the 256-byte page `page`
+		   that have changed since they were translated.
+		 */
+		void revalidate(const byte page);
+
+		/**
+		 * @brief Discards the blocks containing any of `length` bytes from
+		   `begin`, which were changed other than by translated code.
+		 *
+		 * @param begin `const bytePair` The first address written.
+		 * @param length `const std::uint32_t` The number of bytes written.
+		 */
+		void invalidate(const bytePair begin, const std::uint32_t length = 1);
+
+		/**
+		 * @brief Sets whether the 256-byte pages holding `length` bytes from
+		   `begin` are watched, e.g. because they are mapped to a device or
+		   have a watchpoint. Copy and fill loops that read or write watched
+		   pages are run an instruction at a time.
+		 */
+		void watch(const bytePair begin, const std::uint32_t length, const bool watched = true);
+
+		/**
+		 * @brief Discards every block, e.g. after loading a new program.
+		 */
+		void flush(void);
+
+		/**
+		 * @brief Writes every valid block to a cache file for `loadCache`.
+		   The file is written under another name and then renamed, so that
+		   no reader sees it half-written.
+		 *
+		 * @param filename `const std::string&` The file to write.
+		 * @param key `const std::uint64_t` What the blocks were translated
+		   from, e.g. `hashBytes` of the image.
+		 * @return `bool` Whether the file was written.
+		 */
+		bool saveCache(const std::string& filename, const std::uint64_t key) const;
+
+		/**
+		 * @brief Translates the blocks in a cache file written by
+		   `saveCache` with the same `key` and the same version of the
+		   emulator, which is mapped rather than read. Each block's
+		   instructions keep the handlers chosen when it was saved, so their
+		   flags are not analyzed again. Blocks whose opcodes are no longer
+		   in memory, or that would now end elsewhere, are left to be
+		   translated when they are reached.
+		 *
+		 * @param filename `const std::string&` The file to read.
+		 * @param key `const std::uint64_t` What the blocks must have been
+		   translated from.
+		 * @return `std::size_t` The number of blocks translated, which is 0
+		   if the file is missing or damaged, or was written for another key
+		   or version.
+		 */
+		std::size_t loadCache(const std::string& filename, const std::uint64_t key);
+
+		/**
+		 * @return `const statistics&` What the engine has done so far.
+		 */
+		const statistics& getStatistics(void) const noexcept;
+
+	private:
+		struct microOp;
+		struct block;
+
+		/**
+		 * @brief Runs one predecoded instruction.
+		 */
+		using handler = void (*)(blockEngine& engine, const microOp& op) noexcept;
+
+		/**
+		 * @brief One instruction, with its operand already fetched.
+		 */
+		struct microOp
+		{
+			handler run;
+			bytePair operand;
+
+			/**
+			 * @brief The address of the next instruction, which the program
+			   counter is set to before `run` is called.
+			 */
+			bytePair next;
+
+			byte cycles;
+		};
+
+		/**
+		 * @brief A possible successor of a block.
+		 */
+		struct link
+		{
+			/**
+			 * @brief The address this link continues to.
+			 */
+			bytePair target = 0;
+
+			/**
+			 * @brief The block at `target`, or `nullptr` if it has not been
+			   linked yet or was discarded.
+			 */
+			block* to = nullptr;
+
+			/**
+			 * @brief Whether `target` changes to follow `ret` or `pchl`.
+			 */
+			bool cache = false;
+
+			/**
+			 * @brief Whether the link is used at all.
+			 */
+			bool used = false;
+		};
+
+		/**
+		 * @brief A block that `accelerate` can run, as decoded by `recognizeLoop`.
+		 * Registers and register pairs are numbered as in opcodes. The byte
+		   stored in iteration `i` (from 0) is at `pairs[dest]` as the
+		   iteration starts plus `destStep * i + destOffset`, and likewise for
+		   the byte copied.
+		 */
+		struct loopInfo
+		{
+			enum class kind : byte
+			{
+				none,
+				copy,	// From `source`
+				fill	// With register `value`, or `value` itself if `constant`
+			};
+
+			kind type = kind::none;
+			bool constant = false;
+
+			/**
+			 * @brief Whether `counter` is a register pair rather than a register.
+			 */
+			bool wide = false;
+
+			byte counter = 0;
+			byte value = 0;
+			byte source = 0;
+			byte dest = 0;
+			std::int8_t sourceStep = 0;
+			std::int8_t sourceOffset = 0;
+			std::int8_t destStep = 0;
+			std::int8_t destOffset = 0;
+
+			/**
+			 * @brief The cycles taken by one iteration.
+			 */
+			std::uint32_t cycles = 0;
+		};
+
+		struct block
+		{
+			bytePair begin;
+			std::uint32_t size;
+
+			/**
+			 * @brief The instructions, in `opChunks`.
+			 */
+			const microOp* ops;
+			std::uint32_t count;
+
+			/**
+			 * @brief The taken target (or inline cache) and the next instruction.
+			 */
+			link links[2];
+
+			/**
+			 * @brief The fixed links of other blocks that point here, undone when
+			   this block is discarded.
+			 */
+			std::vector<link*> incoming;
+
+			/**
+			 * @brief The number of times the block has been entered.
+			 */
+			std::uint64_t runs = 0;
+
+			bool valid = true;
+
+			/**
+			 * @brief Whether `run` returns instead of entering the block.
+			 */
+			bool exit = false;
+
+			/**
+			 * @brief Whether the block ends in a call or `rst`, whose return
+			   address is the target of `links[1]`, or in a return.
+			 */
+			bool calls = false;
+			bool returns = false;
+
+			loopInfo loop;
+		};
+
+		cpu& machine;
+		statistics stats;
+
+		/**
+		 * @brief All blocks, including discarded ones, which are only freed by
+		   `flush` so that links and running blocks never dangle.
+		 */
+		std::deque<block> blocks;
+
+		/**
+		 * @brief The instructions of all blocks, allocated in order, so that
+		   blocks translated together (usually run together too) are close
+		   in memory. Each block's instructions are in one chunk.
+		 */
+		static constexpr std::uint32_t opChunkSize = 4096;
+		std::vector<std::unique_ptr<microOp[]>> opChunks;
+		std::uint32_t opChunkUsed = opChunkSize;
+
+		/**
+		 * @brief The valid block starting at each address, if any.
+		 */
+		std::vector<block*> entries;
+
+		/**
+		 * @brief Whether each byte is part of a valid block.
+		 */
+		std::vector<byte> code;
+
+		/**
+		 * @brief The valid blocks with bytes in each 256-byte page.
+		 */
+		std::vector<std::vector<block*>> pages;
+
+		/**
+		 * @brief Memory as of the last translation or `revalidate`, in pages
+		   that hold blocks.
+		 */
+		std::vector<byte> snapshot;
+
+		/**
+		 * @brief The addresses set by `setExit`.
+		 */
+		std::vector<byte> exits;
+
+		/**
+		 * @brief The pages set by `watch`.
+		 */
+		std::vector<byte> watched;
+
+		/**
+		 * @brief The block being run, and whether it has been discarded
+		   since it started.
+		 */
+		block* current = nullptr;
+		bool stale = false;
+
+		/**
+		 * @brief Counts flushes, so that links are not made from blocks
+		   freed by a flush.
+		 */
+		std::uint64_t generation = 0;
+
+		/**
+		 * @brief A call that has not returned yet.
+		 */
+		struct returnEntry
+		{
+			/**
+			 * @brief The stack pointer after the call, i.e. where the return
+			   address is.
+			 */
+			bytePair sp;
+
+			/**
+			 * @brief The block that made the call; its `links[1]` leads to
+			   the block after it.
+			 */
+			block* caller;
+		};
+
+		/**
+		 * @brief A ring of the most recent calls, `returnDepth` deep.
+		 */
+		std::array<returnEntry, returnStackSize> returnStack;
+		std::uint32_t returnTop = 0;
+		std::uint32_t returnDepth = 0;
+
+		/**
+		 * @brief The number of sets of handlers, which differ by the flags
+		   that ALU instructions, `inr` and `dcr` compute.
+		 */
+		static constexpr std::size_t flagVariants = 3;
+
+		/**
+		 * @brief The flags computed by each set of handlers, from every flag
+		   to none. Each instruction is given the set with the fewest that
+		   still has all of those `findUsedFlags` finds are used.
+		 */
+		static const std::array<byte, flagVariants> variantFlags;
+
+		/**
+		 * @brief The handler for each opcode, in each set.
+		 */
+		static const std::array<std::array<handler, 256>, flagVariants> handlers;
+
+		template<byte used, std::size_t... opcode>
+		static constexpr std::array<handler, 256> makeHandlers(std::index_sequence<opcode...>) noexcept;
+
+		template<byte opcode, byte used>
+		static void execute(blockEngine& engine, const microOp& op) noexcept;
+
+		/**
+		 * @brief Finds or translates the block at `adr`.
+		 */
+		block& lookup(const bytePair adr);
+
+		/**
+		 * @param variants `const byte*` The set of handlers for each
+		   instruction, from a cache file, or `nullptr` to choose them from
+		   the flags each one must compute.
+		 */
+		block& translate(const bytePair adr, const byte* variants = nullptr);
+
+		/**
+		 * @return `std::uint32_t` The number of instructions run, which is
+		   less than the size of the block if it discarded itself.
+		 */
+		std::uint32_t execute(block& b) noexcept;
+
+		/**
+		 * @brief Finds the block to run after `b`, through a link if possible.
+		 * @return `block*` The block, or `nullptr` if `b` was discarded or
+		   the block is not translated and `translate` is `false`.
+		 */
+		block* follow(block& b, const bool translate);
+
+		/**
+		 * @brief Finds the block after the call that the return just made
+		   by `run` matches.
+		 * @return `block*` The block, or `nullptr` if the return was not
+		   predicted or the block is not translated and `translate` is `false`.
+		 */
+		block* predictReturn(const bool translate);
+
+		/**
+		 * @brief Sets `b.loop` if `b` is a copy or fill loop.
+		 * @param opcodes `const byte*` The opcode of each instruction in `b`.
+		 */
+		static void recognizeLoop(block& b, const byte* opcodes) noexcept;
+
+		/**
+		 * @brief Runs all but the last iteration of the copy or fill loop `b`
+		   at once, if it can be, leaving the last for `execute`.
+		 * @return `std::uint64_t` The number of instructions run, which is 0
+		   if the loop must be run normally.
+		 */
+		std::uint64_t accelerate(const block& b) noexcept;
+
+		/**
+		 * @brief Whether `count` bytes from `first`, stepping by `step`, lie
+		   within memory and outside watched pages and, if they are
+		   `written`, translated code.
+		 */
+		bool canAccess(const std::int32_t first, const int step, const std::uint32_t count, const bool written) const noexcept;
+
+		void attach(link& l, block& to);
+		void detach(link& l) noexcept;
+
+		/**
+		 * @brief Discards the blocks containing `adr`.
+		 */
+		void invalidateAt(const bytePair adr);
+
+		void discard(block& b);
+
+		void store(const bytePair adr, const byte value) noexcept;
+		void store16(const bytePair adr, const bytePair value) noexcept;
+		bytePair load16(const bytePair adr) const noexcept;
+		void push(const bytePair value) noexcept;
+		void pop(bytePair& r16) noexcept;
+
+		/**
+		 * @brief Notes that `adr` was written by translated code.
+		 */
+		void wrote(const bytePair adr) noexcept
+		{
+			if(code[adr]) invalidateAt(adr);
+		}
+	};
+}
@@ -0,0 +1,278 @@
+/**
+ * @file bundle.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A file format packing many memory images into one memory-mappable
+   file, with an index for finding them by name or hash.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `bundle.hpp`.
+
+#include "./bundle.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief The header at the start of a bundle file, followed immediately
+	   by `count` `bundleEntry`s.
+	 */
+	struct bundleHeader
+	{
+		char magic[8];
+		std::uint32_t formatVersion;
+		std::uint32_t count;
+		std::uint64_t reserved[2];
+	};
+
+	constexpr char bundleMagic[8] = {'I', '8', '0', '8', '0', 'B', 'D', 'L'};
+
+	constexpr std::size_t alignUp(const std::size_t n) noexcept
+	{
+		return (n + romBundle::pageSize - 1) / romBundle::pageSize * romBundle::pageSize;
+	}
+
+	int compareName(const bundleEntry& entry, const std::string& name) noexcept
+	{
+		return std::strncmp(entry.name, name.c_str(), sizeof entry.name);
+	}
+}
+
+bool intel8080::writeBundle(const std::string& filename, std::vector<bundleImage> images, std::string& error)
+{
+	for(auto& image : images)
+	{
+		if(image.origin + image.data.size() > 0x10000)
+		{
+			error = image.name + ": does not fit in memory";
+			return false;
+		}
+
+		image.name.resize(std::min(image.name.size(), sizeof(bundleEntry::name) - 1));
+	}
+
+	std::stable_sort(images.begin(), images.end(), [](const bundleImage& a, const bundleImage& b){ return a.name < b.name; });
+
+	const auto duplicate = std::adjacent_find(images.begin(), images.end(), [](const bundleImage& a, const bundleImage& b){ return a.name == b.name; });
+
+	if(duplicate != images.end())
+	{
+		error = "more than one image is named " + duplicate->name;
+		return false;
+	}
+
+	bundleHeader header = {};
+	std::memcpy(header.magic, bundleMagic, sizeof header.magic);
+	header.formatVersion = romBundle::formatVersion;
+	header.count = images.size();
+
+	std::vector<bundleEntry> entries(images.size());
+	std::size_t offset = alignUp(sizeof header + entries.size() * sizeof(bundleEntry));
+
+	for(std::size_t i = 0; i < images.size(); ++i)
+	{
+		bundleEntry& entry = entries[i];
+		entry = {};
+
+		std::copy(images[i].name.begin(), images[i].name.end(), entry.name);
+		entry.hash = hashBytes(images[i].data.data(), images[i].data.size());
+		entry.offset = offset;
+		entry.size = images[i].data.size();
+		entry.origin = images[i].origin;
+		entry.start = images[i].start;
+
+		offset = alignUp(offset + entry.size);
+	}
+
+	const std::string temporary = filename + ".tmp" + std::to_string(getpid());
+	std::FILE *const file = std::fopen(temporary.c_str(), "wb");
+
+	if(not file)
+	{
+		error = "cannot create " + temporary;
+		return false;
+	}
+
+	static const byte zeros[romBundle::pageSize] = {};
+
+	bool written
+		= std::fwrite(&header, sizeof header, 1, file) == 1
+		and std::fwrite(entries.data(), sizeof(bundleEntry), entries.size(), file) == entries.size();
+
+	std::size_t position = sizeof header + entries.size() * sizeof(bundleEntry);
+
+	for(std::size_t i = 0; written and i < images.size(); ++i)
+	{
+		// Pad up to the image's page, then write it
+		const std::size_t padding = entries[i].offset - position;
+		const std::size_t size = entries[i].size;
+
+		written
+			= std::fwrite(zeros, 1, padding, file) == padding
+			and std::fwrite(images[i].data.data(), 1, size, file) == size;
+
+		position = entries[i].offset + size;
+	}
+
+	// Pad the last image to a whole page so it can be mapped
+	const std::size_t padding = alignUp(position) - position;
+	written = written and std::fwrite(zeros, 1, padding, file) == padding;
+
+	if(std::fclose(file) != 0 or not written or std::rename(temporary.c_str(), filename.c_str()) != 0)
+	{
+		std::remove(temporary.c_str());
+		error = "cannot write " + filename;
+		return false;
+	}
+
+	return true;
+}
+
+romBundle::~romBundle()
+{
+	close();
+}
+
+void romBundle::close(void) noexcept
+{
+	if(mapping) munmap((void*)mapping, mappingSize);
+	if(fd >= 0) ::close(fd);
+
+	mapping = nullptr;
+	mappingSize = 0;
+	fd = -1;
+	entries = nullptr;
+	count = 0;
+}
+
+bool romBundle::open(const std::string& filename) noexcept
+{
+	close();
+
+	fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 or (std::size_t)st.st_size < sizeof(bundleHeader))
+	{
+		close();
+		return false;
+	}
+
+	void *const p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(p == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	mapping = (const byte*)p;
+	mappingSize = st.st_size;
+
+	const bundleHeader& header = *(const bundleHeader*)mapping;
+
+	if(std::memcmp(header.magic, bundleMagic, sizeof header.magic) != 0
+		or header.formatVersion != formatVersion
+		or sizeof header + header.count * sizeof(bundleEntry) > mappingSize)
+	{
+		close();
+		return false;
+	}
+
+	entries = (const bundleEntry*)(mapping + sizeof header);
+	count = header.count;
+
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		// Written so that no sum of values from the file can wrap around
+		if(entries[i].offset % pageSize != 0
+			or entries[i].offset > mappingSize or entries[i].size > mappingSize - entries[i].offset
+			or entries[i].size > 0x10000u - entries[i].origin)
+		{
+			close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::size_t romBundle::size(void) const noexcept
+{
+	return count;
+}
+
+const bundleEntry& romBundle::operator[](const std::size_t i) const noexcept
+{
+	return entries[i];
+}
+
+const bundleEntry* romBundle::find(const std::string& name) const noexcept
+{
+	const bundleEntry* const end = entries + count;
+	const bundleEntry* const found = std::lower_bound(entries, end, name,
+		[](const bundleEntry& entry, const std::string& n){ return compareName(entry, n) < 0; });
+
+	return found != end and compareName(*found, name) == 0 ? found : nullptr;
+}
+
+const bundleEntry* romBundle::findByHash(const std::uint64_t hash) const noexcept
+{
+	const bundleEntry* const end = entries + count;
+	const bundleEntry* const found = std::find_if(entries, end, [hash](const bundleEntry& entry){ return entry.hash == hash; });
+
+	return found != end ? found : nullptr;
+}
+
+const byte* romBundle::data(const bundleEntry& entry) const noexcept
+{
+	return mapping + entry.offset;
+}
+
+void romBundle::load(const bundleEntry& entry, byte *const ram) const noexcept
+{
+	std::memcpy(ram + entry.origin, data(entry), entry.size);
+}
+
+byte* romBundle::map(const bundleEntry& entry) const noexcept
+{
+	void *const p = mmap(nullptr, 0x10000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(p == MAP_FAILED)
+		return nullptr;
+
+	byte *const ram = (byte*)p;
+
+	if(entry.size == 0)
+		return ram;
+
+	// The image's last page is zero-padded in the file, so mapping whole
+	// pages leaves the rest of RAM zeroed as it would be if copied
+	const long hostPageSize = sysconf(_SC_PAGESIZE);
+
+	if(entry.origin % hostPageSize == 0 and entry.offset % hostPageSize == 0
+		and mmap(ram + entry.origin, entry.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, entry.offset) != MAP_FAILED)
+	{
+		return ram;
+	}
+
+	load(entry, ram);
+	return ram;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file bundle.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A file format packing many memory images into one memory-mappable
+   file, with an index for finding them by name or hash.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+#include <string>
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief An entry in a bundle's index, describing one image.
+	 * @note This is stored in bundle files as-is.
+	 */
+	struct bundleEntry
+	{
+		/**
+		 * @brief The name of the image, NUL-padded. Names longer than 31
+		   characters are truncated.
+		 */
+		char name[32];
+
+		/**
+		 * @brief `hashBytes` of the image's contents.
+		 */
+		std::uint64_t hash;
+
+		/**
+		 * @brief Where the image's contents start in the bundle file. This
+		   is always a multiple of `romBundle::pageSize`.
+		 */
+		std::uint64_t offset;
+
+		/**
+		 * @brief The size of the image in bytes.
+		 */
+		std::uint32_t size;
+
+		/**
+		 * @brief The address in memory the image is loaded to.
+		 */
+		bytePair origin;
+
+		/**
+		 * @brief The address at which execution of the image should start.
+		 */
+		bytePair start;
+
+		/**
+		 * @brief Unused; always 0.
+		 */
+		std::uint64_t reserved;
+	};
+
+	static_assert(sizeof(bundleEntry) == 64, "bundleEntry is stored in bundle files as-is");
+
+	/**
+	 * @brief An image to be written into a bundle by `writeBundle`.
+	 */
+	struct bundleImage
+	{
+		/**
+		 * @brief The name the image is found by.
+		 */
+		std::string name;
+
+		/**
+		 * @brief The address in memory the image is loaded to.
+		 */
+		bytePair origin = 0;
+
+		/**
+		 * @brief The address at which execution of the image should start.
+		 */
+		bytePair start = 0;
+
+		/**
+		 * @brief The contents of the image. `origin + data.size()` must not
+		   exceed 65536.
+		 */
+		std::vector<byte> data;
+	};
+
+	/**
+	 * @brief Writes images to a bundle file.
+	 * Images are sorted by name in the index. Names must be unique once
+	   truncated to 31 characters.
+	 *
+	 * @param filename `const std::string&` The name of the bundle file to write.
+	 * @param images `std::vector<bundleImage>` The images to write.
+	 * @param error `std::string&` Set to a description of the problem if the
+	   file is not written.
+	 * @return `bool` Whether the file was written.
+	 */
+	bool writeBundle(const std::string& filename, std::vector<bundleImage> images, std::string& error);
+
+	/**
+	 * @brief A bundle file, memory-mapped for reading.
+	 * A bundle has a header, an index of `bundleEntry`s sorted by name, and
+	   the images' contents, each starting on a page boundary. Opening a
+	   bundle costs one `mmap`; the contents of an image are only read from
+	   disk when they are first touched, and can be mapped straight into a
+	   machine's RAM.
+	 */
+	class romBundle
+	{
+	public:
+		/**
+		 * @brief The alignment of images in a bundle file.
+		 */
+		static constexpr std::size_t pageSize = 0x1000;
+
+		/**
+		 * @brief The version of the bundle file format.
+		 */
+		static constexpr std::uint32_t formatVersion = 1;
+
+		romBundle(void) noexcept = default;
+		romBundle(const romBundle&) = delete;
+		romBundle& operator=(const romBundle&) = delete;
+
+		/**
+		 * @brief Unmaps the bundle file, if one is open.
+		 */
+		~romBundle();
+
+		/**
+		 * @brief Opens and maps a bundle file, closing any already open.
+		 * @param filename `const std::string&` The name of the bundle file.
+		 * @return `bool` Whether the file was opened and is a valid bundle.
+		 */
+		bool open(const std::string& filename) noexcept;
+
+		/**
+		 * @return `std::size_t` The number of images in the bundle.
+		 */
+		std::size_t size(void) const noexcept;
+
+		/**
+		 * @return `const bundleEntry&` The `i`th entry in the index.
+		 */
+		const bundleEntry& operator[](const std::size_t i) const noexcept;
+
+		/**
+		 * @brief Finds an image by name, using a binary search of the index.
+		 * @param name `const std::string&` The name of the image.
+		 * @return `const bundleEntry*` The image's entry, or `nullptr` if
+		   there is no such image.
+		 */
+		const bundleEntry* find(const std::string& name) const noexcept;
+
+		/**
+		 * @brief Finds an image by the hash of its contents.
+		 * @param hash `const std::uint64_t` The hash to look for.
+		 * @return `const bundleEntry*` The first entry with that hash, or
+		   `nullptr` if there is no such image.
+		 */
+		const bundleEntry* findByHash(const std::uint64_t hash) const noexcept;
+
+		/**
+		 * @return `const byte*` The contents of `entry`'s image.
+		 */
+		const byte* data(const bundleEntry& entry) const noexcept;
+
+		/**
+		 * @brief Copies an image into RAM at its origin.
+		 * @param entry `const bundleEntry&` The image to load.
+		 * @param ram `byte *const` A pointer to 65536 bytes of RAM.
+		 */
+		void load(const bundleEntry& entry, byte *const ram) const noexcept;
+
+		/**
+		 * @brief Allocates 64K of RAM with an image mapped onto it, as
+		   `mapImageFile` does for a single file.
+		 * If the image's origin is a multiple of `pageSize`, its pages are
+		   mapped copy-on-write straight from the bundle file; otherwise it is
+		   copied.
+		 * @param entry `const bundleEntry&` The image to map.
+		 * @return `byte*` A pointer to 65536 bytes of RAM, or `nullptr` on
+		   failure. It must be freed with `unmapImageFile`.
+		 */
+		byte* map(const bundleEntry& entry) const noexcept;
+
+	private:
+		/**
+		 * @brief The mapped bundle file.
+		 */
+		const byte* mapping = nullptr;
+
+		/**
+		 * @brief The size of `mapping`.
+		 */
+		std::size_t mappingSize = 0;
+
+		/**
+		 * @brief The bundle file, kept open so images can be mapped from it.
+		 */
+		int fd = -1;
+
+		/**
+		 * @brief The index, pointing into `mapping`.
+		 */
+		const bundleEntry* entries = nullptr;
+
+		/**
+		 * @brief The number of entries in `entries`.
+		 */
+		std::size_t count = 0;
+
+		/**
+		 * @brief Closes the bundle file.
+		 */
+		void close(void) noexcept;
+	};
+}
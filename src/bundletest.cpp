@@ -0,0 +1,193 @@
+/**
+ * @file bundletest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks bundle files: images written by `writeBundle` are found by
+   name and by hash and read back, loaded and mapped exactly; duplicate
+   names, images too large for memory and damaged files are rejected.
+   Usage: bundletest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./bundle.hpp"
+#include "./check.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+using namespace intel8080;
+
+namespace
+{
+	bundleImage makeImage(const std::string& name, const bytePair origin, const bytePair start, const std::size_t size, std::mt19937& rng)
+	{
+		bundleImage image;
+		image.name = name;
+		image.origin = origin;
+		image.start = start;
+		image.data.resize(size);
+
+		for(byte& b : image.data)
+			b = rng();
+
+		return image;
+	}
+
+	/**
+	 * @brief Checks that `ram` holds `image` at its origin and zeros elsewhere.
+	 */
+	bool holds(const byte *const ram, const bundleImage& image)
+	{
+		const std::size_t end = image.origin + image.data.size();
+
+		return std::equal(image.data.begin(), image.data.end(), ram + image.origin)
+			and std::all_of(ram, ram + image.origin, [](const byte b){ return b == 0; })
+			and std::all_of(ram + end, ram + 0x10000, [](const byte b){ return b == 0; });
+	}
+}
+
+int main(void)
+{
+	const scratchDirectory dir;
+
+	if(not CHECK(dir.ok()))
+		return checks::summary("bundletest");
+
+	std::mt19937 rng(8080);
+	const std::string longName(40, 'x');
+
+	// Given out of order: a page-aligned image (mapped from the file), a
+	// .com-like one (copied), one filling the top of memory, an empty one
+	// and one whose name is truncated
+	const std::vector<bundleImage> images = {
+		makeImage("space.rom", 0x0000, 0x0000, 0x2000, rng),
+		makeImage("cputest.com", 0x0100, 0x0100, 0x4a33, rng),
+		makeImage("top.bin", 0xf000, 0xf123, 0x1000, rng),
+		makeImage("empty.bin", 0x8000, 0x8000, 0, rng),
+		makeImage(longName, 0x3000, 0x3000, 0x10, rng)
+	};
+
+	const std::string file = dir / "roms.bundle";
+	std::string error;
+
+	CHECK(writeBundle(file, images, error));
+
+	romBundle bundle;
+
+	if(CHECK(bundle.open(file)))
+	{
+		CHECK(bundle.size() == images.size());
+
+		// The index is sorted by name
+		for(std::size_t i = 1; i < bundle.size(); ++i)
+			CHECK(std::strncmp(bundle[i - 1].name, bundle[i].name, sizeof bundle[i].name) < 0);
+
+		for(bundleImage image : images)
+		{
+			image.name.resize(std::min<std::size_t>(image.name.size(), 31));
+
+			const bundleEntry* entry = bundle.find(image.name);
+
+			if(not CHECK(entry != nullptr))
+				continue;
+
+			CHECK(entry->origin == image.origin and entry->start == image.start);
+			CHECK(entry->size == image.data.size());
+			CHECK(entry->offset % romBundle::pageSize == 0);
+			CHECK(entry->hash == hashBytes(image.data.data(), image.data.size()));
+			CHECK(std::equal(image.data.begin(), image.data.end(), bundle.data(*entry)));
+
+			if(not image.data.empty())
+				CHECK(bundle.findByHash(entry->hash) == entry);
+
+			std::vector<byte> ram(0x10000);
+			bundle.load(*entry, ram.data());
+			CHECK(holds(ram.data(), image));
+
+			// Mapped RAM is private: writing it leaves the bundle as it was
+			byte *const mapped = bundle.map(*entry);
+
+			if(CHECK(mapped != nullptr))
+			{
+				CHECK(holds(mapped, image));
+
+				mapped[image.origin] ^= 0xff;
+				CHECK(image.data.empty() or bundle.data(*entry)[0] == image.data[0]);
+
+				unmapImageFile(mapped);
+			}
+		}
+
+		CHECK(bundle.find("missing.rom") == nullptr);
+		CHECK(bundle.find(longName) == nullptr);
+		CHECK(bundle.findByHash(0x0123456789abcdef) == nullptr);
+	}
+
+	// Names that are the same once truncated are duplicates too
+	{
+		std::vector<bundleImage> duplicates = images;
+		duplicates.push_back(makeImage("top.bin", 0x0000, 0x0000, 0x10, rng));
+
+		error.clear();
+		CHECK(not writeBundle(dir / "duplicate.bundle", duplicates, error));
+		CHECK(error.find("top.bin") != std::string::npos);
+
+		duplicates.pop_back();
+		duplicates.push_back(makeImage(longName + "y", 0x0000, 0x0000, 0x10, rng));
+		CHECK(not writeBundle(dir / "duplicate.bundle", duplicates, error));
+	}
+
+	{
+		std::vector<bundleImage> tooLarge = {makeImage("large.bin", 0xff00, 0xff00, 0x101, rng)};
+		CHECK(not writeBundle(dir / "large.bundle", tooLarge, error));
+	}
+
+	// A file that is not a bundle, a bundle whose index is cut off, and
+	// entries whose offset or size run past the file or memory
+	{
+		std::ofstream(dir / "text.bundle") << "This is not a bundle, but is long enough to have a header.";
+		CHECK(not bundle.open(dir / "text.bundle"));
+
+		std::ifstream in(file, std::ios::binary);
+		std::vector<char> head(40 + 64);
+		in.read(head.data(), head.size());
+		std::ofstream(dir / "cut.bundle", std::ios::binary).write(head.data(), head.size());
+		CHECK(not bundle.open(dir / "cut.bundle"));
+
+		// Values that would wrap around if added to the offset or origin
+		std::vector<bundleImage> one = {makeImage("one.rom", 0x0100, 0x0100, romBundle::pageSize, rng)};
+		CHECK(writeBundle(dir / "one.bundle", one, error));
+
+		std::ifstream original(dir / "one.bundle", std::ios::binary);
+		const std::string contents((std::istreambuf_iterator<char>(original)), std::istreambuf_iterator<char>());
+		CHECK(bundle.open(dir / "one.bundle"));
+
+		const std::size_t entry = contents.find("one.rom");
+		const auto patched = [&](const std::size_t field, const auto value)
+		{
+			std::string damaged = contents;
+			std::memcpy(&damaged[entry + field], &value, sizeof value);
+			std::ofstream(dir / "wrap.bundle", std::ios::binary) << damaged;
+			return bundle.open(dir / "wrap.bundle");
+		};
+
+		CHECK(not patched(offsetof(bundleEntry, offset), (std::uint64_t)0 - romBundle::pageSize));
+		CHECK(not patched(offsetof(bundleEntry, size), (std::uint32_t)0 - 0x0100));
+		CHECK(patched(offsetof(bundleEntry, size), (std::uint32_t)0x10));
+
+		CHECK(not bundle.open(dir / "missing.bundle"));
+		CHECK(bundle.size() == 0);
+	}
+
+	return checks::summary("bundletest");
+}
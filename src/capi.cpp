@@ -0,0 +1,256 @@
+/**
+ * @file capi.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A C interface to the emulator, for other languages to call through
+   their foreign function interfaces.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function is for, see `capi.h`.
+
+#include "./capi.h"
+#include "./intel8080.hpp"
+#include "./blocks.hpp"
+#include "./image.hpp"
+
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+using namespace intel8080;
+
+static_assert(sizeof(i8080_registers) == 24, "i8080_registers must not have padding");
+
+namespace
+{
+	/**
+	 * @brief The most cycles any instruction takes (`xthl`), so that running
+	   this many times fewer instructions than there are cycles left never
+	   overshoots by more than a block.
+	 */
+	constexpr std::uint64_t maxInstructionCycles = 18;
+}
+
+/**
+ * @brief A `cpu` with its memory, the engine that runs it and the C
+   callbacks for its ports.
+ */
+struct i8080_machine
+{
+	std::unique_ptr<byte[]> memory;
+	cpu machine;
+	blockEngine engine;
+
+	i8080_input_fn input = nullptr;
+	i8080_output_fn output = nullptr;
+	void* context = nullptr;
+
+	/**
+	 * @brief Why the last call that failed failed.
+	 */
+	std::string error;
+
+	i8080_machine(void)
+	:
+		memory(new byte[0x10000]()),
+		machine(
+			[this](const byte port){ return input ? input(context, port) : (byte)0; },
+			[this](const byte port, const byte data){ if(output) output(context, port, data); },
+			memory.get()),
+		engine(machine)
+	{
+		i8080_registers r = {};
+		r.psw = 0x0002;
+		setRegisters(r);
+	}
+
+	void getRegisters(i8080_registers& r) noexcept
+	{
+		r.cycles = machine.cycles;
+		r.psw = machine.PSW();
+		r.bc = machine.BC();
+		r.de = machine.DE();
+		r.hl = machine.HL();
+		r.sp = machine.SP;
+		r.pc = machine.PC;
+		r.interrupts_enabled = machine.getInterruptsEnabled();
+		r.interrupt_pending = machine.getInterruptPending();
+		r.halted = machine.getHalted();
+		r.interrupt_vector = machine.getInterruptVector();
+	}
+
+	void setRegisters(const i8080_registers& r) noexcept
+	{
+		machine.cycles = r.cycles;
+		machine.PSW() = r.psw;
+		machine.BC() = r.bc;
+		machine.DE() = r.de;
+		machine.HL() = r.hl;
+		machine.SP = r.sp;
+		machine.PC = r.pc;
+		machine.setInterruptsEnabled(r.interrupts_enabled);
+		machine.setInterruptPending(r.interrupt_pending, r.interrupt_vector);
+		machine.setHalted(r.halted);
+	}
+};
+
+// Exceptions must not reach C callers; the only one expected is running out
+// of memory while translating code
+
+uint32_t i8080_abi_version(void)
+{
+	return I8080_ABI_VERSION;
+}
+
+i8080_machine* i8080_create(void)
+{
+	try
+	{
+		return new i8080_machine;
+	}
+	catch(...)
+	{
+		return nullptr;
+	}
+}
+
+void i8080_destroy(i8080_machine* m)
+{
+	delete m;
+}
+
+uint8_t* i8080_memory(i8080_machine* m)
+{
+	return m->memory.get();
+}
+
+void i8080_invalidate(i8080_machine* m, const uint16_t begin, const uint32_t length)
+{
+	m->engine.invalidate(begin, length);
+}
+
+int i8080_load(i8080_machine* m, const uint16_t origin, const uint8_t* data, const size_t length)
+{
+	if(length > 0x10000u - origin)
+	{
+		m->error = "the data does not fit in memory";
+		return -1;
+	}
+
+	if(length)
+	{
+		std::memcpy(m->memory.get() + origin, data, length);
+		m->engine.invalidate(origin, length);
+	}
+
+	return 0;
+}
+
+int i8080_load_image(i8080_machine* m, const char* argument)
+{
+	try
+	{
+		imageInfo image;
+
+		if(not loadImageArgument(argument, m->memory.get(), image, m->error))
+			return -1;
+
+		m->engine.flush();
+		m->machine.PC = image.start;
+
+		// As CP/M leaves it: returning from the program reaches the `hlt` at 0
+		if(image.com)
+		{
+			m->machine.SP = 0x0000;
+			m->machine.push(0x0000);
+		}
+
+		return 0;
+	}
+	catch(const std::bad_alloc&)
+	{
+		m->error = "out of memory";
+		return -1;
+	}
+}
+
+const char* i8080_error(const i8080_machine* m)
+{
+	return m->error.c_str();
+}
+
+void i8080_set_ports(i8080_machine* m, const i8080_input_fn input, const i8080_output_fn output, void* context)
+{
+	m->input = input;
+	m->output = output;
+	m->context = context;
+}
+
+void i8080_get_registers(i8080_machine* m, i8080_registers* registers)
+{
+	m->getRegisters(*registers);
+}
+
+void i8080_set_registers(i8080_machine* m, const i8080_registers* registers)
+{
+	m->setRegisters(*registers);
+}
+
+uint64_t i8080_run_instructions(i8080_machine* m, const uint64_t count)
+{
+	try
+	{
+		return m->engine.run(count);
+	}
+	catch(const std::bad_alloc&)
+	{
+		m->error = "out of memory";
+		return 0;
+	}
+}
+
+uint64_t i8080_run_cycles(i8080_machine* m, const uint64_t count)
+{
+	cpu& machine = m->machine;
+	const std::uint64_t target = machine.cycles + count;
+	std::uint64_t instructions = 0;
+
+	// Copy and fill loops would run past the target
+	blockEngine::limits stop;
+	stop.accelerate = false;
+
+	try
+	{
+		while(machine.cycles < target)
+		{
+			const std::uint64_t n = m->engine.run((target - machine.cycles) / maxInstructionCycles + 1, stop);
+			instructions += n;
+
+			// Halted with nothing to service: the clock runs on regardless
+			if(n == 0)
+			{
+				machine.cycles = target;
+				break;
+			}
+		}
+	}
+	catch(const std::bad_alloc&)
+	{
+		m->error = "out of memory";
+	}
+
+	return instructions;
+}
+
+void i8080_interrupt(i8080_machine* m, const uint8_t vector)
+{
+	m->machine.interrupt(vector);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file capi.h
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A C interface to the emulator, for other languages to call through
+   their foreign function interfaces.
+ * Each call does as much as it can, so that the cost of crossing from
+   Python, Go and the like is paid per batch of instructions rather than per
+   instruction: the CPU runs for a number of instructions or cycles at a
+   time, all registers are read or written in one struct, and memory is
+   exported as a pointer that can be wrapped without copying.
+ * Functions taking a machine are not thread-safe for the same machine;
+   separate machines are independent.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INTEL8080_CAPI_H
+#define INTEL8080_CAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The version of this interface, returned by `i8080_abi_version`.
+   It changes only when a function or struct below changes incompatibly.
+ */
+#define I8080_ABI_VERSION 1
+
+#if defined(_WIN32)
+	#define I8080_API __declspec(dllexport)
+#else
+	#define I8080_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief An emulated 8080 with its own 64 KiB of memory.
+ */
+typedef struct i8080_machine i8080_machine;
+
+/**
+ * @brief Called by `in`.
+ * @param context The pointer given to `i8080_set_ports`.
+ * @param port The port number.
+ * @return The byte read from the port.
+ */
+typedef uint8_t (*i8080_input_fn)(void* context, uint8_t port);
+
+/**
+ * @brief Called by `out`.
+ * @param context The pointer given to `i8080_set_ports`.
+ * @param port The port number.
+ * @param data The byte written to the port.
+ */
+typedef void (*i8080_output_fn)(void* context, uint8_t port, uint8_t data);
+
+/**
+ * @brief Every register and the rest of the CPU's state, read and written
+   at once by `i8080_get_registers` and `i8080_set_registers`.
+ * The layout is fixed: fields are naturally aligned with no padding, so the
+   struct can be declared field for field with `ctypes`, `cgo` and the like.
+ */
+typedef struct i8080_registers
+{
+	/**
+	 * @brief The clock cycles run so far; never reset by the emulator.
+	 */
+	uint64_t cycles;
+
+	/**
+	 * @brief The program state word: A in the high byte, the flags in the
+	   low byte (sign 0x80, zero 0x40, auxiliary carry 0x10, parity 0x04,
+	   carry 0x01).
+	 */
+	uint16_t psw;
+	uint16_t bc;
+	uint16_t de;
+	uint16_t hl;
+	uint16_t sp;
+	uint16_t pc;
+
+	/**
+	 * @brief Booleans (0 or 1): whether interrupts are enabled, whether an
+	   interrupt is waiting to be serviced, and whether the CPU is halted.
+	 */
+	uint8_t interrupts_enabled;
+	uint8_t interrupt_pending;
+	uint8_t halted;
+
+	/**
+	 * @brief The instruction run for the pending interrupt.
+	 */
+	uint8_t interrupt_vector;
+} i8080_registers;
+
+/**
+ * @return `I8080_ABI_VERSION` as the library was built, to check against
+   the header a binding was written for.
+ */
+I8080_API uint32_t i8080_abi_version(void);
+
+/**
+ * @return A new machine with zeroed memory, every register 0 but the flags
+   (0x02), and ports that read 0 and ignore writes; or NULL if there is not
+   enough memory.
+ */
+I8080_API i8080_machine* i8080_create(void);
+
+/**
+ * @brief Frees `machine` and its memory. NULL is ignored.
+ */
+I8080_API void i8080_destroy(i8080_machine* machine);
+
+/**
+ * @return The machine's 65536 bytes of memory, valid until it is destroyed.
+ * @note Memory written through this pointer, or from a port callback, must
+   be reported with `i8080_invalidate` before the machine runs again, in case
+   it holds code that has already been translated.
+ */
+I8080_API uint8_t* i8080_memory(i8080_machine* machine);
+
+/**
+ * @brief Reports that `length` bytes from `begin` were written other than by
+   the CPU. `length` may be up to 65536; addresses wrap around.
+ */
+I8080_API void i8080_invalidate(i8080_machine* machine, uint16_t begin, uint32_t length);
+
+/**
+ * @brief Copies `length` bytes to memory at `origin` and invalidates them.
+ * @return 0, or -1 if they do not fit below the end of memory.
+ */
+I8080_API int i8080_load(i8080_machine* machine, uint16_t origin, const uint8_t* data, size_t length);
+
+/**
+ * @brief Loads an image file given as `FILE[@ORIGIN]` (ORIGIN in hex), as
+   `disasm` does, and sets the program counter to its start.
+ * .hex files are loaded where their records say, .com files at 0x0100 and
+   other files at ORIGIN, or 0; ORIGIN is an error for the others. For .com
+   files, a `hlt` is placed at 0x0000 and a `ret` at 0x0005, and the stack
+   pointer is set so that returning from the program reaches the `hlt`.
+ * @return 0, or -1 with the reason given by `i8080_error`.
+ */
+I8080_API int i8080_load_image(i8080_machine* machine, const char* argument);
+
+/**
+ * @return Why the last call that failed on `machine` failed, valid until
+   the next call on it; "" if none has.
+ */
+I8080_API const char* i8080_error(const i8080_machine* machine);
+
+/**
+ * @brief Sets the functions called by `in` and `out`, each given `context`.
+   Either may be NULL: input then reads 0, and output is ignored.
+ */
+I8080_API void i8080_set_ports(i8080_machine* machine, i8080_input_fn input, i8080_output_fn output, void* context);
+
+I8080_API void i8080_get_registers(i8080_machine* machine, i8080_registers* registers);
+
+I8080_API void i8080_set_registers(i8080_machine* machine, const i8080_registers* registers);
+
+/**
+ * @brief Runs whole blocks of instructions until at least `count` have run
+   or the CPU halts with no interrupt to service. Copy and fill loops may
+   run at once, so this can go well past `count`.
+ * @return The number of instructions run, counting a serviced interrupt
+   as one; 0 if the CPU is halted.
+ */
+I8080_API uint64_t i8080_run_instructions(i8080_machine* machine, uint64_t count);
+
+/**
+ * @brief Runs until at least `count` clock cycles have passed, stopping
+   within a block of the target. While the CPU is halted, the clock still
+   runs, so the cycle count reaches the target.
+ * @return The number of instructions run.
+ */
+I8080_API uint64_t i8080_run_cycles(i8080_machine* machine, uint64_t count);
+
+/**
+ * @brief Requests an interrupt that runs `vector`, usually an `rst`, if
+   interrupts are enabled; it is serviced by the next run.
+ */
+I8080_API void i8080_interrupt(i8080_machine* machine, uint8_t vector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
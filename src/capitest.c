@@ -0,0 +1,132 @@
+/**
+ * @file capitest.c
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks that `capi.h` compiles as C and that a program runs through
+   it: port callbacks with their context, the register struct, memory
+   written through the exported pointer, cycle and instruction budgets and
+   interrupts.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "capi.h"
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { if(!(condition)) { fprintf(stderr, "capitest: line %d: %s\n", __LINE__, #condition); ++failures; } } while(0)
+
+struct ports
+{
+	uint8_t input;
+	uint8_t lastPort;
+	uint8_t lastData;
+	int outputs;
+};
+
+static uint8_t in(void* context, uint8_t port)
+{
+	(void)port;
+	return ((struct ports*)context)->input;
+}
+
+static void out(void* context, uint8_t port, uint8_t data)
+{
+	struct ports* p = context;
+	p->lastPort = port;
+	p->lastData = data;
+	++p->outputs;
+}
+
+int main(void)
+{
+	static const uint8_t program[] = {
+		0x31, 0x00, 0x01,	// lxi sp, 0x0100
+		0xdb, 0x10,			// in 0x10
+		0x3c,				// inr a
+		0xd3, 0x11,			// out 0x11
+		0x21, 0x00, 0x20,	// lxi h, 0x2000
+		0x77,				// mov m, a
+		0x76				// hlt
+	};
+
+	static const uint8_t handler[] = {
+		0x3e, 0x07,			// mvi a, 7
+		0x76				// hlt
+	};
+
+	struct ports ports = {0x41, 0, 0, 0};
+	i8080_registers r;
+	i8080_machine* m;
+	uint8_t* memory;
+	uint64_t n;
+
+	CHECK(i8080_abi_version() == I8080_ABI_VERSION);
+
+	m = i8080_create();
+
+	if(!m)
+	{
+		fprintf(stderr, "capitest: cannot create a machine\n");
+		return 1;
+	}
+
+	memory = i8080_memory(m);
+	i8080_set_ports(m, in, out, &ports);
+	CHECK(i8080_load(m, 0x0000, program, sizeof program) == 0);
+	CHECK(i8080_load(m, 0x0038, handler, sizeof handler) == 0);
+	CHECK(i8080_load(m, 0xfff0, program, 0x11) == -1);
+
+	i8080_get_registers(m, &r);
+	CHECK(r.pc == 0 && r.psw == 0x0002 && r.cycles == 0 && !r.halted);
+
+	// 59 cycles, then halted until the end of the budget
+	n = i8080_run_cycles(m, 1000);
+	i8080_get_registers(m, &r);
+	CHECK(n == 7);
+	CHECK(r.cycles == 1000);
+	CHECK(r.halted && r.pc == 0x000d && r.sp == 0x0100 && r.hl == 0x2000);
+	CHECK(r.psw >> 8 == 0x42);
+	CHECK(memory[0x2000] == 0x42);
+	CHECK(ports.outputs == 1 && ports.lastPort == 0x11 && ports.lastData == 0x42);
+	CHECK(i8080_run_instructions(m, 100) == 0);
+
+	// `rst 7` runs the handler, which halts again
+	r.interrupts_enabled = 1;
+	i8080_set_registers(m, &r);
+	i8080_interrupt(m, 0xff);
+	n = i8080_run_instructions(m, 100);
+	i8080_get_registers(m, &r);
+	CHECK(n == 3);
+	CHECK(r.psw >> 8 == 0x07 && r.pc == 0x003b && r.sp == 0x00fe && r.halted && !r.interrupts_enabled);
+	CHECK(memory[0x00fe] == 0x0d && memory[0x00ff] == 0x00);
+
+	// Code already translated, rewritten through the pointer: `dcr a`
+	memory[0x0005] = 0x3d;
+	i8080_invalidate(m, 0x0005, 1);
+	r.pc = 0;
+	r.halted = 0;
+	i8080_set_registers(m, &r);
+	i8080_run_instructions(m, 100);
+	CHECK(memory[0x2000] == 0x40 && ports.lastData == 0x40);
+
+	CHECK(i8080_load_image(m, "/nonexistent/program.com") == -1);
+	CHECK(i8080_error(m)[0] != '\0');
+
+	i8080_destroy(m);
+	i8080_destroy(NULL);
+
+	if(failures)
+		return 1;
+
+	printf("capitest: passed\n");
+	return 0;
+}
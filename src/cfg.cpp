@@ -0,0 +1,679 @@
+/**
+ * @file cfg.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Recovers basic blocks, the call graph and jump targets from an Intel
+   8080 memory image, starting from known entry points.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `cfg.hpp`.
+
+#include "./cfg.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief What is known about a register while scanning a block for the
+	   target of a `pchl`.
+	 */
+	struct knownValue
+	{
+		enum
+		{
+			unknown,
+			constant,
+			tableLow,	// The low byte of an entry in the table at `table`
+			tableHigh	// The high byte of an entry in the table at `table`
+		} kind = unknown;
+
+		byte value = 0;
+		bytePair table = 0;
+	};
+
+	/**
+	 * @brief The state of the traversal.
+	 */
+	class analysis
+	{
+	public:
+		analysis(const byte* memory, const cfgOptions& options, controlFlowGraph& graph)
+		:
+			memory(memory), options(options), graph(graph),
+			leader(0x10000), endsBlock(0x10000), functionEntry(0x10000)
+		{
+			graph.kinds.assign(0x10000, byteKind::unknown);
+		}
+
+		void addEntry(const bytePair address)
+		{
+			functionEntry[address] = true;
+			addTarget(address);
+		}
+
+		/**
+		 * @brief Traverses everything reachable from the entries, then
+		   resolves `pchl`s and traverses again until nothing new is found.
+		 */
+		void run(void)
+		{
+			for(;;)
+			{
+				while(not worklist.empty())
+				{
+					const bytePair address = worklist.back();
+					worklist.pop_back();
+					trace(address);
+				}
+
+				buildBlocks();
+
+				if(not resolveIndirectJumps())
+					break;
+			}
+
+			buildCallGraph();
+			std::sort(graph.conflicts.begin(), graph.conflicts.end());
+			graph.conflicts.erase(std::unique(graph.conflicts.begin(), graph.conflicts.end()), graph.conflicts.end());
+		}
+
+	private:
+		const byte* memory;
+		const cfgOptions& options;
+		controlFlowGraph& graph;
+
+		std::vector<bool> leader;
+		std::vector<bool> endsBlock;
+		std::vector<bool> functionEntry;
+		std::vector<bytePair> worklist;
+
+		/**
+		 * @brief `pchl`s whose blocks have been analyzed.
+		 */
+		std::set<bytePair> analyzedIndirectJumps;
+
+		void addTarget(const bytePair address)
+		{
+			leader[address] = true;
+			worklist.push_back(address);
+		}
+
+		void markData(const bytePair address)
+		{
+			if(graph.kinds[address] == byteKind::unknown) graph.kinds[address] = byteKind::data;
+		}
+
+		/**
+		 * @brief Decodes instructions from `address` until control cannot
+		   continue to the next one, or known code is reached.
+		 */
+		void trace(bytePair address)
+		{
+			for(;;)
+			{
+				auto& kind = graph.kinds[address];
+
+				if(kind == byteKind::opcode)
+				{
+					// Falling into known code: the code there now has 2 predecessors
+					leader[address] = true;
+					return;
+				}
+
+				if(kind != byteKind::unknown)
+					graph.conflicts.push_back(address);
+
+				const instruction instr = decodeInstruction(memory, address);
+				const opcodeInfo& info = opcodes[instr.opcode];
+				kind = byteKind::opcode;
+
+				for(int i = 1; i < instr.length; ++i)
+				{
+					auto& operandKind = graph.kinds[(bytePair)(address + i)];
+
+					if(operandKind == byteKind::opcode) graph.conflicts.push_back(address + i);
+					else operandKind = byteKind::operand;
+				}
+
+				// Memory read or written directly: LDA, STA, LHLD, SHLD
+				switch(instr.opcode)
+				{
+					case 0x22:
+					case 0x2a:
+						markData(instr.operand + 1);
+						// Fall through
+
+					case 0x32:
+					case 0x3a:
+						markData(instr.operand);
+						break;
+				}
+
+				const bytePair next = address + instr.length;
+
+				switch(info.flow)
+				{
+					case flowType::next:
+						address = next;
+						continue;
+
+					case flowType::jump:
+						endsBlock[address] = true;
+						addTarget(instr.operand);
+						return;
+
+					case flowType::conditionalJump:
+						addTarget(instr.operand);
+						break;
+
+					case flowType::call:
+					case flowType::conditionalCall:
+						addEntry(instr.operand);
+						break;
+
+					case flowType::restart:
+						addEntry(instr.opcode & 0x38);
+						break;
+
+					case flowType::ret:
+					case flowType::indirectJump:
+						endsBlock[address] = true;
+						return;
+
+					case flowType::conditionalReturn:
+					case flowType::halt:
+						break;
+				}
+
+				endsBlock[address] = true;
+				leader[next] = true;
+				address = next;
+			}
+		}
+
+		/**
+		 * @brief Rebuilds `graph.blocks` and `graph.instructions` from the
+		   instructions found so far.
+		 */
+		void buildBlocks(void)
+		{
+			graph.blocks.clear();
+			graph.instructions.clear();
+
+			for(std::uint32_t begin = 0; begin < 0x10000; ++begin)
+			{
+				if(not leader[begin] or graph.kinds[begin] != byteKind::opcode)
+					continue;
+
+				basicBlock block;
+				block.begin = begin;
+				block.size = 0;
+				block.firstInstruction = graph.instructions.size();
+
+				bytePair address = begin;
+
+				for(;;)
+				{
+					const instruction instr = decodeInstruction(memory, address);
+					graph.instructions.push_back(instr);
+					block.size += instr.length;
+
+					const bytePair next = address + instr.length;
+
+					if(endsBlock[address] or leader[next] or graph.kinds[next] != byteKind::opcode or block.size >= 0x10000)
+						break;
+
+					address = next;
+				}
+
+				const instruction& last = graph.instructions.back();
+				const bytePair next = last.address + last.length;
+				block.instructionCount = graph.instructions.size() - block.firstInstruction;
+				block.exit = opcodes[last.opcode].flow;
+
+				switch(block.exit)
+				{
+					case flowType::jump:
+						block.successors = {last.operand};
+						break;
+
+					case flowType::conditionalJump:
+						block.successors = {last.operand, next};
+						break;
+
+					case flowType::call:
+					case flowType::conditionalCall:
+						block.hasCallee = true;
+						block.callee = last.operand;
+						block.successors = {next};
+						break;
+
+					case flowType::restart:
+						block.hasCallee = true;
+						block.callee = last.opcode & 0x38;
+						block.successors = {next};
+						break;
+
+					case flowType::ret:
+					case flowType::indirectJump:
+					{
+						const auto targets = graph.indirectTargets.find(last.address);
+						if(targets != graph.indirectTargets.end()) block.successors = targets->second;
+						else block.unresolved = block.exit == flowType::indirectJump;
+						break;
+					}
+
+					default:
+						block.successors = {next};
+						break;
+				}
+
+				graph.blocks.push_back(std::move(block));
+			}
+		}
+
+		/**
+		 * @brief Looks for the targets of `pchl`s, and of `ret`s to an address
+		   pushed in the same block, that have not been analyzed.
+		 * @return `bool` Whether any new targets were found.
+		 */
+		bool resolveIndirectJumps(void)
+		{
+			bool found = false;
+
+			for(const auto& block : graph.blocks)
+			{
+				if(block.exit != flowType::indirectJump and block.exit != flowType::ret)
+					continue;
+
+				const bytePair site = graph.instructions[block.firstInstruction + block.instructionCount - 1].address;
+
+				if(not analyzedIndirectJumps.insert(site).second)
+					continue;
+
+				std::vector<bytePair> targets = findIndirectTargets(block);
+				if(targets.empty())
+					continue;
+
+				for(const bytePair target : targets)
+					addTarget(target);
+
+				graph.indirectTargets[site] = std::move(targets);
+				found = true;
+			}
+
+			return found;
+		}
+
+		/**
+		 * @brief Follows the values of B, C, D, E, H, L and A, and of pairs
+		   pushed within the block, through a block ending in `pchl` or `ret` to
+		   find where it goes.
+		 */
+		std::vector<bytePair> findIndirectTargets(const basicBlock& block)
+		{
+			// Indexed by register encoding: B, C, D, E, H, L, (M), A
+			knownValue reg[8];
+
+			// Pairs pushed within the block, as (high, low)
+			std::vector<std::pair<knownValue, knownValue>> stack;
+
+			// Set when HL is a constant table address plus an unknown index;
+			// `offset` counts `inx h`s since.
+			bool hlIndexed = false;
+			bytePair tableBase = 0;
+			int offset = 0;
+
+			const auto pairKnown = [&](const int high){
+				return reg[high].kind == knownValue::constant and reg[high + 1].kind == knownValue::constant;
+			};
+			const auto pairValue = [&](const int high){
+				return (bytePair)(reg[high].value << 8 | reg[high + 1].value);
+			};
+			const auto setPair = [&](const int high, const bytePair value){
+				reg[high] = {knownValue::constant, (byte)(value >> 8)};
+				reg[high + 1] = {knownValue::constant, (byte)value};
+			};
+			const auto forgetPair = [&](const int high){
+				reg[high] = reg[high + 1] = knownValue();
+				if(high == 4) hlIndexed = false;
+			};
+
+			for(std::uint32_t i = 0; i + 1 < block.instructionCount; ++i)
+			{
+				const instruction& instr = graph.instructions[block.firstInstruction + i];
+				const byte op = instr.opcode;
+				const int ddd = op >> 3 & 7;
+				const int sss = op & 7;
+				const int high = (op >> 4 & 3) * 2;
+
+				// LXI
+				if((op & 0xcf) == 0x01)
+				{
+					if(high < 6)
+					{
+						setPair(high, instr.operand);
+						if(high == 4) hlIndexed = false;
+					}
+					else
+					{
+						stack.clear();
+					}
+				}
+				// PUSH
+				else if((op & 0xcf) == 0xc5)
+				{
+					stack.emplace_back(reg[high], reg[high + 1]);
+				}
+				// POP
+				else if((op & 0xcf) == 0xc1)
+				{
+					if(stack.empty())
+					{
+						forgetPair(high);
+					}
+					else
+					{
+						reg[high] = stack.back().first;
+						reg[high + 1] = stack.back().second;
+						stack.pop_back();
+						if(high == 4) hlIndexed = false;
+					}
+				}
+				// INX SP, DCX SP, SPHL
+				else if(op == 0x33 or op == 0x3b or op == 0xf9)
+				{
+					stack.clear();
+				}
+				// XTHL, DAD SP
+				else if(op == 0xe3 or op == 0x39)
+				{
+					if(op == 0xe3) stack.clear();
+					forgetPair(4);
+				}
+				// MVI
+				else if((op & 0xc7) == 0x06)
+				{
+					if(ddd != 6)
+					{
+						reg[ddd] = {knownValue::constant, (byte)instr.operand};
+						if(ddd == 4 or ddd == 5) hlIndexed = false;
+					}
+				}
+				// MOV
+				else if((op & 0xc0) == 0x40 and op != 0x76)
+				{
+					if(ddd == 6)
+						continue;
+
+					if(sss == 6)
+					{
+						if(hlIndexed and offset < 2)
+							reg[ddd] = {offset == 0 ? knownValue::tableLow : knownValue::tableHigh, 0, tableBase};
+						else
+							reg[ddd] = knownValue();
+					}
+					else
+					{
+						reg[ddd] = reg[sss];
+					}
+
+					if(ddd == 4 or ddd == 5) hlIndexed = false;
+				}
+				// DAD
+				else if((op & 0xcf) == 0x09)
+				{
+					const bool indexKnown = high == 6 ? false : pairKnown(high);
+
+					if(pairKnown(4) and indexKnown)
+					{
+						setPair(4, pairValue(4) + pairValue(high));
+					}
+					else if(pairKnown(4) and high != 4)
+					{
+						tableBase = pairValue(4);
+						forgetPair(4);
+						hlIndexed = true;
+						offset = 0;
+					}
+					else
+					{
+						forgetPair(4);
+					}
+				}
+				// INX, DCX
+				else if((op & 0xc7) == 0x03)
+				{
+					if(high == 6)
+						continue;
+
+					const int step = op & 0x08 ? -1 : 1;
+
+					if(high == 4 and hlIndexed) offset += step;
+					else if(pairKnown(high)) setPair(high, pairValue(high) + step);
+					else forgetPair(high);
+				}
+				// XCHG
+				else if(op == 0xeb)
+				{
+					std::swap(reg[2], reg[4]);
+					std::swap(reg[3], reg[5]);
+					hlIndexed = false;
+				}
+				// INR, DCR
+				else if((op & 0xc6) == 0x04)
+				{
+					if(ddd != 6) reg[ddd] = knownValue();
+				}
+				// LHLD
+				else if(op == 0x2a)
+				{
+					forgetPair(4);
+				}
+				// Everything else leaves B-L alone but may change A
+				else
+				{
+					reg[7] = knownValue();
+				}
+			}
+
+			if(block.exit == flowType::ret)
+			{
+				if(not stack.empty() and stack.back().first.kind == knownValue::constant and stack.back().second.kind == knownValue::constant)
+					return {(bytePair)(stack.back().first.value << 8 | stack.back().second.value)};
+
+				return {};
+			}
+
+			if(pairKnown(4))
+				return {pairValue(4)};
+
+			const knownValue& h = reg[4];
+			const knownValue& l = reg[5];
+
+			if(h.kind == knownValue::tableHigh and l.kind == knownValue::tableLow and h.table == l.table)
+				return readJumpTable(h.table);
+
+			return {};
+		}
+
+		/**
+		 * @brief Reads a table of 2-byte addresses, marking it as data.
+		 */
+		std::vector<bytePair> readJumpTable(const bytePair table)
+		{
+			std::vector<bytePair> targets;
+			std::uint32_t lowestTarget = 0x10000;
+
+			for(std::size_t i = 0; i < options.maxJumpTableEntries; ++i)
+			{
+				const bytePair entry = table + 2 * i;
+
+				// The table has run into code, or into the code it points to
+				if(graph.kinds[entry] == byteKind::opcode or graph.kinds[entry] == byteKind::operand
+					or (entry >= table and entry >= lowestTarget and lowestTarget > table))
+					break;
+
+				const bytePair target = memory[entry] | memory[(bytePair)(entry + 1)] << 8;
+
+				if(target < options.codeBegin or target >= options.codeEnd)
+					break;
+
+				markData(entry);
+				markData(entry + 1);
+				targets.push_back(target);
+
+				if(target > table) lowestTarget = std::min<std::uint32_t>(lowestTarget, target);
+			}
+
+			std::sort(targets.begin(), targets.end());
+			targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+			return targets;
+		}
+
+		void buildCallGraph(void)
+		{
+			graph.callGraph.clear();
+
+			for(std::uint32_t entry = 0; entry < 0x10000; ++entry)
+			{
+				if(not functionEntry[entry])
+					continue;
+
+				std::set<bytePair> callees;
+				std::set<bytePair> visited;
+				std::vector<bytePair> pending = {(bytePair)entry};
+
+				while(not pending.empty())
+				{
+					const bytePair address = pending.back();
+					pending.pop_back();
+
+					if(not visited.insert(address).second)
+						continue;
+
+					const basicBlock *const block = graph.blockAt(address);
+					if(not block)
+						continue;
+
+					if(block->hasCallee) callees.insert(block->callee);
+
+					for(const bytePair s : block->successors)
+						pending.push_back(s);
+				}
+
+				graph.callGraph[entry].assign(callees.begin(), callees.end());
+			}
+		}
+	};
+
+	void appendHex4(std::string& out, const bytePair value)
+	{
+		char text[8];
+		std::snprintf(text, sizeof text, "%04X", value);
+		out += text;
+	}
+}
+
+const basicBlock* controlFlowGraph::blockAt(const bytePair address) const noexcept
+{
+	const auto it = std::lower_bound(blocks.begin(), blocks.end(), address,
+		[](const basicBlock& block, const bytePair a){ return block.begin < a; });
+
+	return it != blocks.end() and it->begin == address ? &*it : nullptr;
+}
+
+std::string controlFlowGraph::toDot(const bool withInstructions /* = true */) const
+{
+	std::string dot = "digraph cfg {\n\tnode [shape=box, fontname=\"monospace\"];\n";
+
+	for(const auto& block : blocks)
+	{
+		dot += "\tb";
+		appendHex4(dot, block.begin);
+		dot += " [label=\"";
+		appendHex4(dot, block.begin);
+		dot += ":\\l";
+
+		if(withInstructions)
+		{
+			char text[maxInstructionText + 1];
+
+			for(std::uint32_t i = 0; i < block.instructionCount; ++i)
+			{
+				formatInstruction(instructions[block.firstInstruction + i], text);
+				dot += "  ";
+				dot += text;
+				dot += "\\l";
+			}
+		}
+
+		dot += '"';
+		if(callGraph.count(block.begin)) dot += ", style=bold";
+		if(block.unresolved) dot += ", color=red";
+		dot += "];\n";
+
+		for(const bytePair s : block.successors)
+		{
+			dot += "\tb";
+			appendHex4(dot, block.begin);
+			dot += " -> b";
+			appendHex4(dot, s);
+			dot += ";\n";
+		}
+
+		if(block.hasCallee)
+		{
+			dot += "\tb";
+			appendHex4(dot, block.begin);
+			dot += " -> b";
+			appendHex4(dot, block.callee);
+			dot += " [style=dashed];\n";
+		}
+	}
+
+	dot += "}\n";
+	return dot;
+}
+
+controlFlowGraph intel8080::recoverControlFlow(const byte *const memory, const std::vector<bytePair>& entryPoints, const cfgOptions& options /* = cfgOptions() */)
+{
+	controlFlowGraph graph;
+	analysis a(memory, options, graph);
+
+	for(const bytePair entry : entryPoints)
+		a.addEntry(entry);
+
+	for(int n = 0; n < 8; ++n)
+	{
+		if(options.interruptVectors >> n & 1) a.addEntry(8 * n);
+	}
+
+	a.run();
+	return graph;
+}
+
+void intel8080::findUsedFlags(const instruction *const instructions, const std::uint32_t count, byte *const used, const byte liveOut /* = flagMask::all */) noexcept
+{
+	byte live = liveOut;
+
+	for(std::uint32_t i = count; i-- > 0;)
+	{
+		const opcodeInfo& info = opcodes[instructions[i].opcode];
+
+		used[i] = live & info.flagsWritten;
+		live = (live & ~info.flagsWritten) | info.flagsRead;
+	}
+}
@@ -0,0 +1,198 @@
+/**
+ * @file cfg.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Recovers basic blocks, the call graph and jump targets from an Intel
+   8080 memory image, starting from known entry points.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./disassembler.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief What the analysis concluded about a byte of memory.
+	 */
+	enum class byteKind : byte
+	{
+		unknown,	// Never reached or referenced.
+		opcode,		// The first byte of an instruction.
+		operand,	// A later byte of an instruction.
+		data		// Read or written by an instruction, or part of a jump table.
+	};
+
+	/**
+	 * @brief A maximal sequence of instructions with one entry at the top and
+	   one exit at the bottom. Blocks also end at calls and restarts, so that
+	   every control transfer is at the end of a block.
+	 */
+	struct basicBlock
+	{
+		/**
+		 * @brief The address of the first instruction.
+		 */
+		bytePair begin;
+
+		/**
+		 * @brief The number of bytes in the block. `begin + size` is the
+		   address after the last instruction, which may wrap around to 0.
+		 */
+		std::uint32_t size;
+
+		/**
+		 * @brief The range of the block's instructions in
+		   `controlFlowGraph::instructions`.
+		 */
+		std::uint32_t firstInstruction, instructionCount;
+
+		/**
+		 * @brief The flow type of the last instruction.
+		 */
+		flowType exit;
+
+		/**
+		 * @brief The blocks control can continue to within the same function,
+		   including the return site of a call and the resolved targets of a
+		   `pchl` or `ret`.
+		 */
+		std::vector<bytePair> successors;
+
+		/**
+		 * @brief The address called, if the block ends in a call or `rst`.
+		 */
+		bool hasCallee = false;
+		bytePair callee = 0;
+
+		/**
+		 * @brief Set if the block ends in a `pchl` whose targets could not be
+		   found.
+		 */
+		bool unresolved = false;
+	};
+
+	/**
+	 * @brief Options for `recoverControlFlow`.
+	 */
+	struct cfgOptions
+	{
+		/**
+		 * @brief Bit `n` makes `rst n` (address 8n) an entry point, for
+		   vectors used by hardware interrupts.
+		 */
+		byte interruptVectors = 0;
+
+		/**
+		 * @brief The range that can contain code. Jump table entries outside
+		   it end the table.
+		 */
+		bytePair codeBegin = 0x0000;
+		std::uint32_t codeEnd = 0x10000;
+
+		/**
+		 * @brief The most entries read from one jump table.
+		 */
+		std::size_t maxJumpTableEntries = 128;
+	};
+
+	/**
+	 * @brief The control flow graph of a memory image.
+	 */
+	struct controlFlowGraph
+	{
+		/**
+		 * @brief Every instruction found, in address order.
+		 */
+		std::vector<instruction> instructions;
+
+		/**
+		 * @brief Every basic block, in address order.
+		 */
+		std::vector<basicBlock> blocks;
+
+		/**
+		 * @brief Each function entry point (the given entry points, interrupt
+		   vectors, and the targets of calls and `rst`s) with the functions it
+		   calls.
+		 */
+		std::map<bytePair, std::vector<bytePair>> callGraph;
+
+		/**
+		 * @brief The targets found for each resolved `pchl` or `ret`, by its
+		   address.
+		 */
+		std::map<bytePair, std::vector<bytePair>> indirectTargets;
+
+		/**
+		 * @brief Addresses where an instruction was found to start inside
+		   another, or in data.
+		 */
+		std::vector<bytePair> conflicts;
+
+		/**
+		 * @brief The classification of every byte of memory.
+		 */
+		std::vector<byteKind> kinds;
+
+		/**
+		 * @param address `bytePair` An address.
+		 * @return `const basicBlock*` The block starting at `address`, or
+		   `nullptr` if there is none.
+		 */
+		const basicBlock* blockAt(const bytePair address) const noexcept;
+
+		/**
+		 * @brief Writes the graph in Graphviz DOT format. Each block is a node;
+		   control flow edges are solid and calls are dashed.
+		 *
+		 * @param withInstructions `bool` Whether to list each block's
+		   instructions in its node.
+		 * @return `std::string` The DOT source.
+		 */
+		std::string toDot(const bool withInstructions = true) const;
+	};
+
+	/**
+	 * @brief Finds the code reachable from `entryPoints`.
+	 * Calls are assumed to return to the following instruction. A `pchl` is
+	   followed if HL is a constant within its block, or if it is loaded from a
+	   table of addresses indexed within its block (e.g. `lxi h,table; dad d;
+	   mov e,m; inx h; mov d,m; xchg; pchl`); such a table is read until an
+	   entry falls outside the code range or the table reaches known code.
+	   A `ret` is followed if it returns to an address pushed in its block
+	   (e.g. `lxi h,next; push h; ret`).
+	 *
+	 * @param memory `const byte*` 65536 bytes of memory.
+	 * @param entryPoints `const std::vector<bytePair>&` Where execution can begin.
+	 * @param options `const cfgOptions&` See `cfgOptions`.
+	 * @return `controlFlowGraph` The recovered graph.
+	 */
+	controlFlowGraph recoverControlFlow(const byte* memory, const std::vector<bytePair>& entryPoints, const cfgOptions& options = cfgOptions());
+
+	/**
+	 * @brief Finds which of the flags written by each instruction of a
+	   straight-line sequence are used: read by a later instruction before
+	   being written again, or still set when the sequence ends. The others
+	   need not be computed.
+	 *
+	 * @param instructions `const instruction*` The sequence, e.g. part of a block.
+	 * @param count `std::uint32_t` The number of instructions.
+	 * @param used `byte*` Set to the `flagMask` of the used flags written by
+	   each instruction.
+	 * @param liveOut `const byte = flagMask::all` The flags that may be read
+	   after the sequence.
+	 */
+	void findUsedFlags(const instruction* instructions, const std::uint32_t count, byte* used, const byte liveOut = flagMask::all) noexcept;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file cfgtest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks control flow recovery on a small hand-built image: its
+   blocks, calls, a jump table followed through `pchl`, a computed return
+   and a `pchl` that cannot be followed; and which flags `findUsedFlags`
+   finds are used.
+   Usage: cfgtest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./cfg.hpp"
+#include "./check.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	void place(std::vector<byte>& memory, const bytePair address, const std::initializer_list<int> bytes)
+	{
+		std::copy(bytes.begin(), bytes.end(), memory.begin() + address);
+	}
+
+	bool sameTargets(std::vector<bytePair> actual, const std::vector<bytePair>& expected)
+	{
+		std::sort(actual.begin(), actual.end());
+		return actual == expected;
+	}
+}
+
+int main(void)
+{
+	std::vector<byte> memory(0x10000);
+
+	place(memory, 0x0100, {
+		0x31, 0x00, 0x80,	// 0100 lxi sp, 8000h
+		0xcd, 0x20, 0x01,	// 0103 call dispatch
+		0xcd, 0x40, 0x01,	// 0106 call unknown
+		0x21, 0x0f, 0x01,	// 0109 lxi h, done
+		0xe5,				// 010c push h
+		0xc9,				// 010d ret
+		0x00,				// 010e (never reached)
+		0x76,				// 010f done: hlt
+		0xc3, 0x0f, 0x01	// 0110 jmp done, after an interrupt
+	});
+
+	// A jump through a table indexed by DE
+	place(memory, 0x0120, {
+		0x21, 0x30, 0x01,	// 0120 dispatch: lxi h, table
+		0x19,				// 0123 dad d
+		0x5e,				// 0124 mov e, m
+		0x23,				// 0125 inx h
+		0x56,				// 0126 mov d, m
+		0xeb,				// 0127 xchg
+		0xe9				// 0128 pchl
+	});
+
+	place(memory, 0x0130, {
+		0x36, 0x01,			// 0130 table: first
+		0x38, 0x01,			// 0132 second
+		0x00, 0x00,			// 0134 outside the code: the end of the table
+		0xc9,				// 0136 first: ret
+		0x00,				// 0137
+		0x3e, 0x01,			// 0138 second: mvi a, 1
+		0xc9				// 013a ret
+	});
+
+	// A jump to an address popped from the stack
+	place(memory, 0x0140, {
+		0xe1,				// 0140 unknown: pop h
+		0xe9				// 0141 pchl
+	});
+
+	// An interrupt handler at rst 7
+	place(memory, 0x0038, {
+		0xfb,				// 0038 ei
+		0xc9				// 0039 ret
+	});
+
+	cfgOptions options;
+	options.interruptVectors = 0x80;
+	options.codeBegin = 0x0100;
+	options.codeEnd = 0x0200;
+
+	const controlFlowGraph graph = recoverControlFlow(memory.data(), {0x0100}, options);
+
+	std::vector<bytePair> begins;
+	for(const basicBlock& b : graph.blocks) begins.push_back(b.begin);
+
+	CHECK(begins == std::vector<bytePair>({0x0038, 0x0100, 0x0106, 0x0109, 0x010f, 0x0110, 0x0120, 0x0136, 0x0138, 0x0140}));
+
+	// Blocks end at calls, whose return sites follow them
+	if(const basicBlock *const b = graph.blockAt(0x0100); CHECK(b != nullptr))
+	{
+		CHECK(b->size == 6 and b->instructionCount == 2);
+		CHECK(b->exit == flowType::call and b->hasCallee and b->callee == 0x0120);
+		CHECK(b->successors == std::vector<bytePair>({0x0106}));
+	}
+
+	// The return to an address pushed in the same block
+	if(const basicBlock *const b = graph.blockAt(0x0109); CHECK(b != nullptr))
+	{
+		CHECK(b->size == 5 and b->exit == flowType::ret and not b->unresolved);
+		CHECK(b->successors == std::vector<bytePair>({0x010f}));
+		CHECK(graph.indirectTargets.count(0x010d) and graph.indirectTargets.at(0x010d) == std::vector<bytePair>({0x010f}));
+	}
+
+	// The jump table, read up to the entry outside the code
+	if(const basicBlock *const b = graph.blockAt(0x0120); CHECK(b != nullptr))
+	{
+		CHECK(b->size == 9 and b->instructionCount == 7);
+		CHECK(b->exit == flowType::indirectJump and not b->unresolved);
+		CHECK(sameTargets(b->successors, {0x0136, 0x0138}));
+		CHECK(graph.indirectTargets.count(0x0128) and sameTargets(graph.indirectTargets.at(0x0128), {0x0136, 0x0138}));
+	}
+
+	if(const basicBlock *const b = graph.blockAt(0x0140); CHECK(b != nullptr))
+	{
+		CHECK(b->unresolved and b->successors.empty());
+		CHECK(not graph.indirectTargets.count(0x0141));
+	}
+
+	// `hlt` continues after an interrupt
+	if(const basicBlock *const b = graph.blockAt(0x010f); CHECK(b != nullptr))
+		CHECK(b->exit == flowType::halt and b->successors == std::vector<bytePair>({0x0110}));
+
+	CHECK(graph.blockAt(0x0121) == nullptr);
+	CHECK(graph.blockAt(0x010e) == nullptr);
+
+	// Functions: the entry point, what it calls and the interrupt vector
+	CHECK(graph.callGraph.size() == 4);
+	CHECK(graph.callGraph.count(0x0100) and sameTargets(graph.callGraph.at(0x0100), {0x0120, 0x0140}));
+	CHECK(graph.callGraph.count(0x0038) and graph.callGraph.count(0x0120) and graph.callGraph.count(0x0140));
+
+	// Bytes
+	CHECK(graph.kinds[0x0100] == byteKind::opcode and graph.kinds[0x0101] == byteKind::operand and graph.kinds[0x0102] == byteKind::operand);
+	CHECK(std::all_of(&graph.kinds[0x0130], &graph.kinds[0x0134], [](const byteKind k){ return k == byteKind::data; }));
+	CHECK(graph.kinds[0x010e] == byteKind::unknown and graph.kinds[0x0137] == byteKind::unknown);
+	CHECK(graph.conflicts.empty());
+
+	CHECK(graph.toDot().find("digraph") != std::string::npos);
+
+	// add b; adc c; ora a; rar; jz: the carry of `add` is read by `adc`,
+	// whose flags are all written again by `ora`; `rar` only writes the carry
+	{
+		const instruction sequence[] = {
+			{0, 0x80, 1, 0},
+			{1, 0x89, 1, 0},
+			{2, 0xb7, 1, 0},
+			{3, 0x1f, 1, 0},
+			{4, 0xca, 3, 0}
+		};
+
+		byte used[5];
+		findUsedFlags(sequence, 5, used);
+
+		CHECK(used[0] == flagMask::carry);
+		CHECK(used[1] == flagMask::none);
+		CHECK(used[2] == flagMask::all);
+		CHECK(used[3] == flagMask::carry);
+		CHECK(used[4] == flagMask::none);
+
+		// With nothing read after the sequence, `jz` still reads the zero flag
+		findUsedFlags(sequence, 5, used, flagMask::none);
+		CHECK(used[2] == (flagMask::zero | flagMask::carry) and used[3] == flagMask::none);
+	}
+
+	return checks::summary("cfgtest");
+}
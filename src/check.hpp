@@ -0,0 +1,110 @@
+/**
+ * @file check.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief What the small test programs run by `ctest` share: counting and
+   reporting failed checks, and a scratch directory.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <filesystem>
+
+#include <unistd.h>
+
+/**
+ * @brief Counts `condition` as checked, and reports it with its line if it
+   is false. Testing carries on either way.
+ */
+#define CHECK(condition) \
+	intel8080::checks::record((condition), #condition, __FILE__, __LINE__)
+
+namespace intel8080
+{
+	namespace checks
+	{
+		inline std::uint64_t checked = 0;
+		inline std::uint64_t failed = 0;
+
+		inline bool record(const bool passed, const char* text, const char* file, const int line) noexcept
+		{
+			++checked;
+
+			if(not passed)
+			{
+				++failed;
+				std::printf("%s:%d: failed: %s\n", file, line, text);
+			}
+
+			return passed;
+		}
+
+		/**
+		 * @brief Prints how many checks failed.
+		 * @return `int` The exit status: 1 if any check failed.
+		 */
+		inline int summary(const char* name) noexcept
+		{
+			std::printf("%s: %llu checks, %llu failed\n", name,
+				(unsigned long long)checked, (unsigned long long)failed);
+
+			return failed ? 1 : 0;
+		}
+	}
+
+	/**
+	 * @brief A new, empty directory under the system's temporary directory,
+	   removed with everything in it when this is destroyed.
+	 */
+	class scratchDirectory
+	{
+	public:
+		scratchDirectory(void)
+		{
+			std::string path = (std::filesystem::temp_directory_path() / "intel8080-XXXXXX").string();
+
+			if(mkdtemp(path.data()))
+				root = path;
+		}
+
+		~scratchDirectory()
+		{
+			std::error_code ignored;
+
+			if(not root.empty())
+				std::filesystem::remove_all(root, ignored);
+		}
+
+		bool ok(void) const noexcept
+		{
+			return not root.empty();
+		}
+
+		/**
+		 * @return `std::string` The path of `name` in the directory.
+		 */
+		std::string operator/(const std::string& name) const
+		{
+			return root + "/" + name;
+		}
+
+		const std::string& path(void) const noexcept
+		{
+			return root;
+		}
+
+	private:
+		std::string root;
+	};
+}
@@ -0,0 +1,707 @@
+/**
+ * @file cpm.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A CP/M 2.2 environment for running .COM programs on the Intel 8080
+   emulator without a real BIOS or disk.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `cpm.hpp`.
+
+#include "./cpm.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+
+#include <sys/stat.h>
+
+using namespace intel8080;
+
+namespace
+{
+	// Offsets of fields in a file control block
+	constexpr int fcbName = 1;
+	constexpr int fcbType = 9;
+	constexpr int fcbExtent = 12;
+	constexpr int fcbS2 = 14;
+	constexpr int fcbRecordCount = 15;
+	constexpr int fcbCurrentRecord = 32;
+	constexpr int fcbRandomRecord = 33;
+
+	constexpr std::size_t recordSize = 128;
+
+	// Returned in A by file functions that fail
+	constexpr byte failure = 0xff;
+
+	bool fileExists(const std::string& path) noexcept
+	{
+		struct stat st;
+		return stat(path.c_str(), &st) == 0;
+	}
+}
+
+cpm::cpm(const std::string& dir /* = "." */)
+:
+	memory(0x10000),
+	machine([](const byte){ return (byte)0; }, [](const byte, const byte){}, memory.data()),
+	consoleOutput([](const char* data, const std::size_t size){ std::fwrite(data, 1, size, stdout); std::fflush(stdout); }),
+	consoleInput([](){ return std::getchar(); }),
+	directory(dir)
+{
+	outputBuffer.reserve(outputBufferSize);
+}
+
+cpm::~cpm()
+{
+	flush();
+
+	for(const auto& file : files)
+	{
+		std::fclose(file.second);
+	}
+}
+
+bool cpm::loadComFile(const std::string& filename, const std::string& commandTail /* = "" */)
+{
+	std::fill(memory.begin(), memory.end(), 0);
+
+	if(not machine.loadComFile(filename))
+		return false;
+
+	warmBooted = false;
+	dma = 0x0080;
+
+	// 0x0000: JMP WBOOT
+	memory[0x0000] = 0xc3;
+	memory[0x0001] = (biosBase + 3) % 0x100;
+	memory[0x0002] = (biosBase + 3) / 0x100;
+
+	// 0x0005: JMP BDOS
+	memory[0x0005] = 0xc3;
+	memory[0x0006] = bdosBase % 0x100;
+	memory[0x0007] = bdosBase / 0x100;
+
+	// The BDOS and each BIOS entry jump to themselves; they are trapped
+	// before they run, so this only matters to programs that read them
+	memory[bdosBase] = 0xc3;
+	memory[bdosBase + 1] = bdosBase % 0x100;
+	memory[bdosBase + 2] = bdosBase / 0x100;
+
+	for(int entry = 0; entry < 17; ++entry)
+	{
+		const bytePair adr = biosBase + 3 * entry;
+		memory[adr] = 0xc3;
+		memory[adr + 1] = adr % 0x100;
+		memory[adr + 2] = adr / 0x100;
+	}
+
+	// Default FCBs from the first two arguments, and the command tail
+	std::string tail;
+	std::vector<std::string> args;
+
+	for(std::size_t i = 0; i < commandTail.size(); )
+	{
+		while(i < commandTail.size() and commandTail[i] == ' ') ++i;
+		const std::size_t begin = i;
+		while(i < commandTail.size() and commandTail[i] != ' ') ++i;
+		if(i > begin) args.push_back(commandTail.substr(begin, i - begin));
+	}
+
+	for(const auto& arg : args)
+	{
+		tail += ' ';
+		for(const char c : arg) tail += std::toupper((unsigned char)c);
+	}
+
+	tail.resize(std::min<std::size_t>(tail.size(), 0x7f));
+
+	parseFcb(0x005c, args.size() > 0 ? args[0] : "");
+	parseFcb(0x006c, args.size() > 1 ? args[1] : "");
+
+	memory[0x0080] = tail.size();
+	std::copy(tail.begin(), tail.end(), memory.begin() + 0x0081);
+
+	return true;
+}
+
+bool cpm::step(void)
+{
+	if(warmBooted)
+		return false;
+
+	const bytePair pc = machine.PC;
+
+	if(pc != 0x0000 and pc != bdosEntry and pc < bdosBase)
+	{
+		machine.step();
+	}
+	else if(pc == bdosEntry or pc == bdosBase)
+	{
+		bdos();
+	}
+	else if(pc >= biosBase and pc < biosBase + 3 * 17 and (pc - biosBase) % 3 == 0)
+	{
+		bios((pc - biosBase) / 3);
+	}
+	else if(pc == 0x0000)
+	{
+		warmBooted = true;
+		flush();
+		return false;
+	}
+	else
+	{
+		machine.step();
+	}
+
+	return not warmBooted;
+}
+
+std::uint64_t cpm::run(const std::uint64_t maxSteps /* = UINT64_MAX */)
+{
+	std::uint64_t steps = 0;
+
+	while(steps < maxSteps and step())
+	{
+		++steps;
+	}
+
+	return steps;
+}
+
+void cpm::flush(void)
+{
+	if(not outputBuffer.empty())
+	{
+		consoleOutput(outputBuffer.data(), outputBuffer.size());
+		outputBuffer.clear();
+	}
+}
+
+bool cpm::getWarmBooted(void) noexcept
+{
+	return warmBooted;
+}
+
+void cpm::ret(void) noexcept
+{
+	machine.PC = machine.read16(machine.SP);
+	machine.SP += 2;
+}
+
+void cpm::returnValue(const bytePair value) noexcept
+{
+	machine.HL() = value;
+	machine.A() = machine.L();
+	machine.B() = machine.H();
+}
+
+void cpm::putChar(const char c)
+{
+	outputBuffer += c;
+
+	if(outputBuffer.size() >= outputBufferSize)
+		flush();
+}
+
+byte cpm::getChar(void)
+{
+	// Make sure any prompt is visible before waiting for input
+	flush();
+
+	const int c = consoleInput();
+	return c == EOF ? 0x1a : c;
+}
+
+void cpm::bdos(void)
+{
+	const bytePair de = machine.DE();
+	const byte e = machine.E();
+
+	switch(machine.C())
+	{
+		// System reset
+		case 0:
+			warmBooted = true;
+			flush();
+			return;
+
+		// Console input
+		case 1:
+		{
+			const byte c = getChar();
+			putChar(c);
+			returnValue(c);
+			break;
+		}
+
+		// Console output
+		case 2:
+			putChar(e);
+			returnValue(0);
+			break;
+
+		// Reader input
+		case 3:
+			returnValue(0x1a);
+			break;
+
+		// Punch output, list output
+		case 4:
+		case 5:
+			returnValue(0);
+			break;
+
+		// Direct console I/O
+		case 6:
+			if(e == 0xff)
+				returnValue(getChar());
+			else if(e == 0xfe)
+				returnValue(0);
+			else
+			{
+				putChar(e);
+				returnValue(0);
+			}
+			break;
+
+		// Get IOBYTE, set IOBYTE
+		case 7:
+		case 8:
+			returnValue(0);
+			break;
+
+		// Print string
+		case 9:
+		{
+			const byte *const begin = memory.data() + de;
+			const byte *const end = (const byte*)std::memchr(begin, '$', memory.size() - de);
+			const std::size_t length = end ? end - begin : memory.size() - de;
+
+			if(outputBuffer.size() + length > outputBufferSize)
+				flush();
+
+			outputBuffer.append((const char*)begin, length);
+			returnValue(0);
+			break;
+		}
+
+		// Read console buffer
+		case 10:
+		{
+			const byte maxLength = memory[de];
+			byte length = 0;
+
+			while(length < maxLength)
+			{
+				const byte c = getChar();
+				if(c == '\r' or c == '\n' or c == 0x1a) break;
+				memory[(bytePair)(de + 2 + length++)] = c;
+			}
+
+			memory[(bytePair)(de + 1)] = length;
+			returnValue(0);
+			break;
+		}
+
+		// Get console status
+		case 11:
+			returnValue(0);
+			break;
+
+		// Return version number
+		case 12:
+			returnValue(0x0022);
+			break;
+
+		// Reset disk system
+		case 13:
+			dma = 0x0080;
+			returnValue(0);
+			break;
+
+		// Select disk
+		case 14:
+			returnValue(0);
+			break;
+
+		// Open file
+		case 15:
+		{
+			std::FILE *const file = openFile(de);
+
+			if(file)
+			{
+				std::fseek(file, 0, SEEK_END);
+				const long records = (std::ftell(file) + recordSize - 1) / recordSize;
+				const long inExtent = records - 128L * (memory[(bytePair)(de + fcbExtent)] & 0x1f);
+
+				memory[(bytePair)(de + fcbS2)] = 0;
+				memory[(bytePair)(de + fcbRecordCount)] = std::clamp(inExtent, 0L, 128L);
+			}
+
+			returnValue(file ? 0 : failure);
+			break;
+		}
+
+		// Close file
+		case 16:
+		{
+			const std::string path = hostPath(de);
+			returnValue(not path.empty() and (closeFile(path) or fileExists(path)) ? 0 : failure);
+			break;
+		}
+
+		// Search for first, search for next
+		case 17:
+		case 18:
+			returnValue(failure);
+			break;
+
+		// Delete file
+		case 19:
+		{
+			const std::string path = hostPath(de);
+			closeFile(path);
+			returnValue(not path.empty() and std::remove(path.c_str()) == 0 ? 0 : failure);
+			break;
+		}
+
+		// Read sequential, write sequential
+		case 20:
+		case 21:
+		{
+			byte& ex = memory[(bytePair)(de + fcbExtent)];
+			byte& s2 = memory[(bytePair)(de + fcbS2)];
+			byte& cr = memory[(bytePair)(de + fcbCurrentRecord)];
+
+			const std::uint32_t record = (s2 & 0x3f) * 4096U + (ex & 0x1f) * 128U + (cr & 0x7f);
+			const byte error = transferRecord(de, record, machine.C() == 21);
+
+			if(error == 0 and ++cr == 128)
+			{
+				cr = 0;
+
+				if(++ex == 32)
+				{
+					ex = 0;
+					++s2;
+				}
+			}
+
+			returnValue(error);
+			break;
+		}
+
+		// Make file
+		case 22:
+		{
+			const std::string path = hostPath(de);
+			closeFile(path);
+
+			std::FILE *const file = path.empty() ? nullptr : std::fopen(path.c_str(), "w+b");
+			if(file) files[path] = file;
+
+			returnValue(file ? 0 : failure);
+			break;
+		}
+
+		// Rename file; the new name is in the second half of the FCB
+		case 23:
+		{
+			const std::string from = hostPath(de);
+			const std::string to = hostPath(de + 16);
+			closeFile(from);
+			returnValue(not from.empty() and not to.empty() and std::rename(from.c_str(), to.c_str()) == 0 ? 0 : failure);
+			break;
+		}
+
+		// Return login vector (only drive A)
+		case 24:
+			returnValue(0x0001);
+			break;
+
+		// Return current disk
+		case 25:
+			returnValue(0);
+			break;
+
+		// Set DMA address
+		case 26:
+			dma = de;
+			returnValue(0);
+			break;
+
+		// Get/set user code
+		case 32:
+			returnValue(0);
+			break;
+
+		// Read random, write random, write random with zero fill
+		case 33:
+		case 34:
+		case 40:
+		{
+			const byte *const r = memory.data() + (bytePair)(de + fcbRandomRecord);
+			const std::uint32_t record = r[0] + r[1] * 0x100U;
+
+			// Random access leaves the sequential position at the record
+			memory[(bytePair)(de + fcbCurrentRecord)] = record % 128;
+			memory[(bytePair)(de + fcbExtent)] = record / 128 % 32;
+			memory[(bytePair)(de + fcbS2)] = record / 4096;
+
+			const byte error = transferRecord(de, record, machine.C() != 33);
+			returnValue(error == 1 ? 6 : error);
+			break;
+		}
+
+		// Compute file size
+		case 35:
+		{
+			std::FILE *const file = openFile(de);
+			if(not file)
+			{
+				returnValue(failure);
+				break;
+			}
+
+			std::fseek(file, 0, SEEK_END);
+			const long records = (std::ftell(file) + recordSize - 1) / recordSize;
+
+			memory[(bytePair)(de + fcbRandomRecord)] = records % 0x100;
+			memory[(bytePair)(de + fcbRandomRecord + 1)] = records / 0x100 % 0x100;
+			memory[(bytePair)(de + fcbRandomRecord + 2)] = records / 0x10000;
+			returnValue(0);
+			break;
+		}
+
+		// Set random record
+		case 36:
+		{
+			const std::uint32_t record
+				= (memory[(bytePair)(de + fcbS2)] & 0x3f) * 4096U
+				+ (memory[(bytePair)(de + fcbExtent)] & 0x1f) * 128U
+				+ (memory[(bytePair)(de + fcbCurrentRecord)] & 0x7f);
+
+			memory[(bytePair)(de + fcbRandomRecord)] = record % 0x100;
+			memory[(bytePair)(de + fcbRandomRecord + 1)] = record / 0x100;
+			memory[(bytePair)(de + fcbRandomRecord + 2)] = 0;
+			returnValue(0);
+			break;
+		}
+
+		// Anything else does nothing
+		default:
+			returnValue(0);
+			break;
+	}
+
+	ret();
+}
+
+void cpm::bios(const int entry)
+{
+	switch(entry)
+	{
+		// BOOT, WBOOT
+		case 0:
+		case 1:
+			warmBooted = true;
+			flush();
+			return;
+
+		// CONST
+		case 2:
+			machine.A() = 0;
+			break;
+
+		// CONIN
+		case 3:
+			machine.A() = getChar();
+			break;
+
+		// CONOUT
+		case 4:
+			putChar(machine.C());
+			break;
+
+		// READER
+		case 7:
+			machine.A() = 0x1a;
+			break;
+
+		// LISTST
+		case 15:
+			machine.A() = 0xff;
+			break;
+
+		// SECTRAN: no translation
+		case 16:
+			machine.HL() = machine.BC();
+			break;
+
+		// Disk functions fail: there is no disk
+		case 9:
+			machine.HL() = 0;
+			break;
+
+		case 13:
+		case 14:
+			machine.A() = 1;
+			break;
+
+		// LIST, PUNCH, HOME, SETTRK, SETSEC, SETDMA do nothing
+		default:
+			break;
+	}
+
+	ret();
+}
+
+std::string cpm::hostPath(const bytePair fcb)
+{
+	std::string name;
+	bool valid = true;
+
+	const auto append = [&](const int offset, const int length)
+	{
+		for(int i = 0; i < length; ++i)
+		{
+			// Bit 7 of each character is used for file attributes
+			const char c = memory[(bytePair)(fcb + offset + i)] & 0x7f;
+			if(c == ' ') break;
+
+			// Control characters, the delimiters and wildcards CP/M does not
+			// allow in names, and the host's path separators
+			if(c < ' ' or c == 0x7f or std::strchr("<>.,;:=?*[]|/\\", c))
+				valid = false;
+
+			name += c;
+		}
+	};
+
+	append(fcbName, 8);
+
+	if((memory[(bytePair)(fcb + fcbType)] & 0x7f) != ' ')
+	{
+		name += '.';
+		append(fcbType, 3);
+	}
+
+	if(not valid or name.empty() or name[0] == '.')
+		return std::string();
+
+	const std::string upper = directory + '/' + name;
+
+	std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c){ return std::tolower(c); });
+	const std::string lower = directory + '/' + name;
+
+	return not fileExists(upper) and fileExists(lower) ? lower : upper;
+}
+
+std::FILE* cpm::openFile(const bytePair fcb)
+{
+	const std::string path = hostPath(fcb);
+
+	if(path.empty())
+		return nullptr;
+
+	const auto found = files.find(path);
+
+	if(found != files.end())
+		return found->second;
+
+	std::FILE* file = std::fopen(path.c_str(), "r+b");
+	if(not file) file = std::fopen(path.c_str(), "rb");
+	if(file) files[path] = file;
+
+	return file;
+}
+
+bool cpm::closeFile(const std::string& path)
+{
+	const auto found = files.find(path);
+
+	if(found == files.end())
+		return false;
+
+	std::fclose(found->second);
+	files.erase(found);
+	return true;
+}
+
+byte cpm::transferRecord(const bytePair fcb, const std::uint32_t record, const bool write)
+{
+	std::FILE *const file = openFile(fcb);
+
+	if(not file)
+		return failure;
+
+	// Records that would run past the end of memory are not transferred
+	if(dma + recordSize > memory.size())
+		return write ? 2 : 1;
+
+	byte *const buffer = memory.data() + dma;
+	std::fseek(file, record * recordSize, SEEK_SET);
+
+	if(write)
+	{
+		return std::fwrite(buffer, 1, recordSize, file) == recordSize ? 0 : 2;
+	}
+
+	const std::size_t read = std::fread(buffer, 1, recordSize, file);
+
+	if(read == 0)
+		return 1;
+
+	// A partial last record is padded with Ctrl-Z, CP/M's end of text marker
+	std::fill(buffer + read, buffer + recordSize, 0x1a);
+	return 0;
+}
+
+void cpm::parseFcb(const bytePair fcb, const std::string& arg) noexcept
+{
+	byte *const f = memory.data() + fcb;
+
+	std::fill(f, f + 16, 0);
+	std::fill(f + fcbName, f + fcbName + 11, ' ');
+
+	std::string name = arg;
+
+	// Drive prefix, e.g. "B:FOO.TXT"
+	if(name.size() >= 2 and name[1] == ':')
+	{
+		f[0] = std::toupper((unsigned char)name[0]) - 'A' + 1;
+		name = name.substr(2);
+	}
+
+	const std::size_t dot = name.find('.');
+	const std::string base = name.substr(0, dot);
+	const std::string type = dot == std::string::npos ? "" : name.substr(dot + 1);
+
+	// A '*' matches the rest of the name or type
+	const auto fill = [](byte *const field, const std::string& text, const std::size_t length)
+	{
+		for(std::size_t i = 0; i < text.size() and i < length; ++i)
+		{
+			if(text[i] == '*')
+			{
+				std::fill(field + i, field + length, '?');
+				break;
+			}
+
+			field[i] = std::toupper((unsigned char)text[i]);
+		}
+	};
+
+	fill(f + fcbName, base, 8);
+	fill(f + fcbType, type, 3);
+}
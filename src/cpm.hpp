@@ -0,0 +1,252 @@
+/**
+ * @file cpm.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A CP/M 2.2 environment for running .COM programs on the Intel 8080
+   emulator without a real BIOS or disk.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+#include <map>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace intel8080
+{
+	/**
+	 * @brief Runs CP/M 2.2 programs with the BDOS and BIOS implemented natively.
+	 * Calls to the BDOS entry point (0x0005) and to the BIOS jump table are
+	   trapped before they are executed and handled in C++, after which a `ret`
+	   is performed on the program's behalf. A jump to 0x0000 (warm boot) ends
+	   the program.
+	 * Files opened by the program are read from and written to a directory on
+	   the host. Drives, user numbers and directory searches are not supported.
+	 * @see http://www.gaby.de/cpm/manuals/archive/cpm22htm/ch5.htm
+	 */
+	class cpm
+	{
+	public:
+		/**
+		 * @brief The BDOS entry point called by programs.
+		 */
+		static constexpr bytePair bdosEntry = 0x0005;
+
+		/**
+		 * @brief The address of the BDOS. The word at 0x0006 points here, so
+		   this is also the top of the transient program area.
+		 */
+		static constexpr bytePair bdosBase = 0xfe00;
+
+		/**
+		 * @brief The address of the BIOS jump table. The word at 0x0001 points
+		   to its warm boot entry.
+		 */
+		static constexpr bytePair biosBase = 0xff00;
+
+		/**
+		 * @brief The size of the console output buffer. Output is passed to
+		   `consoleOutput` whenever this much has accumulated.
+		 */
+		static constexpr std::size_t outputBufferSize = 0x10000;
+
+		/**
+		 * @brief The RAM of `machine`.
+		 */
+		std::vector<byte> memory;
+
+		/**
+		 * @brief The CPU running the program. Its port handlers may be
+		   replaced; by default `in` returns 0 and `out` does nothing.
+		 */
+		cpu machine;
+
+		/**
+		 * @brief Receives console output in large blocks.
+		 * Defaults to writing to `stdout`.
+		 * @param data `const char*` The characters written.
+		 * @param size `std::size_t` The number of characters written.
+		 */
+		std::function<void(const char* data, std::size_t size)> consoleOutput;
+
+		/**
+		 * @brief Provides console input, one character at a time.
+		 * Defaults to reading from `stdin`.
+		 * @return `int` The next character, or `EOF` if there is none.
+		 */
+		std::function<int(void)> consoleInput;
+
+		/**
+		 * @brief Construct a new CP/M environment.
+		 *
+		 * @param directory `const std::string& = "."` The host directory in
+		   which the program's files are opened and created.
+		 */
+		cpm(const std::string& directory = ".");
+
+		/**
+		 * @brief Flushes console output and closes all files the program left open.
+		 */
+		~cpm();
+
+		/**
+		 * @brief Loads a .COM program and prepares to run it.
+		 * Page zero is rebuilt, the program is loaded at 0x0100, and the command
+		   tail and default FCBs are filled in from `commandTail`.
+		 *
+		 * @param filename `const std::string&` The name of the .COM file.
+		 * @param commandTail `const std::string& = ""` The arguments to the program.
+		 * @return `bool` Whether the load succeeded.
+		 */
+		bool loadComFile(const std::string& filename, const std::string& commandTail = "");
+
+		/**
+		 * @brief Runs the next instruction, or handles a BDOS or BIOS call if
+		   the program counter is at one.
+		 *
+		 * @return `true` The program is still running.
+		 * @return `false` The program has warm booted, i.e. exited.
+		 */
+		bool step(void);
+
+		/**
+		 * @brief Runs the program until it warm boots or `maxSteps` steps
+		   have run.
+		 *
+		 * @param maxSteps `std::uint64_t` The maximum number of steps to run.
+		 * @return `std::uint64_t` The number of steps run, where a BDOS or BIOS
+		   call counts as one step.
+		 */
+		std::uint64_t run(const std::uint64_t maxSteps = UINT64_MAX);
+
+		/**
+		 * @brief Passes all buffered console output to `consoleOutput`.
+		 */
+		void flush(void);
+
+		/**
+		 * @brief Checks whether the program has exited.
+		 *
+		 * @return `true` The program has jumped to 0x0000 or called BDOS
+		   function 0.
+		 * @return `false` The program is still running.
+		 */
+		bool getWarmBooted(void) noexcept;
+
+	private:
+		/**
+		 * @brief The host directory in which files are opened.
+		 */
+		std::string directory;
+
+		/**
+		 * @brief The address of the current DMA buffer, to and from which
+		   records are transferred.
+		 */
+		bytePair dma = 0x0080;
+
+		/**
+		 * @brief Console output that has not yet been passed to `consoleOutput`.
+		 */
+		std::string outputBuffer;
+
+		/**
+		 * @brief Files that are currently open, by host path.
+		 */
+		std::map<std::string, std::FILE*> files;
+
+		/**
+		 * @brief Set when the program warm boots.
+		 */
+		bool warmBooted = false;
+
+		/**
+		 * @brief Handles the BDOS function in register C.
+		 */
+		void bdos(void);
+
+		/**
+		 * @brief Handles a call to the BIOS jump table entry `entry`.
+		 * @param entry `const int` The number of the entry (0 for BOOT, 1 for WBOOT, etc.)
+		 */
+		void bios(const int entry);
+
+		/**
+		 * @brief Returns from a BDOS or BIOS call, as the `ret` at the end of
+		   a real one would.
+		 */
+		void ret(void) noexcept;
+
+		/**
+		 * @brief Sets the return value of a BDOS call, in both A and HL.
+		 * @param value `const bytePair` The value to return.
+		 */
+		void returnValue(const bytePair value) noexcept;
+
+		/**
+		 * @brief Writes one character to the console.
+		 * @param c `const char` The character.
+		 */
+		void putChar(const char c);
+
+		/**
+		 * @brief Reads one character from the console.
+		 * @return `byte` The character, or 0x1a (Ctrl-Z) at end of input.
+		 */
+		byte getChar(void);
+
+		/**
+		 * @brief Converts the name in an FCB to a path on the host.
+		 * If a file with the upper case name does not exist but one with the
+		   lower case name does, the lower case name is used.
+		 * @param fcb `const bytePair` The address of the FCB.
+		 * @return `std::string` The path to the file, or an empty string if
+		   the name is empty or has characters CP/M does not allow in names,
+		   including `/` and `\`, so that no name leads out of the directory.
+		 */
+		std::string hostPath(const bytePair fcb);
+
+		/**
+		 * @brief Gets the host file for an FCB, opening it if necessary.
+		 * @param fcb `const bytePair` The address of the FCB.
+		 * @return `std::FILE*` The open file, or `nullptr` if it cannot be opened.
+		 */
+		std::FILE* openFile(const bytePair fcb);
+
+		/**
+		 * @brief Closes the host file at `path` if it is open.
+		 * @param path `const std::string&` The path to the file.
+		 * @return `bool` Whether the file was open.
+		 */
+		bool closeFile(const std::string& path);
+
+		/**
+		 * @brief Reads or writes one record at the FCB's current position.
+		 * @param fcb `const bytePair` The address of the FCB.
+		 * @param record `const std::uint32_t` The record number within the file.
+		 * @param write `const bool` Whether to write instead of read.
+		 * @return `byte` The BDOS error code: 0 on success, 1 at end of file
+		   when reading, 2 if the disk is full when writing, or 0xff if the
+		   file cannot be opened.
+		 */
+		byte transferRecord(const bytePair fcb, const std::uint32_t record, const bool write);
+
+		/**
+		 * @brief Fills in an FCB from a file name typed on the command line.
+		 * @param fcb `const bytePair` The address of the FCB.
+		 * @param name `const std::string&` The file name, e.g. `FOO.TXT`.
+		 */
+		void parseFcb(const bytePair fcb, const std::string& name) noexcept;
+	};
+}
@@ -0,0 +1,141 @@
+/**
+ * @file cpm22.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Boots CP/M 2.2 from disk images, with the console on stdin and stdout.
+   Usage: cpm22 [--ccp ADDR] [--stats] [[--geometry T,S,R,B,D,K[,F]] [--readonly] IMAGE]...
+   Each IMAGE is mounted as the next drive, starting with A, whose reserved
+   tracks must hold the CCP and BDOS after a one-sector loader. --geometry
+   (tracks, sectors per track, reserved tracks, block size, directory
+   entries, skew and first sector number) and --readonly apply to the image
+   after them; the default is an 8" SSSD disk. --ccp gives the address the
+   system was built for (hex) if it cannot be found from the CCP. The
+   machine runs until console input ends; --stats then reports the
+   instructions run and the BIOS's disk transfers to stderr.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./cpmsystem.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief Parses `T,S,R,B,D,K[,F]` into `geometry`.
+	 */
+	bool parseGeometry(const char* text, diskGeometry& geometry)
+	{
+		std::uint32_t* const fields[] = {&geometry.tracks, &geometry.sectorsPerTrack, &geometry.reservedTracks,
+			&geometry.blockSize, &geometry.directoryEntries, &geometry.skew, &geometry.firstSector};
+
+		std::size_t count = 0;
+
+		for(char* end; count < std::size(fields); text = end + 1)
+		{
+			*fields[count++] = std::strtoul(text, &end, 0);
+
+			if(*end != ',')
+			{
+				if(*end != '\0') return false;
+				break;
+			}
+		}
+
+		return count >= 6 and geometry.valid();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	cpmSystem system;
+	diskGeometry geometry;
+	bool readOnly = false;
+	bool stats = false;
+	bytePair ccpBase = 0;
+	int drives = 0;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+
+		if(arg == "--geometry" and i + 1 < argc)
+		{
+			geometry = diskGeometry();
+
+			if(not parseGeometry(argv[++i], geometry))
+			{
+				std::fprintf(stderr, "cpm22: invalid geometry %s\n", argv[i]);
+				return 2;
+			}
+		}
+		else if(arg == "--readonly")
+		{
+			readOnly = true;
+		}
+		else if(arg == "--ccp" and i + 1 < argc)
+		{
+			ccpBase = std::strtoul(argv[++i], nullptr, 16);
+		}
+		else if(arg == "--stats")
+		{
+			stats = true;
+		}
+		else if(arg[0] == '-')
+		{
+			std::fprintf(stderr, "usage: %s [--ccp ADDR] [--stats] [[--geometry T,S,R,B,D,K[,F]] [--readonly] IMAGE]...\n", argv[0]);
+			return 2;
+		}
+		else
+		{
+			if(drives == cpmSystem::maxDrives or not system.mount(drives, arg, geometry, readOnly))
+			{
+				std::fprintf(stderr, "cpm22: cannot mount %s as drive %c\n", arg.c_str(), 'A' + drives);
+				return 2;
+			}
+
+			++drives;
+			geometry = diskGeometry();
+			readOnly = false;
+		}
+	}
+
+	if(drives == 0)
+	{
+		std::fprintf(stderr, "usage: %s [--ccp ADDR] [--stats] [[--geometry T,S,R,B,D,K[,F]] [--readonly] IMAGE]...\n", argv[0]);
+		return 2;
+	}
+
+	if(not system.boot(ccpBase))
+	{
+		std::fprintf(stderr, "cpm22: cannot boot from drive A: no CP/M 2.2 system found, or the BIOS does not fit above it\n");
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const std::uint64_t instructions = system.run();
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if(stats)
+	{
+		const cpmSystem::statistics& s = system.getStatistics();
+
+		std::fprintf(stderr, "\n%llu instructions in %.3f s (%.1f MIPS), %llu BIOS calls, %llu sectors read, %llu written, %llu warm boots\n",
+			(unsigned long long)instructions, seconds, instructions / seconds / 1e6, (unsigned long long)s.biosCalls,
+			(unsigned long long)s.sectorsRead, (unsigned long long)s.sectorsWritten, (unsigned long long)s.warmBoots);
+	}
+
+	return 0;
+}
@@ -0,0 +1,441 @@
+/**
+ * @file cpmsystem.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A CP/M 2.2 machine that boots the CCP and BDOS from a disk image,
+   with the BIOS implemented natively.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `cpmsystem.hpp`.
+
+#include "./cpmsystem.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <poll.h>
+
+using namespace intel8080;
+
+namespace
+{
+	// Sizes of the BIOS's tables
+	constexpr std::uint32_t headerSize = 16;
+	constexpr std::uint32_t parameterBlockSize = 15;
+	constexpr std::uint32_t directoryBufferSize = 128;
+
+	/**
+	 * @brief The offset of `ccpstart` in the CCP of CP/M 2.2, which its
+	   first instruction jumps to.
+	 */
+	constexpr bytePair ccpStart = 0x035c;
+
+	/**
+	 * @brief The offset of the BDOS entry point, after its serial number.
+	 */
+	constexpr bytePair bdosEntry = 6;
+
+	void word(byte *const p, const bytePair value) noexcept
+	{
+		p[0] = value % 0x100;
+		p[1] = value / 0x100;
+	}
+}
+
+cpmSystem::cpmSystem(void)
+:
+	memory(0x10000),
+	machine(
+		[](const byte){ return (byte)0; },
+		[this](const byte port, const byte)
+		{
+			if(port >= biosPort and port < biosPort + biosEntries)
+				bios(port - biosPort);
+		},
+		memory.data()),
+	consoleOutput([](const char* data, const std::size_t size){ std::fwrite(data, 1, size, stdout); std::fflush(stdout); }),
+	consoleInput([](){ return std::getchar(); }),
+	consoleStatus([](){ pollfd p = {0, POLLIN, 0}; return poll(&p, 1, 0) > 0; }),
+	engine(machine, tieredEngine::thresholds())
+{
+	outputBuffer.reserve(outputBufferSize);
+}
+
+cpmSystem::~cpmSystem()
+{
+	flush();
+}
+
+bool cpmSystem::mount(const int d, const std::string& filename, const diskGeometry& geometry /* = diskGeometry() */, const bool readOnly /* = false */)
+{
+	if(d < 0 or d >= maxDrives)
+		return false;
+
+	return drives[d].open(filename, geometry, readOnly);
+}
+
+void cpmSystem::unmount(const int d)
+{
+	if(d >= 0 and d < maxDrives)
+		drives[d].close();
+}
+
+bool cpmSystem::boot(const bytePair base /* = 0 */)
+{
+	const diskImage& a = drives[0];
+
+	if(not a.isOpen())
+		return false;
+
+	ccpBase = base;
+
+	// `jmp ccpstart`
+	if(ccpBase == 0)
+	{
+		const byte *const ccp = a.data() + diskImage::sectorSize;
+
+		if(ccp[0] != 0xc3)
+			return false;
+
+		ccpBase = (ccp[1] | ccp[2] << 8) - ccpStart;
+	}
+
+	if(ccpBase % 0x100 != 0 or ccpBase + ccpSize + bdosSize + 3 * biosEntries + 1 > 0x10000)
+		return false;
+
+	biosBase = ccpBase + ccpSize + bdosSize;
+
+	// A cold start, from a CPU that may have been stopped
+	machine = cpu(machine.portInputHandler, machine.portOutputHandler, memory.data());
+	engine.flush();
+
+	// IOBYTE, and drive A with user 0
+	memory[0x0003] = 0;
+	memory[0x0004] = 0;
+
+	return start();
+}
+
+std::uint64_t cpmSystem::run(const std::uint64_t maxInstructions /* = UINT64_MAX */)
+{
+	std::uint64_t executed = 0;
+
+	while(executed < maxInstructions and not stopped)
+	{
+		const std::uint64_t n = engine.run(maxInstructions - executed);
+
+		// Halted with interrupts disabled, or stopped by the BIOS
+		if(n == 0 or machine.getHalted())
+			stopped = true;
+
+		executed += n;
+	}
+
+	flush();
+	return executed;
+}
+
+void cpmSystem::flush(void)
+{
+	if(not outputBuffer.empty())
+	{
+		consoleOutput(outputBuffer.data(), outputBuffer.size());
+		outputBuffer.clear();
+	}
+}
+
+bool cpmSystem::getStopped(void) const noexcept
+{
+	return stopped;
+}
+
+const cpmSystem::statistics& cpmSystem::getStatistics(void) const noexcept
+{
+	return stats;
+}
+
+void cpmSystem::bios(const int entry)
+{
+	++stats.biosCalls;
+
+	switch(entry)
+	{
+		// BOOT: as WBOOT, but with drive A and user 0
+		case 0:
+			memory[0x0004] = 0;
+			[[fallthrough]];
+
+		// WBOOT
+		case 1:
+			++stats.warmBoots;
+			if(not start()) stop();
+			break;
+
+		// CONST
+		case 2:
+			machine.A() = consoleStatus() ? 0xff : 0;
+			break;
+
+		// CONIN
+		case 3:
+			machine.A() = getChar();
+			break;
+
+		// CONOUT
+		case 4:
+			putChar(machine.C());
+			break;
+
+		// READER
+		case 7:
+			machine.A() = 0x1a;
+			break;
+
+		// HOME
+		case 8:
+			track = 0;
+			break;
+
+		// SELDSK: the disk parameter header, or 0 if there is no such drive
+		case 9:
+		{
+			const byte d = machine.C();
+			const bool exists = d < maxDrives and headers[d];
+
+			if(exists) drive = d;
+			machine.HL() = exists ? headers[d] : 0;
+			break;
+		}
+
+		// SETTRK
+		case 10:
+			track = machine.BC();
+			break;
+
+		// SETSEC
+		case 11:
+			sector = machine.BC();
+			break;
+
+		// SETDMA
+		case 12:
+			dma = machine.BC();
+			break;
+
+		// READ
+		case 13:
+			machine.A() = transfer(false);
+			break;
+
+		// WRITE
+		case 14:
+			machine.A() = transfer(true);
+			break;
+
+		// LISTST
+		case 15:
+			machine.A() = 0xff;
+			break;
+
+		// SECTRAN, through the table the BDOS passes in DE
+		case 16:
+			machine.HL() = machine.DE()
+				? memory[(bytePair)(machine.DE() + machine.BC())]
+				: machine.BC() + drives[drive].getGeometry().firstSector;
+			break;
+
+		// LIST and PUNCH do nothing
+		default:
+			break;
+	}
+}
+
+bool cpmSystem::loadSystem(void)
+{
+	const diskImage& a = drives[0];
+
+	if(not a.isOpen())
+		return false;
+
+	const diskGeometry& g = a.getGeometry();
+
+	// After the cold start loader in the first sector
+	if(g.reservedTracks * g.sectorsPerTrack * diskImage::sectorSize < diskImage::sectorSize + ccpSize + bdosSize)
+		return false;
+
+	std::memcpy(memory.data() + ccpBase, a.data() + diskImage::sectorSize, ccpSize + bdosSize);
+	return true;
+}
+
+bool cpmSystem::start(void)
+{
+	if(not loadSystem())
+		return false;
+
+	// Every table must fit before any is written
+	const std::uint32_t directoryBuffer = biosBase + 3 * biosEntries + 1;
+	std::uint32_t end = directoryBuffer + directoryBufferSize;
+
+	for(const diskImage& d : drives)
+	{
+		if(not d.isOpen())
+			continue;
+
+		const diskGeometry& g = d.getGeometry();
+		end += headerSize + parameterBlockSize + g.translationTable().size()
+			+ (g.removable ? g.directoryEntries / 4 : 0) + (g.blocks() - 1) / 8 + 1;
+	}
+
+	if(end > 0x10000)
+		return false;
+
+	byte *const ram = memory.data();
+
+	for(int entry = 0; entry < biosEntries; ++entry)
+	{
+		byte *const p = ram + biosBase + 3 * entry;
+		p[0] = 0xd3;
+		p[1] = biosPort + entry;
+		p[2] = 0xc9;
+	}
+
+	// Where `stop` sends the CPU
+	ram[biosBase + 3 * biosEntries] = 0x76;
+
+	std::uint32_t next = directoryBuffer + directoryBufferSize;
+
+	for(int i = 0; i < maxDrives; ++i)
+	{
+		headers[i] = 0;
+
+		if(not drives[i].isOpen())
+			continue;
+
+		const diskGeometry& g = drives[i].getGeometry();
+		const std::vector<byte> table = g.translationTable();
+		const std::uint32_t blocks = g.blocks();
+		const std::uint32_t records = g.blockSize / diskImage::sectorSize;
+		const std::uint32_t directoryBlocks = (g.directoryEntries * 32 + g.blockSize - 1) / g.blockSize;
+		const std::uint32_t checked = g.removable ? g.directoryEntries / 4 : 0;
+
+		const std::uint32_t header = next;
+		const std::uint32_t parameters = header + headerSize;
+		const std::uint32_t translation = parameters + parameterBlockSize;
+		const std::uint32_t checksums = translation + table.size();
+		const std::uint32_t allocation = checksums + checked;
+		next = allocation + (blocks - 1) / 8 + 1;
+
+		std::fill(ram + header, ram + next, 0);
+		std::copy(table.begin(), table.end(), ram + translation);
+
+		// Disk parameter header: XLT, three words of BDOS scratch, DIRBUF,
+		// DPB, CSV, ALV
+		word(ram + header, table.empty() ? 0 : translation);
+		word(ram + header + 8, directoryBuffer);
+		word(ram + header + 10, parameters);
+		word(ram + header + 12, checksums);
+		word(ram + header + 14, allocation);
+
+		// Disk parameter block: SPT, BSH, BLM, EXM, DSM, DRM, AL0, AL1, CKS, OFF
+		byte *const dpb = ram + parameters;
+		const bytePair directoryMask = 0xffff << (16 - directoryBlocks);
+
+		word(dpb, g.sectorsPerTrack);
+		dpb[2] = __builtin_ctz(records);
+		dpb[3] = records - 1;
+		dpb[4] = g.blockSize / (blocks <= 256 ? 1024 : 2048) - 1;
+		word(dpb + 5, blocks - 1);
+		word(dpb + 7, g.directoryEntries - 1);
+		dpb[9] = directoryMask / 0x100;
+		dpb[10] = directoryMask % 0x100;
+		word(dpb + 11, checked);
+		word(dpb + 13, g.reservedTracks);
+
+		headers[i] = header;
+	}
+
+	// Page zero: `jmp wboot` and `jmp bdos`
+	ram[0x0000] = 0xc3;
+	word(ram + 0x0001, biosBase + 3);
+	ram[0x0005] = 0xc3;
+	word(ram + 0x0006, ccpBase + ccpSize + bdosEntry);
+
+	// Everything written may have been run before a warm boot
+	engine.invalidate(0x0000, 8);
+	engine.invalidate(ccpBase, 0x10000 - ccpBase);
+
+	// As the BIOS's `gocpm`, with the current drive in C
+	dma = 0x0080;
+	machine.SP = 0x0080;
+	machine.C() = ram[0x0004];
+	machine.PC = ccpBase;
+	stopped = false;
+	return true;
+}
+
+byte cpmSystem::transfer(const bool write)
+{
+	const diskImage& d = drives[drive];
+	byte *const p = d.sector(track, sector);
+
+	if(not p or dma + diskImage::sectorSize > 0x10000 or (write and d.isReadOnly()))
+		return 1;
+
+	if(write)
+	{
+		std::memcpy(p, memory.data() + dma, diskImage::sectorSize);
+		++stats.sectorsWritten;
+	}
+	else
+	{
+		std::memcpy(memory.data() + dma, p, diskImage::sectorSize);
+		engine.invalidate(dma, diskImage::sectorSize);
+		++stats.sectorsRead;
+	}
+
+	return 0;
+}
+
+void cpmSystem::stop(void)
+{
+	// The `hlt` after the jump table, which is written again in case the
+	// program overwrote it
+	const bytePair halt = biosBase + 3 * biosEntries;
+
+	memory[halt] = 0x76;
+	engine.invalidate(halt);
+	machine.PC = halt;
+	stopped = true;
+}
+
+void cpmSystem::putChar(const char c)
+{
+	outputBuffer += c;
+
+	if(outputBuffer.size() >= outputBufferSize)
+		flush();
+}
+
+byte cpmSystem::getChar(void)
+{
+	// Make sure any prompt is visible before waiting for input
+	flush();
+
+	const int c = consoleInput();
+
+	if(c == EOF)
+	{
+		stop();
+		return 0x1a;
+	}
+
+	// CP/M ends lines with a carriage return
+	return c == '\n' ? '\r' : c;
+}
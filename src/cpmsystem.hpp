@@ -0,0 +1,236 @@
+/**
+ * @file cpmsystem.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A CP/M 2.2 machine that boots the CCP and BDOS from a disk image,
+   with the BIOS implemented natively.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+#include "./disk.hpp"
+#include "./tiered.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace intel8080
+{
+	/**
+	 * @brief Runs CP/M 2.2 itself: the CCP and BDOS are loaded from the
+	   system tracks of drive A and run as 8080 code, and only the BIOS is
+	   native. Unlike `cpm`, which replaces the BDOS, this runs anything
+	   that runs on a real CP/M machine, including programs that use the
+	   disk directly.
+	 * Each entry of the BIOS jump table is `out` to one of the ports from
+	   `biosPort`, then `ret`, so the calls are trapped by the port handler
+	   whichever engine runs the CPU. Disk reads and writes copy the sector
+	   between the mapped image and the DMA buffer in one `memcpy`, instead
+	   of the hundreds of instructions per byte that a BIOS driving a
+	   floppy controller through ports spends.
+	 * The disk parameter headers and blocks, translation tables and BDOS
+	   work areas are built above the jump table (and a `hlt` that the CPU
+	   is sent to when console input ends) from each drive's
+	   `diskGeometry`, at cold and warm boot.
+	 * @see http://www.gaby.de/cpm/manuals/archive/cpm22htm/ch6.htm
+	 */
+	class cpmSystem
+	{
+	public:
+		static constexpr int maxDrives = 16;
+
+		/**
+		 * @brief The sizes of the CCP and the BDOS; the BIOS starts right
+		   after them.
+		 */
+		static constexpr std::uint32_t ccpSize = 0x800;
+		static constexpr std::uint32_t bdosSize = 0xe00;
+
+		/**
+		 * @brief The number of entries in the BIOS jump table.
+		 */
+		static constexpr int biosEntries = 17;
+
+		/**
+		 * @brief The port written to by the first BIOS entry; the others
+		   follow it. `out` to these ports from programs also calls the BIOS.
+		 */
+		static constexpr byte biosPort = 0xe0;
+
+		/**
+		 * @brief The size of the console output buffer. Output is passed to
+		   `consoleOutput` whenever this much has accumulated.
+		 */
+		static constexpr std::size_t outputBufferSize = 0x10000;
+
+		/**
+		 * @brief Counts of what the BIOS has done.
+		 */
+		struct statistics
+		{
+			std::uint64_t biosCalls = 0;
+			std::uint64_t sectorsRead = 0;
+			std::uint64_t sectorsWritten = 0;
+			std::uint64_t warmBoots = 0;
+		};
+
+		/**
+		 * @brief The RAM of `machine`.
+		 */
+		std::vector<byte> memory;
+
+		/**
+		 * @brief The CPU. Its port handlers trap the BIOS and must not be
+		   replaced.
+		 */
+		cpu machine;
+
+		/**
+		 * @brief Receives console output in large blocks.
+		 * Defaults to writing to `stdout`.
+		 */
+		std::function<void(const char* data, std::size_t size)> consoleOutput;
+
+		/**
+		 * @brief Provides console input, one character at a time.
+		 * Defaults to reading from `stdin`.
+		 * @return `int` The next character, or `EOF` if there is none, which
+		   stops the machine.
+		 */
+		std::function<int(void)> consoleInput;
+
+		/**
+		 * @brief Whether `consoleInput` has a character ready.
+		 * Defaults to polling `stdin`.
+		 */
+		std::function<bool(void)> consoleStatus;
+
+		cpmSystem(void);
+
+		/**
+		 * @brief Flushes console output; the images are closed, writing back
+		   any changes.
+		 */
+		~cpmSystem();
+
+		/**
+		 * @brief Mounts a disk image as `drive` (0 for A), replacing any
+		   image there. The BDOS sees it from the next boot or warm boot.
+		 *
+		 * @param drive `int` The drive, from 0 to `maxDrives - 1`.
+		 * @param filename `const std::string&` The image file, which is
+		   created (formatted) if it does not exist and is writable.
+		 * @param geometry `const diskGeometry&` The layout of the disk.
+		 * @param readOnly `bool` Whether writes to the disk fail.
+		 * @return `bool` Whether the image was mounted.
+		 */
+		bool mount(const int drive, const std::string& filename, const diskGeometry& geometry = diskGeometry(), const bool readOnly = false);
+
+		/**
+		 * @brief Unmounts the image in `drive`, if any.
+		 */
+		void unmount(const int drive);
+
+		/**
+		 * @brief Loads the CCP and BDOS from drive A, which must hold them in
+		   its reserved tracks after a one-sector cold start loader, builds
+		   page zero and the BIOS, and starts the CCP.
+		 *
+		 * @param ccpBase `bytePair` The address the system on the disk was
+		   built for, or 0 to find it from the CCP's first jump.
+		 * @return `bool` Whether the system was loaded and the BIOS fits in
+		   memory above it.
+		 */
+		bool boot(const bytePair ccpBase = 0);
+
+		/**
+		 * @brief Runs until `maxInstructions` instructions have run or the
+		   machine stops, because it halted or console input ended.
+		 *
+		 * @return `std::uint64_t` The number of instructions run.
+		 */
+		std::uint64_t run(const std::uint64_t maxInstructions = UINT64_MAX);
+
+		/**
+		 * @brief Passes all buffered console output to `consoleOutput`.
+		 */
+		void flush(void);
+
+		/**
+		 * @return `bool` Whether the machine has stopped.
+		 */
+		bool getStopped(void) const noexcept;
+
+		/**
+		 * @return `const statistics&` What the BIOS has done so far.
+		 */
+		const statistics& getStatistics(void) const noexcept;
+
+	private:
+		std::array<diskImage, maxDrives> drives;
+		tieredEngine engine;
+		statistics stats;
+
+		/**
+		 * @brief Where the CCP and the BIOS jump table are, once booted.
+		 */
+		bytePair ccpBase = 0;
+		bytePair biosBase = 0;
+
+		/**
+		 * @brief The disk parameter header of each drive, or 0 if it has no image.
+		 */
+		std::array<bytePair, maxDrives> headers = {};
+
+		/**
+		 * @brief Set by SELDSK, SETTRK, SETSEC and SETDMA.
+		 */
+		byte drive = 0;
+		bytePair track = 0;
+		bytePair sector = 0;
+		bytePair dma = 0x0080;
+
+		std::string outputBuffer;
+		bool stopped = true;
+
+		/**
+		 * @brief Handles a call to the BIOS jump table entry `entry`.
+		 */
+		void bios(const int entry);
+
+		/**
+		 * @brief Loads the CCP and BDOS from drive A to `ccpBase`.
+		 */
+		bool loadSystem(void);
+
+		/**
+		 * @brief Builds page zero, the jump table and the tables of each
+		   drive, and starts the CCP as the BIOS's warm boot does.
+		 */
+		bool start(void);
+
+		/**
+		 * @brief Reads or writes the sector set by SELDSK, SETTRK and SETSEC.
+		 * @return `byte` The BIOS result: 0 on success, 1 on error.
+		 */
+		byte transfer(const bool write);
+
+		/**
+		 * @brief Sends the CPU to a `hlt`, so that `run` returns.
+		 */
+		void stop(void);
+
+		void putChar(const char c);
+		byte getChar(void);
+	};
+}
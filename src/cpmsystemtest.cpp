@@ -0,0 +1,260 @@
+/**
+ * @file cpmsystemtest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Boots `cpmSystem` from a disk image in a scratch directory whose
+   "CCP" is a small program that calls the BIOS directly: SELDSK, READ and
+   WRITE through the mapped images (including a read-only one and a sector
+   that does not exist), and SECTRAN with and without a skew table. Then
+   checks the results, the DMA buffer and the image files.
+   Usage: cpmsystemtest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./cpmsystem.hpp"
+#include "./check.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	// The address the system is built for, and so where the BIOS goes
+	constexpr bytePair ccpBase = 0xd000;
+	constexpr bytePair biosBase = ccpBase + cpmSystem::ccpSize + cpmSystem::bdosSize;
+
+	// Where the program stores what each call returned
+	constexpr bytePair results = 0x0300;
+
+	// The DMA buffers read into and written from
+	constexpr bytePair readBuffer = 0x0100;
+	constexpr bytePair writeBuffer = 0x0200;
+
+	enum class biosEntry : int
+	{
+		seldsk = 9, settrk, setsec, setdma, read, write, sectran = 16
+	};
+
+	/**
+	 * @brief Assembles the program that stands in for the CCP.
+	 */
+	class assembler
+	{
+	public:
+		std::vector<byte> code;
+
+		void emit(const std::initializer_list<int> bytes)
+		{
+			for(const int b : bytes) code.push_back(b);
+		}
+
+		/**
+		 * @brief `lxi b, bc; call entry`
+		 */
+		void bios(const biosEntry entry, const bytePair bc)
+		{
+			emit({0x01, bc & 0xff, bc >> 8});
+			bios(entry);
+		}
+
+		/**
+		 * @brief `call entry`
+		 */
+		void bios(const biosEntry entry)
+		{
+			const bytePair adr = biosBase + 3 * (int)entry;
+			emit({0xcd, adr & 0xff, adr >> 8});
+		}
+
+		/**
+		 * @brief `sta adr`
+		 */
+		void storeA(const bytePair adr)
+		{
+			emit({0x32, adr & 0xff, adr >> 8});
+		}
+
+		/**
+		 * @brief `shld adr`
+		 */
+		void storeHL(const bytePair adr)
+		{
+			emit({0x22, adr & 0xff, adr >> 8});
+		}
+	};
+
+	std::vector<byte> readFile(const std::string& filename)
+	{
+		std::ifstream in(filename, std::ios::binary);
+		return std::vector<byte>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(const std::string& filename, const std::vector<byte>& data)
+	{
+		std::ofstream(filename, std::ios::binary).write((const char*)data.data(), data.size());
+	}
+
+	std::size_t offset(const diskGeometry& g, const std::uint32_t track, const std::uint32_t sector)
+	{
+		return (track * g.sectorsPerTrack + sector - g.firstSector) * diskImage::sectorSize;
+	}
+}
+
+int main(void)
+{
+	const scratchDirectory dir;
+
+	if(not CHECK(dir.ok()))
+		return checks::summary("cpmsystemtest");
+
+	// Drive A: 8" SSSD, with a skew of 6. Drive B: no skew, read-only
+	const diskGeometry a;
+	diskGeometry b;
+	b.tracks = 40;
+	b.sectorsPerTrack = 18;
+	b.skew = 0;
+
+	assembler p;
+	p.emit({0x31, 0x00, 0x04});			// lxi sp, 0x0400
+
+	// SELDSK A; READ track 2 sector 7 into `readBuffer`
+	p.emit({0x0e, 0x00});				// mvi c, 0
+	p.bios(biosEntry::seldsk);
+	p.storeHL(results + 0);
+	p.bios(biosEntry::settrk, 2);
+	p.bios(biosEntry::setsec, 7);
+	p.bios(biosEntry::setdma, readBuffer);
+	p.bios(biosEntry::read);
+	p.storeA(results + 2);
+
+	// WRITE `writeBuffer` to track 3 sector 26, the last on the track
+	p.bios(biosEntry::settrk, 3);
+	p.bios(biosEntry::setsec, 26);
+	p.bios(biosEntry::setdma, writeBuffer);
+	p.bios(biosEntry::write);
+	p.storeA(results + 3);
+
+	// READ sector 27, which does not exist
+	p.bios(biosEntry::setsec, 27);
+	p.bios(biosEntry::read);
+	p.storeA(results + 4);
+
+	// SECTRAN logical sectors 1 and 12 through A's table, and 1 without one
+	p.emit({0x2a, results & 0xff, results >> 8});	// lhld results
+	p.emit({0x5e, 0x23, 0x56});			// mov e, m; inx h; mov d, m
+	p.emit({0xd5});					// push d
+	p.bios(biosEntry::sectran, 1);
+	p.storeHL(results + 5);
+	p.emit({0xd1});					// pop d
+	p.bios(biosEntry::sectran, 12);
+	p.storeHL(results + 7);
+	p.emit({0x11, 0x00, 0x00});			// lxi d, 0
+	p.bios(biosEntry::sectran, 1);
+	p.storeHL(results + 9);
+
+	// SELDSK B; WRITE to it fails. SELDSK C, which has no image, fails
+	p.emit({0x0e, 0x01});				// mvi c, 1
+	p.bios(biosEntry::seldsk);
+	p.storeHL(results + 11);
+	p.bios(biosEntry::settrk, 3);
+	p.bios(biosEntry::setsec, 1);
+	p.bios(biosEntry::write);
+	p.storeA(results + 13);
+	p.emit({0x0e, 0x02});				// mvi c, 2
+	p.bios(biosEntry::seldsk);
+	p.storeHL(results + 14);
+	p.emit({0x76});					// hlt
+
+	// The system tracks: a cold start loader, then a CCP whose first jump is
+	// to `ccpstart`, where the program is
+	std::vector<byte> imageA(a.imageSize(), diskImage::formatByte);
+	const std::size_t ccp = diskImage::sectorSize;
+	const bytePair ccpStart = ccpBase + 0x035c;
+
+	imageA[ccp] = 0xc3;
+	imageA[ccp + 1] = ccpStart & 0xff;
+	imageA[ccp + 2] = ccpStart >> 8;
+	std::copy(p.code.begin(), p.code.end(), imageA.begin() + ccp + 0x035c);
+
+	for(std::size_t i = 0; i < diskImage::sectorSize; ++i)
+		imageA[offset(a, 2, 7) + i] = i * 3 + 1;
+
+	std::vector<byte> imageB(b.imageSize(), 0x5a);
+
+	writeFile(dir / "a.dsk", imageA);
+	writeFile(dir / "b.dsk", imageB);
+
+	std::vector<byte> written(diskImage::sectorSize);
+
+	{
+		cpmSystem system;
+		system.consoleOutput = [](const char*, const std::size_t){};
+		system.consoleInput = [](){ return EOF; };
+		system.consoleStatus = [](){ return false; };
+
+		CHECK(system.mount(0, dir / "a.dsk", a));
+		CHECK(system.mount(1, dir / "b.dsk", b, true));
+
+		if(not CHECK(system.boot()))
+			return checks::summary("cpmsystemtest");
+
+		for(std::size_t i = 0; i < written.size(); ++i)
+			written[i] = system.memory[writeBuffer + i] = 0xff - i;
+
+		system.run(100000);
+
+		CHECK(system.getStopped() and system.machine.getHalted());
+
+		const byte *const r = system.memory.data() + results;
+		const auto word = [&](const int i){ return (bytePair)(r[i] | r[i + 1] << 8); };
+
+		// The header of A is right after the jump table, the `hlt` and the
+		// directory buffer; its table is after its parameter block
+		const bytePair headerA = biosBase + 3 * cpmSystem::biosEntries + 1 + 128;
+		CHECK(word(0) == headerA);
+		CHECK((system.memory[headerA] | system.memory[headerA + 1] << 8) == headerA + 16 + 15);
+
+		CHECK(r[2] == 0);	// Read
+		CHECK(r[3] == 0);	// Written
+		CHECK(r[4] == 1);	// No such sector
+
+		CHECK(std::equal(system.memory.begin() + readBuffer, system.memory.begin() + readBuffer + diskImage::sectorSize,
+			imageA.begin() + offset(a, 2, 7)));
+
+		// With a skew of 6, logical sector 1 is physical 7, and 12 is 21
+		const std::vector<byte> table = a.translationTable();
+		CHECK(word(5) == 7 and word(5) == table[1]);
+		CHECK(word(7) == 21 and word(7) == table[12]);
+		CHECK(word(9) == 1u + a.firstSector);
+
+		// B has no table, and cannot be written
+		CHECK(word(11) != 0 and system.memory[word(11)] == 0 and system.memory[word(11) + 1] == 0);
+		CHECK(r[13] == 1);
+		CHECK(word(14) == 0);
+
+		const cpmSystem::statistics& s = system.getStatistics();
+		CHECK(s.sectorsRead == 1 and s.sectorsWritten == 1);
+	}
+
+	// Writes reach the file through the mapping, and only where they should
+	const std::vector<byte> afterA = readFile(dir / "a.dsk");
+
+	if(CHECK(afterA.size() == imageA.size()))
+	{
+		std::copy(written.begin(), written.end(), imageA.begin() + offset(a, 3, 26));
+		CHECK(afterA == imageA);
+	}
+
+	CHECK(readFile(dir / "b.dsk") == imageB);
+
+	return checks::summary("cpmsystemtest");
+}
@@ -0,0 +1,260 @@
+/**
+ * @file debug.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs an `intel8080::cpu` until a breakpoint, watchpoint or halt,
+   and says why it stopped.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `debug.hpp`.
+
+#include "./debug.hpp"
+#include "./opcodes.hpp"
+
+#include <algorithm>
+
+using namespace intel8080;
+
+debugTarget::debugTarget(cpu& m)
+:
+	machine(m),
+	engine(m),
+	breakpoints(0x10000),
+	watchMasks(0x10000)
+{}
+
+void debugTarget::setBreakpoint(const bytePair adr, const bool set /* = true */)
+{
+	byte& count = breakpoints[adr];
+
+	if(set and count < 0xff) ++count;
+	else if(not set and count > 0) --count;
+
+	engine.setExit(adr, count > 0);
+}
+
+bool debugTarget::setWatchpoint(const bytePair begin, const std::uint32_t length, const watchKind kind, const bool set /* = true */)
+{
+	if(length == 0 or length > 0x10000)
+		return false;
+
+	if(set)
+	{
+		watchpoints.push_back({begin, length, kind});
+	}
+	else
+	{
+		const auto it = std::find_if(watchpoints.begin(), watchpoints.end(), [&](const watchpoint& w)
+		{
+			return w.begin == begin and w.length == length and w.kind == kind;
+		});
+
+		if(it == watchpoints.end())
+			return false;
+
+		watchpoints.erase(it);
+	}
+
+	std::fill(watchMasks.begin(), watchMasks.end(), 0);
+
+	for(const watchpoint& w : watchpoints)
+	{
+		const byte mask = w.kind == watchKind::write ? watchesWrites
+			: w.kind == watchKind::read ? watchesReads
+			: watchesWrites | watchesReads | watchesAccesses;
+
+		for(std::uint32_t i = 0; i < w.length; ++i)
+			watchMasks[(bytePair)(w.begin + i)] |= mask;
+	}
+
+	return true;
+}
+
+stopInfo debugTarget::step(void)
+{
+	stopInfo stop;
+
+	if(machine.getHalted() and not (machine.getInterruptsEnabled() and machine.getInterruptPending()))
+	{
+		stop.reason = stopReason::halted;
+		return stop;
+	}
+
+	stop.instructions = 1;
+	stepChecked(stop);
+	return stop;
+}
+
+stopInfo debugTarget::run(const std::uint64_t maxInstructions)
+{
+	stopInfo stop;
+
+	// Watched accesses can only be seen an instruction at a time
+	if(not watchpoints.empty())
+	{
+		while(stop.instructions < maxInstructions)
+		{
+			if(machine.getHalted() and not (machine.getInterruptsEnabled() and machine.getInterruptPending()))
+			{
+				stop.reason = stopReason::halted;
+				break;
+			}
+
+			if(stop.instructions != 0 and breakpoints[machine.PC])
+			{
+				stop.reason = stopReason::breakpoint;
+				break;
+			}
+
+			++stop.instructions;
+
+			if(stepChecked(stop))
+				break;
+		}
+
+		return stop;
+	}
+
+	// Blocks end at breakpoints, which are exits
+	const blockEngine::limits limits;
+
+	while(stop.instructions < maxInstructions)
+	{
+		const std::uint64_t n = engine.run(maxInstructions - stop.instructions, limits);
+		stop.instructions += n;
+
+		if(n == 0 or (machine.getHalted() and not (machine.getInterruptsEnabled() and machine.getInterruptPending())))
+		{
+			stop.reason = stopReason::halted;
+			break;
+		}
+
+		if(breakpoints[machine.PC])
+		{
+			stop.reason = stopReason::breakpoint;
+			break;
+		}
+	}
+
+	return stop;
+}
+
+void debugTarget::invalidate(const bytePair begin, const std::uint32_t length /* = 1 */)
+{
+	engine.invalidate(begin, length);
+}
+
+debugTarget::memoryAccess debugTarget::nextAccess(void) const noexcept
+{
+	const bool interrupting = machine.getInterruptsEnabled() and machine.getInterruptPending();
+
+	if(machine.getHalted() and not interrupting)
+		return {};
+
+	const byte *const ram = machine.ram;
+	const bytePair pc = machine.PC;
+	const byte opcode = interrupting ? machine.getInterruptVector() : ram[pc];
+	const bytePair address = ram[(bytePair)(pc + 1)] | ram[(bytePair)(pc + 2)] << 8;
+	const bytePair sp = machine.SP;
+	const bytePair hl = machine.HL();
+
+	// Whether a conditional call or return is taken: NZ, Z, NC, C, PO, PE, P, M
+	const auto taken = [&]() noexcept
+	{
+		constexpr flagPos flags[] = {flagPos::zero, flagPos::carry, flagPos::parity, flagPos::sign};
+		const int condition = opcode >> 3 & 7;
+
+		return machine.getFlag(flags[condition >> 1]) == (condition & 1);
+	};
+
+	switch(opcode)
+	{
+		case 0x02: return {machine.BC(), 1, false, true};	// stax b
+		case 0x12: return {machine.DE(), 1, false, true};	// stax d
+		case 0x0a: return {machine.BC(), 1, true, false};	// ldax b
+		case 0x1a: return {machine.DE(), 1, true, false};	// ldax d
+		case 0x22: return {address, 2, false, true};		// shld
+		case 0x2a: return {address, 2, true, false};		// lhld
+		case 0x32: return {address, 1, false, true};		// sta
+		case 0x3a: return {address, 1, true, false};		// lda
+		case 0x34:											// inr m
+		case 0x35: return {hl, 1, true, true};				// dcr m
+		case 0x36: return {hl, 1, false, true};				// mvi m
+		case 0xe3: return {sp, 2, true, true};				// xthl
+		default: break;
+	}
+
+	// `mov` to or from M, and arithmetic on M
+	if(opcode >= 0x40 and opcode < 0xc0 and opcode != 0x76)
+	{
+		const bool fromM = (opcode & 7) == 6;
+		const bool toM = opcode < 0x80 and (opcode >> 3 & 7) == 6;
+
+		return fromM or toM ? memoryAccess{hl, 1, fromM, toM} : memoryAccess{};
+	}
+
+	// `push` and `pop`
+	if((opcode & 0xcf) == 0xc5) return {(bytePair)(sp - 2), 2, false, true};
+	if((opcode & 0xcf) == 0xc1) return {sp, 2, true, false};
+
+	switch(opcodes[opcode].flow)
+	{
+		case flowType::conditionalCall:
+			if(not taken()) break;
+			[[fallthrough]];
+
+		case flowType::call:
+		case flowType::restart:
+			return {(bytePair)(sp - 2), 2, false, true};
+
+		case flowType::conditionalReturn:
+			if(not taken()) break;
+			[[fallthrough]];
+
+		case flowType::ret:
+			return {sp, 2, true, false};
+
+		default:
+			break;
+	}
+
+	return {};
+}
+
+bool debugTarget::stepChecked(stopInfo& stop)
+{
+	const memoryAccess access = nextAccess();
+
+	machine.step();
+
+	if(not access.write and not access.read)
+		return false;
+
+	// `cpu::step` does not know about translated blocks
+	if(access.write)
+		engine.invalidate(access.address, access.length);
+
+	for(std::uint32_t i = 0; i < access.length; ++i)
+	{
+		const bytePair adr = access.address + i;
+		const byte mask = watchMasks[adr];
+		const bool wrote = access.write and mask & watchesWrites;
+
+		if(wrote or (access.read and mask & watchesReads))
+		{
+			stop.reason = stopReason::watchpoint;
+			stop.address = adr;
+			stop.watch = mask & watchesAccesses ? watchKind::access : wrote ? watchKind::write : watchKind::read;
+			return true;
+		}
+	}
+
+	return false;
+}
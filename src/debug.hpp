@@ -0,0 +1,167 @@
+/**
+ * @file debug.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs an `intel8080::cpu` until a breakpoint, watchpoint or halt,
+   and says why it stopped.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+#include "./blocks.hpp"
+
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief The accesses a watchpoint stops at.
+	 */
+	enum class watchKind : byte
+	{
+		write = 1,
+		read = 2,
+		access = 3
+	};
+
+	/**
+	 * @brief Why `debugTarget::run` or `step` returned.
+	 */
+	enum class stopReason
+	{
+		limit,			// The instructions asked for have run.
+		breakpoint,		// The program counter is at a breakpoint.
+		watchpoint,		// The last instruction accessed a watched address.
+		halted			// The CPU is halted, with no interrupt to service.
+	};
+
+	struct stopInfo
+	{
+		stopReason reason = stopReason::limit;
+
+		/**
+		 * @brief For a watchpoint, the first watched address accessed and
+		   the kind of watchpoint it matched.
+		 */
+		bytePair address = 0;
+		watchKind watch = watchKind::access;
+
+		/**
+		 * @brief The number of instructions run, counting an interrupt as one.
+		 */
+		std::uint64_t instructions = 0;
+	};
+
+	/**
+	 * @brief Runs a `cpu` for a debugger.
+	 * Without watchpoints, code runs in `blockEngine`, with an exit at each
+	   breakpoint; blocks end before exits, so breakpoints cost nothing
+	   until they are reached. With watchpoints, instructions are run one at
+	   a time by `cpu::step`, each checked against the watched addresses
+	   beforehand from its opcode and registers.
+	 * Memory changed other than by the CPU, e.g. by the debugger, must be
+	   reported with `invalidate`.
+	 */
+	class debugTarget
+	{
+	public:
+		/**
+		 * @param machine `cpu&` The CPU to run, which must have RAM.
+		 */
+		explicit debugTarget(cpu& machine);
+
+		/**
+		 * @brief Adds or removes a breakpoint at `adr`. Breakpoints are
+		   counted, so one added twice must be removed twice.
+		 */
+		void setBreakpoint(const bytePair adr, const bool set = true);
+
+		/**
+		 * @brief Adds or removes a watchpoint on `length` bytes from `begin`.
+		   A watchpoint is removed with the same range and kind it was
+		   added with.
+		 * @return `bool` Whether the watchpoint was added or removed.
+		 */
+		bool setWatchpoint(const bytePair begin, const std::uint32_t length, const watchKind kind, const bool set = true);
+
+		/**
+		 * @brief Runs one instruction, or services a pending interrupt.
+		 */
+		stopInfo step(void);
+
+		/**
+		 * @brief Runs until a breakpoint or watchpoint is hit, the CPU halts
+		   or at least `maxInstructions` instructions have run. The
+		   instruction at the program counter is always run, even if there
+		   is a breakpoint there.
+		 */
+		stopInfo run(const std::uint64_t maxInstructions);
+
+		/**
+		 * @brief Reports that `length` bytes from `begin` were changed other
+		   than by the CPU.
+		 */
+		void invalidate(const bytePair begin, const std::uint32_t length = 1);
+
+	private:
+		/**
+		 * @brief A memory access made by an instruction.
+		 */
+		struct memoryAccess
+		{
+			bytePair address = 0;
+			byte length = 0;
+			bool read = false;
+			bool write = false;
+		};
+
+		struct watchpoint
+		{
+			bytePair begin;
+			std::uint32_t length;
+			watchKind kind;
+		};
+
+		// Bits of `watchMasks`
+		static constexpr byte watchesWrites = 1;
+		static constexpr byte watchesReads = 2;
+		static constexpr byte watchesAccesses = 4;
+
+		cpu& machine;
+		blockEngine engine;
+
+		/**
+		 * @brief How many breakpoints there are at each address.
+		 */
+		std::vector<byte> breakpoints;
+
+		std::vector<watchpoint> watchpoints;
+
+		/**
+		 * @brief What each address is watched for, from `watchpoints`.
+		 */
+		std::vector<byte> watchMasks;
+
+		/**
+		 * @return `memoryAccess` The memory the next instruction (or the
+		   pending interrupt) will read or write.
+		 */
+		memoryAccess nextAccess(void) const noexcept;
+
+		/**
+		 * @brief Runs one instruction with `cpu::step`, and tells
+		   `blockEngine` about what it wrote.
+		 * @param stop `stopInfo&` Set to the watchpoint hit, if any.
+		 * @return `bool` Whether a watchpoint was hit.
+		 */
+		bool stepChecked(stopInfo& stop);
+	};
+}
@@ -0,0 +1,811 @@
+/**
+ * @file difftest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs `intel8080::cpu` and `intel8080::referenceCpu` side by side and
+   reports the first instruction after which they disagree.
+   Usage: difftest [--cases N] [--steps N] [--seed N] [--threads N] [--engine cpu|blocks|tiered]
+          difftest --program FILE.COM [--steps N] [--engine cpu|blocks|tiered|recompiled]
+   By default, --cases random machines (random memory and registers, a
+   quarter of them starting with a copy or fill loop) are each run for
+   --steps instructions. Registers, flags, cycle counts and port I/O
+   are compared after every instruction and memory every 64 instructions and at
+   the end; when memory differs, the case is rerun to find the instruction that
+   caused it. Cases are split between --threads threads.
+   With --program, a CP/M .COM program is run instead, with BDOS calls 2 and 9
+   printed to stdout, until it jumps to 0x0000.
+   --engine chooses how `cpu` is run: `cpu::step`, `blockEngine`,
+   `tieredEngine`, or code generated by `recompile`, which is only available
+   when built with INTEL8080_RECOMPILED defined as the name of the function
+   generated for the program (and is then also the top tier of `tieredEngine`). Engines that run a block at a time are checked against the same
+   number of reference instructions after each block.
+   The exit status is 1 if the engines disagreed.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./intel8080.hpp"
+#include "./reference.hpp"
+#include "./blocks.hpp"
+#include "./tiered.hpp"
+
+#ifdef INTEL8080_RECOMPILED
+#include "./recompiled.hpp"
+
+std::uint64_t INTEL8080_RECOMPILED(intel8080::cpu& machine, const std::uint64_t budget);
+#endif
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if not INTEL8080_DEBUG__
+	#error "difftest needs INTEL8080_DEBUG__ to read and set the interrupt state of intel8080::cpu"
+#endif
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief How often memory is compared, in instructions.
+	 */
+	constexpr std::uint64_t memoryCheckInterval = 64;
+
+	/**
+	 * @brief The port I/O seen by an engine. `in` returns a value derived
+	   from the port and the number of previous reads, so that both engines
+	   read the same values as long as they agree; `out` is folded into a hash.
+	 */
+	struct portLog
+	{
+		std::uint64_t reads = 0;
+		std::uint64_t writes = 0;
+
+		byte read(const byte port) noexcept
+		{
+			return port ^ 0x5a ^ (byte)(reads++ * 0x9d);
+		}
+
+		void write(const byte port, const byte data) noexcept
+		{
+			writes = (writes ^ (port << 8 | data)) * 0x100000001b3;
+		}
+	};
+
+	/**
+	 * @brief An Intel 8080 implementation to be compared, with its own 64K
+	   of memory.
+	 */
+	class engine
+	{
+	public:
+		portLog io;
+
+		virtual ~engine() = default;
+
+		/**
+		 * @brief The name used in reports.
+		 */
+		virtual const char* name(void) const noexcept = 0;
+
+		/**
+		 * @brief Copies 64K of memory and the machine state in, and clears the
+		   cycle count and I/O log.
+		 */
+		virtual void reset(const byte* image, const machineState& state) = 0;
+
+		/**
+		 * @brief Runs at least one instruction.
+		 * @return `std::uint64_t` The number of instructions run.
+		 */
+		virtual std::uint64_t step(void) = 0;
+
+		virtual machineState getState(void) = 0;
+		virtual void setState(const machineState& state) = 0;
+		virtual std::uint64_t getCycles(void) = 0;
+		virtual byte* memory(void) = 0;
+	};
+
+	class coreEngine : public engine
+	{
+	public:
+		coreEngine()
+		:
+			ram(0x10000),
+			machine(
+				[this](const byte port){ return io.read(port); },
+				[this](const byte port, const byte data){ io.write(port, data); },
+				ram.data()
+			)
+		{}
+
+		const char* name(void) const noexcept override
+		{
+			return "cpu";
+		}
+
+		void reset(const byte* image, const machineState& state) override
+		{
+			std::memcpy(ram.data(), image, ram.size());
+			setState(state);
+			machine.cycles = 0;
+			io = portLog();
+		}
+
+		std::uint64_t step(void) override
+		{
+			machine.step();
+			return 1;
+		}
+
+		machineState getState(void) override
+		{
+			machineState s;
+			s.A = machine.A();
+			s.F = machine.flags();
+			s.B = machine.B();
+			s.C = machine.C();
+			s.D = machine.D();
+			s.E = machine.E();
+			s.H = machine.H();
+			s.L = machine.L();
+			s.SP = machine.SP;
+			s.PC = machine.PC;
+			s.halted = machine.getHalted();
+			s.interruptsEnabled = machine.getInterruptsEnabled();
+			return s;
+		}
+
+		void setState(const machineState& s) override
+		{
+			machine.A() = s.A;
+			machine.flags() = s.F;
+			machine.B() = s.B;
+			machine.C() = s.C;
+			machine.D() = s.D;
+			machine.E() = s.E;
+			machine.H() = s.H;
+			machine.L() = s.L;
+			machine.SP = s.SP;
+			machine.PC = s.PC;
+			machine.setHalted(s.halted);
+			machine.setInterruptsEnabled(s.interruptsEnabled);
+			machine.setInterruptPending(false, 0);
+		}
+
+		std::uint64_t getCycles(void) override
+		{
+			return machine.cycles;
+		}
+
+		byte* memory(void) override
+		{
+			return ram.data();
+		}
+
+	protected:
+		std::vector<byte> ram;
+		cpu machine;
+	};
+
+	/**
+	 * @brief Runs `cpu` through `blockEngine`, one block at a time.
+	 */
+	class blockEngineEngine : public coreEngine
+	{
+	public:
+		blockEngineEngine()
+		:
+			blocks(machine)
+		{}
+
+		const char* name(void) const noexcept override
+		{
+			return "blocks";
+		}
+
+		void reset(const byte* image, const machineState& state) override
+		{
+			coreEngine::reset(image, state);
+			blocks.flush();
+		}
+
+		std::uint64_t step(void) override
+		{
+			const std::uint64_t n = blocks.run(1);
+			if(n) return n;
+
+			// Halted
+			machine.step();
+			return 1;
+		}
+
+	private:
+		blockEngine blocks;
+	};
+
+	/**
+	 * @brief Runs `cpu` through `tieredEngine`, with thresholds low enough
+	   that short random cases move code through every tier.
+	 */
+	class tieredEngineEngine : public coreEngine
+	{
+	public:
+		/**
+		 * @param native `recompiledProgram` The top tier, if any.
+		 */
+		explicit tieredEngineEngine(const recompiledProgram native)
+		:
+			tiered(machine, tieredEngine::thresholds{2, 4}, native)
+		{}
+
+		const char* name(void) const noexcept override
+		{
+			return "tiered";
+		}
+
+		void reset(const byte* image, const machineState& state) override
+		{
+			coreEngine::reset(image, state);
+			tiered.flush();
+		}
+
+		std::uint64_t step(void) override
+		{
+			const std::uint64_t n = tiered.run(1);
+			if(n) return n;
+
+			// Halted
+			machine.step();
+			return 1;
+		}
+
+	private:
+		tieredEngine tiered;
+	};
+
+	#ifdef INTEL8080_RECOMPILED
+	/**
+	 * @brief Runs the code generated by `recompile` for one program, one
+	   block at a time, with the interpreter as a fallback.
+	 */
+	class recompiledEngine : public coreEngine
+	{
+	public:
+		const char* name(void) const noexcept override
+		{
+			return "recompiled";
+		}
+
+		std::uint64_t step(void) override
+		{
+			const std::uint64_t n = INTEL8080_RECOMPILED(machine, 1);
+			if(n) return n;
+
+			machine.step();
+			return 1;
+		}
+	};
+	#endif
+
+	class referenceEngine : public engine
+	{
+	public:
+		referenceEngine()
+		:
+			ram(0x10000),
+			machine(ram.data())
+		{
+			machine.context = this;
+			machine.input = [](void* context, const byte port){
+				return static_cast<referenceEngine*>(context)->io.read(port);
+			};
+			machine.output = [](void* context, const byte port, const byte data){
+				static_cast<referenceEngine*>(context)->io.write(port, data);
+			};
+		}
+
+		const char* name(void) const noexcept override
+		{
+			return "reference";
+		}
+
+		void reset(const byte* image, const machineState& state) override
+		{
+			std::memcpy(ram.data(), image, ram.size());
+			setState(state);
+			machine.cycles = 0;
+			io = portLog();
+		}
+
+		std::uint64_t step(void) override
+		{
+			machine.step();
+			return 1;
+		}
+
+		machineState getState(void) override
+		{
+			return machine.state;
+		}
+
+		void setState(const machineState& state) override
+		{
+			machine.state = state;
+		}
+
+		std::uint64_t getCycles(void) override
+		{
+			return machine.cycles;
+		}
+
+		byte* memory(void) override
+		{
+			return ram.data();
+		}
+
+	private:
+		std::vector<byte> ram;
+		referenceCpu machine;
+	};
+
+	/**
+	 * @brief Where two engines first disagreed.
+	 */
+	struct divergence
+	{
+		bool found = false;
+		std::uint64_t testCase = 0;
+		std::uint64_t step = 0;
+		std::string description;
+	};
+
+	void describeState(std::string& out, const char* label, const machineState& s, const std::uint64_t cycles)
+	{
+		char line[160];
+		std::snprintf(line, sizeof line,
+			"  %-10s A=%02x F=%02x B=%02x C=%02x D=%02x E=%02x H=%02x L=%02x SP=%04x PC=%04x halted=%d ie=%d cycles=%llu\n",
+			label, s.A, s.F, s.B, s.C, s.D, s.E, s.H, s.L, s.SP, s.PC, s.halted, s.interruptsEnabled,
+			(unsigned long long)cycles);
+		out += line;
+	}
+
+	/**
+	 * @brief Describes a divergence found after running the instruction at
+	   `before.PC`.
+	 */
+	std::string describe(engine& a, engine& b, const machineState& before, const byte* memoryBefore, const std::string& what)
+	{
+		char line[160];
+		std::string out = what + "\n";
+
+		std::snprintf(line, sizeof line, "  instruction at %04x: %02x %02x %02x\n", before.PC,
+			memoryBefore[before.PC], memoryBefore[(bytePair)(before.PC + 1)], memoryBefore[(bytePair)(before.PC + 2)]);
+		out += line;
+
+		describeState(out, "before", before, 0);
+		describeState(out, a.name(), a.getState(), a.getCycles());
+		describeState(out, b.name(), b.getState(), b.getCycles());
+		return out;
+	}
+
+	/**
+	 * @brief Compares everything but memory.
+	 * @return `std::string` What differs, or an empty string.
+	 */
+	std::string compareRegisters(engine& a, engine& b)
+	{
+		if(a.getState() != b.getState()) return "registers differ";
+		if(a.getCycles() != b.getCycles()) return "cycle counts differ";
+		if(a.io.reads != b.io.reads) return "port reads differ";
+		if(a.io.writes != b.io.writes) return "port writes differ";
+		return "";
+	}
+
+	/**
+	 * @return `std::string` The first differing address, or an empty string.
+	 */
+	std::string compareMemory(engine& a, engine& b)
+	{
+		if(std::memcmp(a.memory(), b.memory(), 0x10000) == 0)
+			return "";
+
+		std::size_t adr = 0;
+		while(a.memory()[adr] == b.memory()[adr]) ++adr;
+
+		char line[80];
+		std::snprintf(line, sizeof line, "memory differs at %04zx: %s=%02x %s=%02x",
+			adr, a.name(), a.memory()[adr], b.name(), b.memory()[adr]);
+		return line;
+	}
+
+	/**
+	 * @brief Generates the memory and registers of a random test case. The
+	   same seed and case number always give the same machine.
+	 */
+	void generateCase(const std::uint64_t seed, const std::uint64_t testCase, std::vector<byte>& image, machineState& state)
+	{
+		std::mt19937_64 rng(seed * 0x9e3779b97f4a7c15 + testCase);
+
+		image.resize(0x10000);
+		for(std::size_t i = 0; i < image.size(); i += 8)
+		{
+			const std::uint64_t r = rng();
+			std::memcpy(image.data() + i, &r, 8);
+		}
+
+		// A case ends when the CPU halts, so make `hlt` rarer than other
+		// instructions to let most cases run for all their steps
+		for(auto& b : image)
+		{
+			if(b == 0x76 and rng() % 16) b = 0x00;
+		}
+
+		const std::uint64_t r = rng();
+		state.A = r;
+		state.F = (r >> 8 & 0xd7) | 0x02;
+		state.B = r >> 16;
+		state.C = r >> 24;
+		state.D = r >> 32;
+		state.E = r >> 40;
+		state.H = r >> 48;
+		state.L = r >> 56;
+
+		const std::uint64_t s = rng();
+		state.SP = s;
+		state.PC = s >> 16;
+		state.halted = false;
+		state.interruptsEnabled = s >> 32 & 1;
+
+		// A quarter of the cases start with a copy or fill loop, which
+		// `blockEngine` runs with `memmove` or `memset` when it can
+		const std::uint64_t t = rng();
+
+		if(t % 4 == 0)
+		{
+			struct loop
+			{
+				std::vector<byte> code;
+
+				/**
+				 * @brief The register that counts iterations, as encoded in
+				   opcodes, or the register pair that does if `wide`.
+				 */
+				int counter;
+				bool wide;
+			};
+
+			const std::vector<loop> loops =
+			{
+				{{0x1a, 0x77, 0x23, 0x13, 0x0b, 0x78, 0xb1}, 0, true},	// LDAX D, MOV M, A, INX H, INX D, DCX B, MOV A, B, ORA C
+				{{0x7e, 0x12, 0x2b, 0x1b, 0x0b, 0x79, 0xb0}, 0, true},	// MOV A, M, STAX D, DCX H, DCX D, DCX B, MOV A, C, ORA B
+				{{0x13, 0x0a, 0x12, 0x03, 0x2b, 0x7c, 0xb5}, 2, true},	// INX D, LDAX B, STAX D, INX B, DCX H, MOV A, H, ORA L
+				{{0x73, 0x23, 0x0b, 0x78, 0xb1}, 0, true},				// MOV M, E, INX H, DCX B, MOV A, B, ORA C
+				{{0x36, 0xe5, 0x2b, 0x1b, 0x7a, 0xb3}, 1, true},		// MVI M, e5, DCX H, DCX D, MOV A, D, ORA E
+				{{0x77, 0x23, 0x0d}, 1, false},							// MOV M, A, INX H, DCR C
+				{{0x1a, 0x77, 0x23, 0x1b, 0x05}, 0, false},				// LDAX D, MOV M, A, INX H, DCX D, DCR B
+			};
+
+			const loop& l = loops[t / 4 % loops.size()];
+			std::vector<byte> code = l.code;
+			code.insert(code.end(), {0xc2, (byte)state.PC, (byte)(state.PC >> 8)});	// JNZ to the start
+
+			for(std::size_t i = 0; i < code.size(); ++i)
+			{
+				image[(bytePair)(state.PC + i)] = code[i];
+			}
+
+			// Mostly counts short enough to finish within the case
+			const bytePair count = t >> 8 & (t >> 32 & 1 ? 0x01ff : 0xffff);
+			byte *const registers[] = {&state.B, &state.C, &state.D, &state.E, &state.H, &state.L};
+
+			if(l.wide)
+			{
+				*registers[2 * l.counter] = count >> 8;
+				*registers[2 * l.counter + 1] = count;
+			}
+			else
+			{
+				*registers[l.counter] = count;
+			}
+		}
+	}
+
+	/**
+	 * @brief Runs one random case on both engines.
+	 * @param checkMemoryEveryStep `bool` Compare memory after every
+	   instruction, to find which one caused a memory difference.
+	 */
+	divergence runCase(engine& a, engine& b, const std::uint64_t seed, const std::uint64_t testCase,
+		const std::uint64_t steps, const bool checkMemoryEveryStep = false)
+	{
+		std::vector<byte> image;
+		machineState state;
+		generateCase(seed, testCase, image, state);
+
+		a.reset(image.data(), state);
+		b.reset(image.data(), state);
+
+		// Only kept when looking for the instruction that changed memory
+		std::vector<byte> memoryBefore;
+
+		divergence d;
+		d.testCase = testCase;
+
+		for(std::uint64_t i = 0, n; i < steps; i += n)
+		{
+			const machineState before = b.getState();
+			if(checkMemoryEveryStep) memoryBefore.assign(b.memory(), b.memory() + 0x10000);
+
+			n = a.step();
+			for(std::uint64_t k = 0; k < n; ++k) b.step();
+
+			std::string what = compareRegisters(a, b);
+
+			if(what.empty() and (checkMemoryEveryStep or (i + n) / memoryCheckInterval != i / memoryCheckInterval
+				or i + n >= steps or before.halted))
+			{
+				what = compareMemory(a, b);
+
+				if(not what.empty() and not checkMemoryEveryStep)
+				{
+					// Rerun to find which instruction (or block) wrote the wrong memory
+					return runCase(a, b, seed, testCase, i + n, true);
+				}
+			}
+
+			if(not what.empty())
+			{
+				d.found = true;
+				d.step = i;
+				d.description = describe(a, b, before, checkMemoryEveryStep ? memoryBefore.data() : b.memory(), what);
+				return d;
+			}
+
+			// Nothing more will happen without an interrupt
+			if(before.halted)
+				break;
+		}
+
+		return d;
+	}
+
+	/**
+	 * @brief Creates the engine compared with the reference.
+	 * @param name `const std::string&` cpu, blocks, tiered or recompiled.
+	 * @param program `bool` Whether a program will be run; the recompiled
+	   engine (and the top tier of the tiered engine) only runs the program
+	   it was generated from.
+	 * @return `std::unique_ptr<engine>` The engine, or `nullptr` if it is not
+	   available.
+	 */
+	std::unique_ptr<engine> makeEngine(const std::string& name, const bool program)
+	{
+		if(name == "cpu") return std::make_unique<coreEngine>();
+		if(name == "blocks") return std::make_unique<blockEngineEngine>();
+
+		#ifdef INTEL8080_RECOMPILED
+		if(name == "tiered") return std::make_unique<tieredEngineEngine>(program ? INTEL8080_RECOMPILED : nullptr);
+		if(name == "recompiled" and program) return std::make_unique<recompiledEngine>();
+		#else
+		if(name == "tiered") return std::make_unique<tieredEngineEngine>(nullptr);
+		(void)program;
+		#endif
+
+		return nullptr;
+	}
+
+	int runRandomCases(const std::uint64_t cases, const std::uint64_t steps, const std::uint64_t seed, unsigned threads,
+		const std::string& engineName)
+	{
+		if(threads == 0) threads = 1;
+
+		std::atomic<std::uint64_t> next(0);
+		std::atomic<std::uint64_t> firstFailure(cases);
+		std::vector<divergence> failures(threads);
+		std::vector<std::thread> workers;
+
+		for(unsigned t = 0; t < threads; ++t)
+		{
+			workers.emplace_back([&, t]{
+				const std::unique_ptr<engine> a = makeEngine(engineName, false);
+				referenceEngine b;
+
+				for(std::uint64_t c; (c = next++) < cases and c < firstFailure;)
+				{
+					divergence d = runCase(*a, b, seed, c, steps);
+
+					if(d.found)
+					{
+						if(not failures[t].found or c < failures[t].testCase) failures[t] = d;
+
+						std::uint64_t expected = firstFailure;
+						while(c < expected and not firstFailure.compare_exchange_weak(expected, c));
+						break;
+					}
+				}
+			});
+		}
+
+		for(auto& w : workers) w.join();
+
+		const divergence* first = nullptr;
+		for(const auto& f : failures)
+		{
+			if(f.found and (not first or f.testCase < first->testCase)) first = &f;
+		}
+
+		if(first)
+		{
+			std::printf("Case %llu (seed %llu) diverged at instruction %llu of %s: %s",
+				(unsigned long long)first->testCase, (unsigned long long)seed,
+				(unsigned long long)first->step, engineName.c_str(), first->description.c_str());
+			return 1;
+		}
+
+		std::printf("%llu cases of %llu instructions: no divergence\n",
+			(unsigned long long)cases, (unsigned long long)steps);
+		return 0;
+	}
+
+	/**
+	 * @brief Handles a BDOS call on one engine: prints for functions 2 and
+	   9, then returns.
+	 */
+	void bdos(engine& e, const bool print)
+	{
+		machineState s = e.getState();
+		const byte* mem = e.memory();
+
+		if(print and s.C == 2)
+		{
+			std::putchar(s.E);
+		}
+		else if(print and s.C == 9)
+		{
+			for(bytePair adr = s.D << 8 | s.E; mem[adr] != '$'; ++adr)
+				std::putchar(mem[adr]);
+		}
+
+		s.PC = mem[s.SP] | mem[(bytePair)(s.SP + 1)] << 8;
+		s.SP += 2;
+		e.setState(s);
+	}
+
+	int runProgram(const std::string& filename, const std::uint64_t steps, engine& a)
+	{
+		std::vector<byte> image(0x10000);
+		std::FILE* f = std::fopen(filename.c_str(), "rb");
+
+		if(not f)
+		{
+			std::fprintf(stderr, "Cannot open %s\n", filename.c_str());
+			return 2;
+		}
+
+		const std::size_t size = std::fread(image.data() + 0x100, 1, 0x10000 - 0x100, f);
+		std::fclose(f);
+
+		if(size == 0)
+		{
+			std::fprintf(stderr, "%s is empty\n", filename.c_str());
+			return 2;
+		}
+
+		// Page zero: a jump to the warm boot vector and a BDOS entry point
+		// that is trapped before it is executed
+		image[0x0000] = 0x76;
+		image[0x0005] = 0xc9;
+		image[0x0006] = 0x00;
+		image[0x0007] = 0xfe;
+
+		machineState state = {};
+		state.F = 0x02;
+		state.SP = 0xfffe;
+		state.PC = 0x0100;
+
+		referenceEngine b;
+		a.reset(image.data(), state);
+		b.reset(image.data(), state);
+
+		for(std::uint64_t i = 0, n; i < steps; i += n)
+		{
+			const bytePair pc = b.getState().PC;
+
+			if(pc == 0x0000)
+			{
+				std::printf("\n%s finished after %llu instructions with no divergence\n",
+					filename.c_str(), (unsigned long long)i);
+				return 0;
+			}
+
+			const machineState before = b.getState();
+
+			if(pc == 0x0005)
+			{
+				bdos(a, false);
+				bdos(b, true);
+				n = 1;
+			}
+			else
+			{
+				// Engines that run whole blocks are followed instruction by instruction
+				n = a.step();
+				for(std::uint64_t k = 0; k < n; ++k) b.step();
+			}
+
+			std::string what = compareRegisters(a, b);
+			if(what.empty() and ((i + n) / memoryCheckInterval != i / memoryCheckInterval or i + n >= steps))
+				what = compareMemory(a, b);
+
+			if(not what.empty())
+			{
+				std::fflush(stdout);
+				std::printf("\n%s diverged at instruction %llu: %s", filename.c_str(),
+					(unsigned long long)i, describe(a, b, before, b.memory(), what).c_str());
+				return 1;
+			}
+		}
+
+		std::printf("\n%s: stopped after %llu instructions with no divergence\n",
+			filename.c_str(), (unsigned long long)steps);
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::uint64_t cases = 1000;
+	std::uint64_t steps = 0;
+	std::uint64_t seed = 1;
+	unsigned threads = std::thread::hardware_concurrency();
+	std::string program;
+	std::string engineName = "cpu";
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if(arg == "--cases" and hasValue) cases = std::strtoull(argv[++i], nullptr, 0);
+		else if(arg == "--steps" and hasValue) steps = std::strtoull(argv[++i], nullptr, 0);
+		else if(arg == "--seed" and hasValue) seed = std::strtoull(argv[++i], nullptr, 0);
+		else if(arg == "--threads" and hasValue) threads = std::strtoul(argv[++i], nullptr, 0);
+		else if(arg == "--program" and hasValue) program = argv[++i];
+		else if(arg == "--engine" and hasValue) engineName = argv[++i];
+		else
+		{
+			std::fprintf(stderr,
+				"Usage: %s [--cases N] [--steps N] [--seed N] [--threads N]\n"
+				"       [--engine cpu|blocks|tiered]\n"
+				"       %s --program FILE.COM [--steps N] [--engine cpu|blocks|tiered|recompiled]\n", argv[0], argv[0]);
+			return 2;
+		}
+	}
+
+	std::unique_ptr<engine> a = makeEngine(engineName, not program.empty());
+
+	if(not a)
+	{
+		std::fprintf(stderr, "Engine %s is not available%s\n", engineName.c_str(),
+			program.empty() ? " for random cases" : "");
+		return 2;
+	}
+
+	if(not program.empty())
+		return runProgram(program, steps ? steps : UINT64_MAX, *a);
+
+	return runRandomCases(cases, steps ? steps : 10000, seed, threads, engineName);
+}
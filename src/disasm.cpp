@@ -0,0 +1,194 @@
+/**
+ * @file disasm.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Disassembles a .hex, .com or raw binary file.
+   Usage: disasm INPUT[@ORIGIN] [--begin ADDR] [--length N] [--time]
+                 [--cfg] [--dot FILE] [--entry ADDR]... [--vectors MASK]
+   .com files are loaded at 0x0100, with a `ret` at the BDOS entry point,
+   and raw binaries at ORIGIN (default 0); .hex
+   files are loaded where their records say. The loaded range, or --begin and
+   --length (hex) if given, is listed to stdout. --time instead reports how fast
+   that range is decoded and formatted.
+   --cfg recovers the control flow graph from the entry points (--entry, or by
+   default the start address of the file) and the interrupt vectors in MASK
+   (bit n for rst n), and summarizes it; --dot writes it in DOT format.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./disassembler.hpp"
+#include "./cfg.hpp"
+#include "./image.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief Reports the speed of decoding, and of formatting, the range
+	   `begin` to `begin + length`.
+	 */
+	void timeDisassembly(const std::vector<byte>& memory, const bytePair begin, const std::uint32_t length)
+	{
+		using clock = std::chrono::steady_clock;
+
+		// Enough repetitions to decode about 64 MB
+		const int reps = std::max<std::uint32_t>(1, (64 << 20) / std::max<std::uint32_t>(length, 1));
+
+		std::vector<instruction> instructions;
+		instructions.reserve(length);
+
+		auto start = clock::now();
+		std::size_t count = 0;
+
+		for(int i = 0; i < reps; ++i)
+		{
+			instructions.clear();
+			count += disassemble(memory.data(), begin, length, instructions);
+		}
+
+		const double decodeSeconds = std::chrono::duration<double>(clock::now() - start).count();
+		const int formatReps = std::max(1, reps / 10);
+
+		start = clock::now();
+		std::size_t characters = 0;
+
+		for(int i = 0; i < formatReps; ++i)
+			characters += formatListing(instructions, memory.data()).size();
+
+		const double formatSeconds = std::chrono::duration<double>(clock::now() - start).count();
+
+		std::printf("decode: %.0f MB/s, %.0f M instructions/s\n",
+			(double)reps * length / decodeSeconds / 1e6, count / decodeSeconds / 1e6);
+		std::printf("format: %.0f M instructions/s, %.0f MB/s of text\n",
+			(double)formatReps * instructions.size() / formatSeconds / 1e6, characters / formatSeconds / 1e6);
+	}
+
+	/**
+	 * @brief Recovers and summarizes the control flow graph, and writes it
+	   to `dotFile` if that is not empty.
+	 */
+	int analyze(const std::vector<byte>& memory, const std::vector<bytePair>& entryPoints, const cfgOptions& options, const std::string& dotFile)
+	{
+		const auto begin = std::chrono::steady_clock::now();
+		const controlFlowGraph graph = recoverControlFlow(memory.data(), entryPoints, options);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		std::size_t codeBytes = 0, dataBytes = 0, unresolved = 0;
+		for(const byteKind k : graph.kinds)
+		{
+			if(k == byteKind::opcode or k == byteKind::operand) ++codeBytes;
+			else if(k == byteKind::data) ++dataBytes;
+		}
+		for(const auto& block : graph.blocks)
+		{
+			if(block.unresolved) ++unresolved;
+		}
+
+		std::printf("%zu blocks, %zu instructions, %zu functions in %.2f ms\n",
+			graph.blocks.size(), graph.instructions.size(), graph.callGraph.size(), seconds * 1e3);
+		std::printf("%zu bytes of code, %zu bytes of data\n", codeBytes, dataBytes);
+		std::printf("%zu indirect jumps resolved, %zu pchl unresolved; %zu conflicting addresses\n",
+			graph.indirectTargets.size(), unresolved, graph.conflicts.size());
+
+		for(const auto& function : graph.callGraph)
+		{
+			std::printf("%04X:", function.first);
+			for(const bytePair callee : function.second) std::printf(" %04X", callee);
+			std::printf("\n");
+		}
+
+		if(not dotFile.empty())
+		{
+			const std::string dot = graph.toDot();
+			std::FILE *const file = std::fopen(dotFile.c_str(), "w");
+
+			if(not file or std::fwrite(dot.data(), 1, dot.size(), file) != dot.size())
+			{
+				std::fprintf(stderr, "disasm: cannot write %s\n", dotFile.c_str());
+				if(file) std::fclose(file);
+				return 1;
+			}
+
+			std::fclose(file);
+		}
+
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s INPUT[@ORIGIN] [--begin ADDR] [--length N] [--time]\n"
+			"       [--cfg] [--dot FILE] [--entry ADDR]... [--vectors MASK]\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<byte> memory(0x10000);
+	imageInfo image;
+	std::string error;
+
+	if(not loadImageArgument(argv[1], memory.data(), image, error))
+	{
+		std::fprintf(stderr, "disasm: %s\n", error.c_str());
+		return 1;
+	}
+
+	std::uint32_t begin = image.begin, length = image.length;
+	const bytePair start = image.start;
+
+	bool timeOnly = false;
+	bool cfg = false;
+	std::string dotFile;
+	std::vector<bytePair> entryPoints;
+	cfgOptions options;
+
+	for(int i = 2; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+
+		if(arg == "--begin" and i + 1 < argc) begin = std::strtoul(argv[++i], nullptr, 16) & 0xffff;
+		else if(arg == "--length" and i + 1 < argc) length = std::min(std::strtoul(argv[++i], nullptr, 16), 0x10000ul);
+		else if(arg == "--time") timeOnly = true;
+		else if(arg == "--cfg") cfg = true;
+		else if(arg == "--dot" and i + 1 < argc) dotFile = argv[++i];
+		else if(arg == "--entry" and i + 1 < argc) entryPoints.push_back(std::strtoul(argv[++i], nullptr, 16));
+		else if(arg == "--vectors" and i + 1 < argc) options.interruptVectors = std::strtoul(argv[++i], nullptr, 16);
+		else
+		{
+			std::fprintf(stderr, "disasm: unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	if(timeOnly)
+	{
+		timeDisassembly(memory, begin, length);
+		return 0;
+	}
+
+	if(cfg or not dotFile.empty())
+		return analyze(memory, entryPoints.empty() ? std::vector<bytePair>{start} : entryPoints, options, dotFile);
+
+	std::vector<instruction> instructions;
+	disassemble(memory.data(), begin, length, instructions);
+
+	const std::string listing = formatListing(instructions, memory.data());
+	std::fwrite(listing.data(), 1, listing.size(), stdout);
+	return 0;
+}
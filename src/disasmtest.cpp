@@ -0,0 +1,200 @@
+/**
+ * @file disasmtest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks the disassembler: the length, operand and text of every one
+   of the 256 opcodes, numbers written as Intel's assembler writes them,
+   operands read across the end of memory, listing lines and linear sweeps.
+   Usage: disasmtest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./disassembler.hpp"
+#include "./check.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief Each opcode as written with the bytes 34H and 0A2H after it.
+	   Undocumented opcodes are written as the instructions they run as.
+	 */
+	const char *const expectedText[256] = {
+		"NOP", "LXI B,0A234H", "STAX B", "INX B",
+		"INR B", "DCR B", "MVI B,34H", "RLC",
+		"NOP", "DAD B", "LDAX B", "DCX B",
+		"INR C", "DCR C", "MVI C,34H", "RRC",
+		"NOP", "LXI D,0A234H", "STAX D", "INX D",
+		"INR D", "DCR D", "MVI D,34H", "RAL",
+		"NOP", "DAD D", "LDAX D", "DCX D",
+		"INR E", "DCR E", "MVI E,34H", "RAR",
+		"NOP", "LXI H,0A234H", "SHLD 0A234H", "INX H",
+		"INR H", "DCR H", "MVI H,34H", "DAA",
+		"NOP", "DAD H", "LHLD 0A234H", "DCX H",
+		"INR L", "DCR L", "MVI L,34H", "CMA",
+		"NOP", "LXI SP,0A234H", "STA 0A234H", "INX SP",
+		"INR M", "DCR M", "MVI M,34H", "STC",
+		"NOP", "DAD SP", "LDA 0A234H", "DCX SP",
+		"INR A", "DCR A", "MVI A,34H", "CMC",
+		"MOV B,B", "MOV B,C", "MOV B,D", "MOV B,E",
+		"MOV B,H", "MOV B,L", "MOV B,M", "MOV B,A",
+		"MOV C,B", "MOV C,C", "MOV C,D", "MOV C,E",
+		"MOV C,H", "MOV C,L", "MOV C,M", "MOV C,A",
+		"MOV D,B", "MOV D,C", "MOV D,D", "MOV D,E",
+		"MOV D,H", "MOV D,L", "MOV D,M", "MOV D,A",
+		"MOV E,B", "MOV E,C", "MOV E,D", "MOV E,E",
+		"MOV E,H", "MOV E,L", "MOV E,M", "MOV E,A",
+		"MOV H,B", "MOV H,C", "MOV H,D", "MOV H,E",
+		"MOV H,H", "MOV H,L", "MOV H,M", "MOV H,A",
+		"MOV L,B", "MOV L,C", "MOV L,D", "MOV L,E",
+		"MOV L,H", "MOV L,L", "MOV L,M", "MOV L,A",
+		"MOV M,B", "MOV M,C", "MOV M,D", "MOV M,E",
+		"MOV M,H", "MOV M,L", "HLT", "MOV M,A",
+		"MOV A,B", "MOV A,C", "MOV A,D", "MOV A,E",
+		"MOV A,H", "MOV A,L", "MOV A,M", "MOV A,A",
+		"ADD B", "ADD C", "ADD D", "ADD E",
+		"ADD H", "ADD L", "ADD M", "ADD A",
+		"ADC B", "ADC C", "ADC D", "ADC E",
+		"ADC H", "ADC L", "ADC M", "ADC A",
+		"SUB B", "SUB C", "SUB D", "SUB E",
+		"SUB H", "SUB L", "SUB M", "SUB A",
+		"SBB B", "SBB C", "SBB D", "SBB E",
+		"SBB H", "SBB L", "SBB M", "SBB A",
+		"ANA B", "ANA C", "ANA D", "ANA E",
+		"ANA H", "ANA L", "ANA M", "ANA A",
+		"XRA B", "XRA C", "XRA D", "XRA E",
+		"XRA H", "XRA L", "XRA M", "XRA A",
+		"ORA B", "ORA C", "ORA D", "ORA E",
+		"ORA H", "ORA L", "ORA M", "ORA A",
+		"CMP B", "CMP C", "CMP D", "CMP E",
+		"CMP H", "CMP L", "CMP M", "CMP A",
+		"RNZ", "POP B", "JNZ 0A234H", "JMP 0A234H",
+		"CNZ 0A234H", "PUSH B", "ADI 34H", "RST 0",
+		"RZ", "RET", "JZ 0A234H", "JMP 0A234H",
+		"CZ 0A234H", "CALL 0A234H", "ACI 34H", "RST 1",
+		"RNC", "POP D", "JNC 0A234H", "OUT 34H",
+		"CNC 0A234H", "PUSH D", "SUI 34H", "RST 2",
+		"RC", "RET", "JC 0A234H", "IN 34H",
+		"CC 0A234H", "CALL 0A234H", "SBI 34H", "RST 3",
+		"RPO", "POP H", "JPO 0A234H", "XTHL",
+		"CPO 0A234H", "PUSH H", "ANI 34H", "RST 4",
+		"RPE", "PCHL", "JPE 0A234H", "XCHG",
+		"CPE 0A234H", "CALL 0A234H", "XRI 34H", "RST 5",
+		"RP", "POP PSW", "JP 0A234H", "DI",
+		"CP 0A234H", "PUSH PSW", "ORI 34H", "RST 6",
+		"RM", "SPHL", "JM 0A234H", "EI",
+		"CM 0A234H", "CALL 0A234H", "CPI 34H", "RST 7"
+	};
+
+	/**
+	 * @return `std::string` `memory` at `address` decoded and formatted.
+	 */
+	std::string textAt(const byte* memory, const bytePair address)
+	{
+		char text[maxInstructionText + 1];
+		const std::size_t length = formatInstruction(decodeInstruction(memory, address), text);
+
+		CHECK(length == std::strlen(text) and length <= maxInstructionText);
+		return text;
+	}
+}
+
+int main(void)
+{
+	std::vector<byte> memory(0x10000);
+
+	for(int opcode = 0; opcode < 0x100; ++opcode)
+	{
+		memory[0x1000] = opcode;
+		memory[0x1001] = 0x34;
+		memory[0x1002] = 0xa2;
+
+		const instruction instr = decodeInstruction(memory.data(), 0x1000);
+		const std::string expected = expectedText[opcode];
+
+		// The operand in the text gives the length
+		const byte length = expected.find("0A234H") != std::string::npos ? 3 : expected.find("34H") != std::string::npos ? 2 : 1;
+		const bytePair operand = length == 3 ? 0xa234 : length == 2 ? 0x34 : 0;
+
+		if(not CHECK(instr.address == 0x1000 and instr.opcode == opcode))
+			continue;
+
+		if(not CHECK(instr.length == length and instr.operand == operand))
+			std::printf("opcode %02x: length %u operand %04x\n", opcode, instr.length, instr.operand);
+
+		const std::string text = textAt(memory.data(), 0x1000);
+
+		if(not CHECK(text == expected))
+			std::printf("opcode %02x: \"%s\", expected \"%s\"\n", opcode, text.c_str(), expected.c_str());
+	}
+
+	// A leading 0 only before a letter, and every digit kept
+	{
+		const byte code[] = {0x3e, 0x07, 0x21, 0xc5, 0x00, 0xc6, 0xff, 0xc3, 0xff, 0xff, 0x01, 0x00, 0x00};
+		std::copy(std::begin(code), std::end(code), memory.begin() + 0x2000);
+
+		CHECK(textAt(memory.data(), 0x2000) == "MVI A,07H");
+		CHECK(textAt(memory.data(), 0x2002) == "LXI H,00C5H");
+		CHECK(textAt(memory.data(), 0x2005) == "ADI 0FFH");
+		CHECK(textAt(memory.data(), 0x2007) == "JMP 0FFFFH");
+		CHECK(textAt(memory.data(), 0x200a) == "LXI B,0000H");
+	}
+
+	// Operands past 0xffff are read from 0x0000
+	{
+		memory[0xffff] = 0x01;
+		memory[0x0000] = 0x34;
+		memory[0x0001] = 0x12;
+
+		const instruction instr = decodeInstruction(memory.data(), 0xffff);
+		CHECK(instr.length == 3 and instr.operand == 0x1234);
+	}
+
+	// Listing lines, with the bytes of the instruction in a fixed width
+	{
+		const byte code[] = {0x21, 0x34, 0x12, 0x3e, 0x41, 0x76};
+		std::copy(std::begin(code), std::end(code), memory.begin() + 0x0100);
+
+		std::vector<instruction> instructions;
+		CHECK(disassemble(memory.data(), 0x0100, sizeof code, instructions) == 3);
+
+		CHECK(formatListing(instructions, memory.data()) ==
+			"0100  21 34 12  LXI H,1234H\n"
+			"0103  3E 41     MVI A,41H\n"
+			"0105  76        HLT\n");
+
+		char line[maxListingLine + 1];
+		CHECK(formatListingLine(instructions[0], memory.data(), line) == std::strlen(line));
+	}
+
+	// A linear sweep treats every byte as code, and its last instruction
+	// may run past the end of the range, here across the end of memory
+	{
+		const byte code[] = {0x00, 0x06, 0x01, 0xcd};
+		std::copy(std::begin(code), std::end(code), memory.begin() + 0xfffc);
+
+		std::vector<instruction> instructions(1);
+		CHECK(disassemble(memory.data(), 0xfffc, 4, instructions) == 3);
+		CHECK(instructions.size() == 4);
+		CHECK(instructions[1].address == 0xfffc and instructions[1].length == 1);
+		CHECK(instructions[2].address == 0xfffd and instructions[2].operand == 0x01);
+		CHECK(instructions[3].address == 0xffff and instructions[3].length == 3 and instructions[3].operand == 0x1234);
+
+		// The whole of memory
+		instructions.clear();
+		std::fill(memory.begin(), memory.end(), 0);
+		CHECK(disassemble(memory.data(), 0, 0x10000, instructions) == 0x10000);
+	}
+
+	return checks::summary("disasmtest");
+}
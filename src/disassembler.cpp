@@ -0,0 +1,192 @@
+/**
+ * @file disassembler.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Decodes Intel 8080 machine code into a compact array of instructions,
+   and formats instructions as assembly text.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `disassembler.hpp`.
+
+#include "./disassembler.hpp"
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief The bits of the 2 bytes after the opcode that are operands,
+	   by instruction length.
+	 */
+	constexpr bytePair operandMask[4] = {0, 0, 0x00ff, 0xffff};
+
+	const char *const registerNames[8] = {"B", "C", "D", "E", "H", "L", "M", "A"};
+	const char *const pairNames[4] = {"B", "D", "H", "SP"};
+	const char *const pairPswNames[4] = {"B", "D", "H", "PSW"};
+
+	char* appendText(char* out, const char* text) noexcept
+	{
+		while(*text) *out++ = *text++;
+		return out;
+	}
+
+	char hexDigit(const unsigned value) noexcept
+	{
+		return "0123456789ABCDEF"[value & 0xf];
+	}
+
+	/**
+	 * @brief Appends `digits` hex digits of `value`, without a suffix.
+	 */
+	char* appendHex(char* out, const unsigned value, const int digits) noexcept
+	{
+		for(int i = digits - 1; i >= 0; --i)
+			*out++ = hexDigit(value >> (4 * i));
+
+		return out;
+	}
+
+	/**
+	 * @brief Appends a number as Intel's assembler writes it: hex digits
+	   followed by `H`, with a leading 0 if the first digit is a letter.
+	 */
+	char* appendNumber(char* out, const unsigned value, const int digits) noexcept
+	{
+		if((value >> (4 * (digits - 1)) & 0xf) > 9) *out++ = '0';
+		out = appendHex(out, value, digits);
+		*out++ = 'H';
+		return out;
+	}
+
+	char* appendOperand(char* out, const operandKind kind, const instruction& instr) noexcept
+	{
+		switch(kind)
+		{
+			case operandKind::none: break;
+			case operandKind::destination: out = appendText(out, registerNames[instr.opcode >> 3 & 7]); break;
+			case operandKind::source: out = appendText(out, registerNames[instr.opcode & 7]); break;
+			case operandKind::pair: out = appendText(out, pairNames[instr.opcode >> 4 & 3]); break;
+			case operandKind::pairPsw: out = appendText(out, pairPswNames[instr.opcode >> 4 & 3]); break;
+			case operandKind::immediate8:
+			case operandKind::port: out = appendNumber(out, instr.operand, 2); break;
+			case operandKind::immediate16:
+			case operandKind::address: out = appendNumber(out, instr.operand, 4); break;
+			case operandKind::vector: *out++ = '0' + (instr.opcode >> 3 & 7); break;
+		}
+
+		return out;
+	}
+}
+
+instruction intel8080::decodeInstruction(const byte *const memory, const bytePair address) noexcept
+{
+	const byte opcode = memory[address];
+	const byte length = opcodes[opcode].length;
+	const bytePair operand = memory[(bytePair)(address + 1)] | memory[(bytePair)(address + 2)] << 8;
+
+	return {address, opcode, length, (bytePair)(operand & operandMask[length])};
+}
+
+std::size_t intel8080::disassemble(const byte *const memory, const bytePair begin, const std::uint32_t length, std::vector<instruction>& out)
+{
+	const std::size_t first = out.size();
+
+	// At most one instruction per byte; the vector is shrunk afterwards
+	out.resize(first + length);
+	instruction* p = out.data() + first;
+
+	std::uint32_t offset = 0;
+
+	// Instructions that cannot read past 0xffff, without wrapping
+	const std::uint32_t unwrapped = begin + length <= 0xfffe ? length : (begin <= 0xfffe ? 0xfffe - begin : 0);
+
+	while(offset < unwrapped)
+	{
+		const bytePair address = begin + offset;
+		const byte opcode = memory[address];
+		const byte instrLength = opcodes[opcode].length;
+		const bytePair operand = (memory[address + 1] | memory[address + 2] << 8) & operandMask[instrLength];
+
+		*p++ = {address, opcode, instrLength, operand};
+		offset += instrLength;
+	}
+
+	while(offset < length)
+	{
+		*p = decodeInstruction(memory, begin + offset);
+		offset += p++->length;
+	}
+
+	const std::size_t count = p - (out.data() + first);
+	out.resize(first + count);
+	return count;
+}
+
+std::size_t intel8080::formatInstruction(const instruction& instr, char *const out) noexcept
+{
+	const opcodeInfo& info = opcodes[instr.opcode];
+	char* p = appendText(out, info.mnemonic);
+
+	if(info.first != operandKind::none)
+	{
+		*p++ = ' ';
+		p = appendOperand(p, info.first, instr);
+	}
+
+	if(info.second != operandKind::none)
+	{
+		*p++ = ',';
+		p = appendOperand(p, info.second, instr);
+	}
+
+	*p = '\0';
+	return p - out;
+}
+
+std::size_t intel8080::formatListingLine(const instruction& instr, const byte *const memory, char *const out) noexcept
+{
+	char* p = appendHex(out, instr.address, 4);
+	*p++ = ' ';
+
+	for(int i = 0; i < 3; ++i)
+	{
+		*p++ = ' ';
+
+		if(i < instr.length)
+		{
+			p = appendHex(p, memory[(bytePair)(instr.address + i)], 2);
+		}
+		else
+		{
+			*p++ = ' ';
+			*p++ = ' ';
+		}
+	}
+
+	*p++ = ' ';
+	*p++ = ' ';
+	p += formatInstruction(instr, p);
+	*p++ = '\n';
+	*p = '\0';
+	return p - out;
+}
+
+std::string intel8080::formatListing(const std::vector<instruction>& instructions, const byte *const memory)
+{
+	std::string listing;
+	listing.reserve(instructions.size() * 32);
+
+	char line[maxListingLine + 1];
+
+	for(const auto& instr : instructions)
+		listing.append(line, formatListingLine(instr, memory, line));
+
+	return listing;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file disassembler.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Decodes Intel 8080 machine code into a compact array of instructions,
+   and formats instructions as assembly text.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+#include "./opcodes.hpp"
+
+#include <string>
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief A decoded instruction. Everything else about it (mnemonic,
+	   operand kinds, cycles, flow) is found in `opcodes[opcode]`.
+	 */
+	struct instruction
+	{
+		/**
+		 * @brief The address of the opcode.
+		 */
+		bytePair address;
+
+		/**
+		 * @brief The opcode.
+		 */
+		byte opcode;
+
+		/**
+		 * @brief The length of the instruction in bytes.
+		 */
+		byte length;
+
+		/**
+		 * @brief The bytes following the opcode as a little-endian integer;
+		   only the low byte is meaningful for 2-byte instructions, and 0 for
+		   1-byte instructions.
+		 */
+		bytePair operand;
+
+		/**
+		 * @brief Leaves the instruction uninitialized, so that arrays of
+		   instructions can be allocated without being cleared first.
+		 */
+		instruction(void) noexcept {}
+
+		instruction(const bytePair address, const byte opcode, const byte length, const bytePair operand) noexcept
+		:
+			address(address), opcode(opcode), length(length), operand(operand)
+		{}
+	};
+
+	/**
+	 * @brief The maximum length of the text written by `formatInstruction`,
+	   not including the null terminator.
+	 */
+	constexpr std::size_t maxInstructionText = 16;
+
+	/**
+	 * @brief The maximum length of the line written by `formatListingLine`,
+	   not including the null terminator.
+	 */
+	constexpr std::size_t maxListingLine = 40;
+
+	/**
+	 * @brief Decodes the instruction at `address`. Operand bytes past 0xffff
+	   are read from 0x0000.
+	 *
+	 * @param memory `const byte*` 65536 bytes of memory.
+	 * @param address `bytePair` The address of the opcode.
+	 * @return `instruction` The decoded instruction.
+	 */
+	instruction decodeInstruction(const byte* memory, const bytePair address) noexcept;
+
+	/**
+	 * @brief Decodes consecutive instructions from `begin` until `length`
+	   bytes have been covered, appending them to `out`. The last instruction
+	   may extend past the end of the range.
+	 * Every byte is treated as code; this is a linear sweep, not a trace of
+	   control flow.
+	 *
+	 * @param memory `const byte*` 65536 bytes of memory.
+	 * @param begin `bytePair` The address of the first instruction.
+	 * @param length `std::uint32_t` The number of bytes to decode, up to 0x10000.
+	 * @param out `std::vector<instruction>&` The instructions are appended here.
+	 * @return `std::size_t` The number of instructions decoded.
+	 */
+	std::size_t disassemble(const byte* memory, const bytePair begin, const std::uint32_t length, std::vector<instruction>& out);
+
+	/**
+	 * @brief Writes an instruction as assembly, e.g. `LXI H,1234H`, with
+	   numbers in hexadecimal as written by Intel's assembler.
+	 *
+	 * @param instr `const instruction&` The instruction.
+	 * @param out `char*` At least `maxInstructionText + 1` characters. The
+	   text is null-terminated.
+	 * @return `std::size_t` The length of the text.
+	 */
+	std::size_t formatInstruction(const instruction& instr, char* out) noexcept;
+
+	/**
+	 * @brief Writes a line of a listing: the address, the bytes of the
+	   instruction and the instruction, e.g. `0100  21 34 12  LXI H,1234H`,
+	   followed by a newline.
+	 *
+	 * @param instr `const instruction&` The instruction.
+	 * @param memory `const byte*` The memory it was decoded from.
+	 * @param out `char*` At least `maxListingLine + 1` characters. The text
+	   is null-terminated.
+	 * @return `std::size_t` The length of the line.
+	 */
+	std::size_t formatListingLine(const instruction& instr, const byte* memory, char* out) noexcept;
+
+	/**
+	 * @brief Formats a listing of several instructions.
+	 *
+	 * @param instructions `const std::vector<instruction>&` The instructions.
+	 * @param memory `const byte*` The memory they were decoded from.
+	 * @return `std::string` One line per instruction, as by `formatListingLine`.
+	 */
+	std::string formatListing(const std::vector<instruction>& instructions, const byte* memory);
+}
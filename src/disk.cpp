@@ -0,0 +1,161 @@
+/**
+ * @file disk.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Floppy and hard disk images for CP/M, mapped into memory.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `disk.hpp`.
+
+#include "./disk.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace intel8080;
+
+std::uint32_t diskGeometry::imageSize(void) const noexcept
+{
+	return tracks * sectorsPerTrack * diskImage::sectorSize;
+}
+
+std::uint32_t diskGeometry::blocks(void) const noexcept
+{
+	return (tracks - reservedTracks) * sectorsPerTrack * diskImage::sectorSize / blockSize;
+}
+
+std::vector<byte> diskGeometry::translationTable(void) const
+{
+	std::vector<byte> table;
+
+	if(skew == 0)
+		return table;
+
+	// Each logical sector is `skew` past the last, or the next unused one
+	// after that if it is taken
+	std::vector<bool> used(sectorsPerTrack);
+	std::uint32_t physical = 0;
+
+	for(std::uint32_t logical = 0; logical < sectorsPerTrack; ++logical)
+	{
+		while(used[physical]) physical = (physical + 1) % sectorsPerTrack;
+
+		used[physical] = true;
+		table.push_back(physical + firstSector);
+		physical = (physical + skew) % sectorsPerTrack;
+	}
+
+	return table;
+}
+
+bool diskGeometry::valid(void) const noexcept
+{
+	const bool powerOfTwo = (blockSize & (blockSize - 1)) == 0;
+
+	// The directory is allocated from a 16-bit mask of blocks
+	return tracks > reservedTracks and sectorsPerTrack > 0 and sectorsPerTrack <= 0xffff
+		and (skew == 0 or firstSector + sectorsPerTrack <= 0x100)
+		and firstSector + sectorsPerTrack <= 0x10000
+		and (std::uint64_t)tracks * sectorsPerTrack * diskImage::sectorSize <= UINT32_MAX
+		and powerOfTwo and blockSize >= 1024 and blockSize <= 16384
+		and blocks() > 0 and blocks() <= 0x10000 and (blocks() <= 256 or blockSize >= 2048)
+		and directoryEntries > 0 and directoryEntries % 4 == 0
+		and directoryEntries * 32 <= 16 * blockSize and directoryEntries * 32 <= blocks() * blockSize;
+}
+
+diskImage::~diskImage()
+{
+	close();
+}
+
+bool diskImage::open(const std::string& filename, const diskGeometry& g /* = diskGeometry() */, const bool ro /* = false */) noexcept
+{
+	close();
+
+	if(not g.valid())
+		return false;
+
+	fd = ::open(filename.c_str(), ro ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+	if(fd < 0)
+		return false;
+
+	struct stat st;
+	const std::uint32_t expected = g.imageSize();
+
+	if(fstat(fd, &st) != 0 or (ro and (std::uint64_t)st.st_size < expected)
+		or (not ro and (std::uint64_t)st.st_size < expected and ftruncate(fd, expected) != 0))
+	{
+		close();
+		return false;
+	}
+
+	// Written back to the file if the image is writable
+	void *const p = mmap(nullptr, expected, ro ? PROT_READ : PROT_READ | PROT_WRITE, ro ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+	if(p == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	mapping = (byte*)p;
+	size = expected;
+	geometry = g;
+	readOnly = ro;
+
+	// Sectors added to extend the file are formatted
+	if((std::uint64_t)st.st_size < expected)
+		std::memset(mapping + st.st_size, formatByte, expected - st.st_size);
+
+	return true;
+}
+
+void diskImage::close(void) noexcept
+{
+	if(mapping) munmap(mapping, size);
+	if(fd >= 0) ::close(fd);
+
+	mapping = nullptr;
+	size = 0;
+	fd = -1;
+}
+
+bool diskImage::isOpen(void) const noexcept
+{
+	return mapping;
+}
+
+bool diskImage::isReadOnly(void) const noexcept
+{
+	return readOnly;
+}
+
+const diskGeometry& diskImage::getGeometry(void) const noexcept
+{
+	return geometry;
+}
+
+byte* diskImage::sector(const std::uint32_t track, const std::uint32_t s) const noexcept
+{
+	const std::uint32_t index = s - geometry.firstSector;
+
+	if(not mapping or track >= geometry.tracks or index >= geometry.sectorsPerTrack)
+		return nullptr;
+
+	return mapping + (track * geometry.sectorsPerTrack + index) * sectorSize;
+}
+
+byte* diskImage::data(void) const noexcept
+{
+	return mapping;
+}
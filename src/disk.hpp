@@ -0,0 +1,152 @@
+/**
+ * @file disk.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Floppy and hard disk images for CP/M, mapped into memory.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+#include <string>
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief The layout of a disk, as CP/M 2.2 sees it. Sectors are CP/M's
+	   128-byte records; an image holds every sector of every track in order.
+	 * The defaults are the IBM 3740 8" single-sided single-density disk that
+	   CP/M was distributed on.
+	 * @see http://www.gaby.de/cpm/manuals/archive/cpm22htm/ch6.htm
+	 */
+	struct diskGeometry
+	{
+		std::uint32_t tracks = 77;
+		std::uint32_t sectorsPerTrack = 26;
+
+		/**
+		 * @brief The tracks before the directory, which hold the system.
+		 */
+		std::uint32_t reservedTracks = 2;
+
+		/**
+		 * @brief The allocation unit, in bytes: 1024 to 16384, and at least
+		   2048 if the disk has more than 256 blocks.
+		 */
+		std::uint32_t blockSize = 1024;
+
+		std::uint32_t directoryEntries = 64;
+
+		/**
+		 * @brief The number of physical sectors between consecutive logical
+		   ones, or 0 for no translation.
+		 */
+		std::uint32_t skew = 6;
+
+		/**
+		 * @brief The number of the first physical sector on a track.
+		 */
+		std::uint32_t firstSector = 1;
+
+		/**
+		 * @brief Whether the disk can be removed, so that the BDOS checks
+		   its directory for changes.
+		 */
+		bool removable = true;
+
+		/**
+		 * @return `std::uint32_t` The size of an image, in bytes.
+		 */
+		std::uint32_t imageSize(void) const noexcept;
+
+		/**
+		 * @return `std::uint32_t` The number of blocks after the reserved tracks.
+		 */
+		std::uint32_t blocks(void) const noexcept;
+
+		/**
+		 * @return `std::vector<byte>` The physical sector of each logical
+		   one, as a BIOS's sector translation table, or nothing if there is
+		   no skew.
+		 */
+		std::vector<byte> translationTable(void) const;
+
+		/**
+		 * @return `bool` Whether CP/M 2.2 can use a disk with this layout.
+		 */
+		bool valid(void) const noexcept;
+	};
+
+	/**
+	 * @brief A disk image file, mapped into memory so that sectors are read
+	   and written in place. Writes reach the file when the operating system
+	   flushes the mapping, and at the latest when the image is closed.
+	 */
+	class diskImage
+	{
+	public:
+		static constexpr std::uint32_t sectorSize = 128;
+
+		/**
+		 * @brief The byte of a freshly formatted disk, which marks the
+		   directory entries as unused.
+		 */
+		static constexpr byte formatByte = 0xe5;
+
+		diskImage(void) = default;
+		diskImage(const diskImage&) = delete;
+		diskImage& operator=(const diskImage&) = delete;
+		~diskImage();
+
+		/**
+		 * @brief Maps the image `filename`, closing any image already open.
+		 * A file smaller than `geometry` describes is extended, with the new
+		   sectors formatted, unless `readOnly`.
+		 *
+		 * @param filename `const std::string&` The image file.
+		 * @param geometry `const diskGeometry&` The layout of the disk.
+		 * @param readOnly `bool` Whether writes fail instead.
+		 * @return `bool` Whether the image was opened.
+		 */
+		bool open(const std::string& filename, const diskGeometry& geometry = diskGeometry(), const bool readOnly = false) noexcept;
+
+		/**
+		 * @brief Unmaps the image, writing back any changes.
+		 */
+		void close(void) noexcept;
+
+		bool isOpen(void) const noexcept;
+		bool isReadOnly(void) const noexcept;
+		const diskGeometry& getGeometry(void) const noexcept;
+
+		/**
+		 * @param track `std::uint32_t` The track.
+		 * @param sector `std::uint32_t` The physical sector, numbered from
+		   `diskGeometry::firstSector`.
+		 * @return `byte*` The sector's 128 bytes in the image, or `nullptr`
+		   if there is no such sector.
+		 */
+		byte* sector(const std::uint32_t track, const std::uint32_t sector) const noexcept;
+
+		/**
+		 * @return `byte*` The whole image, `getGeometry().imageSize()` bytes.
+		 */
+		byte* data(void) const noexcept;
+
+	private:
+		diskGeometry geometry;
+		byte* mapping = nullptr;
+		std::uint32_t size = 0;
+		int fd = -1;
+		bool readOnly = false;
+	};
+}
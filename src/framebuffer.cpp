@@ -0,0 +1,394 @@
+/**
+ * @file framebuffer.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Pictures and digests of 1bpp framebuffers in the memory of a
+   `cpu`, for running machines headless.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `framebuffer.hpp`.
+
+#include "./framebuffer.hpp"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief 16 pixels of one byte each, 4 of 32 bits each, and two halves
+	   of 64 bits: the width of an SSE2 or NEON register.
+	 */
+	using bytes = byte __attribute__((vector_size(16)));
+	using words = std::uint32_t __attribute__((vector_size(16)));
+	using halves = std::uint64_t __attribute__((vector_size(16)));
+
+	constexpr std::uint64_t spreadByte = 0x0101010101010101;
+
+	/**
+	 * @brief Transposes an 8 x 8 matrix of bits, whose row `i` is byte `i`
+	   and column `j` bit `j`.
+	 */
+	std::uint64_t transpose(std::uint64_t x) noexcept
+	{
+		std::uint64_t t;
+
+		t = (x ^ x >> 7) & 0x00aa00aa00aa00aa;
+		x ^= t ^ t << 7;
+		t = (x ^ x >> 14) & 0x0000cccc0000cccc;
+		x ^= t ^ t << 14;
+		t = (x ^ x >> 28) & 0x00000000f0f0f0f0;
+		x ^= t ^ t << 28;
+
+		return x;
+	}
+
+	/**
+	 * @brief Reverses the order of the bits in each byte of `x`.
+	 */
+	std::uint64_t reverseBits(std::uint64_t x) noexcept
+	{
+		x = (x >> 1 & 0x5555555555555555) | (x & 0x5555555555555555) << 1;
+		x = (x >> 2 & 0x3333333333333333) | (x & 0x3333333333333333) << 2;
+		x = (x >> 4 & 0x0f0f0f0f0f0f0f0f) | (x & 0x0f0f0f0f0f0f0f0f) << 4;
+
+		return x;
+	}
+
+	constexpr std::uint64_t prime1 = 0x9e3779b185ebca87;
+	constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4f;
+	constexpr std::uint64_t prime3 = 0x165667b19e3779f9;
+	constexpr std::uint64_t prime4 = 0x85ebca77c2b2ae63;
+	constexpr std::uint64_t prime5 = 0x27d4eb2f165667c5;
+
+	std::uint64_t rotl(const std::uint64_t x, const int n) noexcept
+	{
+		return x << n | x >> (64 - n);
+	}
+
+	std::uint64_t round(const std::uint64_t acc, const std::uint64_t input) noexcept
+	{
+		return rotl(acc + input * prime2, 31) * prime1;
+	}
+
+	template<typename T>
+	T read(const byte *const p) noexcept
+	{
+		T value;
+		std::memcpy(&value, p, sizeof value);
+		return value;
+	}
+}
+
+xxh64::xxh64(const std::uint64_t s /* = 0 */) noexcept
+:
+	seed(s),
+	lanes{s + prime1 + prime2, s + prime2, s, s - prime1}
+{}
+
+void xxh64::update(const byte* data, std::size_t size) noexcept
+{
+	total += size;
+
+	// Complete a stripe begun by the last piece
+	if(buffered)
+	{
+		const std::size_t n = std::min(size, sizeof buffer - buffered);
+
+		std::memcpy(buffer + buffered, data, n);
+		buffered += n;
+		data += n;
+		size -= n;
+
+		if(buffered < sizeof buffer)
+			return;
+
+		stripe(buffer);
+		buffered = 0;
+	}
+
+	for(; size >= sizeof buffer; data += sizeof buffer, size -= sizeof buffer)
+		stripe(data);
+
+	std::memcpy(buffer, data, size);
+	buffered = size;
+}
+
+std::uint64_t xxh64::finish(void) const noexcept
+{
+	std::uint64_t h;
+
+	if(total >= sizeof buffer)
+	{
+		h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+
+		for(const std::uint64_t lane : lanes)
+			h = (h ^ round(0, lane)) * prime1 + prime4;
+	}
+	else
+	{
+		h = seed + prime5;
+	}
+
+	h += total;
+
+	std::size_t i = 0;
+
+	for(; i + 8 <= buffered; i += 8)
+		h = rotl(h ^ round(0, read<std::uint64_t>(buffer + i)), 27) * prime1 + prime4;
+
+	if(i + 4 <= buffered)
+	{
+		h = rotl(h ^ read<std::uint32_t>(buffer + i) * prime1, 23) * prime2 + prime3;
+		i += 4;
+	}
+
+	for(; i < buffered; ++i)
+		h = rotl(h ^ buffer[i] * prime5, 11) * prime1;
+
+	h ^= h >> 33;
+	h *= prime2;
+	h ^= h >> 29;
+	h *= prime3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+void xxh64::stripe(const byte *const p) noexcept
+{
+	for(int i = 0; i < 4; ++i)
+		lanes[i] = round(lanes[i], read<std::uint64_t>(p + 8 * i));
+}
+
+std::uint32_t frameGeometry::scanlineStride(void) const noexcept
+{
+	return stride ? stride : width / 8;
+}
+
+std::uint32_t frameGeometry::pictureWidth(void) const noexcept
+{
+	return turn == rotation::clockwise or turn == rotation::anticlockwise ? scanlines : width;
+}
+
+std::uint32_t frameGeometry::pictureHeight(void) const noexcept
+{
+	return turn == rotation::clockwise or turn == rotation::anticlockwise ? width : scanlines;
+}
+
+bool frameGeometry::valid(void) const noexcept
+{
+	const bool quarterTurn = turn == rotation::clockwise or turn == rotation::anticlockwise;
+
+	return width > 0 and width % 8 == 0 and scanlines > 0 and (not quarterTurn or scanlines % 8 == 0)
+		and scanlineStride() >= width / 8
+		and base + (std::uint64_t)(scanlines - 1) * scanlineStride() + width / 8 <= 0x10000;
+}
+
+framebuffer::framebuffer(const byte* r, const frameGeometry& g) noexcept
+:
+	ram(r),
+	geometry(g)
+{}
+
+const frameGeometry& framebuffer::getGeometry(void) const noexcept
+{
+	return geometry;
+}
+
+void framebuffer::toBits(byte *const out) const noexcept
+{
+	const std::uint32_t rowBytes = geometry.pictureWidth() / 8;
+	const std::uint32_t height = geometry.pictureHeight();
+
+	for(std::uint32_t band = 0; band * 8 < height; ++band)
+		buildBand(band, out + band * 8 * rowBytes);
+}
+
+void framebuffer::toGrayscale(byte *const out, const byte lit /* = 0xff */, const byte unlit /* = 0 */) const noexcept
+{
+	const std::uint32_t width = geometry.pictureWidth();
+	const std::uint32_t height = geometry.pictureHeight();
+	std::vector<byte> bits(width);
+
+	const bytes mask = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+	const bytes litLanes = bytes{} + lit;
+	const bytes unlitLanes = bytes{} + unlit;
+
+	for(std::uint32_t band = 0; band * 8 < height; ++band)
+	{
+		buildBand(band, bits.data());
+
+		const std::uint32_t count = std::min<std::uint32_t>(8, height - band * 8) * width / 8;
+		byte *const pixels = out + band * 8 * width;
+
+		// Two bytes of the picture at a time, each spread across 8 lanes
+		std::uint32_t i = 0;
+
+		for(; i + 2 <= count; i += 2)
+		{
+			// Built in registers; storing the halves and loading them as one
+			// vector would stall
+			const bytes lanes = (bytes)halves{bits[i] * spreadByte, bits[i + 1] * spreadByte};
+			const bytes on = (bytes)((lanes & mask) != 0);
+			const bytes result = (on & litLanes) | (~on & unlitLanes);
+			std::memcpy(pixels + i * 8, &result, sizeof result);
+		}
+
+		for(; i < count; ++i)
+			for(int bit = 0; bit < 8; ++bit)
+				pixels[i * 8 + bit] = bits[i] >> bit & 1 ? lit : unlit;
+	}
+}
+
+void framebuffer::toRGBA(std::uint32_t *const out, const std::uint32_t lit /* = 0xffffffff */, const std::uint32_t unlit /* = 0xff000000 */) const noexcept
+{
+	const std::uint32_t width = geometry.pictureWidth();
+	const std::uint32_t height = geometry.pictureHeight();
+	std::vector<byte> bits(width);
+
+	const words low = {1, 2, 4, 8};
+	const words high = {16, 32, 64, 128};
+	const words litLanes = words{} + lit;
+	const words unlitLanes = words{} + unlit;
+
+	for(std::uint32_t band = 0; band * 8 < height; ++band)
+	{
+		buildBand(band, bits.data());
+
+		const std::uint32_t count = std::min<std::uint32_t>(8, height - band * 8) * width / 8;
+		std::uint32_t *const pixels = out + band * 8 * width;
+
+		for(std::uint32_t i = 0; i < count; ++i)
+		{
+			const words lanes = words{} + bits[i];
+			const words on[2] = {(words)((lanes & low) != 0), (words)((lanes & high) != 0)};
+
+			for(int half = 0; half < 2; ++half)
+			{
+				const words result = (on[half] & litLanes) | (~on[half] & unlitLanes);
+				std::memcpy(pixels + i * 8 + half * 4, &result, sizeof result);
+			}
+		}
+	}
+}
+
+std::uint64_t framebuffer::digest(const std::uint64_t seed /* = 0 */) const noexcept
+{
+	const byte *const first = ram + geometry.base;
+	const std::uint32_t lineBytes = geometry.width / 8;
+	const std::uint32_t stride = geometry.scanlineStride();
+	xxh64 h(seed);
+
+	if(stride == lineBytes)
+	{
+		h.update(first, lineBytes * geometry.scanlines);
+	}
+	else
+	{
+		for(std::uint32_t line = 0; line < geometry.scanlines; ++line)
+			h.update(first + line * stride, lineBytes);
+	}
+
+	return h.finish();
+}
+
+void framebuffer::buildBand(const std::uint32_t band, byte *const out) const noexcept
+{
+	using rotation = frameGeometry::rotation;
+
+	const byte *const first = ram + geometry.base;
+	const std::uint32_t lineBytes = geometry.width / 8;
+	const std::uint32_t stride = geometry.scanlineStride();
+	const std::uint32_t scanlines = geometry.scanlines;
+
+	// Bytes whose first pixel is the least significant bit
+	const auto normal = [this](const std::uint64_t x) noexcept { return geometry.msbFirst ? reverseBits(x) : x; };
+
+	switch(geometry.turn)
+	{
+		// A band is 8 scanlines, copied (or with their bits reversed)
+		case rotation::none:
+		case rotation::halfTurn:
+		{
+			const bool halfTurn = geometry.turn == rotation::halfTurn;
+			const std::uint32_t rows = std::min<std::uint32_t>(8, scanlines - band * 8);
+
+			for(std::uint32_t r = 0; r < rows; ++r)
+			{
+				const std::uint32_t y = band * 8 + r;
+				const byte *const line = first + (halfTurn ? scanlines - 1 - y : y) * stride;
+				byte *const row = out + r * lineBytes;
+
+				if(not halfTurn)
+				{
+					if(geometry.msbFirst)
+					{
+						for(std::uint32_t i = 0; i < lineBytes; ++i)
+							row[i] = reverseBits(line[i]);
+					}
+					else
+					{
+						std::memcpy(row, line, lineBytes);
+					}
+				}
+				else
+				{
+					// The last pixel comes first
+					for(std::uint32_t i = 0; i < lineBytes; ++i)
+						row[i] = geometry.msbFirst ? line[lineBytes - 1 - i] : reverseBits(line[lineBytes - 1 - i]);
+				}
+			}
+
+			break;
+		}
+
+		// A band is one byte of every scanline: transposed 8 scanlines at a
+		// time, bit `k` of 8 scanlines from `x` is the row of 8 pixels
+		// from `x` (anticlockwise) or ending at `scanlines - 1 - x`
+		// (clockwise) in row `k` of the band, counted from the bottom
+		// (anticlockwise) or the top (clockwise)
+		case rotation::clockwise:
+		case rotation::anticlockwise:
+		{
+			const bool clockwise = geometry.turn == rotation::clockwise;
+			const std::uint32_t column = clockwise ? band : lineBytes - 1 - band;
+			const std::uint32_t rowBytes = scanlines / 8;
+
+			for(std::uint32_t x = 0; x < scanlines; x += 8)
+			{
+				std::uint64_t tile = 0;
+
+				for(int i = 0; i < 8; ++i)
+					tile |= (std::uint64_t)first[(x + i) * stride + column] << 8 * i;
+
+				tile = transpose(normal(tile));
+
+				if(clockwise)
+				{
+					tile = reverseBits(tile);
+
+					for(int k = 0; k < 8; ++k)
+						out[k * rowBytes + (scanlines - 8 - x) / 8] = tile >> 8 * k;
+				}
+				else
+				{
+					for(int k = 0; k < 8; ++k)
+						out[(7 - k) * rowBytes + x / 8] = tile >> 8 * k;
+				}
+			}
+
+			break;
+		}
+	}
+}
@@ -0,0 +1,192 @@
+/**
+ * @file framebuffer.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Pictures and digests of 1bpp framebuffers in the memory of a
+   `cpu`, for running machines headless.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+namespace intel8080
+{
+	/**
+	 * @brief Where a 1bpp framebuffer is and how it is laid out: `scanlines`
+	   rows of `width` pixels from `base`, one bit per pixel, and which way
+	   the monitor is turned.
+	 */
+	struct frameGeometry
+	{
+		/**
+		 * @brief How the picture on the monitor is turned from the
+		   framebuffer, whose first scanline is the top of the picture when
+		   not turned.
+		 */
+		enum class rotation
+		{
+			none,
+			clockwise,		// The first scanline is the right edge.
+			anticlockwise,	// The first scanline is the left edge, as on Space Invaders.
+			halfTurn		// The first scanline is the bottom edge.
+		};
+
+		bytePair base = 0;
+
+		/**
+		 * @brief The pixels in a scanline, a multiple of 8.
+		 */
+		std::uint32_t width = 256;
+
+		/**
+		 * @brief The number of scanlines, a multiple of 8 if the picture is
+		   turned a quarter.
+		 */
+		std::uint32_t scanlines = 224;
+
+		/**
+		 * @brief The bytes from the start of one scanline to the next, or 0
+		   if they follow each other.
+		 */
+		std::uint32_t stride = 0;
+
+		/**
+		 * @brief Whether the first pixel of each byte is its most
+		   significant bit rather than its least.
+		 */
+		bool msbFirst = false;
+
+		rotation turn = rotation::none;
+
+		/**
+		 * @return `std::uint32_t` The bytes from one scanline to the next.
+		 */
+		std::uint32_t scanlineStride(void) const noexcept;
+
+		/**
+		 * @return `std::uint32_t` The size of the picture as seen on the
+		   monitor, in pixels.
+		 */
+		std::uint32_t pictureWidth(void) const noexcept;
+		std::uint32_t pictureHeight(void) const noexcept;
+
+		/**
+		 * @return `bool` Whether the framebuffer can be converted and lies
+		   within memory.
+		 */
+		bool valid(void) const noexcept;
+	};
+
+	/**
+	 * @brief XXH64, fed a piece at a time, as `framebuffer::digest` hashes
+	   scanlines that may not follow each other.
+	 * @see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+	 */
+	class xxh64
+	{
+	public:
+		explicit xxh64(const std::uint64_t seed = 0) noexcept;
+
+		/**
+		 * @brief Hashes the next `size` bytes from `data`.
+		 */
+		void update(const byte* data, std::size_t size) noexcept;
+
+		/**
+		 * @return `std::uint64_t` The digest of everything hashed so far.
+		 */
+		std::uint64_t finish(void) const noexcept;
+
+	private:
+		const std::uint64_t seed;
+		std::uint64_t lanes[4];
+
+		/**
+		 * @brief The start of a 32-byte stripe that has not all arrived.
+		 */
+		byte buffer[32];
+		std::size_t buffered = 0;
+		std::uint64_t total = 0;
+
+		void stripe(const byte *const p) noexcept;
+	};
+
+	/**
+	 * @brief A 1bpp framebuffer in memory, converted to the picture seen on
+	   the monitor on request.
+	 * The picture is first built as 1bpp rows in the order it is seen, 8
+	   rows at a time: quarter turns transpose 8 x 8 tiles of bits in a
+	   64-bit word. Each band is then expanded to grayscale or 32-bit pixels
+	   16 or 4 at a time with GCC vector extensions.
+	 * `digest` hashes the framebuffer where it is, without building the
+	   picture, so checking frames against recorded ones costs about as much
+	   as reading them.
+	 */
+	class framebuffer
+	{
+	public:
+		/**
+		 * @param ram `const byte*` The memory the framebuffer is in, e.g.
+		   `cpu::ram`; 64 KiB.
+		 * @param geometry `const frameGeometry&` Where the framebuffer is,
+		   which must be valid.
+		 */
+		framebuffer(const byte* ram, const frameGeometry& geometry) noexcept;
+
+		const frameGeometry& getGeometry(void) const noexcept;
+
+		/**
+		 * @brief Builds the picture as 1bpp rows of `pictureWidth() / 8`
+		   bytes, the leftmost pixel of each byte in its least significant
+		   bit.
+		 * @param out `byte *const` `pictureWidth() * pictureHeight() / 8` bytes.
+		 */
+		void toBits(byte *const out) const noexcept;
+
+		/**
+		 * @brief Builds the picture with one byte per pixel.
+		 * @param out `byte *const` `pictureWidth() * pictureHeight()`
+		   bytes, row by row from the top left.
+		 * @param lit `byte` The value of lit pixels.
+		 * @param unlit `byte` The value of the others.
+		 */
+		void toGrayscale(byte *const out, const byte lit = 0xff, const byte unlit = 0) const noexcept;
+
+		/**
+		 * @brief Builds the picture with 32 bits per pixel.
+		 * @param out `std::uint32_t *const` `pictureWidth() * pictureHeight()`
+		   pixels, row by row from the top left.
+		 * @param lit `std::uint32_t` The value of lit pixels.
+		 * @param unlit `std::uint32_t` The value of the others.
+		 */
+		void toRGBA(std::uint32_t *const out, const std::uint32_t lit = 0xffffffff, const std::uint32_t unlit = 0xff000000) const noexcept;
+
+		/**
+		 * @brief Hashes the framebuffer's scanlines, without any bytes
+		   between them, with XXH64. If the scanlines follow each other this
+		   is the XXH64 of the whole framebuffer.
+		 * @param seed `std::uint64_t` The seed.
+		 * @return `std::uint64_t` The digest, which does not depend on the
+		   rotation.
+		 */
+		std::uint64_t digest(const std::uint64_t seed = 0) const noexcept;
+
+	private:
+		const byte* ram;
+		frameGeometry geometry;
+
+		/**
+		 * @brief Builds rows `band * 8` to `band * 8 + 7` of the picture, as
+		   `toBits` would.
+		 */
+		void buildBand(const std::uint32_t band, byte *const out) const noexcept;
+	};
+}
@@ -0,0 +1,197 @@
+/**
+ * @file framebuffertest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks `framebuffer`: `digest` against XXH64 test vectors, with
+   scanlines that follow each other and ones that do not, and the pictures
+   built for each rotation against a pixel-by-pixel model.
+   Usage: framebuffertest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./framebuffer.hpp"
+#include "./check.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief A framebuffer of `text` at 0x1000, as `scanlines` scanlines
+	   `stride` bytes apart.
+	 */
+	std::uint64_t digestOf(const std::string& text, const std::uint32_t scanlines, const std::uint32_t stride, const std::uint64_t seed)
+	{
+		std::vector<byte> ram(0x10000, 0xa5);
+		const std::uint32_t lineBytes = text.size() / scanlines;
+
+		for(std::uint32_t line = 0; line < scanlines; ++line)
+			std::memcpy(ram.data() + 0x1000 + line * stride, text.data() + line * lineBytes, lineBytes);
+
+		frameGeometry g;
+		g.base = 0x1000;
+		g.width = lineBytes * 8;
+		g.scanlines = scanlines;
+		g.stride = stride;
+
+		return framebuffer(ram.data(), g).digest(seed);
+	}
+
+	/**
+	 * @brief Whether pixel `x` of scanline `y` is lit.
+	 */
+	bool pixel(const byte *const ram, const frameGeometry& g, const std::uint32_t x, const std::uint32_t y)
+	{
+		const byte b = ram[g.base + y * g.scanlineStride() + x / 8];
+		return b >> (g.msbFirst ? 7 - x % 8 : x % 8) & 1;
+	}
+
+	/**
+	 * @brief Whether the pixel at `x`, `y` of the picture is lit, from which
+	   edge the first scanline is on.
+	 */
+	bool seen(const byte *const ram, const frameGeometry& g, const std::uint32_t x, const std::uint32_t y)
+	{
+		using rotation = frameGeometry::rotation;
+
+		switch(g.turn)
+		{
+			case rotation::none:			return pixel(ram, g, x, y);
+			case rotation::halfTurn:		return pixel(ram, g, g.width - 1 - x, g.scanlines - 1 - y);
+			case rotation::clockwise:		return pixel(ram, g, y, g.scanlines - 1 - x);
+			case rotation::anticlockwise:	return pixel(ram, g, g.width - 1 - y, x);
+		}
+
+		return false;
+	}
+}
+
+int main(void)
+{
+	// XXH64 of the empty input, which no framebuffer holds, and of short
+	// ones; the last is longer than a stripe
+	{
+		const struct
+		{
+			std::string text;
+			std::uint64_t seed;
+			std::uint64_t digest;
+		}
+		vectors[] = {
+			{"", 0, 0xef46db3751d8e999},
+			{"", 1, 0xd5afba1336a3be4b},
+			{"abc", 0, 0x44bc2cf5ad770999},
+			{"abc", 1, 0xbea9ca8199328908},
+			{"Nobody inspects the spammish repetition", 0, 0xfbcea83c8a378bf1}
+		};
+
+		for(const auto& v : vectors)
+		{
+			xxh64 h(v.seed);
+			h.update((const byte*)v.text.data(), v.text.size());
+			CHECK(h.finish() == v.digest);
+
+			if(v.text.empty())
+				continue;
+
+			// One scanline, and three 16 bytes apart where they fit
+			CHECK(digestOf(v.text, 1, 0, v.seed) == v.digest);
+
+			if(v.text.size() % 3 == 0)
+				CHECK(digestOf(v.text, 3, 16, v.seed) == v.digest);
+		}
+	}
+
+	// Pieces of every size make the same digest as the whole
+	{
+		std::vector<byte> data(1000);
+		std::mt19937 rng(8080);
+
+		for(byte& b : data)
+			b = rng();
+
+		xxh64 whole(7);
+		whole.update(data.data(), data.size());
+
+		for(std::size_t piece = 1; piece <= 65; ++piece)
+		{
+			xxh64 h(7);
+
+			for(std::size_t i = 0; i < data.size(); i += piece)
+				h.update(data.data() + i, std::min(piece, data.size() - i));
+
+			CHECK(h.finish() == whole.finish());
+		}
+	}
+
+	// Every rotation, on a framebuffer that is not square, with scanlines
+	// apart and the first pixel in the most significant bit
+	{
+		using rotation = frameGeometry::rotation;
+
+		std::vector<byte> ram(0x10000);
+		std::mt19937 rng(8080);
+
+		for(byte& b : ram)
+			b = rng();
+
+		for(const rotation turn : {rotation::none, rotation::clockwise, rotation::anticlockwise, rotation::halfTurn})
+		{
+			for(const bool msbFirst : {false, true})
+			{
+				frameGeometry g;
+				g.base = 0x2400;
+				g.width = 48;
+				g.scanlines = 24;
+				g.stride = 8;
+				g.msbFirst = msbFirst;
+				g.turn = turn;
+
+				const framebuffer screen(ram.data(), g);
+				const std::uint32_t width = g.pictureWidth(), height = g.pictureHeight();
+
+				std::vector<byte> expected(width * height);
+
+				for(std::uint32_t y = 0; y < height; ++y)
+					for(std::uint32_t x = 0; x < width; ++x)
+						expected[y * width + x] = seen(ram.data(), g, x, y) ? 0xff : 0;
+
+				std::vector<byte> gray(width * height);
+				screen.toGrayscale(gray.data());
+				CHECK(gray == expected);
+
+				std::vector<std::uint32_t> rgba(width * height);
+				screen.toRGBA(rgba.data(), 1, 2);
+
+				bool same = true;
+
+				for(std::size_t i = 0; i < rgba.size(); ++i)
+					same &= rgba[i] == (expected[i] ? 1u : 2u);
+
+				CHECK(same);
+
+				// The digest is of the scanlines, however they are seen
+				xxh64 h;
+
+				for(std::uint32_t line = 0; line < g.scanlines; ++line)
+					h.update(ram.data() + g.base + line * g.stride, g.width / 8);
+
+				CHECK(screen.digest() == h.finish());
+			}
+		}
+	}
+
+	return checks::summary("framebuffertest");
+}
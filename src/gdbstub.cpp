@@ -0,0 +1,119 @@
+/**
+ * @file gdbstub.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Loads a program and waits for GDB, or another front end that
+   speaks its remote protocol, to debug it.
+   Usage: gdbstub [--port N | --unix PATH] FILE[@ORIGIN]
+   The program is loaded as by disasm (.com, .hex or raw binary) and
+   stopped at its first instruction. The stub listens on port 1234 of the
+   loopback interface by default, or on a Unix domain socket, and exits
+   when the front end detaches or kills the program. In GDB:
+   `target remote :1234`. `in` reads 0 and `out` does nothing.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./rsp.hpp"
+#include "./image.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+using namespace intel8080;
+
+int main(int argc, char** argv)
+{
+	std::uint16_t port = 1234;
+	std::string socketPath;
+	std::string file;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+
+		if(arg == "--port" and i + 1 < argc)
+		{
+			port = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "--unix" and i + 1 < argc)
+		{
+			socketPath = argv[++i];
+		}
+		else if(arg[0] != '-' and file.empty())
+		{
+			file = arg;
+		}
+		else
+		{
+			file.clear();
+			break;
+		}
+	}
+
+	if(file.empty())
+	{
+		std::fprintf(stderr, "usage: %s [--port N | --unix PATH] FILE[@ORIGIN]\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<byte> memory(0x10000);
+	imageInfo image;
+	std::string error;
+
+	if(not loadImageArgument(file, memory.data(), image, error))
+	{
+		std::fprintf(stderr, "gdbstub: %s\n", error.c_str());
+		return 1;
+	}
+
+	cpu machine([](const byte){ return (byte)0; }, [](const byte, const byte){}, memory.data());
+	machine.PC = image.start;
+
+	// As CP/M leaves it: returning from the program reaches the `hlt` at 0
+	if(image.com)
+	{
+		machine.SP = 0x0000;
+		machine.push(0x0000);
+	}
+
+	const int listener = socketPath.empty() ? rspServer::listenTCP(port) : rspServer::listenUnix(socketPath);
+
+	if(listener < 0)
+	{
+		std::perror("gdbstub: cannot listen");
+		return 1;
+	}
+
+	if(socketPath.empty())
+		std::fprintf(stderr, "gdbstub: waiting for the debugger on port %u\n", port);
+	else
+		std::fprintf(stderr, "gdbstub: waiting for the debugger at %s\n", socketPath.c_str());
+
+	const int connection = accept(listener, nullptr, nullptr);
+	close(listener);
+
+	if(connection < 0)
+	{
+		std::perror("gdbstub: accept");
+		return 1;
+	}
+
+	rspServer server(machine);
+	server.serve(connection);
+
+	if(not socketPath.empty())
+		unlink(socketPath.c_str());
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file hextest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks .hex files: what `writeIntelHexFile` writes is loaded back
+   exactly by `loadIntelHexFile`, including Extended Linear Address (0x04)
+   and Start Linear Address (0x05) records past 64K; Extended Segment
+   Address (0x02) records are loaded where they say; lowercase digits are
+   accepted; and malformed files are rejected with the right error and line.
+   Usage: hextest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./intel8080.hpp"
+#include "./check.hpp"
+
+#include <fstream>
+#include <random>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	void writeText(const std::string& filename, const std::string& text)
+	{
+		std::ofstream(filename, std::ios::binary) << text;
+	}
+}
+
+int main(void)
+{
+	const scratchDirectory dir;
+
+	if(not CHECK(dir.ok()))
+		return checks::summary("hextest");
+
+	// Random memory across three 64K segments, so that 0x04 records are needed
+	constexpr std::size_t memorySize = 0x30000;
+	std::vector<byte> original(memorySize);
+	std::mt19937 rng(8080);
+
+	for(byte& b : original)
+		b = rng();
+
+	// A range starting and ending mid-record, crossing two 64K boundaries
+	constexpr std::uint32_t begin = 0x0fff3, length = 0x1f02b;
+
+	for(const byte recordLength : {1, 16, 255})
+	{
+		hexWriteOptions options;
+		options.recordLength = recordLength;
+		options.writeStartAddress = true;
+		options.startAddress = 0x00012345;
+
+		const std::string file = dir / "roundtrip.hex";
+		CHECK(writeIntelHexFile(file, original.data(), begin, length, options));
+
+		std::vector<byte> loaded(memorySize, 0xa5);
+		hexLoadInfo info;
+
+		CHECK(loadIntelHexFile(file, loaded.data(), &info, memorySize));
+		CHECK(info.error == hexError::none);
+		CHECK(info.hasStartAddress and info.startAddress == 0x00012345);
+		CHECK(info.lowAddress == begin and info.highAddress == begin + length);
+		CHECK(std::equal(original.begin() + begin, original.begin() + begin + length, loaded.begin() + begin));
+
+		// Nothing outside the range is touched
+		CHECK(loaded[begin - 1] == 0xa5 and loaded[begin + length] == 0xa5);
+
+		// Too little memory for the upper segments
+		std::vector<byte> small(0x10000);
+		CHECK(not loadIntelHexFile(file, small.data(), &info));
+		CHECK(info.error == hexError::outOfRange);
+	}
+
+	// Without a start address, and with the whole of 64K
+	{
+		const std::string file = dir / "full.hex";
+		CHECK(writeIntelHexFile(file, original.data(), 0, 0x10000));
+
+		std::vector<byte> loaded(0x10000);
+		hexLoadInfo info;
+
+		CHECK(loadIntelHexFile(file, loaded.data(), &info));
+		CHECK(not info.hasStartAddress);
+		CHECK(std::equal(loaded.begin(), loaded.end(), original.begin()));
+	}
+
+	// Extended Segment Address (0x02): segment 0x1000 is 0x10000, and a
+	// record crossing the end of the segment wraps around within it;
+	// then a Start Segment Address (0x03) of 0x1234:0x0010
+	{
+		const std::string file = dir / "segment.hex";
+		writeText(file,
+			":020000021000EC\n"
+			":03FFFE00AABBCCCF\n"
+			":0400000312340010A3\n"
+			":00000001FF\n");
+
+		std::vector<byte> loaded(0x20000);
+		hexLoadInfo info;
+
+		CHECK(loadIntelHexFile(file, loaded.data(), &info, loaded.size()));
+		CHECK(loaded[0x1fffe] == 0xaa and loaded[0x1ffff] == 0xbb and loaded[0x10000] == 0xcc);
+		CHECK(info.hasStartAddress and info.startAddress == 0x12340 + 0x10);
+	}
+
+	// Lowercase digits are as good as uppercase
+	{
+		const std::string file = dir / "lowercase.hex";
+		writeText(file, ":0300300002337a1e\n:00000001ff\n");
+
+		std::vector<byte> loaded(0x10000);
+		hexLoadInfo info;
+
+		CHECK(loadIntelHexFile(file, loaded.data(), &info));
+		CHECK(loaded[0x30] == 0x02 and loaded[0x31] == 0x33 and loaded[0x32] == 0x7a);
+	}
+
+	// Malformed files
+	{
+		struct
+		{
+			const char* text;
+			hexError error;
+			std::size_t line;
+		}
+		const cases[] = {
+			{":0300000001020303\n:00000001FF\n", hexError::badChecksum, 1},
+			{":0100000041BE\n:0300000001020304\n:00000001FF\n", hexError::badChecksum, 2},
+			{":0100000041BE\n", hexError::missingEof, 2},
+			{":01000000G1BE\n:00000001FF\n", hexError::invalidDigit, 1},
+			{":01000000\n:", hexError::invalidDigit, 1},
+			{":010000", hexError::truncatedRecord, 1},
+			{"x:00000001FF\n", hexError::expectedColon, 1},
+			{":00000006FA\n", hexError::badRecordType, 1},
+			{":0100000400FB\n:00000001FF\n", hexError::badRecordLength, 1},
+			{":02FFFF000102FD\n:00000001FF\n", hexError::outOfRange, 1}
+		};
+
+		for(const auto& c : cases)
+		{
+			const std::string file = dir / "bad.hex";
+			writeText(file, c.text);
+
+			std::vector<byte> loaded(0x10000);
+			hexLoadInfo info;
+
+			CHECK(not loadIntelHexFile(file, loaded.data(), &info));
+			CHECK(info.error == c.error);
+			CHECK(info.line == c.line);
+		}
+
+		hexLoadInfo info;
+		std::vector<byte> loaded(0x10000);
+		CHECK(not loadIntelHexFile(dir / "missing.hex", loaded.data(), &info));
+		CHECK(info.error == hexError::cannotOpen);
+	}
+
+	return checks::summary("hextest");
+}
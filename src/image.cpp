@@ -0,0 +1,114 @@
+/**
+ * @file image.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Loads a program image named on the command line of a tool, in any of
+   the formats the emulator supports.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `image.hpp`.
+
+#include "./image.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+using namespace intel8080;
+
+namespace
+{
+	bool endsWith(const std::string& s, const char *const suffix)
+	{
+		const std::size_t n = std::strlen(suffix);
+		if(s.size() < n) return false;
+
+		for(std::size_t i = 0; i < n; ++i)
+		{
+			if(std::tolower((unsigned char)s[s.size() - n + i]) != suffix[i]) return false;
+		}
+
+		return true;
+	}
+}
+
+bool intel8080::loadImageArgument(const std::string& arg, byte *const memory, imageInfo& info, std::string& error)
+{
+	info = imageInfo();
+	info.filename = arg;
+	long origin = -1;
+
+	const std::size_t at = arg.rfind('@');
+	if(at != std::string::npos)
+	{
+		info.filename = arg.substr(0, at);
+		origin = std::strtol(arg.c_str() + at + 1, nullptr, 16);
+	}
+
+	const std::string& filename = info.filename;
+	info.com = endsWith(filename, ".com");
+	const bool hex = endsWith(filename, ".hex");
+
+	// Anything else would be silently ignored
+	if(origin >= 0 and (hex or info.com))
+	{
+		error = filename + ": an origin can only be given for a raw binary";
+		return false;
+	}
+
+	if(hex)
+	{
+		hexLoadInfo hex;
+
+		if(not loadIntelHexFile(filename, memory, &hex))
+		{
+			error = filename + ": line " + std::to_string(hex.line) + ": invalid .hex file (error " + std::to_string((int)hex.error) + ")";
+			return false;
+		}
+
+		info.begin = hex.lowAddress;
+		info.length = hex.highAddress > hex.lowAddress ? hex.highAddress - hex.lowAddress : 0;
+		info.start = hex.hasStartAddress ? hex.startAddress : info.begin;
+		return true;
+	}
+
+	cpu machine([](const byte){ return (byte)0; }, [](const byte, const byte){}, memory);
+	const bytePair adr = info.com ? 0x0100 : origin >= 0 ? origin : 0;
+
+	if(info.com)
+	{
+		memory[0x0000] = 0x76;
+		memory[0x0005] = 0xc9;
+	}
+
+	if(not machine.loadBinaryFile(filename, adr))
+	{
+		char text[16];
+		std::snprintf(text, sizeof text, "%04x", adr);
+		error = filename + ": cannot read file, or it does not fit at " + text;
+		return false;
+	}
+
+	// It has been read, so it fits in memory
+	std::error_code failure;
+	info.length = std::filesystem::file_size(filename, failure);
+
+	if(failure)
+	{
+		error = filename + ": " + failure.message();
+		return false;
+	}
+
+	info.begin = adr;
+	info.start = adr;
+	return true;
+}
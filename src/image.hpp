@@ -0,0 +1,66 @@
+/**
+ * @file image.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Loads a program image named on the command line of a tool, in any of
+   the formats the emulator supports.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+#include <string>
+
+namespace intel8080
+{
+	/**
+	 * @brief Where an image was loaded.
+	 */
+	struct imageInfo
+	{
+		/**
+		 * @brief The file name, without any @ORIGIN.
+		 */
+		std::string filename;
+
+		/**
+		 * @brief Whether the file is a CP/M .COM program.
+		 */
+		bool com = false;
+
+		/**
+		 * @brief The range the image occupies.
+		 */
+		std::uint32_t begin = 0, length = 0;
+
+		/**
+		 * @brief Where the image starts running: the start address record of
+		   a .hex file, or else the start of the image.
+		 */
+		bytePair start = 0;
+	};
+
+	/**
+	 * @brief Loads an image given as `FILE[@ORIGIN]` (ORIGIN in hex).
+	 * .hex files are loaded where their records say, .com files at 0x0100 and
+	   other files at ORIGIN, or 0; ORIGIN is an error for .hex and .com
+	   files. For .com files, a `hlt` is placed at 0x0000 and a `ret` at the
+	   BDOS entry point 0x0005, as stand-ins for CP/M's page zero.
+	 *
+	 * @param arg `const std::string&` The file name with an optional @ORIGIN.
+	 * @param memory `byte*` 65536 bytes of memory.
+	 * @param info `imageInfo&` Set to where the image was loaded.
+	 * @param error `std::string&` Set to a description of the problem if the
+	   image cannot be loaded.
+	 * @return `bool` Whether the image was loaded.
+	 */
+	bool loadImageArgument(const std::string& arg, byte* memory, imageInfo& info, std::string& error);
+}
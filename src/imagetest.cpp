@@ -0,0 +1,146 @@
+/**
+ * @file imagetest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks `mapImageFile`: a raw binary image at an origin that is a
+   multiple of the page size, which is mapped from the file, and at one that
+   is not, which is copied; one that ends at the top of memory and one that
+   runs past it; and that writes to the RAM returned never reach the file.
+   Usage: imagetest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./intel8080.hpp"
+#include "./check.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace intel8080;
+
+namespace
+{
+	std::vector<byte> readFile(const std::string& filename)
+	{
+		std::ifstream in(filename, std::ios::binary);
+		return std::vector<byte>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(const std::string& filename, const std::vector<byte>& data)
+	{
+		std::ofstream(filename, std::ios::binary).write((const char*)data.data(), data.size());
+	}
+
+	/**
+	 * @brief Whether the page at `p` is mapped from `filename`, from the
+	   process's memory map.
+	 */
+	bool mappedFrom(const byte *const p, const std::string& filename)
+	{
+		std::ifstream maps("/proc/self/maps");
+		std::string line;
+
+		while(std::getline(maps, line))
+		{
+			unsigned long begin, end;
+
+			if(std::sscanf(line.c_str(), "%lx-%lx", &begin, &end) == 2
+				and begin <= (unsigned long)p and (unsigned long)p < end)
+			{
+				return line.size() >= filename.size() and line.compare(line.size() - filename.size(), filename.size(), filename) == 0;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Whether `ram` holds `image` at `origin` and zeros everywhere
+	   else.
+	 */
+	bool holds(const byte *const ram, const std::vector<byte>& image, const bytePair origin)
+	{
+		return std::equal(image.begin(), image.end(), ram + origin)
+			and std::all_of(ram, ram + origin, [](const byte b){ return b == 0; })
+			and std::all_of(ram + origin + image.size(), ram + 0x10000, [](const byte b){ return b == 0; });
+	}
+}
+
+int main(void)
+{
+	const scratchDirectory dir;
+
+	if(not CHECK(dir.ok()))
+		return checks::summary("imagetest");
+
+	// Not a whole number of pages, so the last page is only partly the file
+	const long pageSize = sysconf(_SC_PAGESIZE);
+	std::vector<byte> image(pageSize + 0x123);
+	std::mt19937 rng(8080);
+
+	for(byte& b : image)
+		b = rng() | 1;
+
+	const std::string file = dir / "image.bin";
+	writeFile(file, image);
+
+	// Mapped where it lines up with pages, copied where it does not, and
+	// ending exactly at the top of memory
+	for(const std::uint32_t origin : {0ul, 2ul * pageSize, 0x0101ul, 0x10000ul - image.size()})
+	{
+		byte *const ram = mapImageFile(file, origin);
+
+		if(not CHECK(ram))
+			continue;
+
+		CHECK(holds(ram, image, origin));
+		CHECK(mappedFrom(ram + origin, file) == (origin % pageSize == 0));
+
+		// Writes are private to the RAM, over the file and around it
+		ram[origin] ^= 0xff;
+		ram[origin + image.size() - 1] ^= 0xff;
+		ram[(origin + image.size()) % 0x10000] = 0x5a;
+
+		CHECK(ram[origin] == (byte)~image.front());
+		CHECK(readFile(file) == image);
+
+		// Nor are they seen by the next mapping
+		byte *const again = mapImageFile(file, origin);
+
+		if(CHECK(again))
+			CHECK(holds(again, image, origin));
+
+		unmapImageFile(again);
+		unmapImageFile(ram);
+	}
+
+	// Runs past the end of memory
+	CHECK(mapImageFile(file, 0x10000 - image.size() + 1) == nullptr);
+	CHECK(mapImageFile(file, 0xf000) == nullptr);
+
+	// An empty file leaves all of RAM zeroed; a missing one fails
+	writeFile(dir / "empty.bin", {});
+	byte *const empty = mapImageFile(dir / "empty.bin", 0x0100);
+
+	if(CHECK(empty))
+		CHECK(std::all_of(empty, empty + 0x10000, [](const byte b){ return b == 0; }));
+
+	unmapImageFile(empty);
+	unmapImageFile(nullptr);
+
+	CHECK(mapImageFile(dir / "missing.bin") == nullptr);
+
+	return checks::summary("imagetest");
+}
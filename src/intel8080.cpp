@@ -15,13 +15,174 @@
 // For an explanation of what each function and type is for, see `intel8080.hpp`.
 
 #include "./intel8080.hpp"
+#include "./opcodes.hpp"
+#include "./disassembler.hpp"
 
 #include <limits>
 #include <fstream>
-#include <map>
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace intel8080;
 
+namespace
+{
+	/**
+	 * @brief A read-only memory mapping of a whole file, unmapped when
+	   destroyed.
+	 */
+	struct mappedFile
+	{
+		const byte* data = nullptr;
+		std::size_t size = 0;
+		int fd = -1;
+
+		mappedFile(const std::string& filename) noexcept
+		{
+			fd = open(filename.c_str(), O_RDONLY);
+			if(fd < 0) return;
+
+			struct stat st;
+			if(fstat(fd, &st) != 0) return;
+			size = st.st_size;
+
+			// mmap cannot map an empty file, but an empty image is still valid
+			if(size == 0) return;
+
+			void *const p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(p != MAP_FAILED) data = (const byte*)p;
+		}
+
+		~mappedFile()
+		{
+			if(data) munmap((void*)data, size);
+			if(fd >= 0) close(fd);
+		}
+
+		bool ok(void) const noexcept
+		{
+			return fd >= 0 and (data or size == 0);
+		}
+	};
+
+	/**
+	 * @brief Writes to a file through one large buffer, so that formatting
+	   code can append a few bytes at a time without a system call or stream
+	   operation per byte.
+	 */
+	class bufferedWriter
+	{
+	public:
+		bufferedWriter(const std::string& filename) noexcept
+		:
+			file(std::fopen(filename.c_str(), "wb"))
+		{
+		}
+
+		~bufferedWriter()
+		{
+			if(file) std::fclose(file);
+		}
+
+		/**
+		 * @return A pointer to at least `size` bytes of buffer space, which
+		   the caller must fill and then `commit`.
+		 */
+		char* reserve(const std::size_t size) noexcept
+		{
+			if(used + size > sizeof buffer) flush();
+			return buffer + used;
+		}
+
+		void commit(const std::size_t size) noexcept
+		{
+			used += size;
+		}
+
+		/**
+		 * @brief Writes `size` bytes, bypassing the buffer if they are large.
+		 */
+		void write(const void *const data, const std::size_t size) noexcept
+		{
+			if(size >= sizeof buffer)
+			{
+				flush();
+				if(file and std::fwrite(data, 1, size, file) != size) failed = true;
+				return;
+			}
+
+			std::memcpy(reserve(size), data, size);
+			commit(size);
+		}
+
+		/**
+		 * @brief Flushes the buffer and closes the file.
+		 * @return Whether everything was written.
+		 */
+		bool finish(void) noexcept
+		{
+			flush();
+
+			if(file and std::fclose(file) != 0) failed = true;
+			const bool ok = file and not failed;
+			file = nullptr;
+			return ok;
+		}
+
+	private:
+		std::FILE* file;
+		char buffer[0x10000];
+		std::size_t used = 0;
+		bool failed = false;
+
+		void flush(void) noexcept
+		{
+			if(file and used and std::fwrite(buffer, 1, used, file) != used) failed = true;
+			used = 0;
+		}
+	};
+
+	/**
+	 * @brief Formats one .hex record into `out`.
+	 * @return The number of characters written, at most 1 + 2 * (5 + 255) + 1.
+	 */
+	std::size_t formatHexRecord(char *const out, const byte type, const bytePair adr, const byte *const data, const byte length) noexcept
+	{
+		constexpr char digits[] = "0123456789ABCDEF";
+
+		char* p = out;
+		byte checksum = 0;
+
+		const auto put = [&](const byte b) noexcept
+		{
+			*p++ = digits[b >> 4];
+			*p++ = digits[b & 0xf];
+			checksum += b;
+		};
+
+		*p++ = ':';
+		put(length);
+		put(adr >> 8);
+		put(adr & 0xff);
+		put(type);
+
+		for(byte i = 0; i < length; ++i)
+		{
+			put(data[i]);
+		}
+
+		put(-checksum);
+		*p++ = '\n';
+
+		return p - out;
+	}
+}
+
 byte& regPair::high(void) noexcept
 {
 	return pair[1];
@@ -32,6 +193,28 @@ byte& regPair::low(void) noexcept
 	return pair[0];
 }
 
+memoryWord::memoryWord(byte *const r, const bytePair a) noexcept
+:
+	ram(r), adr(a)
+{}
+
+memoryWord::operator bytePair(void) const noexcept
+{
+	return ram[adr] | ram[(bytePair)(adr + 1)] << 8;
+}
+
+memoryWord& memoryWord::operator=(const bytePair value) noexcept
+{
+	ram[adr] = value;
+	ram[(bytePair)(adr + 1)] = value >> 8;
+	return *this;
+}
+
+memoryWord& memoryWord::operator=(const memoryWord& other) noexcept
+{
+	return *this = (bytePair)other;
+}
+
 cpu::cpu(typeof portInputHandler pih, typeof portOutputHandler poh, typeof(ram) preAllocatedRam) noexcept
 :
 	ram(preAllocatedRam), portInputHandler(pih), portOutputHandler(poh)
@@ -41,62 +224,62 @@ cpu::cpu(typeof portInputHandler pih, typeof portOutputHandler poh, typeof(ram)
 
 bytePair& cpu::PSW(void) noexcept
 {
-	return _PSW.full;
+	return pairs[3];
 }
 
 bytePair& cpu::BC(void) noexcept
 {
-	return _BC.full;
+	return pairs[0];
 }
 
 bytePair& cpu::DE(void) noexcept
 {
-	return _DE.full;
+	return pairs[1];
 }
 
 bytePair& cpu::HL(void) noexcept
 {
-	return _HL.full;
+	return pairs[2];
 }
 
 byte& cpu::A(void) noexcept
 {
-	return _PSW.high();
+	return regs[7];
 }
 
 byte& cpu::flags(void) noexcept
 {
-	return _PSW.low();
+	return regs[6];
 }
 
 byte& cpu::B(void) noexcept
 {
-	return _BC.high();
+	return reg<0>();
 }
 
 byte& cpu::C(void) noexcept
 {
-	return _BC.low();
+	return reg<1>();
 }
 
 byte& cpu::D(void) noexcept
 {
-	return _DE.high();
+	return reg<2>();
 }
 
 byte& cpu::E(void) noexcept
 {
-	return _DE.low();
+	return reg<3>();
 }
 
 byte& cpu::H(void) noexcept
 {
-	return _HL.high();
+	return reg<4>();
 }
 
 byte& cpu::L(void) noexcept
 {
-	return _HL.low();
+	return reg<5>();
 }
 
 byte& cpu::atHL(void) noexcept
@@ -104,9 +287,9 @@ byte& cpu::atHL(void) noexcept
 	return ram[HL()];
 }
 
-bytePair& cpu::atSP(void) noexcept
+memoryWord cpu::atSP(void) noexcept
 {
-	return *(bytePair*)(ram + SP);
+	return memoryWord(ram, SP);
 }
 
 int cpu::getFlag(const flagPos f) noexcept
@@ -131,6 +314,37 @@ bool cpu::getHalted(void) noexcept
 	return halted;
 }
 
+void cpu::setHalted(const bool halted) noexcept
+{
+	this->halted = halted;
+}
+
+bool cpu::getInterruptsEnabled(void) noexcept
+{
+	return interruptsEnabled;
+}
+
+void cpu::setInterruptsEnabled(const bool enabled) noexcept
+{
+	interruptsEnabled = enabled;
+}
+
+bool cpu::getInterruptPending(void) noexcept
+{
+	return interruptPending;
+}
+
+byte cpu::getInterruptVector(void) noexcept
+{
+	return interruptVector;
+}
+
+void cpu::setInterruptPending(const bool pending, const byte vector) noexcept
+{
+	interruptPending = pending;
+	interruptVector = vector;
+}
+
 void cpu::load(const bytePair orig, const std::vector<byte>& code) noexcept
 {
 	int i = 0;
@@ -142,11 +356,32 @@ void cpu::load(const bytePair orig, const std::vector<byte>& code) noexcept
 	}
 }
 
+bool cpu::loadBinaryFile(const std::string& filename, const bytePair origin) noexcept
+{
+	const mappedFile file(filename);
+
+	if(not file.ok() or origin + file.size > 0x10000)
+		return false;
+
+	if(file.size) std::memcpy(ram + origin, file.data, file.size);
+	PC = origin;
+	return true;
+}
+
+bool cpu::loadComFile(const std::string& filename) noexcept
+{
+	if(not loadBinaryFile(filename, 0x0100))
+		return false;
+
+	SP = 0x0000;
+	push(0x0000);
+	return true;
+}
+
 void cpu::interrupt(const byte interruptVector) noexcept
 {
 	if(interruptsEnabled)
 	{
-		interruptsEnabled = false;
 		interruptPending = true;
 		this->interruptVector = interruptVector;
 	}
@@ -156,9 +391,11 @@ void cpu::step(void) noexcept
 {
 	if(interruptsEnabled && interruptPending)
 	{
-		exec(interruptVector);
+		// Acknowledging an interrupt disables further ones until `ei`
+		interruptsEnabled = false;
 		interruptPending = false;
 		halted = false;
+		exec(interruptVector);
 	}
 	else if(not halted)
 	{
@@ -189,8 +426,12 @@ void cpu::step(void) noexcept
 		<< getFlag(flagPos::auxCarry) << " "
 		<< getFlag(flagPos::parity) << " "
 		<< getFlag(flagPos::carry) << "\n"
-		<< "Top of stack: " << atSP()
+		<< "Top of stack: " << (bytePair)atSP()
 		<< "\n";
+
+		char next[maxInstructionText + 1];
+		formatInstruction(decodeInstruction(ram, PC), next);
+		std::cout << "Next instruction: " << next << "\n";
 	}
 
 #endif
@@ -202,22 +443,27 @@ byte cpu::get8(void) noexcept
 
 bytePair cpu::get16(void) noexcept
 {
-	auto copy = *(bytePair*)(ram + PC);
+	auto copy = read16(PC);
 	PC += 2;
 	return copy;
 }
 
-template<typename T>
-void cpu::updateFlags(const T result) noexcept
+bytePair cpu::read16(const bytePair adr) noexcept
 {
-	setFlag(sign, (std::make_signed_t<T>)result < 0);
-	setFlag(zero, result == 0);
-	setFlag(parity, not __builtin_parity(result));
+	return ram[adr] | ram[(bytePair)(adr + 1)] << 8;
+}
+
+void cpu::write16(const bytePair adr, const bytePair value) noexcept
+{
+	ram[adr] = value;
+	ram[(bytePair)(adr + 1)] = value >> 8;
 }
 
-void cpu::updateAuxCarryFlag(const byte a, const byte b) noexcept
+void cpu::updateFlags(const byte result) noexcept
 {
-	setFlag(auxCarry, lowBitsOf(b, 4) + lowBitsOf(a, 4) > 0b1111);
+	setFlag(sign, result & 0x80);
+	setFlag(zero, result == 0);
+	setFlag(parity, not __builtin_parity(result));
 }
 
 void cpu::inr(byte& r8) noexcept
@@ -228,7 +474,9 @@ void cpu::inr(byte& r8) noexcept
 
 void cpu::dcr(byte& r8) noexcept
 {
-	setFlag(auxCarry, lowBitsOf(r8, 4) == 0b0000);
+	// The 8080 adds 0xff, so there is a carry from bit 3 unless the low 4
+	// bits were 0
+	setFlag(auxCarry, lowBitsOf(r8, 4) != 0b0000);
 	updateFlags(--r8);
 }
 
@@ -240,21 +488,26 @@ void cpu::dad(bytePair& r16) noexcept
 
 void cpu::add(const byte r8, const bool withCarry /* = false */) noexcept
 {
-	byte added = r8;
-	if(withCarry and getFlag(carry)) ++added;
+	const unsigned carryIn = withCarry and getFlag(carry);
+	const unsigned sum = A() + r8 + carryIn;
 
-	setFlag(carry, added > std::numeric_limits<byte>::max() - A());
-	updateAuxCarryFlag(A(), added);
-	updateFlags(A() += added);
+	setFlag(carry, sum > std::numeric_limits<byte>::max());
+	setFlag(auxCarry, lowBitsOf(A(), 4) + lowBitsOf(r8, 4) + carryIn > 0b1111);
+	updateFlags(A() = sum);
 }
 
 void cpu::sub(const byte r8, const bool withBorrow /* = false */) noexcept
 {
-	byte added = r8;
-	if(withBorrow and getFlag(carry)) ++added;
-
-	setFlag(carry, added > A());
-	updateFlags(A() -= added);
+	// The 8080 subtracts by adding the one's complement of `r8` and the
+	// complement of the borrow; the carry flag is then the complement of the
+	// carry out, but the auxiliary carry flag is not complemented.
+	const unsigned notBorrow = not (withBorrow and getFlag(carry));
+	const byte complement = ~r8;
+	const unsigned sum = A() + complement + notBorrow;
+
+	setFlag(carry, sum <= std::numeric_limits<byte>::max());
+	setFlag(auxCarry, lowBitsOf(A(), 4) + lowBitsOf(complement, 4) + notBorrow > 0b1111);
+	updateFlags(A() = sum);
 }
 
 void cpu::cmp(const byte r8) noexcept
@@ -266,6 +519,8 @@ void cpu::cmp(const byte r8) noexcept
 
 void cpu::logicAnd(const byte r8) noexcept
 {
+	// `ana` sets the auxiliary carry flag to the OR of bit 3 of its operands
+	setFlag(auxCarry, bitOf(A(), 3) | bitOf(r8, 3));
 	updateFlags(A() &= r8);
 	setFlag(carry, false);
 }
@@ -273,24 +528,26 @@ void cpu::logicAnd(const byte r8) noexcept
 void cpu::logicOr(const byte r8) noexcept
 {
 	updateFlags(A() |= r8);
+	setFlag(auxCarry, false);
 	setFlag(carry, false);
 }
 
 void cpu::logicXor(const byte r8) noexcept
 {
 	updateFlags(A() ^= r8);
+	setFlag(auxCarry, false);
 	setFlag(carry, false);
 }
 
 void cpu::push(const bytePair r16) noexcept
 {
 	SP -= 2;
-	atSP() = r16;
+	write16(SP, r16);
 }
 
 void cpu::pop(bytePair& r16) noexcept
 {
-	r16 = atSP();
+	r16 = read16(SP);
 	SP += 2;
 
 	// Reset unused flags
@@ -319,6 +576,7 @@ void cpu::ret(const bool condition) noexcept
 {
 	if(condition)
 	{
+		cycles += 6;
 		pop(PC);
 	}
 }
@@ -329,6 +587,7 @@ void cpu::call(const bool condition) noexcept
 
 	if(condition)
 	{
+		cycles += 6;
 		push(PC);
 		PC = adr;
 	}
@@ -336,553 +595,506 @@ void cpu::call(const bool condition) noexcept
 
 void cpu::exec(const byte instr) noexcept
 {
+	cycles += opcodes[instr].cycles;
+	handlers[instr](*this);
+}
+
+template<int op>
+void cpu::alu(const byte r8) noexcept
+{
+	if constexpr(op == 0) add(r8);
+	else if constexpr(op == 1) add(r8, true);
+	else if constexpr(op == 2) sub(r8);
+	else if constexpr(op == 3) sub(r8, true);
+	else if constexpr(op == 4) logicAnd(r8);
+	else if constexpr(op == 5) logicXor(r8);
+	else if constexpr(op == 6) logicOr(r8);
+	else cmp(r8);
+}
+
+// The 8080 encodes most instructions in bit fields: `ddd` (bits 3-5) and
+// `sss` (bits 0-2) name registers, with 6 for M, `rp` (bits 4-5) names a
+// register pair and `ddd` also names the condition or the accumulator
+// operation. Each handler is `execute` specialized for one opcode, so that
+// these are all resolved at compile time.
+template<byte opcode>
+void cpu::execute(cpu& m) noexcept
+{
+	constexpr int ddd = opcode >> 3 & 7;
+	constexpr int sss = opcode & 7;
+	constexpr int rp = opcode >> 4 & 3;
+
+	byte& A = m.regs[7];
 	bytePair temp;
 
-	switch(instr)
+	// HLT, in place of MOV M, M
+	if constexpr(opcode == 0x76) m.halted = true;
+	// MOV r8, r8
+	else if constexpr(opcode >= 0x40 and opcode < 0x80) m.reg<ddd>() = m.reg<sss>();
+	// ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP r8
+	else if constexpr(opcode >= 0x80 and opcode < 0xc0) m.alu<ddd>(m.reg<sss>());
+	else if constexpr(opcode < 0x40)
 	{
 		// NOP, incl. undocumented
-		case 0x00:
-		case 0x08:
-		case 0x10:
-		case 0x18:
-		case 0x20:
-		case 0x28:
-		case 0x30:
-		case 0x38:
-			// Intentionally empty
-			break;
-
-		// LXI r16, d16
-		case 0x01: BC() = get16(); break;
-		case 0x11: DE() = get16(); break;
-		case 0x21: HL() = get16(); break;
-		case 0x31: SP = get16(); break;
-
-		// STAX r16
-		case 0x02: ram[BC()] = A(); break;
-		case 0x12: ram[DE()] = A(); break;
-
-		// LDAX r16
-		case 0x0a: A() = ram[BC()]; break;
-		case 0x1a: A() = ram[DE()]; break;
-
-		// SHLD a16
-		case 0x22: *(bytePair*)(ram + get16()) = HL(); break;
-
-		// LHLD a16
-		case 0x2a: HL() = *(bytePair*)(ram + get16()); break;
-
-		// STA a16
-		case 0x32: ram[get16()] = A(); break;
-
-		// LDA a16
-		case 0x3a: A() = ram[get16()]; break;
-
-		// INX r16
-		case 0x03: ++BC(); break;
-		case 0x13: ++DE(); break;
-		case 0x23: ++HL(); break;
-		case 0x33: ++SP; break;
-
-		// DCX r16
-		case 0x0b: --BC(); break;
-		case 0x1b: --DE(); break;
-		case 0x2b: --HL(); break;
-		case 0x3b: --SP; break;
-
+		if constexpr(sss == 0) {}
+		else if constexpr(sss == 1)
+		{
+			// DAD r16
+			if constexpr(opcode & 0x08) m.dad(m.pair<rp>());
+			// LXI r16, d16
+			else m.pair<rp>() = m.get16();
+		}
+		else if constexpr(sss == 2)
+		{
+			// STAX r16
+			if constexpr(ddd == 0 or ddd == 2) m.ram[m.pair<rp>()] = A;
+			// LDAX r16
+			else if constexpr(ddd == 1 or ddd == 3) A = m.ram[m.pair<rp>()];
+			// SHLD a16
+			else if constexpr(ddd == 4) m.write16(m.get16(), m.pairs[2]);
+			// LHLD a16
+			else if constexpr(ddd == 5) m.pairs[2] = m.read16(m.get16());
+			// STA a16
+			else if constexpr(ddd == 6) m.ram[m.get16()] = A;
+			// LDA a16
+			else A = m.ram[m.get16()];
+		}
+		else if constexpr(sss == 3)
+		{
+			// DCX r16
+			if constexpr(opcode & 0x08) --m.pair<rp>();
+			// INX r16
+			else ++m.pair<rp>();
+		}
 		// INR r8
-		case 0x04: inr(B()); break;
-		case 0x0c: inr(C()); break;
-		case 0x14: inr(D()); break;
-		case 0x1c: inr(E()); break;
-		case 0x24: inr(H()); break;
-		case 0x2c: inr(L()); break;
-		case 0x34: inr(atHL()); break;
-		case 0x3c: inr(A()); break;
-
+		else if constexpr(sss == 4) m.inr(m.reg<ddd>());
 		// DCR r8
-		case 0x05: dcr(B()); break;
-		case 0x0d: dcr(C()); break;
-		case 0x15: dcr(D()); break;
-		case 0x1d: dcr(E()); break;
-		case 0x25: dcr(H()); break;
-		case 0x2d: dcr(L()); break;
-		case 0x35: dcr(atHL()); break;
-		case 0x3d: dcr(A()); break;
-
+		else if constexpr(sss == 5) m.dcr(m.reg<ddd>());
 		// MVI r8
-		case 0x06: B() = get8(); break;
-		case 0x0e: C() = get8(); break;
-		case 0x16: D() = get8(); break;
-		case 0x1e: E() = get8(); break;
-		case 0x26: H() = get8(); break;
-		case 0x2e: L() = get8(); break;
-		case 0x36: atHL() = get8(); break;
-		case 0x3e: A() = get8(); break;
-
+		else if constexpr(sss == 6) m.reg<ddd>() = m.get8();
 		// RLC
-		case 0x07:							// (on register A:)
-			temp = highBitsOf(A(), 1);		// Extract bit 7
-			setFlag(carry, temp);			// Carry flag <- bit 7
-			A() <<= 1;						// Left shift 1
-			A() += (byte)temp;		// Bit 0 <- bit 7
-			break;
-
+		else if constexpr(ddd == 0)
+		{
+			temp = highBitsOf(A, 1);		// Extract bit 7
+			m.setFlag(carry, temp);			// Carry flag <- bit 7
+			A <<= 1;						// Left shift 1
+			A += (byte)temp;				// Bit 0 <- bit 7
+		}
 		// RRC
-		case 0x0f:									// (on register A:)
-			temp = lowBitsOf(A(), 1);				// Extract bit 0
-			setFlag(carry, temp);					// Carry flag <- bit 0
-			A() >>= 1;								// Right shift 1
-			A() += (1U << 7) * (byte)temp;	// Bit 7 <- bit 0
-			break;
-
-		// RAL
-		case 0x17: // Same as RLC, but bit 0 is not replaced with bit 7
-			setFlag(carry, highBitsOf(A(), 1));
-			A() <<= 1;
-			break;
-
-		// RAR
-		case 0x1f: // Same as RRC, but bit 7 is not replaced with bit 0
-			setFlag(carry, lowBitsOf(A(), 1));
-			A() >>= 1;
-			break;
-
+		else if constexpr(ddd == 1)
+		{
+			temp = lowBitsOf(A, 1);				// Extract bit 0
+			m.setFlag(carry, temp);				// Carry flag <- bit 0
+			A >>= 1;							// Right shift 1
+			A += (1U << 7) * (byte)temp;		// Bit 7 <- bit 0
+		}
+		// RAL: same as RLC, but bit 0 <- the old carry flag
+		else if constexpr(ddd == 2)
+		{
+			temp = m.getFlag(carry);
+			m.setFlag(carry, highBitsOf(A, 1));
+			A <<= 1;
+			A += (byte)temp;
+		}
+		// RAR: same as RRC, but bit 7 <- the old carry flag
+		else if constexpr(ddd == 3)
+		{
+			temp = m.getFlag(carry);
+			m.setFlag(carry, lowBitsOf(A, 1));
+			A >>= 1;
+			A += (1U << 7) * (byte)temp;
+		}
 		// DAA
-		case 0x27:
-			if(getFlag(auxCarry) or lowBitsOf(A(), 4) > 9)
+		else if constexpr(ddd == 4)
+		{
+			// The correction is added as by `adi`, which sets the auxiliary
+			// carry flag, but the carry flag is never cleared.
+			byte correction = 0;
+			bool carryOut = m.getFlag(carry);
+
+			if(m.getFlag(auxCarry) or lowBitsOf(A, 4) > 9)
 			{
-				A() += 6;
-				setFlag(auxCarry, true);
+				correction += 6;
 			}
 
-			if(getFlag(carry) or highBitsOf(A(), 4) > 9)
+			if(carryOut or highBitsOf(A, 4) > 9 or (highBitsOf(A, 4) >= 9 and lowBitsOf(A, 4) > 9))
 			{
-				A() += (6U << 4);
-				setFlag(carry, true);
+				correction += (6U << 4);
+				carryOut = true;
 			}
 
-			updateFlags(A());
-			break;
-
+			m.add(correction);
+			m.setFlag(carry, carryOut);
+		}
+		// CMA
+		else if constexpr(ddd == 5) A = ~A;
 		// STC
-		case 0x37: setFlag(carry, true); break;
+		else if constexpr(ddd == 6) m.setFlag(carry, true);
+		// CMC
+		else m.setFlag(carry, not m.getFlag(carry));
+	}
+	// Rcc
+	else if constexpr(sss == 0) m.ret(m.condition<ddd>());
+	else if constexpr(sss == 1)
+	{
+		// RET, incl. undocumented
+		if constexpr(opcode == 0xc9 or opcode == 0xd9) m.pop(m.PC);
+		// PCHL
+		else if constexpr(opcode == 0xe9) m.PC = m.pairs[2];
+		// SPHL
+		else if constexpr(opcode == 0xf9) m.SP = m.pairs[2];
+		// POP PSW
+		else if constexpr(rp == 3) m.pop(m.pairs[3]);
+		// POP r16
+		else m.pop(m.pair<rp>());
+	}
+	// Jcc a16
+	else if constexpr(sss == 2) m.jmp(m.condition<ddd>());
+	else if constexpr(sss == 3)
+	{
+		// JMP a16, incl. undocumented
+		if constexpr(opcode == 0xc3 or opcode == 0xcb) m.jmp(true);
+		// OUT p8
+		else if constexpr(opcode == 0xd3) m.portOutputHandler(m.get8(), A);
+		// IN p8
+		else if constexpr(opcode == 0xdb) A = m.portInputHandler(m.get8());
+		// XTHL
+		else if constexpr(opcode == 0xe3)
+		{
+			temp = m.read16(m.SP);
+			m.write16(m.SP, m.pairs[2]);
+			m.pairs[2] = temp;
+		}
+		// XCHG
+		else if constexpr(opcode == 0xeb) std::swap(m.pairs[2], m.pairs[1]);
+		// DI
+		else if constexpr(opcode == 0xf3) m.interruptsEnabled = false;
+		// EI
+		else m.interruptsEnabled = true;
+	}
+	// Ccc a16
+	else if constexpr(sss == 4) m.call(m.condition<ddd>());
+	else if constexpr(sss == 5)
+	{
+		// CALL, incl. undocumented
+		if constexpr(opcode & 0x08)
+		{
+			temp = m.get16();
+			m.push(m.PC);
+			m.PC = temp;
+		}
+		// PUSH PSW
+		else if constexpr(rp == 3) m.push(m.pairs[3]);
+		// PUSH r16
+		else m.push(m.pair<rp>());
+	}
+	// ADI, ACI, SUI, SBI, ANI, XRI, ORI, CPI
+	else if constexpr(sss == 6) m.alu<ddd>(m.get8());
+	// RST
+	else m.rst(ddd);
+}
 
-		// CMA
-		case 0x2f: A() = ~A(); break;
+template<std::size_t... opcode>
+constexpr std::array<cpu::handler, 256> cpu::makeHandlers(std::index_sequence<opcode...>) noexcept
+{
+	return {{&execute<opcode>...}};
+}
 
-		// CMC
-		case 0x3f: setFlag(carry, not getFlag(carry)); break;
-
-		// DAD r16
-		case 0x09: dad(BC()); break;
-		case 0x19: dad(DE()); break;
-		case 0x29: dad(HL()); break;
-		case 0x39: dad(SP); break;
-
-		// MOV r8, r8
-		case 0x40: B() = B(); break;
-		case 0x41: B() = C(); break;
-		case 0x42: B() = D(); break;
-		case 0x43: B() = E(); break;
-		case 0x44: B() = H(); break;
-		case 0x45: B() = L(); break;
-		case 0x46: B() = atHL(); break;
-		case 0x47: B() = A(); break;
-		case 0x48: C() = B(); break;
-		case 0x49: C() = C(); break;
-		case 0x4a: C() = D(); break;
-		case 0x4b: C() = E(); break;
-		case 0x4c: C() = H(); break;
-		case 0x4d: C() = L(); break;
-		case 0x4e: C() = atHL(); break;
-		case 0x4f: C() = A(); break;
-		case 0x50: D() = B(); break;
-		case 0x51: D() = C(); break;
-		case 0x52: D() = D(); break;
-		case 0x53: D() = E(); break;
-		case 0x54: D() = H(); break;
-		case 0x55: D() = L(); break;
-		case 0x56: D() = atHL(); break;
-		case 0x57: D() = A(); break;
-		case 0x58: E() = B(); break;
-		case 0x59: E() = C(); break;
-		case 0x5a: E() = D(); break;
-		case 0x5b: E() = E(); break;
-		case 0x5c: E() = H(); break;
-		case 0x5d: E() = L(); break;
-		case 0x5e: E() = atHL(); break;
-		case 0x5f: E() = A(); break;
-		case 0x60: H() = B(); break;
-		case 0x61: H() = C(); break;
-		case 0x62: H() = D(); break;
-		case 0x63: H() = E(); break;
-		case 0x64: H() = H(); break;
-		case 0x65: H() = L(); break;
-		case 0x66: H() = atHL(); break;
-		case 0x67: H() = A(); break;
-		case 0x68: L() = B(); break;
-		case 0x69: L() = C(); break;
-		case 0x6a: L() = D(); break;
-		case 0x6b: L() = E(); break;
-		case 0x6c: L() = H(); break;
-		case 0x6d: L() = L(); break;
-		case 0x6e: L() = atHL(); break;
-		case 0x6f: L() = A(); break;
-		case 0x70: atHL() = B(); break;
-		case 0x71: atHL() = C(); break;
-		case 0x72: atHL() = D(); break;
-		case 0x73: atHL() = E(); break;
-		case 0x74: atHL() = H(); break;
-		case 0x75: atHL() = L(); break;
-		// 0x76 is used for HLT
-		case 0x77: atHL() = A(); break;
-		case 0x78: A() = B(); break;
-		case 0x79: A() = C(); break;
-		case 0x7a: A() = D(); break;
-		case 0x7b: A() = E(); break;
-		case 0x7c: A() = H(); break;
-		case 0x7d: A() = L(); break;
-		case 0x7e: A() = atHL(); break;
-		case 0x7f: A() = A(); break;
-
-		// HLT
-		case 0x76: halted = true; break;
-
-		// ADD r8
-		case 0x80: add(B()); break;
-		case 0x81: add(C()); break;
-		case 0x82: add(D()); break;
-		case 0x83: add(E()); break;
-		case 0x84: add(H()); break;
-		case 0x85: add(L()); break;
-		case 0x86: add(atHL()); break;
-		case 0x87: add(A()); break;
-
-		// ADC r8
-		case 0x88: add(B(), true); break;
-		case 0x89: add(C(), true); break;
-		case 0x8a: add(D(), true); break;
-		case 0x8b: add(E(), true); break;
-		case 0x8c: add(H(), true); break;
-		case 0x8d: add(L(), true); break;
-		case 0x8e: add(atHL(), true); break;
-		case 0x8f: add(A(), true); break;
-
-		// SUB r8
-		case 0x90: sub(B()); break;
-		case 0x91: sub(C()); break;
-		case 0x92: sub(D()); break;
-		case 0x93: sub(E()); break;
-		case 0x94: sub(H()); break;
-		case 0x95: sub(L()); break;
-		case 0x96: sub(atHL()); break;
-		case 0x97: sub(A()); break;
-
-		// SBB r8
-		case 0x98: sub(B(), true); break;
-		case 0x99: sub(C(), true); break;
-		case 0x9a: sub(D(), true); break;
-		case 0x9b: sub(E(), true); break;
-		case 0x9c: sub(H(), true); break;
-		case 0x9d: sub(L(), true); break;
-		case 0x9e: sub(atHL(), true); break;
-		case 0x9f: sub(A(), true); break;
-
-		// ANA r8
-		case 0xa0: logicAnd(B()); break;
-		case 0xa1: logicAnd(C()); break;
-		case 0xa2: logicAnd(D()); break;
-		case 0xa3: logicAnd(E()); break;
-		case 0xa4: logicAnd(H()); break;
-		case 0xa5: logicAnd(L()); break;
-		case 0xa6: logicAnd(atHL()); break;
-		case 0xa7: logicAnd(A()); break;
-
-		// XRA r8
-		case 0xa8: logicXor(B()); break;
-		case 0xa9: logicXor(C()); break;
-		case 0xaa: logicXor(D()); break;
-		case 0xab: logicXor(E()); break;
-		case 0xac: logicXor(H()); break;
-		case 0xad: logicXor(L()); break;
-		case 0xae: logicXor(atHL()); break;
-		case 0xaf: logicXor(A()); break;
-
-		// ORA r8
-		case 0xb0: logicOr(B()); break;
-		case 0xb1: logicOr(C()); break;
-		case 0xb2: logicOr(D()); break;
-		case 0xb3: logicOr(E()); break;
-		case 0xb4: logicOr(H()); break;
-		case 0xb5: logicOr(L()); break;
-		case 0xb6: logicOr(atHL()); break;
-		case 0xb7: logicOr(A()); break;
-
-		// CMP r8
-		case 0xb8: cmp(B()); break;
-		case 0xb9: cmp(C()); break;
-		case 0xba: cmp(D()); break;
-		case 0xbb: cmp(E()); break;
-		case 0xbc: cmp(H()); break;
-		case 0xbd: cmp(L()); break;
-		case 0xbe: cmp(atHL()); break;
-		case 0xbf: cmp(A()); break;
-
-		// ADI
-		case 0xc6: add(get8()); break;
-
-		// ACI
-		case 0xce: add(get8(), true); break;
-
-		// SUI
-		case 0xd6: sub(get8()); break;
-
-		// SBI
-		case 0xde: sub(get8(), true); break;
-
-		// ANI
-		case 0xe6: logicAnd(get8()); break;
-
-		// XRI
-		case 0xee: logicXor(get8()); break;
-
-		// ORI
-		case 0xf6: logicOr(get8()); break;
-
-		// CPI
-		case 0xfe: cmp(get8()); break;
+const std::array<cpu::handler, 256> cpu::handlers = makeHandlers(std::make_index_sequence<256>());
 
-		// XCHG
-		case 0xeb:
-			temp = HL();
-			HL() = DE();
-			DE() = temp;
-			break;
+std::uint64_t intel8080::hashBytes(const byte *const data, const std::size_t size) noexcept
+{
+	constexpr std::uint64_t prime = 0x9e3779b97f4a7c15;
 
-		// XTHL
-		case 0xe3:
-			temp = *(bytePair*)(ram + SP);
-			*(bytePair*)(ram + SP) = HL();
-			HL() = temp;
-			break;
+	const auto mix = [](std::uint64_t h) noexcept
+	{
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccd;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53;
+		h ^= h >> 33;
+		return h;
+	};
+
+	std::uint64_t h = size * prime;
+	std::size_t i = 0;
+
+	// Eight bytes at a time, then whatever is left over
+	for(; i + 8 <= size; i += 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		h = (h ^ mix(word)) * prime;
+	}
 
-		// SPHL
-		case 0xf9: SP = HL(); break;
+	std::uint64_t tail = 0;
+	for(std::size_t shift = 0; i < size; ++i, shift += 8)
+	{
+		tail |= (std::uint64_t)data[i] << shift;
+	}
 
-		// PCHL
-		case 0xe9: PC = HL(); break;
+	return mix(h ^ mix(tail));
+}
 
-		// DI
-		case 0xf3: interruptsEnabled = false; break;
+byte intel8080::asciiToHex(const char c) noexcept
+{
+	if(c >= '0' and c <= '9')
+		return c - '0';
+	else if(c >= 'A' and c <= 'F')
+		return (c - 'A') + 10;
+	else if(c >= 'a' and c <= 'f')
+		return (c - 'a') + 10;
+	else
+		return 0xff;
+}
 
-		// EI
-		case 0xfb: interruptsEnabled = true; break;
+bool intel8080::loadIntelHexFile(const std::string& filename, byte *const memory, hexLoadInfo *const info /* = nullptr */, const std::size_t memorySize /* = 0x10000 */)
+{
+	hexLoadInfo localInfo;
+	hexLoadInfo& result = info ? *info : localInfo;
+	result = hexLoadInfo();
 
-		// PUSH r16
-		case 0xc5: push(BC()); break;
-		case 0xd5: push(DE()); break;
-		case 0xe5: push(HL()); break;
-		case 0xf5: push(PSW()); break;
+	std::filebuf hexFile;
+	if(not hexFile.open(filename, std::ios::in | std::ios::binary))
+	{
+		result.error = hexError::cannotOpen;
+		return false;
+	}
 
-		// POP r16
-		case 0xc1: pop(BC()); break;
-		case 0xd1: pop(DE()); break;
-		case 0xe1: pop(HL()); break;
-		case 0xf1: pop(PSW()); break;
+	// Base address set by 0x02 or 0x04 records; `segmented` is true for 0x02,
+	// in which case the 16-bit offset wraps around within the segment
+	std::uint32_t base = 0;
+	bool segmented = false;
+	bool wroteAnything = false;
+	std::size_t line = 1;
 
-		// IN p8
-		case 0xdb: A() = portInputHandler(get8()); break;
+	// Each record is at most 255 data bytes plus 5 bytes of header/checksum;
+	// it is kept here until its checksum has been verified
+	byte record[5 + 255];
 
-		// OUT p8
-		case 0xd3: portOutputHandler(get8(), A()); break;
+	const auto fail = [&](const hexError e)
+	{
+		result.error = e;
+		result.line = line;
+		return false;
+	};
 
-		// RST
-		case 0xc7: rst(0); break;
-		case 0xcf: rst(1); break;
-		case 0xd7: rst(2); break;
-		case 0xdf: rst(3); break;
-		case 0xe7: rst(4); break;
-		case 0xef: rst(5); break;
-		case 0xf7: rst(6); break;
-		case 0xff: rst(7); break;
+	for(;;)
+	{
+		// Skip whitespace between records, counting lines as we go
+		int c = hexFile.sbumpc();
+		while(c == '\n' or c == '\r' or c == ' ' or c == '\t')
+		{
+			if(c == '\n') ++line;
+			c = hexFile.sbumpc();
+		}
 
-		// JNZ a16
-		case 0xc2: jmp(not getFlag(zero)); break;
+		if(c == std::char_traits<char>::eof())
+			return fail(hexError::missingEof);
 
-		// JMP a16
-		case 0xc3: jmp(true); break;
+		if(c != ':')
+			return fail(hexError::expectedColon);
 
-		// JZ a16
-		case 0xca: jmp(getFlag(zero)); break;
+		// Read the byte count first so we know how long the record is, then
+		// the rest of the record
+		std::size_t length = 1;
+		byte checksum = 0;
 
-		// JNC a16
-		case 0xd2: jmp(not getFlag(carry)); break;
+		for(std::size_t i = 0; i < length; ++i)
+		{
+			const int hi = hexFile.sbumpc();
+			const int lo = hexFile.sbumpc();
 
-		// JC a16
-		case 0xda: jmp(getFlag(carry)); break;
+			if(hi == std::char_traits<char>::eof() or lo == std::char_traits<char>::eof())
+				return fail(hexError::truncatedRecord);
 
-		// JPO a16
-		case 0xe2: jmp(not getFlag(parity)); break;
+			const byte hiVal = asciiToHex(hi);
+			const byte loVal = asciiToHex(lo);
 
-		// JPE a16
-		case 0xea: jmp(getFlag(parity)); break;
+			if(hiVal > 0xf or loVal > 0xf)
+				return fail(hexError::invalidDigit);
 
-		// JP a16
-		case 0xf2: jmp(not getFlag(sign)); break;
+			record[i] = hiVal * 0x10 + loVal;
+			checksum += record[i];
 
-		// JM a16
-		case 0xfa: jmp(getFlag(sign)); break;
+			if(i == 0)
+			{
+				// Byte count, address (2), record type, data, checksum
+				length = 5 + record[0];
+			}
+		}
 
-		// RET, incl. undocumented
-		case 0xc9:
-		case 0xd9: ret(true); break;
+		if(checksum != 0)
+			return fail(hexError::badChecksum);
 
-		// RNZ
-		case 0xc0: ret(not getFlag(zero)); break;
+		const byte byteCount = record[0];
+		const bytePair offset = record[1] * 0x100 + record[2];
+		const byte recordType = record[3];
+		const byte *const data = record + 4;
 
-		// RZ
-		case 0xc8: ret(getFlag(zero)); break;
+		switch(recordType)
+		{
+			// Data
+			case 0x00:
+			{
+				if(byteCount == 0)
+					break;
 
-		// RNC
-		case 0xd0: ret(not getFlag(carry)); break;
+				// A segmented record that crosses the end of its segment
+				// wraps around to the start of the segment
+				if(segmented and offset + byteCount > 0x10000)
+				{
+					const std::size_t firstPart = 0x10000 - offset;
 
-		// RC
-		case 0xd8: ret(getFlag(carry)); break;
+					if(base + 0x10000 > memorySize)
+						return fail(hexError::outOfRange);
 
-		// RPO
-		case 0xe0: ret(not getFlag(parity)); break;
+					std::copy(data, data + firstPart, memory + base + offset);
+					std::copy(data + firstPart, data + byteCount, memory + base);
 
-		// RPE
-		case 0xe8: ret(getFlag(parity)); break;
+					result.lowAddress = wroteAnything ? std::min(result.lowAddress, base) : base;
+					result.highAddress = wroteAnything ? std::max(result.highAddress, base + 0x10000) : base + 0x10000;
+					wroteAnything = true;
+					break;
+				}
 
-		// RP
-		case 0xf0: ret(not getFlag(sign)); break;
+				const std::uint32_t adr = base + offset;
 
-		// RM
-		case 0xf8: ret(getFlag(sign)); break;
+				if(adr + byteCount > memorySize or adr + byteCount < adr)
+					return fail(hexError::outOfRange);
 
-		// CALL, incl. undocumented
-		case 0xcd:
-		case 0xdd:
-		case 0xed:
-		case 0xfd: call(true); break;
+				std::copy(data, data + byteCount, memory + adr);
 
-		// CNZ
-		case 0xc4: call(not getFlag(zero)); break;
+				result.lowAddress = wroteAnything ? std::min(result.lowAddress, adr) : adr;
+				result.highAddress = wroteAnything ? std::max(result.highAddress, adr + byteCount) : adr + byteCount;
+				wroteAnything = true;
+				break;
+			}
 
-		// CZ
-		case 0xcc: call(getFlag(zero)); break;
+			// End Of File
+			case 0x01:
+				if(byteCount != 0)
+					return fail(hexError::badRecordLength);
 
-		// CNC
-		case 0xd4: call(not getFlag(carry)); break;
+				return true;
 
-		// CC
-		case 0xdc: call(getFlag(carry)); break;
+			// Extended Segment Address
+			case 0x02:
+				if(byteCount != 2)
+					return fail(hexError::badRecordLength);
 
-		// CPO
-		case 0xe4: call(not getFlag(parity)); break;
+				base = (data[0] * 0x100U + data[1]) << 4;
+				segmented = true;
+				break;
 
-		// CPE
-		case 0xec: call(getFlag(parity)); break;
+			// Start Segment Address (CS:IP)
+			case 0x03:
+				if(byteCount != 4)
+					return fail(hexError::badRecordLength);
 
-		// CP
-		case 0xf4: call(not getFlag(sign)); break;
+				result.hasStartAddress = true;
+				result.startAddress = ((data[0] * 0x100U + data[1]) << 4) + (data[2] * 0x100U + data[3]);
+				break;
 
-		// CM
-		case 0xfc: call(getFlag(sign)); break;
+			// Extended Linear Address
+			case 0x04:
+				if(byteCount != 2)
+					return fail(hexError::badRecordLength);
 
-		// All cases should be covered; no `default` is necessary.
+				base = (data[0] * 0x100U + data[1]) << 16;
+				segmented = false;
+				break;
+
+			// Start Linear Address
+			case 0x05:
+				if(byteCount != 4)
+					return fail(hexError::badRecordLength);
+
+				result.hasStartAddress = true;
+				result.startAddress = (std::uint32_t)data[0] << 24 | data[1] << 16 | data[2] << 8 | data[3];
+				break;
+
+			default:
+				return fail(hexError::badRecordType);
+		}
 	}
 }
 
-byte intel8080::asciiToHex(const char c) noexcept
+byte* intel8080::mapImageFile(const std::string& filename, const bytePair origin /* = 0 */) noexcept
 {
-	if(c >= '0' and c <= '9')
-		return c - '0';
-	else if(c >= 'A' and c <= 'F')
-		return (c - 'A') + 10;
-	else
-		return 0; // This is here for completeness' sake, it doesn't actually do anything
+	const mappedFile file(filename);
+
+	if(not file.ok() or origin + file.size > 0x10000)
+		return nullptr;
+
+	void *const p = mmap(nullptr, 0x10000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(p == MAP_FAILED)
+		return nullptr;
+
+	byte *const ram = (byte*)p;
+
+	if(file.size == 0)
+		return ram;
+
+	// Map the file's pages directly over RAM if they line up; the last page
+	// is zero-filled past the end of the file
+	if(origin % sysconf(_SC_PAGESIZE) == 0
+		and mmap(ram + origin, file.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, file.fd, 0) != MAP_FAILED)
+	{
+		return ram;
+	}
+
+	std::memcpy(ram + origin, file.data, file.size);
+	return ram;
+}
+
+void intel8080::unmapImageFile(byte *const ram) noexcept
+{
+	if(ram) munmap(ram, 0x10000);
 }
 
-bool intel8080::loadIntelHexFile(const std::string& filename, byte *const memory)
+bool intel8080::writeIntelHexFile(const std::string& filename, const byte *const memory, const std::uint32_t begin, const std::uint32_t length, const hexWriteOptions& options /* = hexWriteOptions() */)
 {
-	std::ifstream hexFile(filename);
-	std::string contents;
-	int val;
-	byte byteCount;
-	bytePair adr;
-	byte recordType;
-	std::map<bytePair, std::vector<byte>> records;
+	if(options.recordLength == 0)
+		return false;
 
-	// Open the file by creating a buffer, loading file contents into the buffer, and copying it as a string
-	if(hexFile.is_open()){
-		std::stringstream buffer;
-		buffer << hexFile.rdbuf();
-		contents = buffer.str();
-	}
-	else return false;
+	bufferedWriter out(filename);
+	constexpr std::size_t maxRecordSize = 1 + 2 * (5 + 255) + 1;
+
+	const std::uint64_t end = (std::uint64_t)begin + length;
+	std::uint32_t upper = 0;
 
-	// From the beginning of each record...
-	for(int colonPos = 0; colonPos != std::string::npos; colonPos = contents.find(':', colonPos + 1))
+	for(std::uint64_t adr = begin; adr < end; )
 	{
-		// For each char until the end of the file OR the next colon, whichever comes first...
-		for(int i = 1; colonPos + i < contents.size() and contents[colonPos + i] != ':'; ++i)
+		// Records never cross a 64K boundary, since their address is 16 bits
+		if((adr >> 16) != upper)
 		{
-			int byteNum = (i - 1) / 2;
+			upper = adr >> 16;
+			const byte data[2] = {(byte)(upper >> 8), (byte)upper};
+			out.commit(formatHexRecord(out.reserve(maxRecordSize), 0x04, 0, data, 2));
+		}
 
-			if((i - 1) % 2 == 0)
-			{
-				val = 0x10 * asciiToHex(contents[colonPos + i]);
-			}
-			else
-			{
-				val += asciiToHex(contents[colonPos + i]);
+		const std::uint64_t segmentEnd = std::min<std::uint64_t>(end, (adr | 0xffff) + 1);
+		const byte count = std::min<std::uint64_t>(options.recordLength, segmentEnd - adr);
 
-				// Field type
-				switch(byteNum)
-				{
-					// Byte count
-					case 0:
-						byteCount = val;
-						break;
-
-					// Address, byte 1
-					case 1:
-						adr = val * 0x100;
-						break;
-
-					// Address, byte 2
-					case 2:
-						adr += val;
-						break;
-
-					// Record type
-					case 3:
-						recordType = val;
-						break;
-
-					// Data and checksum
-					default:
-						if(byteNum - 4 <= byteCount)
-						{
-							records[adr].push_back(val);
-						}
-						break;
-				}
-			}
-		}
+		out.commit(formatHexRecord(out.reserve(maxRecordSize), 0x00, adr & 0xffff, memory + adr, count));
+		adr += count;
 	}
 
-	// Write the records to memory
-	for(const auto& record : records)
+	if(options.writeStartAddress)
 	{
-		for(int i = 0; i < record.second.size(); ++i)
-		{
-			memory[record.first + i] = record.second[i];
-		}
+		const std::uint32_t start = options.startAddress;
+		const byte data[4] = {(byte)(start >> 24), (byte)(start >> 16), (byte)(start >> 8), (byte)start};
+		out.commit(formatHexRecord(out.reserve(maxRecordSize), 0x05, 0, data, 4));
 	}
 
-	return true;
-}
\ No newline at end of file
+	out.commit(formatHexRecord(out.reserve(maxRecordSize), 0x01, 0, nullptr, 0));
+	return out.finish();
+}
+
+bool intel8080::writeBinaryFile(const std::string& filename, const byte *const memory, const std::uint32_t begin, const std::uint32_t length)
+{
+	bufferedWriter out(filename);
+	out.write(memory + begin, length);
+	return out.finish();
+}
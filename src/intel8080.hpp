@@ -16,8 +16,14 @@
 
 #define INTEL8080_DEBUG__ true
 
+// The version of the emulator as 0xMMmmpp (major, minor, patch), recorded in
+// the results `bench` saves.
+#define INTEL8080_VERSION__ 0x000300
+
 #include <set>
+#include <array>
 #include <vector>
+#include <utility>
 #include <cinttypes>
 #include <functional>
 
@@ -67,6 +73,33 @@ namespace intel8080
 		carry = 0		// Set if there was a carry (from bit 7).
 	};
 
+	/**
+	 * @brief 2 bytes of memory, read and written as a little-endian
+	   `bytePair` that wraps around from 0xffff to 0x0000.
+	 */
+	class memoryWord
+	{
+	public:
+		/**
+		 * @param ram `byte *const` 65536 bytes of memory.
+		 * @param adr `const bytePair` The address of the low byte.
+		 */
+		memoryWord(byte *const ram, const bytePair adr) noexcept;
+
+		operator bytePair(void) const noexcept;
+
+		memoryWord& operator=(const bytePair value) noexcept;
+
+		/**
+		 * @brief Copies the value of `other`, not where it is.
+		 */
+		memoryWord& operator=(const memoryWord& other) noexcept;
+
+	private:
+		byte *const ram;
+		const bytePair adr;
+	};
+
 	/**
 	 * @brief A pair of 8-bit registers.
 	 */
@@ -117,6 +150,13 @@ namespace intel8080
 		 */
 		bytePair PC = 0;
 
+		/**
+		 * @brief The number of clock cycles (states) the CPU has run for.
+		 * This is never reset by the CPU, so the user may set it to whatever is
+		   convenient, e.g. 0 at the start of each frame.
+		 */
+		std::uint64_t cycles = 0;
+
 		/**
 		 * @brief A pointer to space in memory used as RAM.
 		 */
@@ -219,10 +259,11 @@ namespace intel8080
 		byte& atHL(void) noexcept;
 
 		/**
-		 * @return `bytePair&` A mutable reference to the 2 bytes pointed to by
-		   the register pair HL.
+		 * @return `memoryWord` The 2 bytes pointed to by the stack pointer,
+		   which can be read and assigned. Like the stack instructions, this
+		   wraps around from 0xffff to 0x0000.
 		 */
-		bytePair& atSP(void) noexcept;
+		memoryWord atSP(void) noexcept;
 
 		/**
 		 * @param f `const flagPos` The position of the flag to retrieve.
@@ -246,6 +287,44 @@ namespace intel8080
 		 */
 		bool getHalted(void) noexcept;
 
+		/**
+		 * @brief Halts the CPU or resumes it, e.g. to restore a saved state.
+		 * @param halted `const bool` Whether the CPU is halted.
+		 */
+		void setHalted(const bool halted) noexcept;
+
+		/**
+		 * @return `bool` Whether interrupts are enabled, i.e. whether
+		   `interrupt(const byte)` requests one.
+		 */
+		bool getInterruptsEnabled(void) noexcept;
+
+		/**
+		 * @brief Enables or disables interrupts as `ei` and `di` do.
+		 * @param enabled `const bool` Whether interrupts are enabled.
+		 */
+		void setInterruptsEnabled(const bool enabled) noexcept;
+
+		/**
+		 * @return `bool` Whether an interrupt has been requested and not yet
+		   serviced. It is serviced by the next `step(void)` if interrupts
+		   are enabled.
+		 */
+		bool getInterruptPending(void) noexcept;
+
+		/**
+		 * @return `byte` The instruction run for the pending interrupt, if any.
+		 */
+		byte getInterruptVector(void) noexcept;
+
+		/**
+		 * @brief Sets the pending interrupt directly, whether or not
+		   interrupts are enabled, e.g. to restore a saved state.
+		 * @param pending `const bool` Whether an interrupt is pending.
+		 * @param vector `const byte` The instruction to run for it.
+		 */
+		void setInterruptPending(const bool pending, const byte vector) noexcept;
+
 		/**
 		 * @brief Loads raw bytes (be it data, a program, or both) to memory,
 		   typically an assembled program.
@@ -254,6 +333,28 @@ namespace intel8080
 		 */
 		void load(const bytePair origin, const std::vector<byte>& bytes) noexcept;
 
+		/**
+		 * @brief Loads a raw binary image from a file to memory.
+		 * The file is memory-mapped and copied straight into RAM, with no
+		   intermediate buffer. The program counter is set to `origin`.
+		 * @param filename `const std::string&` The name of the file to load.
+		 * @param origin `const bytePair` The address in RAM to load the file to.
+		 * @return `bool` Whether the load succeeded. It fails if the file
+		   cannot be opened or does not fit in RAM above `origin`.
+		 */
+		bool loadBinaryFile(const std::string& filename, const bytePair origin) noexcept;
+
+		/**
+		 * @brief Loads a CP/M .COM program and prepares the CPU to run it.
+		 * The program is loaded at 0x0100 (the start of the transient program
+		   area) and the program counter is set to 0x0100. The stack pointer is
+		   set to the top of memory with 0x0000 pushed onto the stack, so that a
+		   `ret` from the program returns to the warm boot vector, as in CP/M.
+		 * @param filename `const std::string&` The name of the .COM file to load.
+		 * @return `bool` Whether the load succeeded.
+		 */
+		bool loadComFile(const std::string& filename) noexcept;
+
 		/**
 		 * @brief Interrupts the CPU and prepares it to run the interrupt vector.
 		 * @note This does not actually run the interrupt vector, but stores it
@@ -278,36 +379,49 @@ namespace intel8080
 		 */
 		void step(void) noexcept;
 
-		#if INTEL8080_DEBUG__
 		/**
-		 * @brief Dumps the status of all registers and flags to the console.
+		 * @brief Reads 2 bytes from memory, wrapping around from 0xffff to 0x0000.
+		 *
+		 * @param adr `const bytePair` The address of the low byte.
+		 * @return `bytePair` The 2 bytes at `adr`.
 		 */
-		void dump(void) noexcept;
-		#endif
-
-	#if not INTEL8080_DEBUG__
-	private:
-	#endif
+		bytePair read16(const bytePair adr) noexcept;
 
 		/**
-		 * @brief The program state word (accumulator and flag register).
+		 * @brief Writes 2 bytes to memory, wrapping around from 0xffff to 0x0000.
+		 *
+		 * @param adr `const bytePair` The address of the low byte.
+		 * @param value `const bytePair` The value to write.
 		 */
-		regPair _PSW;
-		
+		void write16(const bytePair adr, const bytePair value) noexcept;
+
+		#if INTEL8080_DEBUG__
 		/**
-		 * @brief The register pair BC.
+		 * @brief Dumps the status of all registers and flags to the console.
 		 */
-		regPair _BC;
+		void dump(void) noexcept;
+		#endif
 
 		/**
-		 * @brief The register pair DE.
+		 * @brief Runs predecoded instructions with the helpers below.
 		 */
-		regPair _DE;
+		friend class blockEngine;
+
+	#if not INTEL8080_DEBUG__
+	private:
+	#endif
 
 		/**
-		 * @brief The register pair HL.
+		 * @brief The 8-bit registers, ordered so that each register pair is
+		   a `bytePair` with its low register first: C, B, E, D, L, H, the
+		   flag register and A.
+		 * `pairs` holds BC, DE, HL and the program state word in turn.
 		 */
-		regPair _HL;
+		union
+		{
+			byte regs[8];
+			bytePair pairs[4];
+		};
 
 		/**
 		 * @brief If `true`, allows interrupts to be serviced.
@@ -331,7 +445,7 @@ namespace intel8080
 		 * That is, `step(void)` will do nothing except for servicing any
 		   pending interrupts, after which `halted` will be reset to `false`.
 		 */
-		bool halted;
+		bool halted = false;
 
 		/**
 		 * @brief Returns the byte at the program counter, then increments the
@@ -352,24 +466,9 @@ namespace intel8080
 		/**
 		 * @brief Updates the sign, zero, and parity flags based on a result.
 		 * 
-		 * @tparam T The type of result, either `byte` or `bytePair`.
-		 * @param result `T` The result.
-		 */
-		template<typename T>
-		void updateFlags(const T result) noexcept;
-
-		/**
-		 * @brief Updates the carry flag based on the sum of the lower 4 bits of
-		   two numbers.
-		 * That is, if the sum of the lower 4 bits of `a` and `b` is greater
-		   than the maximum value a 4-bit integer can hold, an auxiliary carry
-		   must be required in order to store the sum, and so the auxiliary
-		   carry flag is set to 1.
-		 *
-		 * @param a `byte` The first number.
-		 * @param b `byte` The second number.
+		 * @param result `byte` The result.
 		 */
-		void updateAuxCarryFlag(const byte a, const byte b) noexcept;
+		void updateFlags(const byte result) noexcept;
 
 		/**
 		 * @brief Executes the `inr` instruction with operand `r8`.
@@ -470,18 +569,19 @@ namespace intel8080
 
 		/**
 		 * @brief Executes a conditional `ret`.
-		 * Performs a `ret` if `condition` is true.
+		 * Performs a `ret` if `condition` is true, which takes 6 more cycles
+		   than if it is false.
 		 * 
-		 * @param condition `bool` Whether to return. Use `true` for an unconditional return.
+		 * @param condition `bool` Whether to return.
 		 */
 		void ret(const bool condition) noexcept;
 
 		/**
-		 * @brief Calls a subroutine.
-		 * Executes `call` with the address pointed to by the program counter if
-		 * `condition` is true.
+		 * @brief Executes a conditional `call`.
+		 * Calls the subroutine at the address pointed to by the program counter
+		 * if `condition` is true, which takes 6 more cycles than if it is false.
 		 * 
-		 * @param condition `bool` Whether to call. Use `true` for an unconditional call.
+		 * @param condition `bool` Whether to call.
 		 */
 		void call(const bool r8) noexcept;
 
@@ -494,8 +594,86 @@ namespace intel8080
 		 * @param r8 The instruction to execute.
 		 */
 		void exec(const byte r8) noexcept;
+
+		/**
+		 * @brief Executes one instruction, whose opcode has been fetched.
+		 */
+		using handler = void (*)(cpu& m) noexcept;
+
+		/**
+		 * @brief The handler for each opcode.
+		 */
+		static const std::array<handler, 256> handlers;
+
+		template<std::size_t... opcode>
+		static constexpr std::array<handler, 256> makeHandlers(std::index_sequence<opcode...>) noexcept;
+
+		/**
+		 * @brief Executes `opcode`, decoded from its bit fields at compile time.
+		 */
+		template<byte opcode>
+		static void execute(cpu& m) noexcept;
+
+		/**
+		 * @param r `const int` A register as encoded in an opcode (B, C, D,
+		   E, H, L, M, A), other than M.
+		 * @return `int` Its index in `regs`.
+		 */
+		static constexpr int regSlot(const int r) noexcept
+		{
+			return r == 7 ? 7 : r ^ 1;
+		}
+
+		/**
+		 * @return `byte&` The register encoded as `r` in an opcode, or the
+		   byte pointed to by HL if `r` is 6.
+		 */
+		template<int r>
+		byte& reg(void) noexcept;
+
+		/**
+		 * @return `bytePair&` The register pair encoded as `rp` in an
+		   opcode, with 3 as the stack pointer.
+		 */
+		template<int rp>
+		bytePair& pair(void) noexcept;
+
+		/**
+		 * @return `bool` Whether the condition encoded as `cc` in a
+		   conditional jump, call or return holds.
+		 */
+		template<int cc>
+		bool condition(void) noexcept;
+
+		/**
+		 * @brief Executes the accumulator operation encoded as `op` in an
+		   opcode (`add`, `adc`, `sub`, `sbb`, `ana`, `xra`, `ora`, `cmp`).
+		 */
+		template<int op>
+		void alu(const byte r8) noexcept;
 	};
 
+	template<int r>
+	byte& cpu::reg(void) noexcept
+	{
+		if constexpr(r == 6) return ram[pairs[2]];
+		else return regs[regSlot(r)];
+	}
+
+	template<int rp>
+	bytePair& cpu::pair(void) noexcept
+	{
+		if constexpr(rp == 3) return SP;
+		else return pairs[rp];
+	}
+
+	template<int cc>
+	bool cpu::condition(void) noexcept
+	{
+		constexpr flagPos flag[4] = {zero, carry, parity, sign};
+		return (regs[6] >> flag[cc >> 1] & 1) == (cc & 1);
+	}
+
 	/**
 	 * @return `T` The `k` lowest bits of `n`.
 	 */
@@ -524,19 +702,164 @@ namespace intel8080
 	}
 
 	/**
-	 * @param `c` A hexadecimal digit in ASCII.
-	 * @note This assumes `c` is a valid hex character.
-	 * @return The value of `c` when interpreted as a hexadecimal (base 16) digit.
+	 * @brief Computes a fast, non-cryptographic 64-bit hash of some bytes.
+	 * The result only depends on the bytes, so it can be used to identify
+	   the contents of memory across processes and machines.
+	 *
+	 * @param data `const byte *const` The bytes to hash.
+	 * @param size `const std::size_t` The number of bytes to hash.
+	 * @return `std::uint64_t` The hash.
+	 */
+	std::uint64_t hashBytes(const byte *const data, const std::size_t size) noexcept;
+
+	/**
+	 * @param `c` A hexadecimal digit in ASCII, either uppercase or lowercase.
+	 * @return The value of `c` when interpreted as a hexadecimal (base 16)
+	   digit, or `0xff` if `c` is not a hexadecimal digit.
 	 */
 	byte asciiToHex(const char c) noexcept;
 
+	/**
+	 * @brief Reasons why loading a .hex file may fail.
+	 */
+	enum class hexError
+	{
+		none,				// The file was loaded successfully.
+		cannotOpen,			// The file could not be opened.
+		expectedColon,		// Something other than whitespace was found between records.
+		invalidDigit,		// A record contained a character that is not a hex digit.
+		truncatedRecord,	// The file ended in the middle of a record.
+		badChecksum,		// A record's checksum did not match its contents.
+		badRecordType,		// A record's type was not between 0x00 and 0x05.
+		badRecordLength,	// A record of type 0x01 through 0x05 had the wrong byte count.
+		outOfRange,			// A data record would have been written past the end of memory.
+		missingEof			// The file ended without an End Of File (0x01) record.
+	};
+
+	/**
+	 * @brief Describes the outcome of `loadIntelHexFile`.
+	 */
+	struct hexLoadInfo
+	{
+		/**
+		 * @brief Why the load failed, or `hexError::none` if it succeeded.
+		 */
+		hexError error = hexError::none;
+
+		/**
+		 * @brief The line (counting from 1) on which `error` was found.
+		 */
+		std::size_t line = 0;
+
+		/**
+		 * @brief Whether a Start Segment Address (0x03) or Start Linear Address
+		   (0x05) record was found.
+		 */
+		bool hasStartAddress = false;
+
+		/**
+		 * @brief The start address given by the last 0x03 or 0x05 record. For
+		   0x03 records this is the physical address `CS * 16 + IP`.
+		 */
+		std::uint32_t startAddress = 0;
+
+		/**
+		 * @brief The lowest address written to by a data record.
+		 */
+		std::uint32_t lowAddress = 0;
+
+		/**
+		 * @brief One past the highest address written to by a data record.
+		 * If nothing was written, this is equal to `lowAddress`.
+		 */
+		std::uint32_t highAddress = 0;
+	};
+
 	/**
 	 * @brief Loads the data specified by a .hex file into memory.
-	 * @note Only record types 0x00 (Data) and 0x01 (End Of File) are supported. 
+	 * The file is parsed in a single pass; each data record is checked against
+	   its checksum and then copied directly into `memory`. Records loaded
+	   before an error is found are left in memory.
+	 * @note All record types are supported: 0x00 (Data), 0x01 (End Of File),
+	   0x02 (Extended Segment Address), 0x03 (Start Segment Address),
+	   0x04 (Extended Linear Address) and 0x05 (Start Linear Address).
+	   Extended addresses allow images larger than 64K (e.g. for banked
+	   memory) to be loaded, provided `memorySize` is large enough.
 	 *
 	 * @param filename `const std::string&` The name of the .hex file to load.
-	 * @param memory `byte *const` A pointer to at least 64K of continuous memory space. This will be modified.
-	 * @return `bool` Whether the load succeeded. If it failed, it means either the file doesn't exist or something went wrong with the checksums/formatting.
+	 * @param memory `byte *const` A pointer to at least `memorySize` bytes of continuous memory space. This will be modified.
+	 * @param info `hexLoadInfo *const = nullptr` If not null, receives the reason for any failure and the start address, if any.
+	 * @param memorySize `const std::size_t = 0x10000` The size of `memory`.
+	 * @return `bool` Whether the load succeeded. If it failed, `info->error` says why.
+	 */
+	bool loadIntelHexFile(const std::string& filename, byte *const memory, hexLoadInfo *const info = nullptr, const std::size_t memorySize = 0x10000);
+
+	/**
+	 * @brief Options for `writeIntelHexFile`.
+	 */
+	struct hexWriteOptions
+	{
+		/**
+		 * @brief The maximum number of data bytes in each record, from 1 to 255.
+		 */
+		byte recordLength = 16;
+
+		/**
+		 * @brief Whether to write a Start Linear Address (0x05) record.
+		 */
+		bool writeStartAddress = false;
+
+		/**
+		 * @brief The start address to write if `writeStartAddress` is `true`.
+		 */
+		std::uint32_t startAddress = 0;
+	};
+
+	/**
+	 * @brief Writes a range of memory to a .hex file.
+	 * Every record has a valid checksum. Extended Linear Address (0x04)
+	   records are written as needed if the range extends past 64K.
+	 *
+	 * @param filename `const std::string&` The name of the .hex file to write.
+	 * @param memory `const byte *const` The memory to write from, e.g. `cpu::ram`.
+	 * @param begin `const std::uint32_t` The address of the first byte to write.
+	 * @param length `const std::uint32_t` The number of bytes to write.
+	 * @param options `const hexWriteOptions& = hexWriteOptions()` How to format the file.
+	 * @return `bool` Whether the file was written.
+	 */
+	bool writeIntelHexFile(const std::string& filename, const byte *const memory, const std::uint32_t begin, const std::uint32_t length, const hexWriteOptions& options = hexWriteOptions());
+
+	/**
+	 * @brief Writes a range of memory to a raw binary file.
+	 *
+	 * @param filename `const std::string&` The name of the file to write.
+	 * @param memory `const byte *const` The memory to write from, e.g. `cpu::ram`.
+	 * @param begin `const std::uint32_t` The address of the first byte to write.
+	 * @param length `const std::uint32_t` The number of bytes to write.
+	 * @return `bool` Whether the file was written.
+	 */
+	bool writeBinaryFile(const std::string& filename, const byte *const memory, const std::uint32_t begin, const std::uint32_t length);
+
+	/**
+	 * @brief Allocates 64K of RAM with the contents of a raw binary image
+	   mapped directly onto it at `origin`.
+	 * If `origin` is a multiple of the page size, the file's pages are mapped
+	   copy-on-write instead of being copied, so they are only read from disk
+	   when first touched and writes to RAM never reach the file. Otherwise the
+	   file is copied in. The rest of RAM is zeroed.
+	 * @note The result can be passed to the `cpu` constructor as `ram`.
+	 *
+	 * @param filename `const std::string&` The name of the file to map.
+	 * @param origin `const bytePair = 0` The address in RAM to map the file to.
+	 * @return `byte*` A pointer to 65536 bytes of RAM, or `nullptr` if the file
+	   cannot be opened or does not fit in RAM above `origin`. It must be freed
+	   with `unmapImageFile`.
+	 */
+	byte* mapImageFile(const std::string& filename, const bytePair origin = 0) noexcept;
+
+	/**
+	 * @brief Frees RAM returned by `mapImageFile`.
+	 * @param ram `byte *const` The RAM to free. Nothing happens if this is `nullptr`.
 	 */
-	bool loadIntelHexFile(const std::string& filename, byte *const memory);
+	void unmapImageFile(byte *const ram) noexcept;
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+/**
+ * @file invaders.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs Space Invaders headless, for regression tests against frames
+   recorded earlier.
+   Usage: invaders [--frames N] [--every N] [--input FRAME,PORT,VALUE]... [--pgm FILE] [--cache FILE] [--stats] ROM...
+   The ROM files are loaded in turn from 0x0000 (e.g. invaders.h invaders.g
+   invaders.f invaders.e). The board runs for --frames frames (600 by
+   default, 10 seconds), and the hash of every --every'th frame, and of the
+   last, is printed to stdout as `FRAME HASH`. --input sets input port PORT
+   (0 to 2) to VALUE from the start of frame FRAME on; the numbers may be
+   given in hex with 0x. --pgm saves the last frame as an image. --cache
+   starts with the code translated by an earlier run of the same ROM, if
+   the file has it, and saves the code translated by this one there.
+   --stats reports the frames per second to stderr.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./arcadeboard.hpp"
+
+#include <map>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	const char usage[] = "usage: %s [--frames N] [--every N] [--input FRAME,PORT,VALUE]... [--pgm FILE] [--cache FILE] [--stats] ROM...\n";
+
+	/**
+	 * @brief A change to an input port.
+	 */
+	struct inputChange
+	{
+		int port;
+		byte value;
+	};
+
+	/**
+	 * @brief Parses `FRAME,PORT,VALUE`.
+	 */
+	bool parseInput(const char* text, std::uint64_t& frame, inputChange& change)
+	{
+		char* end;
+
+		frame = std::strtoull(text, &end, 0);
+		if(*end != ',') return false;
+
+		change.port = std::strtol(end + 1, &end, 0);
+		if(*end != ',' or change.port < 0 or change.port > 2) return false;
+
+		const unsigned long value = std::strtoul(end + 1, &end, 0);
+		change.value = value;
+		return *end == '\0' and value <= 0xff;
+	}
+
+	bool savePGM(const std::string& filename, const arcadeBoard& board)
+	{
+		std::vector<byte> pixels(arcadeBoard::width * arcadeBoard::height);
+		board.toGrayscale(pixels.data());
+
+		std::FILE *const f = std::fopen(filename.c_str(), "wb");
+
+		if(not f)
+			return false;
+
+		std::fprintf(f, "P5\n%d %d\n255\n", arcadeBoard::width, arcadeBoard::height);
+		const bool ok = std::fwrite(pixels.data(), 1, pixels.size(), f) == pixels.size();
+		return std::fclose(f) == 0 and ok;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::uint64_t frames = 600;
+	std::uint64_t every = 0;
+	std::multimap<std::uint64_t, inputChange> changes;
+	std::string pgm;
+	std::string cache;
+	bool stats = false;
+	std::vector<std::string> roms;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+
+		if(arg == "--frames" and i + 1 < argc)
+		{
+			frames = std::strtoull(argv[++i], nullptr, 0);
+		}
+		else if(arg == "--every" and i + 1 < argc)
+		{
+			every = std::strtoull(argv[++i], nullptr, 0);
+		}
+		else if(arg == "--input" and i + 1 < argc)
+		{
+			std::uint64_t frame;
+			inputChange change;
+
+			if(not parseInput(argv[++i], frame, change))
+			{
+				std::fprintf(stderr, "invaders: invalid input %s\n", argv[i]);
+				return 2;
+			}
+
+			changes.emplace(frame, change);
+		}
+		else if(arg == "--pgm" and i + 1 < argc)
+		{
+			pgm = argv[++i];
+		}
+		else if(arg == "--cache" and i + 1 < argc)
+		{
+			cache = argv[++i];
+		}
+		else if(arg == "--stats")
+		{
+			stats = true;
+		}
+		else if(arg[0] == '-')
+		{
+			std::fprintf(stderr, usage, argv[0]);
+			return 2;
+		}
+		else
+		{
+			roms.push_back(arg);
+		}
+	}
+
+	if(roms.empty())
+	{
+		std::fprintf(stderr, usage, argv[0]);
+		return 2;
+	}
+
+	arcadeBoard board;
+
+	if(not board.load(roms))
+	{
+		std::fprintf(stderr, "invaders: cannot load the ROM, or it is larger than %u bytes\n", (unsigned)arcadeBoard::romSize);
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const std::size_t cached = cache.empty() ? 0 : board.loadCache(cache);
+	auto next = changes.begin();
+
+	for(std::uint64_t frame = 0; frame < frames; ++frame)
+	{
+		for(; next != changes.end() and next->first <= frame; ++next)
+			board.inputs[next->second.port] = next->second.value;
+
+		board.runFrame();
+
+		if((every and (frame + 1) % every == 0) or frame + 1 == frames)
+			std::printf("%llu %016llx\n", (unsigned long long)frame + 1, (unsigned long long)board.frameHash());
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if(not pgm.empty() and not savePGM(pgm, board))
+	{
+		std::fprintf(stderr, "invaders: cannot write %s\n", pgm.c_str());
+		return 1;
+	}
+
+	if(not cache.empty() and not board.saveCache(cache))
+	{
+		std::fprintf(stderr, "invaders: cannot write %s\n", cache.c_str());
+		return 1;
+	}
+
+	if(stats)
+	{
+		std::fprintf(stderr, "%llu frames in %.3f s (%.0f frames/s, %.0fx real time)\n",
+			(unsigned long long)frames, seconds, frames / seconds, frames / seconds / 60);
+
+		if(not cache.empty())
+			std::fprintf(stderr, "%zu blocks from %s\n", cached, cache.c_str());
+	}
+
+	return 0;
+}
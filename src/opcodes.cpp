@@ -0,0 +1,281 @@
+/**
+ * @file opcodes.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Metadata about each Intel 8080 opcode, shared by tools that need to
+   decode instructions without executing them.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `opcodes.hpp`.
+
+#include "./opcodes.hpp"
+
+using namespace intel8080;
+
+const opcodeInfo intel8080::opcodes[256] =
+{
+//	opcode     length, cycles, mnemonic, operands, flow, flags read, flags written
+	/* 00 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 01 */ {3, 10, "LXI",  operandKind::pair,         operandKind::immediate16,  flowType::next,            flagMask::none,  flagMask::none},
+	/* 02 */ {1,  7, "STAX", operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 03 */ {1,  5, "INX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 04 */ {1,  5, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 05 */ {1,  5, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 06 */ {2,  7, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 07 */ {1,  4, "RLC",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::carry},
+	/* 08 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 09 */ {1, 10, "DAD",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::carry},
+	/* 0a */ {1,  7, "LDAX", operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 0b */ {1,  5, "DCX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 0c */ {1,  5, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 0d */ {1,  5, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 0e */ {2,  7, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 0f */ {1,  4, "RRC",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::carry},
+	/* 10 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 11 */ {3, 10, "LXI",  operandKind::pair,         operandKind::immediate16,  flowType::next,            flagMask::none,  flagMask::none},
+	/* 12 */ {1,  7, "STAX", operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 13 */ {1,  5, "INX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 14 */ {1,  5, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 15 */ {1,  5, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 16 */ {2,  7, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 17 */ {1,  4, "RAL",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::carry, flagMask::carry},
+	/* 18 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 19 */ {1, 10, "DAD",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::carry},
+	/* 1a */ {1,  7, "LDAX", operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 1b */ {1,  5, "DCX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 1c */ {1,  5, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 1d */ {1,  5, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 1e */ {2,  7, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 1f */ {1,  4, "RAR",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::carry, flagMask::carry},
+	/* 20 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 21 */ {3, 10, "LXI",  operandKind::pair,         operandKind::immediate16,  flowType::next,            flagMask::none,  flagMask::none},
+	/* 22 */ {3, 16, "SHLD", operandKind::address,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 23 */ {1,  5, "INX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 24 */ {1,  5, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 25 */ {1,  5, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 26 */ {2,  7, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 27 */ {1,  4, "DAA",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::auxCarry | flagMask::carry, flagMask::all},
+	/* 28 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 29 */ {1, 10, "DAD",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::carry},
+	/* 2a */ {3, 16, "LHLD", operandKind::address,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 2b */ {1,  5, "DCX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 2c */ {1,  5, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 2d */ {1,  5, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 2e */ {2,  7, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 2f */ {1,  4, "CMA",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 30 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 31 */ {3, 10, "LXI",  operandKind::pair,         operandKind::immediate16,  flowType::next,            flagMask::none,  flagMask::none},
+	/* 32 */ {3, 13, "STA",  operandKind::address,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 33 */ {1,  5, "INX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 34 */ {1, 10, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 35 */ {1, 10, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 36 */ {2, 10, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 37 */ {1,  4, "STC",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::carry},
+	/* 38 */ {1,  4, "NOP",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 39 */ {1, 10, "DAD",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::carry},
+	/* 3a */ {3, 13, "LDA",  operandKind::address,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 3b */ {1,  5, "DCX",  operandKind::pair,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* 3c */ {1,  5, "INR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 3d */ {1,  5, "DCR",  operandKind::destination,  operandKind::none,         flowType::next,            flagMask::none,  flagMask::allButCarry},
+	/* 3e */ {2,  7, "MVI",  operandKind::destination,  operandKind::immediate8,   flowType::next,            flagMask::none,  flagMask::none},
+	/* 3f */ {1,  4, "CMC",  operandKind::none,         operandKind::none,         flowType::next,            flagMask::carry, flagMask::carry},
+	/* 40 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 41 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 42 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 43 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 44 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 45 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 46 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 47 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 48 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 49 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 4a */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 4b */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 4c */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 4d */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 4e */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 4f */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 50 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 51 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 52 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 53 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 54 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 55 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 56 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 57 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 58 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 59 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 5a */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 5b */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 5c */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 5d */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 5e */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 5f */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 60 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 61 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 62 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 63 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 64 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 65 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 66 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 67 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 68 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 69 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 6a */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 6b */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 6c */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 6d */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 6e */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 6f */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 70 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 71 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 72 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 73 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 74 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 75 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 76 */ {1,  7, "HLT",  operandKind::none,         operandKind::none,         flowType::halt,            flagMask::none,  flagMask::none},
+	/* 77 */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 78 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 79 */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 7a */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 7b */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 7c */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 7d */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 7e */ {1,  7, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 7f */ {1,  5, "MOV",  operandKind::destination,  operandKind::source,       flowType::next,            flagMask::none,  flagMask::none},
+	/* 80 */ {1,  4, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 81 */ {1,  4, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 82 */ {1,  4, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 83 */ {1,  4, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 84 */ {1,  4, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 85 */ {1,  4, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 86 */ {1,  7, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 87 */ {1,  4, "ADD",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 88 */ {1,  4, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 89 */ {1,  4, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 8a */ {1,  4, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 8b */ {1,  4, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 8c */ {1,  4, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 8d */ {1,  4, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 8e */ {1,  7, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 8f */ {1,  4, "ADC",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 90 */ {1,  4, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 91 */ {1,  4, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 92 */ {1,  4, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 93 */ {1,  4, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 94 */ {1,  4, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 95 */ {1,  4, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 96 */ {1,  7, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 97 */ {1,  4, "SUB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* 98 */ {1,  4, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 99 */ {1,  4, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 9a */ {1,  4, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 9b */ {1,  4, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 9c */ {1,  4, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 9d */ {1,  4, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 9e */ {1,  7, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* 9f */ {1,  4, "SBB",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* a0 */ {1,  4, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a1 */ {1,  4, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a2 */ {1,  4, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a3 */ {1,  4, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a4 */ {1,  4, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a5 */ {1,  4, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a6 */ {1,  7, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a7 */ {1,  4, "ANA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a8 */ {1,  4, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* a9 */ {1,  4, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* aa */ {1,  4, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* ab */ {1,  4, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* ac */ {1,  4, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* ad */ {1,  4, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* ae */ {1,  7, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* af */ {1,  4, "XRA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b0 */ {1,  4, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b1 */ {1,  4, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b2 */ {1,  4, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b3 */ {1,  4, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b4 */ {1,  4, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b5 */ {1,  4, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b6 */ {1,  7, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b7 */ {1,  4, "ORA",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b8 */ {1,  4, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* b9 */ {1,  4, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* ba */ {1,  4, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* bb */ {1,  4, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* bc */ {1,  4, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* bd */ {1,  4, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* be */ {1,  7, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* bf */ {1,  4, "CMP",  operandKind::source,       operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* c0 */ {1,  5, "RNZ",  operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::zero,  flagMask::none},
+	/* c1 */ {1, 10, "POP",  operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* c2 */ {3, 10, "JNZ",  operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::zero,  flagMask::none},
+	/* c3 */ {3, 10, "JMP",  operandKind::address,      operandKind::none,         flowType::jump,            flagMask::none,  flagMask::none},
+	/* c4 */ {3, 11, "CNZ",  operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::zero,  flagMask::none},
+	/* c5 */ {1, 11, "PUSH", operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* c6 */ {2,  7, "ADI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* c7 */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+	/* c8 */ {1,  5, "RZ",   operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::zero,  flagMask::none},
+	/* c9 */ {1, 10, "RET",  operandKind::none,         operandKind::none,         flowType::ret,             flagMask::none,  flagMask::none},
+	/* ca */ {3, 10, "JZ",   operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::zero,  flagMask::none},
+	/* cb */ {3, 10, "JMP",  operandKind::address,      operandKind::none,         flowType::jump,            flagMask::none,  flagMask::none},
+	/* cc */ {3, 11, "CZ",   operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::zero,  flagMask::none},
+	/* cd */ {3, 17, "CALL", operandKind::address,      operandKind::none,         flowType::call,            flagMask::none,  flagMask::none},
+	/* ce */ {2,  7, "ACI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* cf */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+	/* d0 */ {1,  5, "RNC",  operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::carry, flagMask::none},
+	/* d1 */ {1, 10, "POP",  operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* d2 */ {3, 10, "JNC",  operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::carry, flagMask::none},
+	/* d3 */ {2, 10, "OUT",  operandKind::port,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* d4 */ {3, 11, "CNC",  operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::carry, flagMask::none},
+	/* d5 */ {1, 11, "PUSH", operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* d6 */ {2,  7, "SUI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* d7 */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+	/* d8 */ {1,  5, "RC",   operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::carry, flagMask::none},
+	/* d9 */ {1, 10, "RET",  operandKind::none,         operandKind::none,         flowType::ret,             flagMask::none,  flagMask::none},
+	/* da */ {3, 10, "JC",   operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::carry, flagMask::none},
+	/* db */ {2, 10, "IN",   operandKind::port,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* dc */ {3, 11, "CC",   operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::carry, flagMask::none},
+	/* dd */ {3, 17, "CALL", operandKind::address,      operandKind::none,         flowType::call,            flagMask::none,  flagMask::none},
+	/* de */ {2,  7, "SBI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::carry, flagMask::all},
+	/* df */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+	/* e0 */ {1,  5, "RPO",  operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::parity,flagMask::none},
+	/* e1 */ {1, 10, "POP",  operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* e2 */ {3, 10, "JPO",  operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::parity,flagMask::none},
+	/* e3 */ {1, 18, "XTHL", operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* e4 */ {3, 11, "CPO",  operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::parity,flagMask::none},
+	/* e5 */ {1, 11, "PUSH", operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* e6 */ {2,  7, "ANI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* e7 */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+	/* e8 */ {1,  5, "RPE",  operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::parity,flagMask::none},
+	/* e9 */ {1,  5, "PCHL", operandKind::none,         operandKind::none,         flowType::indirectJump,    flagMask::none,  flagMask::none},
+	/* ea */ {3, 10, "JPE",  operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::parity,flagMask::none},
+	/* eb */ {1,  5, "XCHG", operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* ec */ {3, 11, "CPE",  operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::parity,flagMask::none},
+	/* ed */ {3, 17, "CALL", operandKind::address,      operandKind::none,         flowType::call,            flagMask::none,  flagMask::none},
+	/* ee */ {2,  7, "XRI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* ef */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+	/* f0 */ {1,  5, "RP",   operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::sign,  flagMask::none},
+	/* f1 */ {1, 10, "POP",  operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* f2 */ {3, 10, "JP",   operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::sign,  flagMask::none},
+	/* f3 */ {1,  4, "DI",   operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* f4 */ {3, 11, "CP",   operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::sign,  flagMask::none},
+	/* f5 */ {1, 11, "PUSH", operandKind::pairPsw,      operandKind::none,         flowType::next,            flagMask::all,   flagMask::none},
+	/* f6 */ {2,  7, "ORI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* f7 */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+	/* f8 */ {1,  5, "RM",   operandKind::none,         operandKind::none,         flowType::conditionalReturn,flagMask::sign,  flagMask::none},
+	/* f9 */ {1,  5, "SPHL", operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* fa */ {3, 10, "JM",   operandKind::address,      operandKind::none,         flowType::conditionalJump, flagMask::sign,  flagMask::none},
+	/* fb */ {1,  4, "EI",   operandKind::none,         operandKind::none,         flowType::next,            flagMask::none,  flagMask::none},
+	/* fc */ {3, 11, "CM",   operandKind::address,      operandKind::none,         flowType::conditionalCall, flagMask::sign,  flagMask::none},
+	/* fd */ {3, 17, "CALL", operandKind::address,      operandKind::none,         flowType::call,            flagMask::none,  flagMask::none},
+	/* fe */ {2,  7, "CPI",  operandKind::immediate8,   operandKind::none,         flowType::next,            flagMask::none,  flagMask::all},
+	/* ff */ {1, 11, "RST",  operandKind::vector,       operandKind::none,         flowType::restart,         flagMask::none,  flagMask::none},
+};
@@ -0,0 +1,122 @@
+/**
+ * @file opcodes.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Metadata about each Intel 8080 opcode, shared by tools that need to
+   decode instructions without executing them.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+namespace intel8080
+{
+	/**
+	 * @brief What an operand of an instruction is. Registers are encoded in
+	   the opcode; the other kinds follow it in memory.
+	 */
+	enum class operandKind : byte
+	{
+		none,
+		destination,	// An 8-bit register (B, C, D, E, H, L, M or A) in bits 3-5 of the opcode.
+		source,			// An 8-bit register in bits 0-2 of the opcode.
+		pair,			// A register pair (B, D, H or SP) in bits 4-5 of the opcode.
+		pairPsw,		// A register pair (B, D, H or PSW) in bits 4-5 of the opcode.
+		immediate8,		// The byte after the opcode.
+		immediate16,	// The 2 bytes after the opcode.
+		address,		// The 2 bytes after the opcode, used as a memory or jump address.
+		port,			// The byte after the opcode, used as a port number.
+		vector			// A restart number (0-7) in bits 3-5 of the opcode.
+	};
+
+	/**
+	 * @brief How an instruction affects the program counter.
+	 */
+	enum class flowType : byte
+	{
+		next,				// Continues to the next instruction.
+		jump,				// Jumps to its address operand.
+		conditionalJump,	// Jumps to its address operand or continues.
+		call,				// Calls its address operand.
+		conditionalCall,	// Calls its address operand or continues.
+		restart,			// Calls 8 times its vector operand.
+		indirectJump,		// Jumps to the address in HL (`pchl`).
+		ret,				// Returns to the address on the stack.
+		conditionalReturn,	// Returns to the address on the stack or continues.
+		halt				// Stops until an interrupt.
+	};
+
+	/**
+	 * @brief Masks of the flags within the flags register.
+	 */
+	namespace flagMask
+	{
+		constexpr byte none = 0;
+		constexpr byte sign = 1 << flagPos::sign;
+		constexpr byte zero = 1 << flagPos::zero;
+		constexpr byte auxCarry = 1 << flagPos::auxCarry;
+		constexpr byte parity = 1 << flagPos::parity;
+		constexpr byte carry = 1 << flagPos::carry;
+		constexpr byte allButCarry = sign | zero | auxCarry | parity;
+		constexpr byte all = allButCarry | carry;
+	}
+
+	/**
+	 * @brief Static information about an opcode.
+	 */
+	struct opcodeInfo
+	{
+		/**
+		 * @brief The length of the instruction in bytes, including operands.
+		 */
+		byte length;
+
+		/**
+		 * @brief The number of clock cycles (states) the instruction takes.
+		 * For conditional calls and returns, this is the number taken if the
+		   condition is false; if it is true, the instruction takes 6 more.
+		 */
+		byte cycles;
+
+		/**
+		 * @brief The mnemonic in upper case, e.g. `MOV`.
+		 */
+		char mnemonic[5];
+
+		/**
+		 * @brief The operands, in the order they are written in assembly.
+		 */
+		operandKind first, second;
+
+		/**
+		 * @brief How the instruction affects the program counter.
+		 */
+		flowType flow;
+
+		/**
+		 * @brief The flags (`flagMask`) the instruction depends on. `push psw`
+		   reads all of them.
+		 */
+		byte flagsRead;
+
+		/**
+		 * @brief The flags (`flagMask`) the instruction replaces.
+		 */
+		byte flagsWritten;
+	};
+
+	/**
+	 * @brief Information about every opcode, indexed by opcode.
+	 * @note Undocumented opcodes are described as the documented instructions
+	   they behave like, as in `cpu::exec`.
+	 */
+	extern const opcodeInfo opcodes[256];
+}
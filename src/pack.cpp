@@ -0,0 +1,75 @@
+/**
+ * @file pack.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Packs .hex, .bin and .com files into a bundle file.
+   Usage: pack OUTPUT INPUT[@ORIGIN]...
+   The origin of a .hex file comes from its records, that of a .com file is
+   always 0x0100, and that of any other file defaults to 0x0000. ORIGIN, in
+   hex, can only be given for the last. Every image is named after its file,
+   and names must be unique.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./bundle.hpp"
+#include "./image.hpp"
+
+#include <cstdio>
+
+using namespace intel8080;
+
+namespace
+{
+	bool readImage(const std::string& arg, bundleImage& image)
+	{
+		std::vector<byte> memory(0x10000);
+		imageInfo info;
+		std::string error;
+
+		if(not loadImageArgument(arg, memory.data(), info, error))
+		{
+			std::fprintf(stderr, "pack: %s\n", error.c_str());
+			return false;
+		}
+
+		const std::size_t slash = info.filename.rfind('/');
+		image.name = slash == std::string::npos ? info.filename : info.filename.substr(slash + 1);
+		image.origin = info.begin;
+		image.start = info.start;
+		image.data.assign(memory.begin() + info.begin, memory.begin() + info.begin + info.length);
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 3)
+	{
+		std::fprintf(stderr, "usage: %s OUTPUT INPUT[@ORIGIN]...\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<bundleImage> images(argc - 2);
+
+	for(int i = 2; i < argc; ++i)
+	{
+		if(not readImage(argv[i], images[i - 2]))
+			return 1;
+	}
+
+	std::string error;
+
+	if(not writeBundle(argv[1], std::move(images), error))
+	{
+		std::fprintf(stderr, "pack: %s\n", error.c_str());
+		return 1;
+	}
+
+	return 0;
+}
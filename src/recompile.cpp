@@ -0,0 +1,149 @@
+/**
+ * @file recompile.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Translates a .hex, .com or raw binary file into C++ source that runs
+   it natively, for programs that are run many times.
+   Usage: recompile INPUT[@ORIGIN] OUTPUT.cpp [--name NAME] [--entry ADDR]...
+                    [--vectors MASK] [--trap ADDR]... [--trace STEPS]
+   The code reachable from the entry points (by default the start address of
+   the file) and the interrupt vectors in MASK (bit n for rst n) is translated
+   into a function NAME (default recompiledProgram), which is run with
+   `intel8080::runRecompiled` from `recompiled.hpp`. Control reaching a --trap
+   address returns to the caller; for .com files, 0x0000 and the BDOS entry
+   point 0x0005 are always traps.
+   Code that is only reached through computed return addresses cannot be
+   found statically. With --trace, a .com program is first run for up to STEPS
+   instructions in `intel8080::cpm`, and every address control is transferred
+   to is added as an entry point.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./recompiler.hpp"
+#include "./image.hpp"
+#include "./cpm.hpp"
+#include "./disassembler.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief Runs a .com program and collects the addresses that control is
+	   transferred to, other than by falling through to the next instruction.
+	 */
+	std::vector<bytePair> traceBranchTargets(const std::string& filename, const std::uint64_t steps)
+	{
+		cpm system;
+		system.consoleOutput = [](const char*, const std::size_t){};
+		system.consoleInput = [](){ return EOF; };
+
+		std::vector<bool> seen(0x10000);
+		std::vector<bytePair> targets;
+
+		if(not system.loadComFile(filename))
+			return targets;
+
+		bytePair next = system.machine.PC;
+
+		for(std::uint64_t i = 0; i < steps and system.step(); ++i)
+		{
+			const bytePair pc = system.machine.PC;
+
+			if(pc != next and pc < cpm::bdosBase and not seen[pc])
+			{
+				seen[pc] = true;
+				targets.push_back(pc);
+			}
+
+			next = pc + decodeInstruction(system.memory.data(), pc).length;
+		}
+
+		return targets;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 3)
+	{
+		std::fprintf(stderr,
+			"usage: %s INPUT[@ORIGIN] OUTPUT.cpp [--name NAME] [--entry ADDR]...\n"
+			"       [--vectors MASK] [--trap ADDR]... [--trace STEPS]\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<byte> memory(0x10000);
+	imageInfo image;
+	std::string error;
+
+	if(not loadImageArgument(argv[1], memory.data(), image, error))
+	{
+		std::fprintf(stderr, "recompile: %s\n", error.c_str());
+		return 1;
+	}
+
+	recompileOptions options;
+	cfgOptions analysis;
+	std::vector<bytePair> entryPoints;
+	std::uint64_t traceSteps = 0;
+
+	options.source = image.filename;
+	if(image.com) options.traps = {0x0000, 0x0005};
+
+	for(int i = 3; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+
+		if(arg == "--name" and i + 1 < argc) options.functionName = argv[++i];
+		else if(arg == "--entry" and i + 1 < argc) entryPoints.push_back(std::strtoul(argv[++i], nullptr, 16));
+		else if(arg == "--vectors" and i + 1 < argc) analysis.interruptVectors = std::strtoul(argv[++i], nullptr, 16);
+		else if(arg == "--trap" and i + 1 < argc) options.traps.push_back(std::strtoul(argv[++i], nullptr, 16));
+		else if(arg == "--trace" and i + 1 < argc) traceSteps = std::strtoull(argv[++i], nullptr, 10);
+		else
+		{
+			std::fprintf(stderr, "recompile: unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	if(entryPoints.empty()) entryPoints.push_back(image.start);
+
+	if(traceSteps)
+	{
+		if(not image.com)
+		{
+			std::fprintf(stderr, "recompile: --trace is only supported for .com files\n");
+			return 2;
+		}
+
+		for(const bytePair target : traceBranchTargets(image.filename, traceSteps))
+			entryPoints.push_back(target);
+	}
+
+	const controlFlowGraph graph = recoverControlFlow(memory.data(), entryPoints, analysis);
+	const std::string source = recompileToCpp(memory.data(), graph, options);
+
+	std::FILE *const file = std::fopen(argv[2], "w");
+
+	if(not file or std::fwrite(source.data(), 1, source.size(), file) != source.size())
+	{
+		std::fprintf(stderr, "recompile: cannot write %s\n", argv[2]);
+		if(file) std::fclose(file);
+		return 1;
+	}
+
+	std::fclose(file);
+	return 0;
+}
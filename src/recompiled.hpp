@@ -0,0 +1,277 @@
+/**
+ * @file recompiled.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Support code for C++ generated by `recompile`: the flag helpers the
+   generated code calls, which can skip flags that are never used, and a
+   loop that runs generated code with the interpreter as a fallback.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+#include "./opcodes.hpp"
+
+#include <cstring>
+
+namespace intel8080
+{
+	/**
+	 * @brief A program generated by `recompile`.
+	 * Runs translated blocks on `machine`, starting at its program counter,
+	   until at least `budget` instructions have run (checked between
+	   blocks) or control reaches code that was not translated, was modified
+	   since translation, or must be interpreted (`ei`, `di`, `hlt`). Returns
+	   the number of instructions run, which is 0 if the block at the program
+	   counter cannot be run.
+	 * The program also returns after `in` and `out`, whose handlers see the
+	   registers, program counter and cycles of `machine` as `cpu::step`
+	   would leave them; after a store that changes code still to run in its
+	   block; and at a backward branch, `ret` or `pchl` if an interrupt can
+	   be serviced. The pages it stores to are marked in
+	   `recompiled::pagesWritten`.
+	 */
+	using recompiledProgram = std::uint64_t (*)(cpu& machine, std::uint64_t budget);
+
+	/**
+	 * @brief Runs `program`, interpreting one instruction whenever it cannot
+	   run, until at least `maxInstructions` instructions have run or the
+	   CPU halts. Pending interrupts are serviced whenever the program
+	   returns, as `cpu::step` would.
+	 *
+	 * @param machine `cpu&` The CPU.
+	 * @param program `recompiledProgram` The generated code.
+	 * @param maxInstructions `std::uint64_t` The number of instructions to run.
+	 * @return `std::uint64_t` The number of instructions run.
+	 */
+	inline std::uint64_t runRecompiled(cpu& machine, const recompiledProgram program, const std::uint64_t maxInstructions)
+	{
+		std::uint64_t executed = 0;
+
+		while(executed < maxInstructions)
+		{
+			if(machine.getInterruptsEnabled() and machine.getInterruptPending())
+			{
+				machine.step();
+				++executed;
+				continue;
+			}
+
+			if(machine.getHalted())
+				break;
+
+			const std::uint64_t n = program(machine, maxInstructions - executed);
+
+			if(n == 0)
+			{
+				machine.step();
+				++executed;
+			}
+			else
+			{
+				executed += n;
+			}
+		}
+
+		return executed;
+	}
+
+	/**
+	 * @brief Inline equivalents of the ALU helpers of `cpu`, operating on
+	   separate accumulator and flags variables so that generated code can
+	   keep them in registers. `blockEngine`'s handlers use them too.
+	 */
+	namespace recompiled
+	{
+		/**
+		 * @brief The sign, zero and parity flags of every byte, with the
+		   always-set bit 1.
+		 */
+		struct szpTable
+		{
+			byte flags[256];
+
+			constexpr szpTable() : flags()
+			{
+				for(int i = 0; i < 256; ++i)
+				{
+					int bits = 0;
+					for(int b = i; b; b >>= 1) bits += b & 1;
+
+					flags[i] = (i & 0x80) | (i == 0) << 6 | (bits % 2 == 0) << 2 | 0x02;
+				}
+			}
+		};
+
+		inline constexpr szpTable szp{};
+
+		inline bytePair read16(const byte* ram, const bytePair adr) noexcept
+		{
+			return ram[adr] | ram[(bytePair)(adr + 1)] << 8;
+		}
+
+		inline void write16(byte* ram, const bytePair adr, const bytePair value) noexcept
+		{
+			ram[adr] = value;
+			ram[(bytePair)(adr + 1)] = value >> 8;
+		}
+
+		/**
+		 * @brief The 256-byte pages generated code has stored to since they
+		   were last cleared, so that code translated elsewhere (by
+		   `tieredEngine`'s `blockEngine`) is only checked where it may have
+		   changed. Set by `stored`, and cleared by whoever checks them.
+		 */
+		inline thread_local byte pagesWritten[0x100];
+
+		/**
+		 * @brief Marks the pages of a store of `length` bytes at `adr` in
+		   `pagesWritten`.
+		 */
+		inline void stored(const bytePair adr, const unsigned length) noexcept
+		{
+			pagesWritten[adr >> 8] = 1;
+			pagesWritten[(bytePair)(adr + length - 1) >> 8] = 1;
+		}
+
+		/**
+		 * @brief Whether a store of `length` bytes at `adr` changed any of
+		   the `size` bytes from `begin`, allowing for wrapping around to 0.
+		 */
+		inline bool overlaps(const bytePair adr, const unsigned length, const bytePair begin, const unsigned size) noexcept
+		{
+			return (bytePair)(adr - begin) < size or (length == 2 and (bytePair)(adr + 1 - begin) < size);
+		}
+
+		/**
+		 * @brief The sign, zero and parity flags of `result` that are in
+		   `used`. Without parity, the table is not needed.
+		 */
+		template<byte used>
+		inline byte szpFlags(const byte result) noexcept
+		{
+			if(used & flagMask::parity) return szp.flags[result] & used;
+
+			return (used & flagMask::sign ? result & 0x80 : 0) | (used & flagMask::zero ? (result == 0) << 6 : 0);
+		}
+
+		/**
+		 * @brief Replaces the flags in `used` with `flags`. The others are
+		   left as they were, since they are written again before they are
+		   read, and so are the unused bits, as `cpu::setFlag` leaves them.
+		 */
+		template<byte used>
+		inline byte merge(const byte F, const byte flags) noexcept
+		{
+			return (F & ~used) | flags;
+		}
+
+		// Each helper below only computes the flags in `used`; see `findUsedFlags`
+
+		template<byte used = flagMask::all>
+		inline void add(byte& A, byte& F, const byte value, const unsigned carry) noexcept
+		{
+			const unsigned sum = A + value + carry;
+			byte flags = szpFlags<used>(sum);
+
+			if(used & flagMask::auxCarry) flags |= ((A & 0xf) + (value & 0xf) + carry) & 0x10;
+			if(used & flagMask::carry) flags |= sum >> 8;
+
+			F = merge<used>(F, flags);
+			A = sum;
+		}
+
+		/**
+		 * @brief Subtracts as the 8080 does, by adding the complement.
+		 * @return `byte` The difference; `A` is not changed, for `cmp`.
+		 */
+		template<byte used = flagMask::all>
+		inline byte sub(const byte A, byte& F, const byte value, const unsigned borrow) noexcept
+		{
+			const byte complement = ~value;
+			const unsigned sum = A + complement + (borrow ^ 1);
+			byte flags = szpFlags<used>(sum);
+
+			if(used & flagMask::auxCarry) flags |= ((A & 0xf) + (complement & 0xf) + (borrow ^ 1)) & 0x10;
+			if(used & flagMask::carry) flags |= ~sum >> 8 & 1;
+
+			F = merge<used>(F, flags);
+			return sum;
+		}
+
+		template<byte used = flagMask::all>
+		inline void ana(byte& A, byte& F, const byte value) noexcept
+		{
+			byte flags = szpFlags<used>(A & value);
+			if(used & flagMask::auxCarry) flags |= ((A | value) & 0x08) << 1;
+
+			F = merge<used>(F, flags);
+			A &= value;
+		}
+
+		template<byte used = flagMask::all>
+		inline void xra(byte& A, byte& F, const byte value) noexcept
+		{
+			A ^= value;
+			F = merge<used>(F, szpFlags<used>(A));
+		}
+
+		template<byte used = flagMask::all>
+		inline void ora(byte& A, byte& F, const byte value) noexcept
+		{
+			A |= value;
+			F = merge<used>(F, szpFlags<used>(A));
+		}
+
+		template<byte used = flagMask::all>
+		inline byte inr(byte& F, const byte value) noexcept
+		{
+			constexpr byte written = used & flagMask::allButCarry;
+			const byte result = value + 1;
+			byte flags = szpFlags<written>(result);
+
+			if(written & flagMask::auxCarry) flags |= ((result & 0xf) == 0) << 4;
+
+			F = merge<written>(F, flags);
+			return result;
+		}
+
+		template<byte used = flagMask::all>
+		inline byte dcr(byte& F, const byte value) noexcept
+		{
+			constexpr byte written = used & flagMask::allButCarry;
+			const byte result = value - 1;
+			byte flags = szpFlags<written>(result);
+
+			if(written & flagMask::auxCarry) flags |= ((result & 0xf) != 0xf) << 4;
+
+			F = merge<written>(F, flags);
+			return result;
+		}
+
+		inline void daa(byte& A, byte& F) noexcept
+		{
+			const byte low = A & 0xf, high = A >> 4;
+			byte correction = 0;
+			unsigned carry = F & 0x01;
+
+			if((F & 0x10) or low > 9) correction += 0x06;
+
+			if(carry or high > 9 or (high >= 9 and low > 9))
+			{
+				correction += 0x60;
+				carry = 1;
+			}
+
+			add(A, F, correction, 0);
+			F = (F & ~0x01) | carry;
+		}
+	}
+}
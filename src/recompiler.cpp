@@ -0,0 +1,708 @@
+/**
+ * @file recompiler.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Translates the basic blocks of an Intel 8080 memory image into C++
+   source that runs them on an `intel8080::cpu`.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `recompiler.hpp`.
+
+#include "./recompiler.hpp"
+#include "./opcodes.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+using namespace intel8080;
+
+namespace
+{
+	// Expressions for the 8-bit registers, indexed by their encoding
+	const char *const registers[8] = {"B", "C", "D", "E", "H", "L", "ram[H << 8 | L]", "A"};
+
+	// The high and low registers of each pair, indexed by their encoding;
+	// SP is handled separately
+	const char *const pairHigh[3] = {"B", "D", "H"};
+	const char *const pairLow[3] = {"C", "E", "L"};
+
+	// Expressions for the conditions, indexed by their encoding
+	const char *const conditions[8] = {
+		"not (F & 0x40)", "F & 0x40", "not (F & 0x01)", "F & 0x01",
+		"not (F & 0x04)", "F & 0x04", "not (F & 0x80)", "F & 0x80"
+	};
+
+	/**
+	 * @brief A run of instructions in a block that can be translated, ending
+	   either at the end of the block or before an instruction the
+	   interpreter must run.
+	 */
+	struct segment
+	{
+		const basicBlock* block;
+		std::uint32_t firstInstruction, instructionCount;
+		bytePair begin;
+		std::uint32_t size;
+		bool endsBlock;
+	};
+
+	/**
+	 * @brief Accumulates the generated source.
+	 */
+	class generator
+	{
+	public:
+		std::string out;
+
+		generator(const byte* memory, const controlFlowGraph& graph, const recompileOptions& options)
+		:
+			memory(memory), graph(graph), options(options), translated(0x10000)
+		{
+			for(const auto& block : graph.blocks)
+			{
+				if(std::find(options.traps.begin(), options.traps.end(), block.begin) != options.traps.end())
+					continue;
+
+				// Blocks that wrap around the end of memory are left to the interpreter
+				if(block.begin + block.size > 0x10000)
+					continue;
+
+				// Split the block around instructions the interpreter must run,
+				// so that translated code resumes after them
+				segment current = {&block, block.firstInstruction, 0, block.begin, 0, false};
+
+				for(std::uint32_t i = 0; i < block.instructionCount; ++i)
+				{
+					const instruction& instr = graph.instructions[block.firstInstruction + i];
+
+					if(interpreted(instr.opcode))
+					{
+						addSegment(current);
+						current = {&block, block.firstInstruction + i + 1, 0, (bytePair)(instr.address + instr.length), 0, false};
+						continue;
+					}
+
+					++current.instructionCount;
+					current.size += instr.length;
+
+					// Port handlers see the state of the machine and may request
+					// an interrupt, so the program returns after them
+					if(isPort(instr.opcode))
+					{
+						addSegment(current);
+						current = {&block, block.firstInstruction + i + 1, 0, (bytePair)(instr.address + instr.length), 0, false};
+					}
+				}
+
+				current.endsBlock = true;
+				addSegment(current);
+			}
+		}
+
+		void generate(void)
+		{
+			line("// Generated by recompile%s%s. Do not edit.", options.source.empty() ? "" : " from ", options.source.c_str());
+			blank();
+			line("#include \"recompiled.hpp\"");
+			blank();
+			line("namespace");
+			line("{");
+			line("\tusing namespace intel8080;");
+			line("\tusing namespace intel8080::recompiled;");
+			blank();
+			line("\t// The bytes each block was translated from, to detect modified code");
+			line("\tconst byte original[] =");
+			line("\t{");
+
+			for(const segment& seg : segments)
+			{
+				std::string bytes = "\t\t";
+				for(std::uint32_t i = 0; i < seg.size; ++i)
+				{
+					char text[8];
+					std::snprintf(text, sizeof text, "0x%02x, ", memory[seg.begin + i]);
+					bytes += text;
+				}
+				bytes.pop_back();
+				out += bytes + "\n";
+			}
+
+			if(segments.empty()) line("\t\t0");
+
+			line("\t};");
+			line("}");
+			blank();
+			line("std::uint64_t %s(intel8080::cpu& machine, const std::uint64_t budget)", options.functionName.c_str());
+			line("{");
+			line("\tbyte *const ram = machine.ram;");
+			line("\tbyte A = machine.A(), F = machine.flags();");
+			line("\tbyte B = machine.B(), C = machine.C(), D = machine.D(), E = machine.E(), H = machine.H(), L = machine.L();");
+			line("\tbytePair SP = machine.SP, PC = machine.PC;");
+			line("\tstd::uint64_t cycles = machine.cycles, executed = 0;");
+			blank();
+			line("\t// `ei` and `di` are interpreted, so this holds until the program returns");
+			line("\tconst bool interruptible = machine.getInterruptsEnabled();");
+			blank();
+
+			// The blocks are generated first, to know whether any of them
+			// continues through the switch
+			const std::string prologue = std::move(out);
+			out.clear();
+
+			std::size_t offset = 0;
+			for(const segment& seg : segments)
+			{
+				generateSegment(seg, offset);
+				offset += seg.size;
+			}
+
+			const std::string blocks = std::move(out);
+			out = prologue;
+
+			if(dispatched) line("dispatch:");
+			line("\tswitch(PC)");
+			line("\t{");
+			for(const segment& seg : segments)
+				line("\t\tcase 0x%04x: goto block_%04x;", seg.begin, seg.begin);
+			line("\t\tdefault: goto leave;");
+			line("\t}");
+			out += blocks;
+
+			blank();
+			line("leave:");
+			saveState();
+			line("\treturn executed;");
+			line("}");
+		}
+
+	private:
+		const byte* memory;
+		const controlFlowGraph& graph;
+		const recompileOptions& options;
+
+		std::vector<bool> translated;
+		std::vector<segment> segments;
+
+		/**
+		 * @brief Whether any block continues through the dispatch switch.
+		 */
+		bool dispatched = false;
+
+		void addSegment(const segment& seg)
+		{
+			// Segments that only end a block ending in an interpreted instruction are empty
+			if(seg.instructionCount == 0 or translated[seg.begin])
+				return;
+
+			translated[seg.begin] = true;
+			segments.push_back(seg);
+		}
+
+		/**
+		 * @return `bool` Whether the instruction changes state that generated
+		   code does not have access to, so must be run by the interpreter.
+		 */
+		static bool interpreted(const byte opcode) noexcept
+		{
+			return opcode == 0xf3 or opcode == 0xfb or opcode == 0x76;
+		}
+
+		static bool isPort(const byte opcode) noexcept
+		{
+			return opcode == 0xd3 or opcode == 0xdb;
+		}
+
+		/**
+		 * @param instr `const instruction&` An instruction.
+		 * @param length `unsigned&` Set to the number of bytes stored.
+		 * @return `const char*` An expression for the address `instr`
+		   stores to, as it is after the store, or `nullptr` if it does not
+		   store or ends its block (calls and `rst`).
+		 */
+		static const char* storeAddress(const instruction& instr, unsigned& length)
+		{
+			static char address[8];
+			const byte op = instr.opcode;
+			length = 1;
+
+			if((op >> 3 == 0x0e and op != 0x76) or op == 0x34 or op == 0x35 or op == 0x36) return "H << 8 | L";
+			if(op == 0x02) return "B << 8 | C";
+			if(op == 0x12) return "D << 8 | E";
+
+			if(op == 0x22 or op == 0x32)
+			{
+				length = op == 0x22 ? 2 : 1;
+				std::snprintf(address, sizeof address, "0x%04x", instr.operand);
+				return address;
+			}
+
+			length = 2;
+			if((op & 0xcf) == 0xc5 or op == 0xe3) return "SP";
+
+			return nullptr;
+		}
+
+		/**
+		 * @brief Writes the local copies of the registers back to `machine`.
+		 */
+		void saveState(const char* indent = "\t")
+		{
+			line("%smachine.A() = A; machine.flags() = F;", indent);
+			line("%smachine.B() = B; machine.C() = C; machine.D() = D; machine.E() = E; machine.H() = H; machine.L() = L;", indent);
+			line("%smachine.SP = SP; machine.PC = PC; machine.cycles = cycles;", indent);
+		}
+
+		/**
+		 * @brief Reloads the local copies of the registers from `machine`.
+		 */
+		void loadState(const char* indent = "\t")
+		{
+			line("%sA = machine.A(); F = machine.flags();", indent);
+			line("%sB = machine.B(); C = machine.C(); D = machine.D(); E = machine.E(); H = machine.H(); L = machine.L();", indent);
+			line("%sSP = machine.SP; PC = machine.PC; cycles = machine.cycles;", indent);
+		}
+
+		void blank(void)
+		{
+			out += '\n';
+		}
+
+		void line(const char* format, ...) __attribute__((format(printf, 2, 3)))
+		{
+			char text[256];
+			va_list args;
+			va_start(args, format);
+			std::vsnprintf(text, sizeof text, format, args);
+			va_end(args);
+
+			out += text;
+			out += '\n';
+		}
+
+		/**
+		 * @brief Continues from `from` at `target`: directly if it was
+		   translated and the budget allows, otherwise by returning. A
+		   backward branch, which may close a loop, also returns if an
+		   interrupt can be serviced.
+		 */
+		void transfer(const char* indent, const bytePair from, const bytePair target)
+		{
+			line("%sPC = 0x%04x;", indent, target);
+
+			if(translated[target] and target > from)
+			{
+				line("%sif(executed < budget) goto block_%04x;", indent, target);
+			}
+			else if(translated[target])
+			{
+				line("%sif(executed < budget and not (interruptible and machine.getInterruptPending())) goto block_%04x;", indent, target);
+			}
+
+			line("%sgoto leave;", indent);
+		}
+
+		/**
+		 * @brief Continues at the program counter, through the dispatch
+		   switch, unless an interrupt can be serviced.
+		 */
+		void transferIndirect(const char* indent)
+		{
+			line("%sif(executed < budget and not (interruptible and machine.getInterruptPending())) goto dispatch;", indent);
+			dispatched = true;
+			line("%sgoto leave;", indent);
+		}
+
+		void generateSegment(const segment& seg, const std::size_t offset)
+		{
+			std::uint64_t cycles = 0;
+			for(std::uint32_t i = 0; i < seg.instructionCount; ++i)
+				cycles += opcodes[graph.instructions[seg.firstInstruction + i].opcode].cycles;
+
+			blank();
+			line("block_%04x:", seg.begin);
+			line("\tif(std::memcmp(ram + 0x%04x, original + %zu, %u) != 0) goto leave;", seg.begin, offset, seg.size);
+			line("\texecuted += %u;", seg.instructionCount);
+			line("\tcycles += %llu;", (unsigned long long)cycles);
+
+			const instruction *const instructions = &graph.instructions[seg.firstInstruction];
+			const std::uint32_t end = seg.begin + seg.size;
+
+			// Every flag is exact whenever control can leave generated code:
+			// at the end of a segment, and after a store that may have
+			// changed the rest of it
+			std::vector<byte> used(seg.instructionCount);
+
+			for(std::uint32_t first = 0, i = 0; i < seg.instructionCount; ++i)
+			{
+				unsigned length;
+
+				if(storeAddress(instructions[i], length) or i + 1 == seg.instructionCount)
+				{
+					findUsedFlags(instructions + first, i + 1 - first, used.data() + first);
+					first = i + 1;
+				}
+			}
+
+			for(std::uint32_t i = 0; i < seg.instructionCount; ++i)
+			{
+				const instruction& instr = instructions[i];
+
+				if(seg.endsBlock and i + 1 == seg.instructionCount) generateExit(instr, used[i]);
+				else generateInstruction(instr, used[i]);
+
+				unsigned length;
+				const char *const address = storeAddress(instr, length);
+
+				if(address)
+					line("\tstored(%s, %u);", address, length);
+
+				// The instructions after a store that changes them are left to
+				// the interpreter, after taking back their count and cycles
+				const bytePair next = instr.address + instr.length;
+
+				// A fixed address is checked here instead
+				const bool fixed = instr.opcode == 0x22 or instr.opcode == 0x32;
+				const bool mayOverlap = not fixed or (bytePair)(instr.operand - next) < end - next
+					or (length == 2 and (bytePair)(instr.operand + 1 - next) < end - next);
+
+				if(address and i + 1 < seg.instructionCount and mayOverlap)
+				{
+					std::uint64_t cyclesAfter = 0;
+					for(std::uint32_t j = i + 1; j < seg.instructionCount; ++j)
+						cyclesAfter += opcodes[instructions[j].opcode].cycles;
+
+					line("\tif(overlaps(%s, %u, 0x%04x, %u))", address, length, next, end - next);
+					line("\t{");
+					line("\t\texecuted -= %u;", seg.instructionCount - i - 1);
+					line("\t\tcycles -= %llu;", (unsigned long long)cyclesAfter);
+					line("\t\tPC = 0x%04x;", next);
+					line("\t\tgoto leave;");
+					line("\t}");
+				}
+			}
+
+			// Stopped before an instruction the interpreter must run, or after
+			// a port handler, which has already set the program counter
+			if(not seg.endsBlock and not isPort(instructions[seg.instructionCount - 1].opcode))
+			{
+				line("\tPC = 0x%04x;", (bytePair)end);
+				line("\tgoto leave;");
+			}
+			else if(not seg.endsBlock)
+			{
+				line("\tgoto leave;");
+			}
+		}
+
+		/**
+		 * @brief The template arguments of a flag helper that only computes
+		   the flags in `used`: none when it computes them all.
+		 */
+		static std::string onlyFlags(const byte used)
+		{
+			if(used == flagMask::all) return "";
+
+			char text[8];
+			std::snprintf(text, sizeof text, "<0x%02x>", used);
+			return text;
+		}
+
+		/**
+		 * @brief Generates an instruction that continues to the next one,
+		   computing only the flags in `used`.
+		 */
+		void generateInstruction(const instruction& instr, const byte used)
+		{
+			const byte op = instr.opcode;
+			const int ddd = op >> 3 & 7;
+			const int sss = op & 7;
+			const int rp = op >> 4 & 3;
+			const unsigned n = instr.operand;
+
+			switch(op >> 6)
+			{
+				// MOV
+				case 1:
+					line("\t%s = %s;", registers[ddd], registers[sss]);
+					return;
+
+				// ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP
+				case 2:
+					generateAlu(ddd, registers[sss], used);
+					return;
+
+				case 0:
+					switch(sss)
+					{
+						// NOP
+						case 0:
+							return;
+
+						// LXI, DAD
+						case 1:
+							if(op & 0x08)
+							{
+								if(used) line("\t{ const unsigned t = (H << 8 | L) + %s; F = (F & 0xfe) | t >> 16; H = t >> 8; L = t; }", pair(rp).c_str());
+								else line("\t{ const bytePair t = (H << 8 | L) + %s; H = t >> 8; L = t; }", pair(rp).c_str());
+							}
+							else if(rp == 3)
+							{
+								line("\tSP = 0x%04x;", n);
+							}
+							else
+							{
+								line("\t%s = 0x%02x; %s = 0x%02x;", pairHigh[rp], n >> 8, pairLow[rp], n & 0xff);
+							}
+							return;
+
+						case 2:
+							switch(ddd)
+							{
+								case 0: line("\tram[B << 8 | C] = A;"); return;
+								case 1: line("\tA = ram[B << 8 | C];"); return;
+								case 2: line("\tram[D << 8 | E] = A;"); return;
+								case 3: line("\tA = ram[D << 8 | E];"); return;
+								case 4: line("\twrite16(ram, 0x%04x, H << 8 | L);", n); return;
+								case 5: line("\t{ const bytePair t = read16(ram, 0x%04x); H = t >> 8; L = t; }", n); return;
+								case 6: line("\tram[0x%04x] = A;", n); return;
+								default: line("\tA = ram[0x%04x];", n); return;
+							}
+
+						// INX, DCX
+						case 3:
+						{
+							const char *const delta = op & 0x08 ? "- 1" : "+ 1";
+
+							if(rp == 3) line("\tSP = SP %s;", delta);
+							else line("\t{ const bytePair t = (%s << 8 | %s) %s; %s = t >> 8; %s = t; }",
+								pairHigh[rp], pairLow[rp], delta, pairHigh[rp], pairLow[rp]);
+							return;
+						}
+
+						// INR, DCR
+						case 4:
+						case 5:
+							if(used) line("\t%s = %s%s(F, %s);", registers[ddd], sss == 4 ? "inr" : "dcr", onlyFlags(used | flagMask::carry).c_str(), registers[ddd]);
+							else line("\t%s = %s %s 1;", registers[ddd], registers[ddd], sss == 4 ? "+" : "-");
+							return;
+
+						// MVI
+						case 6:
+							line("\t%s = 0x%02x;", registers[ddd], n);
+							return;
+
+						default:
+							// Rotates, STC and CMC whose carry is overwritten
+							if(ddd != 4 and ddd != 5 and not used)
+							{
+								switch(ddd)
+								{
+									case 0: line("\tA = A << 1 | A >> 7;"); return;
+									case 1: line("\tA = A >> 1 | A << 7;"); return;
+									case 2: line("\tA = A << 1 | (F & 1);"); return;
+									case 3: line("\tA = A >> 1 | F << 7;"); return;
+									default: return;
+								}
+							}
+
+							switch(ddd)
+							{
+								case 0: line("\tF = (F & 0xfe) | A >> 7; A = A << 1 | A >> 7;"); return;
+								case 1: line("\tF = (F & 0xfe) | (A & 1); A = A >> 1 | A << 7;"); return;
+								case 2: line("\t{ const byte c = F & 1; F = (F & 0xfe) | A >> 7; A = A << 1 | c; }"); return;
+								case 3: line("\t{ const byte c = F & 1; F = (F & 0xfe) | (A & 1); A = A >> 1 | c << 7; }"); return;
+								case 4: line("\tdaa(A, F);"); return;
+								case 5: line("\tA = ~A;"); return;
+								case 6: line("\tF |= 0x01;"); return;
+								default: line("\tF ^= 0x01;"); return;
+							}
+					}
+
+				default:
+					switch(sss)
+					{
+						// POP, SPHL (the others end blocks)
+						case 1:
+							if(op == 0xf9)
+								line("\tSP = H << 8 | L;");
+							else if(rp == 3)
+								line("\t{ const bytePair t = read16(ram, SP); SP += 2; A = t >> 8; F = (t & 0xd7) | 0x02; }");
+							else
+								line("\t{ const bytePair t = read16(ram, SP); SP += 2; %s = t >> 8; %s = t; }", pairHigh[rp], pairLow[rp]);
+							return;
+
+						// OUT, IN, XTHL, XCHG
+						case 3:
+							switch(ddd)
+							{
+								// The handler sees the machine as `cpu::step` leaves it
+								case 2:
+								case 3:
+									line("\tPC = 0x%04x;", (bytePair)(instr.address + instr.length));
+									saveState();
+
+									if(ddd == 2) line("\tmachine.portOutputHandler(0x%02x, A);", n);
+									else line("\tmachine.A() = machine.portInputHandler(0x%02x);", n);
+
+									loadState();
+									return;
+								case 4: line("\t{ const bytePair t = read16(ram, SP); write16(ram, SP, H << 8 | L); H = t >> 8; L = t; }"); return;
+								case 5: line("\t{ const byte h = H, l = L; H = D; L = E; D = h; E = l; }"); return;
+							}
+							break;
+
+						// PUSH
+						case 5:
+							line("\tSP -= 2;");
+							line("\twrite16(ram, SP, %s);", rp == 3 ? "A << 8 | F" : pair(rp).c_str());
+							return;
+
+						// ALU with an immediate operand
+						case 6:
+						{
+							char value[8];
+							std::snprintf(value, sizeof value, "0x%02x", n);
+							generateAlu(ddd, value, used);
+							return;
+						}
+					}
+			}
+
+			// Control transfers are only generated by `generateExit`
+			line("\t#error unexpected opcode 0x%02x", op);
+		}
+
+		void generateAlu(const int op, const char* value, const byte used)
+		{
+			if(not used)
+			{
+				switch(op)
+				{
+					case 0: line("\tA += %s;", value); return;
+					case 1: line("\tA += %s + (F & 1);", value); return;
+					case 2: line("\tA -= %s;", value); return;
+					case 3: line("\tA -= %s + (F & 1);", value); return;
+					case 4: line("\tA &= %s;", value); return;
+					case 5: line("\tA ^= %s;", value); return;
+					case 6: line("\tA |= %s;", value); return;
+					default: return;
+				}
+			}
+
+			const std::string flags = onlyFlags(used);
+			const char *const f = flags.c_str();
+
+			switch(op)
+			{
+				case 0: line("\tadd%s(A, F, %s, 0);", f, value); return;
+				case 1: line("\tadd%s(A, F, %s, F & 1);", f, value); return;
+				case 2: line("\tA = sub%s(A, F, %s, 0);", f, value); return;
+				case 3: line("\tA = sub%s(A, F, %s, F & 1);", f, value); return;
+				case 4: line("\tana%s(A, F, %s);", f, value); return;
+				case 5: line("\txra%s(A, F, %s);", f, value); return;
+				case 6: line("\tora%s(A, F, %s);", f, value); return;
+				default: line("\tsub%s(A, F, %s, 0);", f, value); return;
+			}
+		}
+
+		static std::string pair(const int rp)
+		{
+			if(rp == 3) return "SP";
+			return std::string("(") + pairHigh[rp] + " << 8 | " + pairLow[rp] + ")";
+		}
+
+		/**
+		 * @brief Generates the last instruction of a block and the transfer
+		   to the next.
+		 */
+		void generateExit(const instruction& instr, const byte used)
+		{
+			const bytePair next = instr.address + instr.length;
+			const int cc = instr.opcode >> 3 & 7;
+
+			switch(opcodes[instr.opcode].flow)
+			{
+				case flowType::jump:
+					transfer("\t", instr.address, instr.operand);
+					return;
+
+				case flowType::conditionalJump:
+					line("\tif(%s)", conditions[cc]);
+					line("\t{");
+					transfer("\t\t", instr.address, instr.operand);
+					line("\t}");
+					transfer("\t", instr.address, next);
+					return;
+
+				case flowType::call:
+					line("\tSP -= 2;");
+					line("\twrite16(ram, SP, 0x%04x);", next);
+					line("\tstored(SP, 2);");
+					transfer("\t", instr.address, instr.operand);
+					return;
+
+				case flowType::conditionalCall:
+					line("\tif(%s)", conditions[cc]);
+					line("\t{");
+					line("\t\tcycles += 6;");
+					line("\t\tSP -= 2;");
+					line("\t\twrite16(ram, SP, 0x%04x);", next);
+					line("\t\tstored(SP, 2);");
+					transfer("\t\t", instr.address, instr.operand);
+					line("\t}");
+					transfer("\t", instr.address, next);
+					return;
+
+				case flowType::restart:
+					line("\tSP -= 2;");
+					line("\twrite16(ram, SP, 0x%04x);", next);
+					line("\tstored(SP, 2);");
+					transfer("\t", instr.address, instr.opcode & 0x38);
+					return;
+
+				case flowType::ret:
+					line("\tPC = read16(ram, SP);");
+					line("\tSP += 2;");
+					transferIndirect("\t");
+					return;
+
+				case flowType::conditionalReturn:
+					line("\tif(%s)", conditions[cc]);
+					line("\t{");
+					line("\t\tcycles += 6;");
+					line("\t\tPC = read16(ram, SP);");
+					line("\t\tSP += 2;");
+					transferIndirect("\t\t");
+					line("\t}");
+					transfer("\t", instr.address, next);
+					return;
+
+				case flowType::indirectJump:
+					line("\tPC = H << 8 | L;");
+					transferIndirect("\t");
+					return;
+
+				case flowType::next:
+				case flowType::halt:
+					generateInstruction(instr, used);
+					transfer("\t", instr.address, next);
+					return;
+			}
+		}
+	};
+}
+
+std::string intel8080::recompileToCpp(const byte *const memory, const controlFlowGraph& graph, const recompileOptions& options /* = recompileOptions() */)
+{
+	generator g(memory, graph, options);
+	g.generate();
+	return std::move(g.out);
+}
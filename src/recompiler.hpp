@@ -0,0 +1,74 @@
+/**
+ * @file recompiler.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Translates the basic blocks of an Intel 8080 memory image into C++
+   source that runs them on an `intel8080::cpu`.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./cfg.hpp"
+
+#include <string>
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief Options for `recompileToCpp`.
+	 */
+	struct recompileOptions
+	{
+		/**
+		 * @brief The name of the generated function, which has the signature
+		   of `recompiledProgram` (see `recompiled.hpp`).
+		 */
+		std::string functionName = "recompiledProgram";
+
+		/**
+		 * @brief Addresses at which no block is translated, so that the
+		   generated function returns when control reaches them; e.g. the CP/M
+		   BDOS entry point, which the host handles.
+		 */
+		std::vector<bytePair> traps;
+
+		/**
+		 * @brief A description of where the image came from, for the comment
+		   at the top of the generated source.
+		 */
+		std::string source;
+	};
+
+	/**
+	 * @brief Generates a C++ function that runs the blocks of `graph`.
+	 * Each block becomes a labelled sequence of statements operating on local
+	   copies of the registers. A block first checks that its bytes in memory
+	   are still those it was translated from, and returns to the caller if
+	   not. Blocks jump directly to statically known successors that were
+	   translated; returns, `pchl` and other targets go through a switch on the
+	   program counter, which returns to the caller for untranslated code.
+	   `ei`, `di` and `hlt` are left to the interpreter.
+	 * `in` and `out` write the registers back to the machine before calling
+	   the port handler, reload them after it, and return to the caller,
+	   where an interrupt the handler requested can be serviced. A store
+	   that may change the rest of its block is followed by a check, and
+	   the rest is left to the interpreter if it did. Backward branches,
+	   returns and `pchl` return to the caller if an interrupt can be
+	   serviced.
+	 *
+	 * @param memory `const byte*` The 65536 bytes of memory `graph` was
+	   recovered from.
+	 * @param graph `const controlFlowGraph&` The blocks to translate.
+	 * @param options `const recompileOptions&` See `recompileOptions`.
+	 * @return `std::string` The C++ source, which includes `recompiled.hpp`.
+	 */
+	std::string recompileToCpp(const byte* memory, const controlFlowGraph& graph, const recompileOptions& options = recompileOptions());
+}
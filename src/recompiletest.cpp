@@ -0,0 +1,226 @@
+/**
+ * @file recompiletest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Checks code generated by `recompile` against `cpu::step` on a small
+   hand-assembled program: what port handlers see and change, code changed
+   by a store in the same block and by a port handler, and an interrupt
+   requested by a port handler in a loop, and the pages the generated code
+   marks as stored to; then the same with the generated code as the top
+   tier of a `tieredEngine`.
+   Usage: recompiletest
+   Built without `INTEL8080_RECOMPILED`, this instead writes the program to
+   the file given, for `recompile` to translate.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./intel8080.hpp"
+
+#include <cstdio>
+#include <vector>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief The program, at 0x0000; it starts at 0x0100.
+	 */
+	std::vector<byte> program(void)
+	{
+		std::vector<byte> image(0x0125);
+
+		const auto place = [&](const bytePair address, const std::initializer_list<int> bytes)
+		{
+			std::copy(bytes.begin(), bytes.end(), image.begin() + address);
+		};
+
+		// rst 2
+		place(0x0010, {
+			0x3e, 0xaa,			// 0010 mvi a, 0aah
+			0x32, 0x02, 0x02,	// 0012 sta 0202h
+			0x76				// 0015 hlt
+		});
+
+		place(0x0100, {
+			0x31, 0x00, 0x80,	// 0100 lxi sp, 8000h
+			0x3e, 0x42,			// 0103 mvi a, 42h
+			0x06, 0x07,			// 0105 mvi b, 7
+			0xd3, 0x10,			// 0107 out 10h: sees the registers, PC and cycles
+			0xdb, 0x11,			// 0109 in 11h: sets C, returns 99h
+			0x32, 0x00, 0x02,	// 010b sta 0200h
+			0x21, 0x14, 0x01,	// 010e lxi h, 0114h
+			0x36, 0x02,			// 0111 mvi m, 2: rewrites the operand below
+			0x3e, 0x01,			// 0113 mvi a, 1, run as mvi a, 2
+			0x32, 0x01, 0x02,	// 0115 sta 0201h
+			0xd3, 0x13,			// 0118 out 13h: rewrites the operand below
+			0x3e, 0x00,			// 011a mvi a, 0, run as mvi a, 77h
+			0x32, 0x03, 0x02,	// 011c sta 0203h
+			0xfb,				// 011f ei
+			0xd3, 0x12,			// 0120 out 12h: requests rst 2 the third time
+			0xc3, 0x20, 0x01	// 0122 jmp 0120h
+		});
+
+		return image;
+	}
+}
+
+#ifdef INTEL8080_RECOMPILED
+
+#include "./recompiled.hpp"
+#include "./tiered.hpp"
+#include "./check.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+std::uint64_t INTEL8080_RECOMPILED(intel8080::cpu& machine, const std::uint64_t budget);
+
+namespace
+{
+	/**
+	 * @brief What a port handler saw.
+	 */
+	struct portAccess
+	{
+		byte port, A, B, C;
+		bytePair SP, PC;
+		std::uint64_t cycles;
+
+		bool operator==(const portAccess& other) const noexcept
+		{
+			return port == other.port and A == other.A and B == other.B and C == other.C
+				and SP == other.SP and PC == other.PC and cycles == other.cycles;
+		}
+	};
+
+	/**
+	 * @brief The program on a `cpu` with port handlers that log what they see.
+	 */
+	struct testSystem
+	{
+		std::vector<byte> memory;
+		cpu machine;
+		std::vector<portAccess> accesses;
+		int loops = 0;
+
+		testSystem()
+		:
+			memory(0x10000),
+			machine(nullptr, nullptr, memory.data())
+		{
+			const std::vector<byte> image = program();
+			std::copy(image.begin(), image.end(), memory.begin());
+			machine.PC = 0x0100;
+			machine.PSW() = 0x0002;
+			machine.BC() = machine.DE() = machine.HL() = 0;
+
+			machine.portOutputHandler = [this](const byte port, const byte)
+			{
+				log(port);
+
+				if(port == 0x13) memory[0x011b] = 0x77;
+				if(port == 0x12 and ++loops == 3) machine.interrupt(0xd7);
+			};
+
+			machine.portInputHandler = [this](const byte port)
+			{
+				log(port);
+				machine.C() = 0x55;
+				return 0x99;
+			};
+		}
+
+		void log(const byte port)
+		{
+			accesses.push_back({port, machine.A(), machine.B(), machine.C(), machine.SP, machine.PC, machine.cycles});
+		}
+	};
+}
+
+int main(void)
+{
+	testSystem reference, native;
+
+	std::uint64_t steps = 0;
+	for(; steps < 1000 and not reference.machine.getHalted(); ++steps)
+		reference.machine.step();
+
+	CHECK(reference.machine.getHalted() and reference.loops == 3);
+
+	// The first block runs natively and returns after `out`
+	CHECK(INTEL8080_RECOMPILED(native.machine, 1000) == 4);
+	CHECK(native.accesses.size() == 1 and native.machine.PC == 0x0109);
+
+	std::fill(std::begin(recompiled::pagesWritten), std::end(recompiled::pagesWritten), 0);
+	const std::uint64_t executed = 4 + runRecompiled(native.machine, INTEL8080_RECOMPILED, 1000);
+
+	// The pages of the code it changed and of the results, and no others
+	CHECK(recompiled::pagesWritten[0x01] and recompiled::pagesWritten[0x02]);
+	CHECK(std::count(std::begin(recompiled::pagesWritten), std::end(recompiled::pagesWritten), 1) == 2);
+
+	// The interrupt is taken as soon as it is requested
+	CHECK(native.machine.getHalted() and native.loops == 3);
+	CHECK(executed == steps);
+
+	CHECK(native.accesses == reference.accesses);
+	CHECK(native.machine.PSW() == reference.machine.PSW());
+	CHECK(native.machine.BC() == reference.machine.BC() and native.machine.C() == 0x55);
+	CHECK(native.machine.HL() == reference.machine.HL());
+	CHECK(native.machine.SP == reference.machine.SP);
+	CHECK(native.machine.PC == reference.machine.PC);
+	CHECK(native.machine.cycles == reference.machine.cycles);
+	CHECK(native.memory == reference.memory);
+
+	// Blocks are translated when first entered and run natively from the second time
+	{
+		testSystem tiered;
+		tieredEngine engine(tiered.machine, {1, 2}, INTEL8080_RECOMPILED);
+
+		CHECK(engine.run(1000) == steps);
+		CHECK(tiered.machine.getHalted() and tiered.loops == 3);
+		CHECK(engine.getStatistics().inNative != 0);
+
+		CHECK(tiered.accesses == reference.accesses);
+		CHECK(tiered.machine.PSW() == reference.machine.PSW() and tiered.machine.BC() == reference.machine.BC());
+		CHECK(tiered.machine.PC == reference.machine.PC and tiered.machine.cycles == reference.machine.cycles);
+		CHECK(tiered.memory == reference.memory);
+	}
+
+	// What the program stored
+	const byte *const results = reference.memory.data() + 0x0200;
+	CHECK(results[0] == 0x99 and results[1] == 0x02 and results[2] == 0xaa and results[3] == 0x77);
+
+	return checks::summary("recompiletest");
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+	if(argc != 2)
+	{
+		std::fprintf(stderr, "usage: %s OUTPUT.bin\n", argv[0]);
+		return 2;
+	}
+
+	const std::vector<byte> image = program();
+	std::FILE *const file = std::fopen(argv[1], "wb");
+
+	if(not file or std::fwrite(image.data(), 1, image.size(), file) != image.size())
+	{
+		std::fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[1]);
+		if(file) std::fclose(file);
+		return 1;
+	}
+
+	return std::fclose(file) == 0 ? 0 : 1;
+}
+
+#endif
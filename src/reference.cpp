@@ -0,0 +1,597 @@
+/**
+ * @file reference.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A deliberately simple Intel 8080 core, written independently of
+   `intel8080::cpu`, for checking other execution engines against.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `reference.hpp`.
+
+#include "./reference.hpp"
+
+using namespace intel8080;
+
+namespace
+{
+	// Bits of the flags register
+	constexpr byte S = 0x80;
+	constexpr byte Z = 0x40;
+	constexpr byte AC = 0x10;
+	constexpr byte P = 0x04;
+	constexpr byte CY = 0x01;
+
+	// Bit 1 is always set; bits 3 and 5 are always clear
+	constexpr byte alwaysSet = 0x02;
+	constexpr byte alwaysClear = 0x28;
+
+	bool evenParity(byte value) noexcept
+	{
+		bool even = true;
+
+		for(; value; value >>= 1)
+		{
+			if(value & 1) even = not even;
+		}
+
+		return even;
+	}
+}
+
+bool machineState::operator==(const machineState& o) const noexcept
+{
+	return A == o.A and F == o.F and B == o.B and C == o.C and D == o.D and E == o.E and H == o.H and L == o.L
+		and SP == o.SP and PC == o.PC and halted == o.halted and interruptsEnabled == o.interruptsEnabled;
+}
+
+bool machineState::operator!=(const machineState& o) const noexcept
+{
+	return not (*this == o);
+}
+
+referenceCpu::referenceCpu(byte *const mem) noexcept
+:
+	memory(mem)
+{
+	state.F = alwaysSet;
+}
+
+byte referenceCpu::read(const bytePair adr) const noexcept
+{
+	return memory[adr];
+}
+
+void referenceCpu::write(const bytePair adr, const byte value) noexcept
+{
+	memory[adr] = value;
+}
+
+bytePair referenceCpu::read16(const bytePair adr) const noexcept
+{
+	return read(adr) | read(adr + 1) << 8;
+}
+
+void referenceCpu::write16(const bytePair adr, const bytePair value) noexcept
+{
+	write(adr, value & 0xff);
+	write(adr + 1, value >> 8);
+}
+
+byte referenceCpu::fetch(void) noexcept
+{
+	return read(state.PC++);
+}
+
+bytePair referenceCpu::fetch16(void) noexcept
+{
+	const bytePair value = read16(state.PC);
+	state.PC += 2;
+	return value;
+}
+
+byte referenceCpu::getRegister(const int r) const noexcept
+{
+	switch(r)
+	{
+		case 0: return state.B;
+		case 1: return state.C;
+		case 2: return state.D;
+		case 3: return state.E;
+		case 4: return state.H;
+		case 5: return state.L;
+		case 6: return read(state.H << 8 | state.L);
+		default: return state.A;
+	}
+}
+
+void referenceCpu::setRegister(const int r, const byte value) noexcept
+{
+	switch(r)
+	{
+		case 0: state.B = value; break;
+		case 1: state.C = value; break;
+		case 2: state.D = value; break;
+		case 3: state.E = value; break;
+		case 4: state.H = value; break;
+		case 5: state.L = value; break;
+		case 6: write(state.H << 8 | state.L, value); break;
+		default: state.A = value; break;
+	}
+}
+
+bytePair referenceCpu::getPair(const int rp) const noexcept
+{
+	switch(rp)
+	{
+		case 0: return state.B << 8 | state.C;
+		case 1: return state.D << 8 | state.E;
+		case 2: return state.H << 8 | state.L;
+		default: return state.SP;
+	}
+}
+
+void referenceCpu::setPair(const int rp, const bytePair value) noexcept
+{
+	switch(rp)
+	{
+		case 0: state.B = value >> 8; state.C = value & 0xff; break;
+		case 1: state.D = value >> 8; state.E = value & 0xff; break;
+		case 2: state.H = value >> 8; state.L = value & 0xff; break;
+		default: state.SP = value; break;
+	}
+}
+
+bool referenceCpu::condition(const int cc) const noexcept
+{
+	switch(cc)
+	{
+		case 0: return not (state.F & Z);
+		case 1: return state.F & Z;
+		case 2: return not (state.F & CY);
+		case 3: return state.F & CY;
+		case 4: return not (state.F & P);
+		case 5: return state.F & P;
+		case 6: return not (state.F & S);
+		default: return state.F & S;
+	}
+}
+
+void referenceCpu::setZSP(const byte value) noexcept
+{
+	state.F &= ~(S | Z | P);
+	if(value & 0x80) state.F |= S;
+	if(value == 0) state.F |= Z;
+	if(evenParity(value)) state.F |= P;
+}
+
+void referenceCpu::push(const bytePair value) noexcept
+{
+	state.SP -= 2;
+	write16(state.SP, value);
+}
+
+bytePair referenceCpu::pop(void) noexcept
+{
+	const bytePair value = read16(state.SP);
+	state.SP += 2;
+	return value;
+}
+
+void referenceCpu::alu(const int op, const byte value) noexcept
+{
+	const unsigned a = state.A;
+	const unsigned carryIn = state.F & CY;
+	unsigned result;
+
+	switch(op)
+	{
+		// ADD, ADC
+		case 0:
+		case 1:
+		{
+			const unsigned c = op == 1 ? carryIn : 0;
+			result = a + value + c;
+
+			state.F &= ~(AC | CY);
+			if(result > 0xff) state.F |= CY;
+			if((a & 0xf) + (value & 0xf) + c > 0xf) state.F |= AC;
+			break;
+		}
+
+		// SUB, SBB, CMP: the 8080 adds the one's complement of the operand
+		// and the complement of the borrow, so the auxiliary carry is the
+		// carry out of bit 3 of that sum, and the carry flag is its inverse
+		case 2:
+		case 3:
+		case 7:
+		{
+			const unsigned notBorrow = op == 3 ? not carryIn : 1;
+			const unsigned complement = ~value & 0xff;
+			result = a + complement + notBorrow;
+
+			state.F &= ~(AC | CY);
+			if(result <= 0xff) state.F |= CY;
+			if((a & 0xf) + (complement & 0xf) + notBorrow > 0xf) state.F |= AC;
+			break;
+		}
+
+		// ANA: the auxiliary carry is the OR of bit 3 of the operands
+		case 4:
+			result = a & value;
+
+			state.F &= ~(AC | CY);
+			if((a | value) & 0x08) state.F |= AC;
+			break;
+
+		// XRA
+		case 5:
+			result = a ^ value;
+			state.F &= ~(AC | CY);
+			break;
+
+		// ORA
+		default:
+			result = a | value;
+			state.F &= ~(AC | CY);
+			break;
+	}
+
+	setZSP(result);
+
+	if(op != 7)
+	{
+		state.A = result;
+	}
+}
+
+void referenceCpu::step(void) noexcept
+{
+	if(state.halted)
+		return;
+
+	const byte op = fetch();
+	const int ddd = op >> 3 & 7;
+	const int sss = op & 7;
+	const int rp = op >> 4 & 3;
+
+	switch(op >> 6)
+	{
+		// MOV, HLT
+		case 1:
+			if(op == 0x76)
+			{
+				state.halted = true;
+				cycles += 7;
+			}
+			else
+			{
+				setRegister(ddd, getRegister(sss));
+				cycles += ddd == 6 or sss == 6 ? 7 : 5;
+			}
+			return;
+
+		// ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP with a register
+		case 2:
+			alu(ddd, getRegister(sss));
+			cycles += sss == 6 ? 7 : 4;
+			return;
+
+		case 0:
+			switch(sss)
+			{
+				// NOP
+				case 0:
+					cycles += 4;
+					return;
+
+				// LXI, DAD
+				case 1:
+					if(op & 0x08)
+					{
+						const unsigned sum = getPair(2) + getPair(rp);
+						setPair(2, sum);
+						state.F = sum > 0xffff ? state.F | CY : state.F & ~CY;
+					}
+					else
+					{
+						setPair(rp, fetch16());
+					}
+					cycles += 10;
+					return;
+
+				// STAX, LDAX, SHLD, LHLD, STA, LDA
+				case 2:
+					switch(ddd)
+					{
+						case 0: write(getPair(0), state.A); cycles += 7; break;
+						case 1: state.A = read(getPair(0)); cycles += 7; break;
+						case 2: write(getPair(1), state.A); cycles += 7; break;
+						case 3: state.A = read(getPair(1)); cycles += 7; break;
+						case 4: write16(fetch16(), getPair(2)); cycles += 16; break;
+						case 5: setPair(2, read16(fetch16())); cycles += 16; break;
+						case 6: write(fetch16(), state.A); cycles += 13; break;
+						default: state.A = read(fetch16()); cycles += 13; break;
+					}
+					return;
+
+				// INX, DCX
+				case 3:
+					setPair(rp, getPair(rp) + (op & 0x08 ? -1 : 1));
+					cycles += 5;
+					return;
+
+				// INR
+				case 4:
+				{
+					const byte value = getRegister(ddd) + 1;
+					setRegister(ddd, value);
+					setZSP(value);
+					state.F = (value & 0xf) == 0 ? state.F | AC : state.F & ~AC;
+					cycles += ddd == 6 ? 10 : 5;
+					return;
+				}
+
+				// DCR
+				case 5:
+				{
+					const byte value = getRegister(ddd) - 1;
+					setRegister(ddd, value);
+					setZSP(value);
+					state.F = (value & 0xf) != 0xf ? state.F | AC : state.F & ~AC;
+					cycles += ddd == 6 ? 10 : 5;
+					return;
+				}
+
+				// MVI
+				case 6:
+					setRegister(ddd, fetch());
+					cycles += ddd == 6 ? 10 : 7;
+					return;
+
+				// Rotates and accumulator/carry instructions
+				default:
+				{
+					const byte a = state.A;
+					const byte carry = state.F & CY;
+
+					switch(ddd)
+					{
+						// RLC
+						case 0:
+							state.A = a << 1 | a >> 7;
+							state.F = (state.F & ~CY) | a >> 7;
+							break;
+
+						// RRC
+						case 1:
+							state.A = a >> 1 | a << 7;
+							state.F = (state.F & ~CY) | (a & 1);
+							break;
+
+						// RAL
+						case 2:
+							state.A = a << 1 | carry;
+							state.F = (state.F & ~CY) | a >> 7;
+							break;
+
+						// RAR
+						case 3:
+							state.A = a >> 1 | carry << 7;
+							state.F = (state.F & ~CY) | (a & 1);
+							break;
+
+						// DAA: add 6 to each digit that is out of range or
+						// carried out of, then set the flags as for that addition,
+						// except that the carry flag is never cleared
+						case 4:
+						{
+							byte correction = 0;
+							bool carryOut = carry;
+
+							if((state.F & AC) or (a & 0xf) > 9)
+								correction |= 0x06;
+
+							if(carry or a >> 4 > 9 or (a >> 4 >= 9 and (a & 0xf) > 9))
+							{
+								correction |= 0x60;
+								carryOut = true;
+							}
+
+							alu(0, correction);
+							state.F = carryOut ? state.F | CY : state.F & ~CY;
+							break;
+						}
+
+						// CMA
+						case 5:
+							state.A = ~a;
+							break;
+
+						// STC
+						case 6:
+							state.F |= CY;
+							break;
+
+						// CMC
+						default:
+							state.F ^= CY;
+							break;
+					}
+
+					cycles += 4;
+					return;
+				}
+			}
+
+		default:
+			switch(sss)
+			{
+				// Conditional returns
+				case 0:
+					if(condition(ddd))
+					{
+						state.PC = pop();
+						cycles += 11;
+					}
+					else
+					{
+						cycles += 5;
+					}
+					return;
+
+				// POP, RET, PCHL, SPHL
+				case 1:
+					if(not (op & 0x08))
+					{
+						const bytePair value = pop();
+
+						if(rp == 3)
+						{
+							state.A = value >> 8;
+							state.F = (value & 0xff & ~alwaysClear) | alwaysSet;
+						}
+						else
+						{
+							setPair(rp, value);
+						}
+
+						cycles += 10;
+					}
+					else if(ddd == 1 or ddd == 3)
+					{
+						state.PC = pop();
+						cycles += 10;
+					}
+					else if(ddd == 5)
+					{
+						state.PC = getPair(2);
+						cycles += 5;
+					}
+					else
+					{
+						state.SP = getPair(2);
+						cycles += 5;
+					}
+					return;
+
+				// Conditional jumps
+				case 2:
+				{
+					const bytePair adr = fetch16();
+					if(condition(ddd)) state.PC = adr;
+					cycles += 10;
+					return;
+				}
+
+				// JMP, OUT, IN, XTHL, XCHG, DI, EI
+				case 3:
+					switch(ddd)
+					{
+						case 0:
+						case 1:
+							state.PC = fetch16();
+							cycles += 10;
+							break;
+
+						case 2:
+						{
+							const byte port = fetch();
+							if(output) output(context, port, state.A);
+							cycles += 10;
+							break;
+						}
+
+						case 3:
+						{
+							const byte port = fetch();
+							state.A = input ? input(context, port) : 0;
+							cycles += 10;
+							break;
+						}
+
+						case 4:
+						{
+							const bytePair top = read16(state.SP);
+							write16(state.SP, getPair(2));
+							setPair(2, top);
+							cycles += 18;
+							break;
+						}
+
+						case 5:
+						{
+							const bytePair de = getPair(1);
+							setPair(1, getPair(2));
+							setPair(2, de);
+							cycles += 5;
+							break;
+						}
+
+						case 6:
+							state.interruptsEnabled = false;
+							cycles += 4;
+							break;
+
+						default:
+							state.interruptsEnabled = true;
+							cycles += 4;
+							break;
+					}
+					return;
+
+				// Conditional calls
+				case 4:
+				{
+					const bytePair adr = fetch16();
+
+					if(condition(ddd))
+					{
+						push(state.PC);
+						state.PC = adr;
+						cycles += 17;
+					}
+					else
+					{
+						cycles += 11;
+					}
+					return;
+				}
+
+				// PUSH, CALL
+				case 5:
+					if(not (op & 0x08))
+					{
+						push(rp == 3 ? state.A << 8 | state.F : getPair(rp));
+						cycles += 11;
+					}
+					else
+					{
+						const bytePair adr = fetch16();
+						push(state.PC);
+						state.PC = adr;
+						cycles += 17;
+					}
+					return;
+
+				// ALU with an immediate operand
+				case 6:
+					alu(ddd, fetch());
+					cycles += 7;
+					return;
+
+				// RST
+				default:
+					push(state.PC);
+					state.PC = ddd * 8;
+					cycles += 11;
+					return;
+			}
+	}
+}
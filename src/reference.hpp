@@ -0,0 +1,109 @@
+/**
+ * @file reference.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A deliberately simple Intel 8080 core, written independently of
+   `intel8080::cpu`, for checking other execution engines against.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+
+namespace intel8080
+{
+	/**
+	 * @brief The architectural state of an Intel 8080, as compared between
+	   execution engines.
+	 */
+	struct machineState
+	{
+		byte A, F, B, C, D, E, H, L;
+		bytePair SP, PC;
+		bool halted;
+		bool interruptsEnabled;
+
+		bool operator==(const machineState& other) const noexcept;
+		bool operator!=(const machineState& other) const noexcept;
+	};
+
+	/**
+	 * @brief A reference Intel 8080 core.
+	 * Every instruction is written out with the flag behaviour documented in
+	   the Intel 8080 Programmer's Manual and the 8080/8085 Assembly Language
+	   Programming Manual, favouring clarity over speed. All 16-bit memory
+	   accesses wrap around at 0xffff.
+	 * It shares no code with `cpu` beyond basic types, so that a bug in one is
+	   unlikely to be repeated in the other.
+	 */
+	class referenceCpu
+	{
+	public:
+		/**
+		 * @brief The registers, flags and status of the CPU.
+		 */
+		machineState state = {};
+
+		/**
+		 * @brief 65536 bytes of memory.
+		 */
+		byte* memory;
+
+		/**
+		 * @brief Called by `in`; returns the byte read from `port`.
+		 */
+		byte (*input)(void* context, const byte port) = nullptr;
+
+		/**
+		 * @brief Called by `out`.
+		 */
+		void (*output)(void* context, const byte port, const byte data) = nullptr;
+
+		/**
+		 * @brief Passed to `input` and `output`.
+		 */
+		void* context = nullptr;
+
+		/**
+		 * @brief The number of clock cycles (states) run.
+		 */
+		std::uint64_t cycles = 0;
+
+		/**
+		 * @param memory `byte *const` 65536 bytes of memory.
+		 */
+		referenceCpu(byte *const memory) noexcept;
+
+		/**
+		 * @brief Runs one instruction, unless the CPU is halted.
+		 */
+		void step(void) noexcept;
+
+	private:
+		byte read(const bytePair adr) const noexcept;
+		void write(const bytePair adr, const byte value) noexcept;
+		bytePair read16(const bytePair adr) const noexcept;
+		void write16(const bytePair adr, const bytePair value) noexcept;
+		byte fetch(void) noexcept;
+		bytePair fetch16(void) noexcept;
+
+		byte getRegister(const int r) const noexcept;
+		void setRegister(const int r, const byte value) noexcept;
+		bytePair getPair(const int rp) const noexcept;
+		void setPair(const int rp, const bytePair value) noexcept;
+
+		bool condition(const int cc) const noexcept;
+		void setZSP(const byte value) noexcept;
+		void push(const bytePair value) noexcept;
+		bytePair pop(void) noexcept;
+
+		void alu(const int op, const byte value) noexcept;
+	};
+}
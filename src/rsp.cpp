@@ -0,0 +1,735 @@
+/**
+ * @file rsp.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A GDB remote serial protocol server for an `intel8080::cpu`.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `rsp.hpp`.
+
+#include "./rsp.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace intel8080;
+
+namespace
+{
+	const char hexDigits[] = "0123456789abcdef";
+
+	/**
+	 * @brief The registers, described to the front end.
+	 */
+	const char targetDescription[] =
+		"<?xml version=\"1.0\"?>"
+		"<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+		"<target version=\"1.0\">"
+			"<feature name=\"org.intel8080.core\">"
+				"<flags id=\"i8080_flags\" size=\"1\">"
+					"<field name=\"c\" start=\"0\" end=\"0\"/>"
+					"<field name=\"p\" start=\"2\" end=\"2\"/>"
+					"<field name=\"ac\" start=\"4\" end=\"4\"/>"
+					"<field name=\"z\" start=\"6\" end=\"6\"/>"
+					"<field name=\"s\" start=\"7\" end=\"7\"/>"
+				"</flags>"
+				"<reg name=\"a\" bitsize=\"8\" type=\"uint8\" regnum=\"0\"/>"
+				"<reg name=\"f\" bitsize=\"8\" type=\"i8080_flags\"/>"
+				"<reg name=\"bc\" bitsize=\"16\" type=\"uint16\"/>"
+				"<reg name=\"de\" bitsize=\"16\" type=\"uint16\"/>"
+				"<reg name=\"hl\" bitsize=\"16\" type=\"data_ptr\"/>"
+				"<reg name=\"sp\" bitsize=\"16\" type=\"data_ptr\"/>"
+				"<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+			"</feature>"
+		"</target>";
+
+	/**
+	 * @brief The size of each register, in bytes.
+	 */
+	constexpr int registerSizes[] = {1, 1, 2, 2, 2, 2, 2};
+	constexpr int registerCount = std::size(registerSizes);
+
+	int hexValue(const char c) noexcept
+	{
+		if(c >= '0' and c <= '9') return c - '0';
+		if(c >= 'a' and c <= 'f') return c - 'a' + 10;
+		if(c >= 'A' and c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	/**
+	 * @brief Parses a hex number from `text[i]`, leaving `i` after it.
+	 */
+	bool parseHex(const std::string& text, std::size_t& i, std::uint32_t& value) noexcept
+	{
+		const std::size_t first = i;
+		value = 0;
+
+		for(int digit; i < text.size() and (digit = hexValue(text[i])) >= 0 and i - first < 8; ++i)
+			value = value << 4 | digit;
+
+		return i != first;
+	}
+
+	/**
+	 * @brief Parses `ADDR,LENGTH` from `text[i]`, leaving `i` after it, and
+	   limits the length to the end of memory.
+	 */
+	bool parseRange(const std::string& text, std::size_t& i, std::uint32_t& address, std::uint32_t& length) noexcept
+	{
+		if(not parseHex(text, i, address) or i >= text.size() or text[i++] != ',' or not parseHex(text, i, length)
+			or address > 0xffff)
+			return false;
+
+		length = std::min<std::uint32_t>(length, 0x10000 - address);
+		return true;
+	}
+
+	void appendHex(std::string& out, const byte *const data, const std::size_t size)
+	{
+		const std::size_t first = out.size();
+		out.resize(first + 2 * size);
+
+		char *const p = &out[first];
+
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			p[2 * i] = hexDigits[data[i] >> 4];
+			p[2 * i + 1] = hexDigits[data[i] & 0xf];
+		}
+	}
+
+	/**
+	 * @brief Decodes `size` bytes of hex from `hex[i]` into `out`.
+	 */
+	bool decodeHex(const std::string& hex, const std::size_t i, byte *const out, const std::size_t size) noexcept
+	{
+		if(hex.size() < i + 2 * size)
+			return false;
+
+		for(std::size_t j = 0; j < size; ++j)
+		{
+			const int high = hexValue(hex[i + 2 * j]);
+			const int low = hexValue(hex[i + 2 * j + 1]);
+
+			if(high < 0 or low < 0)
+				return false;
+
+			out[j] = high << 4 | low;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Appends `data`, escaping the bytes that frame packets or mark
+	   repeats, as binary packets do.
+	 */
+	void appendBinary(std::string& out, const byte *const data, const std::size_t size)
+	{
+		out.reserve(out.size() + size + size / 16);
+
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			const byte b = data[i];
+
+			if(b == '#' or b == '$' or b == '}' or b == '*')
+			{
+				out += '}';
+				out += (char)(b ^ 0x20);
+			}
+			else
+			{
+				out += (char)b;
+			}
+		}
+	}
+}
+
+rspServer::rspServer(cpu& m)
+:
+	machine(m),
+	target(m)
+{}
+
+int rspServer::listenTCP(const std::uint16_t port)
+{
+	const int s = socket(AF_INET, SOCK_STREAM, 0);
+
+	if(s < 0)
+		return -1;
+
+	const int one = 1;
+	setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if(bind(s, (const sockaddr*)&address, sizeof address) != 0 or listen(s, 1) != 0)
+	{
+		close(s);
+		return -1;
+	}
+
+	return s;
+}
+
+int rspServer::listenUnix(const std::string& path)
+{
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+
+	if(path.size() >= sizeof address.sun_path)
+		return -1;
+
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	const int s = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if(s < 0)
+		return -1;
+
+	unlink(path.c_str());
+
+	if(bind(s, (const sockaddr*)&address, sizeof address) != 0 or listen(s, 1) != 0)
+	{
+		close(s);
+		return -1;
+	}
+
+	return s;
+}
+
+void rspServer::serve(const int connection)
+{
+	fd = connection;
+	acknowledge = true;
+	input.clear();
+
+	// Replies are single writes; do not hold them back. Fails harmlessly on
+	// Unix domain sockets.
+	const int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+
+	std::string packet, reply;
+
+	while(receive(packet))
+	{
+		reply.clear();
+
+		const bool more = handle(packet, reply);
+
+		// `k` has no reply
+		if(packet != "k" and not send(reply))
+			break;
+
+		// Acknowledged like any other packet, then never again
+		if(packet == "QStartNoAckMode")
+			acknowledge = false;
+
+		if(not more)
+			break;
+	}
+
+	close(fd);
+	fd = -1;
+}
+
+bool rspServer::receive(std::string& packet)
+{
+	char buffer[0x10000];
+
+	for(;;)
+	{
+		while(not input.empty())
+		{
+			if(input[0] != '$')
+			{
+				// Acknowledgements, and interrupts that came too late
+				input.erase(0, 1);
+				continue;
+			}
+
+			const std::size_t end = input.find('#');
+
+			if(end == std::string::npos or input.size() < end + 3)
+				break;
+
+			byte sum = 0;
+
+			for(std::size_t i = 1; i < end; ++i)
+				sum += input[i];
+
+			const bool ok = hexValue(input[end + 1]) << 4 == (sum & 0xf0) and hexValue(input[end + 2]) == (sum & 0xf);
+
+			packet.assign(input, 1, end - 1);
+			input.erase(0, end + 3);
+
+			if(acknowledge and write(fd, ok ? "+" : "-", 1) != 1)
+				return false;
+
+			if(ok or not acknowledge)
+				return true;
+		}
+
+		// Something too large to be a packet
+		if(input.size() > 2 * packetSize)
+			return false;
+
+		const ssize_t n = read(fd, buffer, sizeof buffer);
+
+		if(n <= 0)
+			return false;
+
+		input.append(buffer, n);
+	}
+}
+
+bool rspServer::send(const std::string& payload)
+{
+	byte sum = 0;
+
+	for(const char c : payload)
+		sum += c;
+
+	char trailer[3] = {'#', hexDigits[sum >> 4], hexDigits[sum & 0xf]};
+
+	for(;;)
+	{
+		// Written without copying the payload
+		iovec parts[3] = {{(void*)"$", 1}, {(void*)payload.data(), payload.size()}, {trailer, sizeof trailer}};
+		std::size_t left = 1 + payload.size() + sizeof trailer;
+		int part = 0;
+
+		while(left)
+		{
+			const ssize_t n = writev(fd, parts + part, 3 - part);
+
+			if(n <= 0)
+				return false;
+
+			left -= n;
+
+			// Skip what was written, which may end partway through a part
+			std::size_t done = n;
+
+			for(; part < 3 and done >= parts[part].iov_len; ++part)
+				done -= parts[part].iov_len;
+
+			if(part < 3)
+			{
+				parts[part].iov_base = (char*)parts[part].iov_base + done;
+				parts[part].iov_len -= done;
+			}
+		}
+
+		if(not acknowledge)
+			return true;
+
+		// Resent until it arrives intact
+		for(;;)
+		{
+			if(input.empty())
+			{
+				char c;
+				if(read(fd, &c, 1) != 1) return false;
+				input += c;
+			}
+
+			const char c = input[0];
+
+			if(c == '+' or c == '-')
+				input.erase(0, 1);
+
+			if(c == '+') return true;
+			if(c == '-') break;
+
+			// Not an acknowledgement: the front end has moved on
+			return true;
+		}
+	}
+}
+
+bool rspServer::interrupted(void)
+{
+	pollfd p = {fd, POLLIN, 0};
+
+	if(poll(&p, 1, 0) > 0)
+	{
+		char buffer[256];
+		const ssize_t n = read(fd, buffer, sizeof buffer);
+
+		// Stop if the front end has gone
+		if(n <= 0)
+			return true;
+
+		input.append(buffer, n);
+	}
+
+	const std::size_t i = input.find('\x03');
+
+	if(i == std::string::npos)
+		return false;
+
+	input.erase(i, 1);
+	return true;
+}
+
+bool rspServer::handle(const std::string& packet, std::string& reply)
+{
+	if(packet.empty())
+		return true;
+
+	std::size_t i = 1;
+	std::uint32_t address, length, value;
+
+	switch(packet[0])
+	{
+		case '?':
+			reply = lastStop;
+			break;
+
+		case 'g':
+			reply = readRegisters();
+			break;
+
+		case 'G':
+			reply = writeRegisters(packet.substr(1)) ? "OK" : "E01";
+			break;
+
+		case 'p':
+			if(not parseHex(packet, i, value) or not readRegister(value, reply))
+				reply = "E01";
+			break;
+
+		case 'P':
+			reply = parseHex(packet, i, value) and i < packet.size() and packet[i] == '='
+				and writeRegister(value, packet.substr(i + 1)) ? "OK" : "E01";
+			break;
+
+		case 'm':
+			if(parseRange(packet, i, address, length))
+				appendHex(reply, machine.ram + address, length);
+			else
+				reply = "E01";
+			break;
+
+		// Binary memory reads, from GDB 16
+		case 'x':
+			if(parseRange(packet, i, address, length))
+			{
+				reply = "b";
+				appendBinary(reply, machine.ram + address, length);
+			}
+			else
+			{
+				reply = "E01";
+			}
+			break;
+
+		case 'M':
+			if(parseRange(packet, i, address, length) and i < packet.size() and packet[i] == ':'
+				and decodeHex(packet, i + 1, machine.ram + address, length))
+			{
+				target.invalidate(address, length);
+				reply = "OK";
+			}
+			else
+			{
+				reply = "E01";
+			}
+			break;
+
+		case 'X':
+		{
+			if(not parseRange(packet, i, address, length) or i >= packet.size() or packet[i++] != ':')
+			{
+				reply = "E01";
+				break;
+			}
+
+			std::uint32_t n = 0;
+
+			for(; i < packet.size() and n < length; ++n)
+			{
+				const char c = packet[i++];
+				machine.ram[address + n] = c == '}' and i < packet.size() ? packet[i++] ^ 0x20 : c;
+			}
+
+			target.invalidate(address, n);
+			reply = n == length ? "OK" : "E01";
+			break;
+		}
+
+		case 'c':
+		case 's':
+			if(parseHex(packet, i, value))
+				machine.PC = value;
+
+			reply = resume(packet[0] == 's');
+			break;
+
+		case 'v':
+			if(packet == "vCont?")
+			{
+				reply = "vCont;c;C;s;S";
+			}
+			else if(packet.compare(0, 6, "vCont;") == 0 and packet.size() > 6)
+			{
+				// One thread, so only the first action matters
+				const char action = packet[6];
+
+				if(action == 'c' or action == 'C' or action == 's' or action == 'S')
+					reply = resume(action == 's' or action == 'S');
+				else
+					reply = "E01";
+			}
+			break;
+
+		case 'Z':
+		case 'z':
+			reply = setPoint(packet);
+			break;
+
+		case 'q':
+			if(packet.compare(0, 10, "qSupported") == 0)
+			{
+				char features[160];
+				std::snprintf(features, sizeof features,
+					"PacketSize=%zx;qXfer:features:read+;swbreak+;hwbreak+;QStartNoAckMode+;binary-upload+;vContSupported+",
+					packetSize);
+				reply = features;
+			}
+			else if(packet.compare(0, 31, "qXfer:features:read:target.xml:") == 0)
+			{
+				i = 31;
+
+				if(not parseRange(packet, i, address, length))
+				{
+					reply = "E01";
+					break;
+				}
+
+				const std::size_t size = sizeof targetDescription - 1;
+				const std::size_t offset = std::min<std::size_t>(address, size);
+				const std::size_t n = std::min<std::size_t>(length, size - offset);
+
+				reply = offset + n < size ? "m" : "l";
+				appendBinary(reply, (const byte*)targetDescription + offset, n);
+			}
+			else if(packet == "qAttached")
+			{
+				reply = "1";
+			}
+			else if(packet == "qC")
+			{
+				reply = "QC1";
+			}
+			else if(packet == "qfThreadInfo")
+			{
+				reply = "m1";
+			}
+			else if(packet == "qsThreadInfo")
+			{
+				reply = "l";
+			}
+			else if(packet.compare(0, 7, "qSymbol") == 0)
+			{
+				reply = "OK";
+			}
+			break;
+
+		case 'Q':
+			if(packet == "QStartNoAckMode")
+				reply = "OK";
+			break;
+
+		// One thread
+		case 'H':
+		case 'T':
+			reply = "OK";
+			break;
+
+		case 'D':
+			reply = "OK";
+			return false;
+
+		case 'k':
+			return false;
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+std::string rspServer::resume(const bool step)
+{
+	stopInfo stop;
+	bool stoppedByFrontEnd = false;
+
+	if(step)
+	{
+		stop = target.step();
+	}
+	else
+	{
+		do
+		{
+			stop = target.run(pollInterval);
+		}
+		while(stop.reason == stopReason::limit and not (stoppedByFrontEnd = interrupted()));
+	}
+
+	char reply[64];
+	const char* kind = "";
+	char detail[24] = "";
+
+	switch(stop.reason)
+	{
+		case stopReason::breakpoint:
+			kind = "swbreak:;";
+			break;
+
+		case stopReason::watchpoint:
+			kind = stop.watch == watchKind::write ? "watch" : stop.watch == watchKind::read ? "rwatch" : "awatch";
+			std::snprintf(detail, sizeof detail, ":%x;", stop.address);
+			break;
+
+		default:
+			break;
+	}
+
+	// SIGINT if the front end stopped it, else SIGTRAP, with SP and PC so
+	// that the front end need not ask for them
+	std::snprintf(reply, sizeof reply, "T%02x%s%s05:%02x%02x;06:%02x%02x;",
+		stoppedByFrontEnd ? 2 : 5, kind, detail,
+		machine.SP & 0xff, machine.SP >> 8, machine.PC & 0xff, machine.PC >> 8);
+
+	lastStop = reply;
+	return lastStop;
+}
+
+std::string rspServer::readRegisters(void)
+{
+	std::string reply;
+
+	for(int n = 0; n < registerCount; ++n)
+		readRegister(n, reply);
+
+	return reply;
+}
+
+bool rspServer::writeRegisters(const std::string& hex)
+{
+	std::size_t i = 0;
+
+	for(int n = 0; n < registerCount; ++n)
+	{
+		if(not writeRegister(n, hex.substr(i, 2 * registerSizes[n])))
+			return false;
+
+		i += 2 * registerSizes[n];
+	}
+
+	return true;
+}
+
+bool rspServer::readRegister(const int n, std::string& reply)
+{
+	bytePair value;
+
+	switch(n)
+	{
+		case 0: value = machine.A(); break;
+		case 1: value = machine.flags(); break;
+		case 2: value = machine.BC(); break;
+		case 3: value = machine.DE(); break;
+		case 4: value = machine.HL(); break;
+		case 5: value = machine.SP; break;
+		case 6: value = machine.PC; break;
+		default: return false;
+	}
+
+	// Little-endian, as in memory
+	const byte bytes[2] = {(byte)value, (byte)(value >> 8)};
+	appendHex(reply, bytes, registerSizes[n]);
+	return true;
+}
+
+bool rspServer::writeRegister(const int n, const std::string& hex)
+{
+	byte bytes[2] = {};
+
+	if(n < 0 or n >= registerCount or hex.size() != 2 * (std::size_t)registerSizes[n]
+		or not decodeHex(hex, 0, bytes, registerSizes[n]))
+		return false;
+
+	const bytePair value = bytes[0] | bytes[1] << 8;
+
+	switch(n)
+	{
+		case 0: machine.A() = value; break;
+		case 1: machine.flags() = value; break;
+		case 2: machine.BC() = value; break;
+		case 3: machine.DE() = value; break;
+		case 4: machine.HL() = value; break;
+		case 5: machine.SP = value; break;
+		case 6: machine.PC = value; break;
+	}
+
+	return true;
+}
+
+std::string rspServer::setPoint(const std::string& packet)
+{
+	// `Ztype,addr,kind`, where `kind` is the length of a watchpoint
+	std::size_t i = 1;
+	std::uint32_t type, address, kind;
+
+	if(not parseHex(packet, i, type) or i >= packet.size() or packet[i++] != ','
+		or not parseHex(packet, i, address) or i >= packet.size() or packet[i++] != ','
+		or not parseHex(packet, i, kind) or address > 0xffff)
+		return "E01";
+
+	const bool set = packet[0] == 'Z';
+
+	switch(type)
+	{
+		// Software and hardware breakpoints
+		case 0:
+		case 1:
+			target.setBreakpoint(address, set);
+			return "OK";
+
+		case 2:
+		case 3:
+		case 4:
+		{
+			const watchKind watch = type == 2 ? watchKind::write : type == 3 ? watchKind::read : watchKind::access;
+			return target.setWatchpoint(address, kind, watch, set) ? "OK" : "E01";
+		}
+
+		default:
+			return "";
+	}
+}
@@ -0,0 +1,128 @@
+/**
+ * @file rsp.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A GDB remote serial protocol server for an `intel8080::cpu`.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+#include "./debug.hpp"
+
+#include <string>
+
+namespace intel8080
+{
+	/**
+	 * @brief Lets GDB and other front ends that speak its remote protocol
+	   debug a `cpu` over a socket.
+	 * The registers are A, the flags, BC, DE, HL, SP and PC, numbered 0 to
+	   6, and described to the front end by a target description. Software
+	   and hardware breakpoints are both breakpoints of `debugTarget`, so
+	   memory is never patched; write, read and access watchpoints are
+	   supported, as are `c`, `s`, `vCont` and an interrupt from the front
+	   end while running.
+	 * Memory is read with `m` (hex) or `x` (binary) and written with `M` or
+	   `X`, and packets of up to `packetSize` bytes are accepted, so all of
+	   memory can be read or written in one packet.
+	 * @see https://sourceware.org/gdb/current/onlinedocs/gdb.html/Remote-Protocol.html
+	 */
+	class rspServer
+	{
+	public:
+		/**
+		 * @brief The largest packet accepted or sent: enough for all 64 KiB
+		   of memory as hex.
+		 */
+		static constexpr std::size_t packetSize = 0x20100;
+
+		/**
+		 * @brief How many instructions run between checks for an interrupt
+		   from the front end.
+		 */
+		static constexpr std::uint64_t pollInterval = 1 << 20;
+
+		/**
+		 * @param machine `cpu&` The CPU to debug, which must have RAM.
+		 */
+		explicit rspServer(cpu& machine);
+
+		/**
+		 * @return `int` A socket listening on `port` of the loopback
+		   interface, or -1.
+		 */
+		static int listenTCP(const std::uint16_t port);
+
+		/**
+		 * @return `int` A Unix domain socket listening at `path`, which is
+		   replaced if it exists, or -1.
+		 */
+		static int listenUnix(const std::string& path);
+
+		/**
+		 * @brief Talks to the front end on `connection` until it detaches,
+		   kills the program or disconnects, then closes `connection`.
+		 */
+		void serve(const int connection);
+
+	private:
+		cpu& machine;
+		debugTarget target;
+
+		int fd = -1;
+		bool acknowledge = true;
+
+		/**
+		 * @brief Bytes received but not yet handled.
+		 */
+		std::string input;
+
+		/**
+		 * @brief The reply to `?`.
+		 */
+		std::string lastStop = "S05";
+
+		/**
+		 * @brief Reads the next packet into `packet`, without its framing
+		   and with `X` data still escaped.
+		 * @return `bool` Whether a packet was read before the connection closed.
+		 */
+		bool receive(std::string& packet);
+
+		/**
+		 * @brief Frames and sends `payload`.
+		 */
+		bool send(const std::string& payload);
+
+		/**
+		 * @return `bool` Whether the front end has asked to interrupt the
+		   program (a 0x03 byte).
+		 */
+		bool interrupted(void);
+
+		/**
+		 * @brief Handles `packet`, setting `reply`.
+		 * @return `bool` Whether to carry on.
+		 */
+		bool handle(const std::string& packet, std::string& reply);
+
+		/**
+		 * @brief Runs or steps the CPU, and describes why it stopped.
+		 */
+		std::string resume(const bool step);
+
+		std::string readRegisters(void);
+		bool writeRegisters(const std::string& hex);
+		bool readRegister(const int n, std::string& reply);
+		bool writeRegister(const int n, const std::string& hex);
+		std::string setPoint(const std::string& packet);
+	};
+}
@@ -0,0 +1,214 @@
+/**
+ * @file rsptest.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs a debugging session against `rspServer` over a socket pair,
+   as a front end would: the program is written with `X` and read back with
+   `x` and `m`, registers are set with `P`, then it is stepped with `s` and
+   run with `c` to a watchpoint (`Z2`), a breakpoint (`Z0`) and a `hlt`.
+   Checks each reply, with and without acknowledgements.
+   Usage: rsptest
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "./rsp.hpp"
+#include "./check.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+using namespace intel8080;
+
+namespace
+{
+	/**
+	 * @brief The front end's side of the connection.
+	 */
+	class frontEnd
+	{
+	public:
+		bool acknowledge = true;
+
+		explicit frontEnd(const int fd) noexcept
+		:
+			fd(fd)
+		{}
+
+		/**
+		 * @brief Sends `payload` and returns the reply, or "<error>" if the
+		   packet was not acknowledged or the reply was damaged.
+		 */
+		std::string exchange(const std::string& payload)
+		{
+			char trailer[4];
+			std::snprintf(trailer, sizeof trailer, "#%02x", checksum(payload));
+
+			const std::string packet = "$" + payload + trailer;
+
+			if(write(fd, packet.data(), packet.size()) != (ssize_t)packet.size())
+				return "<error>";
+
+			char c;
+
+			if(acknowledge and (read(fd, &c, 1) != 1 or c != '+'))
+				return "<error>";
+
+			// `$`, the reply up to `#`, and two digits of checksum
+			if(read(fd, &c, 1) != 1 or c != '$')
+				return "<error>";
+
+			std::string reply;
+
+			while(read(fd, &c, 1) == 1 and c != '#')
+				reply += c;
+
+			char digits[3] = {};
+
+			if(read(fd, digits, 2) != 2 or std::strtoul(digits, nullptr, 16) != checksum(reply))
+				return "<error>";
+
+			if(acknowledge and write(fd, "+", 1) != 1)
+				return "<error>";
+
+			return reply;
+		}
+
+	private:
+		int fd;
+
+		static unsigned checksum(const std::string& payload) noexcept
+		{
+			byte sum = 0;
+
+			for(const char c : payload)
+				sum += c;
+
+			return sum;
+		}
+	};
+
+	/**
+	 * @brief Escapes the bytes that frame packets, as in binary packets.
+	 */
+	std::string escape(const std::vector<byte>& data)
+	{
+		std::string out;
+
+		for(const byte b : data)
+		{
+			if(b == '#' or b == '$' or b == '}' or b == '*')
+			{
+				out += '}';
+				out += (char)(b ^ 0x20);
+			}
+			else
+			{
+				out += (char)b;
+			}
+		}
+
+		return out;
+	}
+
+	std::vector<byte> unescape(const std::string& text)
+	{
+		std::vector<byte> out;
+
+		for(std::size_t i = 0; i < text.size(); ++i)
+			out.push_back(text[i] == '}' and i + 1 < text.size() ? text[++i] ^ 0x20 : text[i]);
+
+		return out;
+	}
+}
+
+int main(void)
+{
+	// Its immediates are the bytes that must be escaped
+	const std::vector<byte> program = {
+		0x06, 0x7d,			// 0100 mvi b, '}'
+		0x0e, 0x2a,			// 0102 mvi c, '*'
+		0x16, 0x24,			// 0104 mvi d, '$'
+		0x3e, 0x23,			// 0106 mvi a, '#'
+		0x21, 0x00, 0x02,	// 0108 lxi h, 0x0200
+		0x77,				// 010b mov m, a
+		0x3c,				// 010c inr a
+		0x32, 0x10, 0x02,	// 010d sta 0x0210
+		0x76				// 0110 hlt
+	};
+
+	std::vector<byte> memory(0x10000);
+	cpu machine([](const byte){ return (byte)0; }, [](const byte, const byte){}, memory.data());
+	machine.PSW() = 0x0002;
+	machine.BC() = machine.DE() = machine.HL() = 0;
+
+	int sockets[2];
+
+	if(not CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0))
+		return checks::summary("rsptest");
+
+	rspServer server(machine);
+	std::thread serving([&](){ server.serve(sockets[0]); });
+
+	frontEnd gdb(sockets[1]);
+
+	CHECK(gdb.exchange("qSupported:swbreak+;hwbreak+").find("PacketSize=20100;") != std::string::npos);
+
+	// The program, in binary and back
+	CHECK(gdb.exchange("X100,11:" + escape(program)) == "OK");
+
+	const std::string binary = gdb.exchange("x100,11");
+	CHECK(binary.size() > 1 and binary[0] == 'b' and unescape(binary.substr(1)) == program);
+	CHECK(gdb.exchange("m10b,3") == "773c32");
+
+	// No more acknowledgements from here
+	CHECK(gdb.exchange("QStartNoAckMode") == "OK");
+	gdb.acknowledge = false;
+
+	// SP = 0x0400, PC = 0x0100, each little-endian
+	CHECK(gdb.exchange("P5=0004") == "OK");
+	CHECK(gdb.exchange("P6=0001") == "OK");
+
+	CHECK(gdb.exchange("s") == "T0505:0004;06:0201;");
+	CHECK(gdb.exchange("s") == "T0505:0004;06:0401;");
+
+	// `mov m, a` writes the watched byte, and stops after it; the breakpoint
+	// stops before `sta`
+	CHECK(gdb.exchange("Z0,10d,1") == "OK");
+	CHECK(gdb.exchange("Z2,200,1") == "OK");
+	CHECK(gdb.exchange("c") == "T05watch:200;05:0004;06:0c01;");
+	CHECK(gdb.exchange("c") == "T05swbreak:;05:0004;06:0d01;");
+	CHECK(gdb.exchange("?") == "T05swbreak:;05:0004;06:0d01;");
+
+	// Removed, so the program runs to `hlt`
+	CHECK(gdb.exchange("z0,10d,1") == "OK");
+	CHECK(gdb.exchange("z2,200,1") == "OK");
+	CHECK(gdb.exchange("c") == "T0505:0004;06:1101;");
+
+	// A, the flags, BC, DE, HL, SP and PC
+	const std::string registers = gdb.exchange("g");
+	CHECK(registers.size() == 2 * 12);
+	CHECK(registers.compare(0, 2, "24") == 0);
+	CHECK(registers.substr(4) == "2a7d" "0024" "0002" "0004" "1101");
+
+	CHECK(gdb.exchange("D") == "OK");
+
+	serving.join();
+	close(sockets[1]);
+
+	CHECK(machine.getHalted());
+	CHECK(memory[0x0200] == 0x23 and memory[0x0210] == 0x24);
+
+	return checks::summary("rsptest");
+}
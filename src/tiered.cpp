@@ -0,0 +1,251 @@
+/**
+ * @file tiered.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs an `intel8080::cpu` in the interpreter until code is hot, then
+   in `blockEngine`, then in code generated by `recompile`.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// For an explanation of what each function and type is for, see `tiered.hpp`.
+
+#include "./tiered.hpp"
+
+#include <algorithm>
+
+using namespace intel8080;
+
+tieredEngine::tieredEngine(cpu& m, const thresholds& l, const recompiledProgram n /* = nullptr */)
+:
+	machine(m),
+	limits(l),
+	native(n),
+	blocks(m),
+	counts(0x10000),
+	nativeStates(0x10000, nativeState::untried)
+{}
+
+std::uint64_t tieredEngine::run(const std::uint64_t maxInstructions)
+{
+	std::uint64_t executed = 0;
+
+	while(executed < maxInstructions)
+	{
+		const std::uint64_t budget = maxInstructions - executed;
+		const bytePair pc = machine.PC;
+
+		// A pending interrupt is serviced before any tier runs the next block
+		if(not machine.getHalted() and not interruptible())
+		{
+			const nativeState state = nativeStates[pc];
+
+			if(state == nativeState::native or (native and state == nativeState::untried and blocks.getRuns(pc) >= limits.native))
+			{
+				if(const std::uint64_t n = runNative(budget))
+				{
+					executed += n;
+					continue;
+				}
+			}
+
+			if(blocks.translated(pc))
+			{
+				executed += runBlocks(budget);
+				continue;
+			}
+
+			if(++counts[pc] >= limits.blocks)
+			{
+				blocks.translateAt(pc);
+				++stats.promotedToBlocks;
+
+				executed += runBlocks(budget);
+				continue;
+			}
+		}
+
+		const std::uint64_t n = interpret(budget);
+
+		if(n == 0)
+			break;
+
+		executed += n;
+	}
+
+	return executed;
+}
+
+void tieredEngine::invalidate(const bytePair begin, const std::uint32_t length /* = 1 */)
+{
+	// The recompiled program checks its own code
+	blocks.invalidate(begin, length);
+}
+
+void tieredEngine::flush(void)
+{
+	blocks.flush();
+	std::fill(counts.begin(), counts.end(), 0);
+
+	for(std::uint32_t adr = 0; adr < 0x10000; ++adr)
+	{
+		if(nativeStates[adr] == nativeState::native)
+			blocks.setExit(adr, false);
+
+		nativeStates[adr] = nativeState::untried;
+	}
+}
+
+const tieredEngine::statistics& tieredEngine::getStatistics(void) const noexcept
+{
+	return stats;
+}
+
+const blockEngine::statistics& tieredEngine::getBlockStatistics(void) const noexcept
+{
+	return blocks.getStatistics();
+}
+
+std::uint64_t tieredEngine::interpret(const std::uint64_t maxInstructions)
+{
+	// Only an interrupt ends a halt; the interrupt is run on its own, and
+	// pushes the return address
+	if(machine.getHalted() or interruptible())
+	{
+		machine.step();
+
+		if(machine.getHalted())
+			return 0;
+
+		blocks.invalidate(machine.SP, 2);
+		++stats.interpreted;
+		return 1;
+	}
+
+	std::uint64_t executed = 0;
+	byte opcode;
+
+	// Up to where a block would end, so that the blocks counted are the ones
+	// `blocks` would translate
+	do
+	{
+		opcode = machine.ram[machine.PC];
+		const bytePair sp = machine.SP;
+
+		willStore(opcode);
+		machine.step();
+		++executed;
+
+		// `push`, `call`, `rst` and interrupts write just below the old stack
+		// pointer; anything else that moves it by 2 is checked needlessly
+		if((bytePair)(sp - machine.SP) == 2)
+			blocks.invalidate(machine.SP, 2);
+	}
+	while(not blockEngine::endsBlock(opcode) and executed < maxInstructions
+		and executed != blockEngine::maxBlockInstructions and not blocks.translated(machine.PC));
+
+	stats.interpreted += executed;
+	return executed;
+}
+
+std::uint64_t tieredEngine::runBlocks(const std::uint64_t maxInstructions)
+{
+	// Stopping at hot blocks lets `run` promote them
+	blockEngine::limits stop;
+	stop.translate = false;
+	stop.hotRuns = native ? limits.native : 0;
+
+	const std::uint64_t executed = blocks.run(maxInstructions, stop);
+	stats.inBlocks += executed;
+	return executed;
+}
+
+std::uint64_t tieredEngine::runNative(const std::uint64_t maxInstructions)
+{
+	const bytePair pc = machine.PC;
+	const std::uint64_t executed = native(machine, maxInstructions);
+	nativeState& state = nativeStates[pc];
+
+	if(executed == 0)
+	{
+		// It was most likely modified since it was recompiled
+		if(state == nativeState::native)
+		{
+			blocks.setExit(pc, false);
+			++stats.deoptimized;
+		}
+		else
+		{
+			++stats.nativeRejected;
+		}
+
+		state = nativeState::rejected;
+		return 0;
+	}
+
+	if(state != nativeState::native)
+	{
+		state = nativeState::native;
+		blocks.setExit(pc);
+		++stats.promotedToNative;
+	}
+
+	// Only the pages the recompiled program stored to can have changed
+	stats.inNative += executed;
+
+	for(std::uint32_t page = 0; page < 0x100; ++page)
+	{
+		if(recompiled::pagesWritten[page])
+		{
+			recompiled::pagesWritten[page] = 0;
+			blocks.revalidate(page);
+		}
+	}
+
+	return executed;
+}
+
+void tieredEngine::willStore(const byte opcode)
+{
+	const bytePair pc = machine.PC;
+	const bytePair operand = machine.ram[(bytePair)(pc + 1)] | machine.ram[(bytePair)(pc + 2)] << 8;
+
+	switch(opcode)
+	{
+		// STAX B
+		case 0x02:
+			blocks.invalidate(machine.BC());
+			break;
+
+		// STAX D
+		case 0x12:
+			blocks.invalidate(machine.DE());
+			break;
+
+		// SHLD
+		case 0x22:
+			blocks.invalidate(operand, 2);
+			break;
+
+		// STA
+		case 0x32:
+			blocks.invalidate(operand);
+			break;
+
+		// XTHL
+		case 0xe3:
+			blocks.invalidate(machine.SP, 2);
+			break;
+
+		// INR M, DCR M, MVI M, MOV M, r
+		case 0x34: case 0x35: case 0x36:
+		case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x77:
+			blocks.invalidate(machine.HL());
+			break;
+	}
+}
@@ -0,0 +1,174 @@
+/**
+ * @file tiered.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Runs an `intel8080::cpu` in the interpreter until code is hot, then
+   in `blockEngine`, then in code generated by `recompile`.
+ * @version 0.3
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022 Weiju Wang.
+ * This file is part of `intel8080`.
+ * `intel8080` is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * `intel8080` is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./intel8080.hpp"
+#include "./blocks.hpp"
+#include "./recompiled.hpp"
+
+#include <vector>
+
+namespace intel8080
+{
+	/**
+	 * @brief Runs a `cpu` in up to three tiers, with the same results as
+	   calling `cpu::step` repeatedly.
+	 * Code starts in `cpu::step`, which costs nothing to start but is the
+	   slowest. The number of times control enters a basic block there is
+	   counted, and a block entered `thresholds::blocks` times is translated
+	   for `blockEngine`, which runs it from then on. If a program generated
+	   by `recompile` is given, a translated block entered
+	   `thresholds::native` times is run by it instead whenever control
+	   reaches it; if the program cannot run the block (it was not
+	   recompiled, or has been modified since), it returns to `blockEngine`.
+	 * Pending interrupts are serviced before the next block in any tier. The
+	   recompiled program returns after `in` and `out` and, if an interrupt
+	   can be serviced, at backward branches and returns, so an interrupt
+	   requested by a port handler is taken after the same instruction as
+	   in `cpu::step`.
+	 * Memory written by the host, port handlers or DMA must be reported with
+	   `invalidate`.
+	 */
+	class tieredEngine
+	{
+	public:
+		/**
+		 * @brief The number of times a block must be entered before it is
+		   promoted to each tier.
+		 */
+		struct thresholds
+		{
+			std::uint32_t blocks = 16;
+			std::uint64_t native = 256;
+		};
+
+		/**
+		 * @brief Counts of what the engine has done, for tuning.
+		 */
+		struct statistics
+		{
+			std::uint64_t interpreted = 0;		// Instructions run by `cpu::step`.
+			std::uint64_t inBlocks = 0;			// Instructions run by `blockEngine`.
+			std::uint64_t inNative = 0;			// Instructions run by the recompiled program.
+			std::uint64_t promotedToBlocks = 0;	// Blocks translated for `blockEngine`.
+			std::uint64_t promotedToNative = 0;	// Blocks handed to the recompiled program.
+			std::uint64_t nativeRejected = 0;	// Hot blocks the recompiled program could not run.
+			std::uint64_t deoptimized = 0;		// Blocks taken back from the recompiled program.
+		};
+
+		/**
+		 * @brief Construct an engine for `machine`, which must have RAM.
+		 * @param machine `cpu&` The CPU to run. Its registers can be changed
+		   freely between calls to `run`.
+		 * @param limits `const thresholds&` When to promote blocks.
+		 * @param native `recompiledProgram` Code generated by `recompile` for
+		   the program in memory, or `nullptr` for only two tiers.
+		 */
+		tieredEngine(cpu& machine, const thresholds& limits, const recompiledProgram native = nullptr);
+
+		/**
+		 * @brief Runs until at least `maxInstructions` instructions have run
+		   or the CPU halts, servicing interrupts as `cpu::step` would.
+		 *
+		 * @param maxInstructions `std::uint64_t` The number of instructions to run.
+		 * @return `std::uint64_t` The number of instructions run, which is 0
+		   if the CPU is halted with no interrupt to service.
+		 */
+		std::uint64_t run(const std::uint64_t maxInstructions);
+
+		/**
+		 * @brief Reports that `length` bytes from `begin` were changed other
+		   than by the CPU.
+		 */
+		void invalidate(const bytePair begin, const std::uint32_t length = 1);
+
+		/**
+		 * @brief Forgets everything about the code in memory, e.g. after
+		   loading a new program.
+		 */
+		void flush(void);
+
+		/**
+		 * @return `const statistics&` What the engine has done so far.
+		 */
+		const statistics& getStatistics(void) const noexcept;
+
+		/**
+		 * @return `const blockEngine::statistics&` What the block tier has done so far.
+		 */
+		const blockEngine::statistics& getBlockStatistics(void) const noexcept;
+
+	private:
+		cpu& machine;
+		const thresholds limits;
+		const recompiledProgram native;
+		blockEngine blocks;
+		statistics stats;
+
+		/**
+		 * @brief The number of times each address has been entered in the
+		   interpreter.
+		 */
+		std::vector<std::uint32_t> counts;
+
+		/**
+		 * @brief Whether the recompiled program runs the block at an address.
+		 */
+		enum class nativeState : byte
+		{
+			untried,
+			native,
+			rejected
+		};
+
+		std::vector<nativeState> nativeStates;
+
+		/**
+		 * @return `bool` Whether `cpu::step` would service an interrupt next.
+		 */
+		bool interruptible(void) noexcept
+		{
+			return machine.getInterruptsEnabled() and machine.getInterruptPending();
+		}
+
+		/**
+		 * @brief Runs what would be one block in `blocks`, or less if it
+		   reaches a translated block, in the interpreter. A pending
+		   interrupt is run on its own.
+		 */
+		std::uint64_t interpret(const std::uint64_t maxInstructions);
+
+		/**
+		 * @brief Runs translated blocks until one is cold, run natively or hot.
+		 */
+		std::uint64_t runBlocks(const std::uint64_t maxInstructions);
+
+		/**
+		 * @brief Runs the recompiled program from the program counter,
+		   promoting the block there or taking it back according to whether
+		   the program can run it.
+		 * @return `std::uint64_t` The number of instructions run, which is 0
+		   if it could not run the block.
+		 */
+		std::uint64_t runNative(const std::uint64_t maxInstructions);
+
+		/**
+		 * @brief Reports the memory that the instruction about to be
+		   interpreted, `opcode`, may write to `blocks`, other than by pushing.
+		 */
+		void willStore(const byte opcode);
+	};
+}